@@ -55,6 +55,7 @@
 #include <core/Hydrogen.h>
 #include <core/Preferences/Preferences.h>
 #include <core/Sampler/Interpolation.h>
+#include <core/SMF/SMFReader.h>
 #include <core/Version.h>
 
 using namespace H2Core;
@@ -226,6 +227,10 @@ int main(int argc, char *argv[])
 			QStringList() << "kitToDrumkitMap",
 			"Create a .h2map from the provided drumkit. To write the output into a file, use it in conjunction with -o.",
 			"Path" );
+		QCommandLineOption importMidiOption(
+			QStringList() << "importMidi",
+			"Import a Standard MIDI File (type 0 or 1) into the patterns of the loaded song using the MIDI output notes of its instruments. Use it in conjunction with -o to write the resulting song into a file.",
+			"File" );
 		QCommandLineOption kitOption(
 			QStringList() << "k" << "kit",
 			"Load a drumkit at startup", "DrumkitName" );
@@ -255,6 +260,7 @@ int main(int argc, char *argv[])
 		parser.addOption( compressionLevelOption );
 		parser.addOption( kitOption );
 		parser.addOption( kitToDrumkitMapOption );
+		parser.addOption( importMidiOption );
 		parser.addOption( interpolationOption );
 		parser.addOption( installDrumkitOption );
 		parser.addOption( checkDrumkitOption );
@@ -284,6 +290,7 @@ int main(int argc, char *argv[])
 		const QString sInstallDrumkitName = parser.value( installDrumkitOption );
 		const QString sDrumkitToLoad = parser.value( kitOption );
 		const QString sKitToDrumkitMap = parser.value( kitToDrumkitMapOption );
+		const QString sMidiFileToImport = parser.value( importMidiOption );
 		const QString sDrumkitToValidate = parser.value( checkDrumkitOption );
 		const QString sDrumkitToLegacyValidate = parser.value( legacyCheckDrumkitOption );
 		const QString sLogFile = parser.value( logFileOption );
@@ -499,7 +506,8 @@ int main(int argc, char *argv[])
 		// point the CLI has to be properly reworked. But as it seems not to be
 		// in common usage only support audio export or .h2map for now.
 		bool bExportMode = false;
-		if ( ! sOutFilename.isEmpty() && sKitToDrumkitMap.isEmpty() ) {
+		if ( ! sOutFilename.isEmpty() && sKitToDrumkitMap.isEmpty() &&
+			 sMidiFileToImport.isEmpty() ) {
 			auto pInstrumentList = pSong->getDrumkit()->getInstruments();
 			for (auto i = 0; i < pInstrumentList->size(); i++) {
 				pInstrumentList->get(i)->set_currently_exported( true );
@@ -601,6 +609,36 @@ int main(int argc, char *argv[])
 			}
 		}
 
+		if ( ! sMidiFileToImport.isEmpty() ) {
+			pAudioEngine->lock( RIGHT_HERE );
+			SMFReader reader;
+			const bool bImported = reader.load( sMidiFileToImport, pSong );
+			if ( bImported ) {
+				// The patterns cached by the audio engine were replaced.
+				pAudioEngine->updatePlayingPatterns();
+				pHydrogen->updateSongSize();
+			}
+			pAudioEngine->unlock();
+
+			if ( ! bImported ) {
+				nReturnCode = 1;
+				std::cout << "Unable to import MIDI file [" <<
+					sMidiFileToImport.toLocal8Bit().data() << "]" << std::endl;
+			}
+			else if ( ! sOutFilename.isEmpty() &&
+					  ! pSong->save( sOutFilename ) ) {
+				nReturnCode = 1;
+				std::cout << "Unable to save song to [" <<
+					sOutFilename.toLocal8Bit().data() << "]" << std::endl;
+			}
+			else {
+				nReturnCode = 0;
+				std::cout << "MIDI file [" <<
+					sMidiFileToImport.toLocal8Bit().data() <<
+					"] successfully imported" << std::endl;
+			}
+		}
+
 		if ( nReturnCode == -1 || bExportMode ) {
 			// Interactive mode - h2cli is not done yet.
 			while ( ! quit ) {
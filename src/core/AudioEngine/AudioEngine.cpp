@@ -32,6 +32,9 @@
 #include <limits>
 #include <sstream>
 
+#include <core/AudioEngine/FlightRecorder.h>
+#include <core/AudioEngine/InstrumentReclaimer.h>
+#include <core/AudioEngine/Profiler.h>
 #include <core/AudioEngine/TransportPosition.h>
 #include <core/Basics/AutomationPath.h>
 #include <core/Basics/Drumkit.h>
@@ -45,6 +48,7 @@
 #include <core/EventQueue.h>
 #include <core/FX/Effects.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Mix.h>
 #include <core/Helpers/Random.h>
 #include <core/Hydrogen.h>
 #include <core/IO/AlsaAudioDriver.h>
@@ -64,6 +68,7 @@
 #include <core/IO/PortMidiDriver.h>
 #include <core/IO/PulseAudioDriver.h>
 #include <core/Preferences/Preferences.h>
+#include <core/rt_clock.h>
 #include <core/Sampler/Sampler.h>
 
 #define AUDIO_ENGINE_DEBUG 0
@@ -81,17 +86,11 @@ namespace H2Core
 		__logger->log( Logger::Debug, _class_name(), __FUNCTION__, \
 					   QString( "%1" ).arg( x ), "\033[34;1m" ); }
 
-/** Gets the current time.
- * \return Current time obtained by gettimeofday()*/
-inline timeval currentTime2()
-{
-	struct timeval now;
-	gettimeofday( &now, nullptr );
-	return now;
-}
-
 AudioEngine::AudioEngine()
 		: m_pSampler( nullptr )
+		, m_pProfiler( nullptr )
+		, m_pFlightRecorder( nullptr )
+		, m_pInstrumentReclaimer( nullptr )
 		, m_pAudioDriver( nullptr )
 		, m_pMidiDriver( nullptr )
 		, m_pMidiDriverOut( nullptr )
@@ -115,6 +114,9 @@ AudioEngine::AudioEngine()
 	m_pQueuingPosition = std::make_shared<TransportPosition>( "Queuing" );
 	
 	m_pSampler = new Sampler;
+	m_pProfiler = new Profiler;
+	m_pFlightRecorder = new FlightRecorder;
+	m_pInstrumentReclaimer = new InstrumentReclaimer( this );
 
 	m_pEventQueue = EventQueue::get_instance();
 	
@@ -146,6 +148,12 @@ AudioEngine::AudioEngine()
 AudioEngine::~AudioEngine()
 {
 	stopAudioDrivers();
+
+	// Stops the snapshot thread while the engine is still intact.
+	delete m_pFlightRecorder;
+	m_pFlightRecorder = nullptr;
+	delete m_pInstrumentReclaimer;
+	m_pInstrumentReclaimer = nullptr;
 	if ( getState() != State::Initialized ) {
 		AE_ERRORLOG( "Error the audio engine is not in State::Initialized" );
 		return;
@@ -173,6 +181,7 @@ AudioEngine::~AudioEngine()
 #endif
 
 	delete m_pSampler;
+	delete m_pProfiler;
 }
 
 Sampler* AudioEngine::getSampler() const
@@ -1331,9 +1340,8 @@ void AudioEngine::processPlayNotes( unsigned long nframes )
 			float fNoteProbability = pNote->get_probability();
 			if ( fNoteProbability != 1. ) {
 				// Current note is skipped with a certain probability.
-				if ( fNoteProbability < (float) rand() / (float) RAND_MAX ) {
+				if ( fNoteProbability < Random::getUniform() ) {
 					m_songNoteQueue.pop();
-					pNote->get_instrument()->dequeue( pNote );
 					continue;
 				}
 			}
@@ -1352,7 +1360,6 @@ void AudioEngine::processPlayNotes( unsigned long nframes )
 
 			if ( ! pNote->get_instrument()->hasSamples() ) {
 				m_songNoteQueue.pop();
-				pNote->get_instrument()->dequeue( pNote );
 				delete pNote;
 				continue;
 			}
@@ -1364,7 +1371,6 @@ void AudioEngine::processPlayNotes( unsigned long nframes )
 
 			m_pSampler->noteOn( pNote );
 			m_songNoteQueue.pop();
-			pNote->get_instrument()->dequeue( pNote );
 			
 			const int nInstrument = pSong->getDrumkit()->getInstruments()->index( pNote->get_instrument() );
 			if( pNote->get_note_off() ){
@@ -1386,15 +1392,12 @@ void AudioEngine::processPlayNotes( unsigned long nframes )
 
 void AudioEngine::clearNoteQueues( std::shared_ptr<Instrument> pInstrument )
 {
-	// notes in the song queue. Attention: their instruments are enqueued.
+	// notes in the song queue.
 	if ( pInstrument == nullptr ) {
 		// delete all copied notes in the note queues
 		while ( !m_songNoteQueue.empty() ) {
 			auto pNote = m_songNoteQueue.top();
 			if ( pNote != nullptr ) {
-				if ( pNote->get_instrument() != nullptr ) {
-					pNote->get_instrument()->dequeue( pNote );
-				}
 				delete pNote;
 			}
 			m_songNoteQueue.pop();
@@ -1410,9 +1413,6 @@ void AudioEngine::clearNoteQueues( std::shared_ptr<Instrument> pInstrument )
 			auto ppNote = m_songNoteQueue.top();
 			if ( ppNote == nullptr || ppNote->get_instrument() == nullptr ||
 				 ppNote->get_instrument() == pInstrument ) {
-				if ( ppNote->get_instrument() != nullptr ) {
-					ppNote->get_instrument()->dequeue( ppNote );
-				}
 				if ( ppNote != nullptr ) {
 					delete ppNote;
 				}
@@ -1428,7 +1428,7 @@ void AudioEngine::clearNoteQueues( std::shared_ptr<Instrument> pInstrument )
 
 	}
 
-	// Notes of MIDI note queue (no instrument enqueued in here).
+	// Notes of MIDI note queue.
 	for ( auto it = m_midiNoteQueue.begin(); it != m_midiNoteQueue.end(); ) {
 		auto ppNote = *it;
 		if ( ppNote == nullptr || ppNote->get_instrument() == nullptr ||
@@ -1453,11 +1453,16 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 		 dynamic_cast<JackAudioDriver*>(pAudioEngine->m_pAudioDriver) != nullptr ) {
 		return 0;
 	}
-	timeval startTimeval = currentTime2();
+	auto pProfiler = pAudioEngine->m_pProfiler;
+	const uint64_t nStartNs = rtClockNs();
+	pProfiler->beginCycle();
 	const auto sDrivers = pAudioEngine->getDriverNames();
 
 	pAudioEngine->clearAudioBuffers( nframes );
 
+	uint64_t nStageStartNs = rtClockNs();
+	uint64_t nDriverNs = nStageStartNs - nStartNs;
+
 	// Calculate maximum time to wait for audio engine lock. Using the
 	// last calculated processing time as an estimate of the expected
 	// processing time for this frame.
@@ -1478,8 +1483,14 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 	 * (like shutting down drivers). In such cases, it seems to be ok to interrupt
 	 * audio processing.
 	 */
-	if ( !pAudioEngine->tryLockFor( std::chrono::microseconds( (int)(1000.0*fSlackTime) ),
-							  RIGHT_HERE ) ) {
+	const bool bLocked = pAudioEngine->tryLockFor(
+		std::chrono::microseconds( (int)(1000.0*fSlackTime) ), RIGHT_HERE );
+	uint64_t nNowNs = rtClockNs();
+	pProfiler->record( Profiler::Stage::LockWait, nNowNs - nStageStartNs );
+	nStageStartNs = nNowNs;
+
+	if ( ! bLocked ) {
+		pProfiler->record( Profiler::Stage::Total, nNowNs - nStartNs );
 		___ERRORLOG( QString( "[%1] Failed to lock audioEngine in allowed %2 ms, missed buffer" )
 					 .arg( sDrivers ).arg( fSlackTime ) );
 
@@ -1490,6 +1501,10 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 			return 2;
 		}
 
+		pAudioEngine->m_pFlightRecorder->notifyXrun(
+			FlightRecorder::XrunSource::Lock );
+		pAudioEngine->recordCycle( nStartNs, nframes, false );
+
 		return 0;
 	}
 
@@ -1516,6 +1531,9 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 		static_cast<JackAudioDriver*>( pAudioDriver )->updateTransportPosition();
 	}
 #endif
+	nNowNs = rtClockNs();
+	nDriverNs += nNowNs - nStageStartNs;
+	pProfiler->record( Profiler::Stage::Driver, nDriverNs );
 
 	// Check whether the tempo was changed.
 	pAudioEngine->updateBpmAndTickSize( pAudioEngine->m_pTransportPosition );
@@ -1542,7 +1560,9 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 
 	// always update note queue.. could come from pattern or realtime input
 	// (midi, keyboard)
+	nStageStartNs = rtClockNs();
 	pAudioEngine->updateNoteQueue( nframes );
+	pProfiler->record( Profiler::Stage::NoteQueue, rtClockNs() - nStageStartNs );
 
 	pAudioEngine->processAudio( nframes );
 
@@ -1583,10 +1603,18 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 		}
 	}
 
-	timeval finishTimeval = currentTime2();
-	pAudioEngine->m_fProcessTime =
-			( finishTimeval.tv_sec - startTimeval.tv_sec ) * 1000.0
-			+ ( finishTimeval.tv_usec - startTimeval.tv_usec ) / 1000.0;
+	const uint64_t nTotalNs = rtClockNs() - nStartNs;
+	pProfiler->record( Profiler::Stage::Total, nTotalNs );
+	pAudioEngine->m_fProcessTime = static_cast<float>(nTotalNs) / 1000000.0;
+
+	// Offline drivers do not have to keep up with realtime.
+	if ( pAudioEngine->m_fProcessTime > pAudioEngine->m_fMaxProcessTime &&
+		 dynamic_cast<DiskWriterDriver*>(pAudioEngine->m_pAudioDriver) == nullptr &&
+		 dynamic_cast<FakeDriver*>(pAudioEngine->m_pAudioDriver) == nullptr ) {
+		pAudioEngine->m_pFlightRecorder->notifyXrun(
+			FlightRecorder::XrunSource::Deadline );
+	}
+	pAudioEngine->recordCycle( nStartNs, nframes, true );
 	
 #ifdef CONFIG_DEBUG
 	if ( pAudioEngine->m_fProcessTime > pAudioEngine->m_fMaxProcessTime ) {
@@ -1605,11 +1633,41 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 	}
 #endif
 
+	// Let the reclaimer know the engine holds no references to notes
+	// besides the ones in its queues.
+	pAudioEngine->m_pInstrumentReclaimer->quiescentPoint();
+
 	pAudioEngine->unlock();
 
 	return 0;
 }
 
+void AudioEngine::recordCycle( uint64_t nStartNs, uint32_t nFrames,
+								bool bLocked ) {
+	FlightRecorder::CycleRecord record;
+	record.nTimestampNs = nStartNs;
+	record.nBudgetNs = static_cast<uint64_t>( m_fMaxProcessTime * 1000000.0 );
+	record.nFrames = nFrames;
+	// The containers must not be accessed without holding the lock.
+	if ( bLocked ) {
+		record.nVoices = static_cast<int>(
+			m_pSampler->getPlayingNotesQueue().size() );
+		record.nSongNoteQueue = static_cast<int>(m_songNoteQueue.size());
+		record.nMidiNoteQueue = static_cast<int>(m_midiNoteQueue.size());
+	} else {
+		record.nVoices = -1;
+		record.nSongNoteQueue = -1;
+		record.nMidiNoteQueue = -1;
+	}
+	const uint64_t* stages = m_pProfiler->getCurrentCycle();
+	for ( int ii = 0; ii < static_cast<int>(Profiler::Stage::Count); ++ii ) {
+		record.stages[ ii ] = stages[ ii ];
+	}
+	record.bXrun = false;
+
+	m_pFlightRecorder->record( record );
+}
+
 void AudioEngine::processAudio( uint32_t nFrames ) {
 
 	auto pSong = Hydrogen::get_instance()->getSong();
@@ -1617,28 +1675,31 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 		return;
 	}
 
+	uint64_t nStageStartNs = rtClockNs();
 	processPlayNotes( nFrames );
+	uint64_t nNowNs = rtClockNs();
+	m_pProfiler->record( Profiler::Stage::PlayNotes, nNowNs - nStageStartNs );
+	nStageStartNs = nNowNs;
 
 	float *pBuffer_L = m_pAudioDriver->getOut_L(),
 		*pBuffer_R = m_pAudioDriver->getOut_R();
 	assert( pBuffer_L != nullptr && pBuffer_R != nullptr );
 
 	getSampler()->process( nFrames );
-	float* out_L = getSampler()->m_pMainOut_L;
-	float* out_R = getSampler()->m_pMainOut_R;
-	for ( unsigned i = 0; i < nFrames; ++i ) {
-		pBuffer_L[ i ] += out_L[ i ];
-		pBuffer_R[ i ] += out_R[ i ];
-	}
+	nNowNs = rtClockNs();
+	m_pProfiler->record( Profiler::Stage::Sampler, nNowNs - nStageStartNs );
+	nStageStartNs = nNowNs;
+
+	Mix::add( pBuffer_L, getSampler()->m_pMainOut_L, nFrames );
+	Mix::add( pBuffer_R, getSampler()->m_pMainOut_R, nFrames );
 
 #ifdef H2CORE_HAVE_LADSPA
-	timeval ladspaTime_start = currentTime2();
+	auto pEffects = Effects::get_instance();
+	pEffects->processFX( nFrames );
 
 	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
-		LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
+		LadspaFX *pFX = pEffects->getLadspaFX( nFX );
 		if ( ( pFX ) && ( pFX->isEnabled() ) ) {
-			pFX->processFX( nFrames );
-
 			float *buf_L, *buf_R;
 			if ( pFX->getPluginType() == LadspaFX::STEREO_FX ) {
 				buf_L = pFX->m_pBuffer_L;
@@ -1648,36 +1709,22 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 				buf_R = buf_L;
 			}
 
-			for ( unsigned i = 0; i < nFrames; ++i ) {
-				pBuffer_L[ i ] += buf_L[ i ];
-				pBuffer_R[ i ] += buf_R[ i ];
-				if ( buf_L[ i ] > m_fFXPeak_L[nFX] ) {
-					m_fFXPeak_L[nFX] = buf_L[ i ];
-				}
-
-				if ( buf_R[ i ] > m_fFXPeak_R[nFX] ) {
-					m_fFXPeak_R[nFX] = buf_R[ i ];
-				}
-			}
+			m_fFXPeak_L[ nFX ] = Mix::addWithPeak(
+				pBuffer_L, buf_L, nFrames, m_fFXPeak_L[ nFX ] );
+			m_fFXPeak_R[ nFX ] = Mix::addWithPeak(
+				pBuffer_R, buf_R, nFrames, m_fFXPeak_R[ nFX ] );
 		}
 	}
 
-	timeval ladspaTime_end = currentTime2();
-	m_fLadspaTime =
-			( ladspaTime_end.tv_sec - ladspaTime_start.tv_sec ) * 1000.0
-			+ ( ladspaTime_end.tv_usec - ladspaTime_start.tv_usec ) / 1000.0;
+	const uint64_t nFXNs = rtClockNs() - nStageStartNs;
+	m_pProfiler->record( Profiler::Stage::FX, nFXNs );
+	m_fLadspaTime = static_cast<float>(nFXNs) / 1000000.0;
 #else
 	m_fLadspaTime = 0.0;
 #endif
 
-	float fPeak_L = m_fMasterPeak_L, fPeak_R = m_fMasterPeak_R;
-	for ( unsigned i = 0; i < nFrames; ++i ) {
-		fPeak_L = std::max( fPeak_L, pBuffer_L[i] );
-		fPeak_R = std::max( fPeak_R, pBuffer_R[i] );
-	}
-
-	m_fMasterPeak_L = fPeak_L;
-	m_fMasterPeak_R = fPeak_R;
+	m_fMasterPeak_L = Mix::peak( pBuffer_L, nFrames, m_fMasterPeak_L );
+	m_fMasterPeak_R = Mix::peak( pBuffer_R, nFrames, m_fMasterPeak_R );
 }
 
 void AudioEngine::setState( const AudioEngine::State& state ) {
@@ -2512,7 +2559,6 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 			}
 
 			m_midiNoteQueue.pop_front();
-			pNote->get_instrument()->enqueue( pNote );
 			pNote->computeNoteStart();
 			pNote->humanize();
 			m_songNoteQueue.push( pNote );
@@ -2616,7 +2662,6 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 												 0.f, // pan
 												 -1,
 												 fPitch );
-				m_pMetronomeInstrument->enqueue( pMetronomeNote );
 				pMetronomeNote->computeNoteStart();
 				m_songNoteQueue.push( pMetronomeNote );
 			}
@@ -2716,7 +2761,6 @@ void AudioEngine::updateNoteQueue( unsigned nIntervalLengthInFrames )
 								  .arg( pCopiedNote->toQString() ) );
 #endif
 
-						pCopiedNote->get_instrument()->enqueue( pCopiedNote );
 						m_songNoteQueue.push( pCopiedNote );
 					}
 				}
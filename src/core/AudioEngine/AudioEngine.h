@@ -64,11 +64,14 @@ namespace H2Core
 {
 	class Drumkit;
 	class EventQueue;
+	class FlightRecorder;
 	class Instrument;
+	class InstrumentReclaimer;
 	class MidiInput;
 	class MidiOutput;
 	class Note;
 	class PatternList;
+	class Profiler;
 	class Song;
 	class TransportPosition;
 	
@@ -273,6 +276,14 @@ public:
 	static double computeDoubleTickSize(const int nSampleRate, const float fBpm, const int nResolution);
 
 	Sampler*		getSampler() const;
+	/** Timings of the individual stages of audioEngine_process(). */
+	Profiler*		getProfiler() const;
+	/** Statistics of the last few seconds of processing written to
+	 * disk on xruns. */
+	FlightRecorder*	getFlightRecorder() const;
+	/** Unloads the samples of instruments removed from the drumkit
+	 * once no note is using them anymore. */
+	InstrumentReclaimer*	getInstrumentReclaimer() const;
 
 	/** \return Time passed since the beginning of the song*/
 	float			getElapsedTime() const;	
@@ -470,6 +481,7 @@ public:
 	friend int FakeDriver::connect();
 
 	friend class AudioEngineTests;
+	friend class InstrumentReclaimer;
 		friend class JackAudioDriver;
 private:
 
@@ -517,6 +529,14 @@ private:
 	 */
 	void			updateNoteQueue( unsigned nIntervalLengthInFrames );
 	void 			processAudio( uint32_t nFrames );
+	/**
+	 * Hands the statistics of the current cycle to the
+	 * #FlightRecorder.
+	 *
+	 * \param bLocked Whether the audio engine is locked. If not, the
+	 * note queues are not inspected.
+	 */
+	void			recordCycle( uint64_t nStartNs, uint32_t nFrames, bool bLocked );
 	long long 		computeTickInterval( double* fTickStart, double* fTickEnd, unsigned nIntervalLengthInFrames );
 	void			updateBpmAndTickSize( std::shared_ptr<TransportPosition> pTransportPosition );
 	void			calculateTransportOffsetOnBpmChange( std::shared_ptr<TransportPosition> pTransportPosition );
@@ -597,6 +617,9 @@ private:
 	QString getDriverNames() const;
 
 	Sampler* 			m_pSampler;
+	Profiler*			m_pProfiler;
+	FlightRecorder*		m_pFlightRecorder;
+	InstrumentReclaimer*	m_pInstrumentReclaimer;
 	AudioOutput *		m_pAudioDriver;
 	MidiInput *			m_pMidiDriver;
 	MidiOutput *		m_pMidiDriverOut;
@@ -687,8 +710,20 @@ private:
 	struct compare_pNotes {
 		bool operator() (Note* pNote1, Note* pNote2);
 	};
+	/** Priority queue which additionally allows to iterate over all
+	 * contained notes (in no particular order). */
+	class SongNoteQueue :
+		public std::priority_queue<Note*, std::deque<Note*>, compare_pNotes > {
+	public:
+		std::deque<Note*>::const_iterator begin() const {
+			return c.begin();
+		}
+		std::deque<Note*>::const_iterator end() const {
+			return c.end();
+		}
+	};
 
-	std::priority_queue<Note*, std::deque<Note*>, compare_pNotes > m_songNoteQueue;
+	SongNoteQueue		m_songNoteQueue;
 	std::deque<Note*>	m_midiNoteQueue;	///< Midi Note FIFO
 	
 	/**
@@ -767,6 +802,18 @@ inline float AudioEngine::getMasterPeak_R() const {
 	return m_fMasterPeak_R;
 }
 
+inline Profiler* AudioEngine::getProfiler() const {
+	return m_pProfiler;
+}
+
+inline FlightRecorder* AudioEngine::getFlightRecorder() const {
+	return m_pFlightRecorder;
+}
+
+inline InstrumentReclaimer* AudioEngine::getInstrumentReclaimer() const {
+	return m_pInstrumentReclaimer;
+}
+
 inline float AudioEngine::getProcessTime() const {
 	return m_fProcessTime;
 }
@@ -0,0 +1,250 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/AudioEngine/FlightRecorder.h>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Hydrogen.h>
+#include <core/IO/AudioOutput.h>
+#include <core/Sampler/Sampler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+namespace H2Core {
+
+FlightRecorder::FlightRecorder()
+	: m_records( new CycleRecord[ nCapacity ] )
+	, m_nWritten( 0 )
+	, m_bFrozen( false )
+	, m_nPendingXrun( -1 )
+	, m_bMarkXrun( false )
+	, m_nSnapshots( 0 )
+	, m_bShutdown( false ) {
+	m_worker = std::thread( &FlightRecorder::workerLoop, this );
+}
+
+FlightRecorder::~FlightRecorder() {
+	m_bShutdown = true;
+	if ( m_worker.joinable() ) {
+		m_worker.join();
+	}
+}
+
+QString FlightRecorder::XrunSourceToQString( const XrunSource& source ) {
+	switch ( source ) {
+	case XrunSource::Driver:
+		return "Driver";
+	case XrunSource::Deadline:
+		return "Deadline";
+	case XrunSource::Lock:
+		return "Lock";
+	default:
+		return QString( "Unknown source [%1]" ).arg( static_cast<int>(source) );
+	}
+}
+
+void FlightRecorder::record( const CycleRecord& record ) {
+	if ( m_bFrozen.load( std::memory_order_acquire ) ) {
+		return;
+	}
+
+	const uint64_t nWritten = m_nWritten.load( std::memory_order_relaxed );
+	CycleRecord& target = m_records[ nWritten % nCapacity ];
+	target = record;
+	target.bXrun = m_bMarkXrun.exchange( false, std::memory_order_relaxed ) ||
+		record.bXrun;
+	m_nWritten.store( nWritten + 1, std::memory_order_release );
+}
+
+void FlightRecorder::notifyXrun( const XrunSource& source ) {
+	m_bMarkXrun.store( true, std::memory_order_relaxed );
+
+	int nExpected = -1;
+	m_nPendingXrun.compare_exchange_strong( nExpected, static_cast<int>(source),
+											std::memory_order_relaxed );
+}
+
+QString FlightRecorder::getLastSnapshotPath() const {
+	std::lock_guard<std::mutex> lock( m_snapshotMutex );
+	return m_sLastSnapshotPath;
+}
+
+std::vector<FlightRecorder::CycleRecord> FlightRecorder::copyRecords() const {
+	const uint64_t nWritten = m_nWritten.load( std::memory_order_acquire );
+	// The audio thread might still be writing the cycle it started
+	// before the ring buffer was frozen. It is stored in the slot of the
+	// oldest record, which is thus omitted.
+	const uint64_t nCount = std::min( nWritten,
+									  static_cast<uint64_t>(nCapacity - 1) );
+
+	std::vector<CycleRecord> records;
+	records.reserve( nCount );
+	for ( uint64_t ii = nWritten - nCount; ii < nWritten; ++ii ) {
+		records.push_back( m_records[ ii % nCapacity ] );
+	}
+
+	return records;
+}
+
+void FlightRecorder::workerLoop() {
+	auto lastSnapshot = std::chrono::steady_clock::now() -
+		std::chrono::milliseconds( nSnapshotCooldown );
+
+	while ( ! m_bShutdown ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+		const int nSource = m_nPendingXrun.load( std::memory_order_relaxed );
+		if ( nSource == -1 ) {
+			continue;
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		if ( now - lastSnapshot < std::chrono::milliseconds( nSnapshotCooldown ) ) {
+			// Still part of the burst already written.
+			m_nPendingXrun = -1;
+			continue;
+		}
+
+		// Give the audio thread some time to record the cycles following
+		// the xrun as well.
+		std::this_thread::sleep_for( std::chrono::milliseconds( 500 ) );
+
+		writeSnapshot( static_cast<XrunSource>(nSource) );
+		lastSnapshot = std::chrono::steady_clock::now();
+		m_nPendingXrun = -1;
+	}
+}
+
+void FlightRecorder::writeSnapshot( const XrunSource& source ) {
+	m_bFrozen.store( true, std::memory_order_release );
+	const auto records = copyRecords();
+	m_bFrozen.store( false, std::memory_order_release );
+
+	// The audio thread must not be kept waiting while it is struggling
+	// already. Only a few values are copied while holding the lock and
+	// they are omitted altogether in case it is contended.
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	QString sDriver( "unknown" ), sPlayingNotes( "unknown" );
+	int nSampleRate = 0;
+	if ( pAudioEngine->tryLock( RIGHT_HERE ) ) {
+		sDriver = pAudioEngine->getDriverNames();
+		if ( pAudioEngine->getAudioDriver() != nullptr ) {
+			nSampleRate = pAudioEngine->getAudioDriver()->getSampleRate();
+		}
+		sPlayingNotes = QString::number(
+			pAudioEngine->getSampler()->getPlayingNotesNumber() );
+		pAudioEngine->unlock();
+	}
+
+	// The histograms of the profiler are atomic.
+	const QString sProfilerState =
+		pAudioEngine->getProfiler()->toQString( "", false );
+
+	const QString sDir = Filesystem::xruns_dir();
+	if ( ! Filesystem::mkdir( sDir ) ) {
+		return;
+	}
+	const QString sPath = QDir( sDir ).absoluteFilePath(
+		QString( "xrun-%1.log" )
+		.arg( QDateTime::currentDateTime().toString( "yyyy-MM-dd_hh-mm-ss-zzz" ) ) );
+
+	QFile file( sPath );
+	if ( ! file.open( QIODevice::WriteOnly | QIODevice::Text ) ) {
+		ERRORLOG( QString( "Unable to open [%1] for writing" ).arg( sPath ) );
+		return;
+	}
+
+	QTextStream stream( &file );
+	stream << QString( "Xrun source: %1\n" ).arg( XrunSourceToQString( source ) )
+		   << QString( "Driver: %1\n" ).arg( sDriver )
+		   << QString( "Sample rate: %1\n" ).arg( nSampleRate )
+		   << QString( "Playing notes: %1\n" ).arg( sPlayingNotes )
+		   << QString( "Cycles: %1\n\n" ).arg( records.size() );
+
+	stream << "# time [ms] | xrun | frames | budget [us] | voices | song queue | midi queue";
+	for ( int ii = 0; ii < static_cast<int>(Profiler::Stage::Count); ++ii ) {
+		stream << " | " << Profiler::StageToQString(
+			static_cast<Profiler::Stage>(ii) ) << " [us]";
+	}
+	stream << "\n";
+
+	const uint64_t nLastNs = records.size() > 0 ?
+		records.back().nTimestampNs : 0;
+	for ( const auto& record : records ) {
+		// Time relative to the most recent cycle.
+		stream << QString( "%1 | %2 | %3 | %4 | %5 | %6 | %7" )
+			.arg( -1 * static_cast<double>( nLastNs - record.nTimestampNs ) / 1000000.0,
+				  0, 'f', 3 )
+			.arg( record.bXrun ? "X" : "-" )
+			.arg( record.nFrames )
+			.arg( record.nBudgetNs / 1000.0, 0, 'f', 1 )
+			.arg( record.nVoices )
+			.arg( record.nSongNoteQueue )
+			.arg( record.nMidiNoteQueue );
+		for ( const auto& nStageNs : record.stages ) {
+			stream << QString( " | %1" ).arg( nStageNs / 1000.0, 0, 'f', 1 );
+		}
+		stream << "\n";
+	}
+
+	stream << "\n" << sProfilerState << "\n";
+
+	{
+		std::lock_guard<std::mutex> lock( m_snapshotMutex );
+		m_sLastSnapshotPath = sPath;
+	}
+	++m_nSnapshots;
+
+	WARNINGLOG( QString( "Xrun [%1] detected. Snapshot written to [%2]" )
+				.arg( XrunSourceToQString( source ) ).arg( sPath ) );
+}
+
+QString FlightRecorder::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[FlightRecorder]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nWritten: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nWritten.load() ) )
+			.append( QString( "%1%2m_nSnapshots: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( getSnapshotCount() ) )
+			.append( QString( "%1%2m_sLastSnapshotPath: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( getLastSnapshotPath() ) );
+	}
+	else {
+		sOutput = QString( "[FlightRecorder] m_nWritten: %1" )
+			.arg( m_nWritten.load() )
+			.append( QString( ", m_nSnapshots: %1" ).arg( getSnapshotCount() ) )
+			.append( QString( ", m_sLastSnapshotPath: %1" )
+					 .arg( getLastSnapshotPath() ) );
+	}
+
+	return sOutput;
+}
+
+};
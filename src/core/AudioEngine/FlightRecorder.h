@@ -0,0 +1,140 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_FLIGHT_RECORDER_H
+#define H2C_FLIGHT_RECORDER_H
+
+#include <core/AudioEngine/Profiler.h>
+#include <core/Object.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <QString>
+
+namespace H2Core
+{
+
+/**
+ * Always-on recorder of the last few seconds of audio processing.
+ *
+ * At the end of each process cycle the audio thread stores some
+ * statistics - like the number of playing voices, the size of the note
+ * queues, and the timings of the individual #Profiler stages - in a
+ * fixed-size ring buffer. This involves neither locking nor memory
+ * allocation.
+ *
+ * Whenever an xrun is reported via notifyXrun(), a background thread
+ * freezes the ring buffer and writes it - together with the #Profiler
+ * histograms - to a file in Filesystem::xruns_dir(). This
+ * way intermittent dropouts can be analyzed after the show.
+ *
+ * \ingroup docCore docAudioEngine
+ */
+class FlightRecorder : public H2Core::Object<FlightRecorder>
+{
+	H2_OBJECT(FlightRecorder)
+public:
+	/** Number of cycles kept. At a buffer size of 256 frames and a
+	 * sample rate of 48kHz this corresponds to roughly 20 seconds.*/
+	static constexpr int nCapacity = 4096;
+	/** Minimum time in milliseconds between two snapshots. Xruns
+	 * tend to come in bursts and there is no use in writing a file
+	 * for each one of them.*/
+	static constexpr int nSnapshotCooldown = 10000;
+
+	enum class XrunSource {
+		/** Reported by the audio driver (e.g. the JACK server).*/
+		Driver = 0,
+		/** Processing took longer than the duration of the buffer.*/
+		Deadline = 1,
+		/** The audio engine lock could not be obtained in time and
+		 * the buffer was dropped.*/
+		Lock = 2
+	};
+	static QString XrunSourceToQString( const XrunSource& source );
+
+	struct CycleRecord {
+		/** Monotonic time stamp (see rtClockNs()) of the start of
+		 * the cycle.*/
+		uint64_t nTimestampNs;
+		/** Time available to process the cycle.*/
+		uint64_t nBudgetNs;
+		uint32_t nFrames;
+		int nVoices;
+		int nSongNoteQueue;
+		int nMidiNoteQueue;
+		uint64_t stages[ static_cast<int>(Profiler::Stage::Count) ];
+		/** Whether an xrun was reported during this cycle.*/
+		bool bXrun;
+	};
+
+	FlightRecorder();
+	~FlightRecorder();
+
+	/** Stores @a record in the ring buffer. To be called by the audio
+	 * thread at the end of each cycle.*/
+	void record( const CycleRecord& record );
+	/** Real-time safe. Marks the latest cycle and requests a
+	 * snapshot to be written by the background thread.*/
+	void notifyXrun( const XrunSource& source );
+
+	/** Number of snapshots written so far.*/
+	int getSnapshotCount() const {
+		return m_nSnapshots.load( std::memory_order_relaxed );
+	}
+	/** Path of the last snapshot written.*/
+	QString getLastSnapshotPath() const;
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	void workerLoop();
+	void writeSnapshot( const XrunSource& source );
+	/** \return All records currently held by the ring buffer,
+	 * oldest first.*/
+	std::vector<CycleRecord> copyRecords() const;
+
+	std::unique_ptr<CycleRecord[]> m_records;
+	/** Total number of records written. The next one will be stored
+	 * at `m_nWritten % nCapacity`.*/
+	std::atomic<uint64_t> m_nWritten;
+	/** While set, the audio thread does not record new cycles.*/
+	std::atomic<bool> m_bFrozen;
+	/** Set by notifyXrun() and consumed by the worker thread. -1 if
+	 * no snapshot is requested or the corresponding #XrunSource.*/
+	std::atomic<int> m_nPendingXrun;
+	std::atomic<bool> m_bMarkXrun;
+	std::atomic<int> m_nSnapshots;
+	std::atomic<bool> m_bShutdown;
+	std::thread m_worker;
+
+	mutable std::mutex m_snapshotMutex;
+	QString m_sLastSnapshotPath;
+};
+
+};
+
+#endif  // H2C_FLIGHT_RECORDER_H
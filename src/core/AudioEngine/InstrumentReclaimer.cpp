@@ -0,0 +1,338 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/AudioEngine/InstrumentReclaimer.h>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Sample.h>
+#include <core/Sampler/Sampler.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace H2Core {
+
+InstrumentReclaimer::InstrumentReclaimer( AudioEngine* pAudioEngine )
+	: m_pAudioEngine( pAudioEngine )
+	, m_nEpoch( 1 )
+	, m_nQuiescentEpoch( 0 )
+	, m_nRetired( 0 )
+	, m_nReclaimed( 0 )
+	, m_nRetiredSamples( 0 )
+	, m_bShutdown( false ) {
+	m_worker = std::thread( &InstrumentReclaimer::workerLoop, this );
+}
+
+InstrumentReclaimer::~InstrumentReclaimer() {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+	}
+	m_retiredAdded.notify_all();
+	if ( m_worker.joinable() ) {
+		m_worker.join();
+	}
+
+	// The audio engine is shut down. The samples of the remaining
+	// instruments are freed along with them.
+	for ( const auto& ppInstrument : m_retired ) {
+		ppInstrument->m_bRetired = false;
+	}
+	m_retired.clear();
+	for ( const auto& ppSample : m_retiredSamples ) {
+		ppSample->m_bRetired = false;
+	}
+	m_retiredSamples.clear();
+}
+
+void InstrumentReclaimer::retire( std::shared_ptr<Instrument> pInstrument ) {
+	if ( pInstrument == nullptr ) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		pInstrument->m_bRetired.store( true, std::memory_order_relaxed );
+		raise( pInstrument->m_nLastUsedEpoch,
+			   m_nEpoch.load( std::memory_order_relaxed ) );
+		if ( std::find( m_retired.begin(), m_retired.end(), pInstrument ) ==
+			 m_retired.end() ) {
+			m_retired.push_back( pInstrument );
+		}
+		m_nRetired.store( static_cast<int>(m_retired.size()),
+					 std::memory_order_release );
+	}
+	m_retiredAdded.notify_all();
+}
+
+void InstrumentReclaimer::retire( std::shared_ptr<Sample> pSample ) {
+	if ( pSample == nullptr ) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		pSample->m_bRetired.store( true, std::memory_order_relaxed );
+		raise( pSample->m_nLastUsedEpoch,
+			   m_nEpoch.load( std::memory_order_relaxed ) );
+		if ( std::find( m_retiredSamples.begin(), m_retiredSamples.end(),
+						pSample ) == m_retiredSamples.end() ) {
+			m_retiredSamples.push_back( pSample );
+		}
+		m_nRetiredSamples.store( static_cast<int>(m_retiredSamples.size()),
+								 std::memory_order_release );
+	}
+	m_retiredAdded.notify_all();
+}
+
+void InstrumentReclaimer::revive( std::shared_ptr<Instrument> pInstrument ) {
+	if ( pInstrument == nullptr ) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> unloadLock( m_unloadMutex );
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_retired.erase( std::remove( m_retired.begin(), m_retired.end(),
+								  pInstrument ), m_retired.end() );
+	pInstrument->m_bRetired.store( false, std::memory_order_relaxed );
+	m_nRetired.store( static_cast<int>(m_retired.size()),
+					 std::memory_order_release );
+}
+
+void InstrumentReclaimer::quiescentPoint() {
+	const uint64_t nEpoch = m_nEpoch.load( std::memory_order_acquire );
+
+	if ( m_nRetired.load( std::memory_order_acquire ) > 0 ||
+		 m_nRetiredSamples.load( std::memory_order_acquire ) > 0 ) {
+		for ( const auto& ppNote : m_pAudioEngine->m_songNoteQueue ) {
+			stamp( ppNote, nEpoch );
+		}
+		for ( const auto& ppNote : m_pAudioEngine->m_midiNoteQueue ) {
+			stamp( ppNote, nEpoch );
+		}
+		// Notes in the queue of note offs are only used to send MIDI
+		// messages and do not require samples.
+		for ( const auto& ppNote :
+				  m_pAudioEngine->getSampler()->getPlayingNotesQueue() ) {
+			stamp( ppNote, nEpoch );
+		}
+	}
+
+	m_nQuiescentEpoch.store( nEpoch, std::memory_order_release );
+}
+
+void InstrumentReclaimer::stamp( const Note* pNote, uint64_t nEpoch ) {
+	if ( pNote == nullptr ) {
+		return;
+	}
+	const auto pInstrument = pNote->get_instrument();
+	if ( pInstrument != nullptr &&
+		 pInstrument->m_bRetired.load( std::memory_order_relaxed ) ) {
+		raise( pInstrument->m_nLastUsedEpoch, nEpoch );
+	}
+
+	// Samples the note has started rendering.
+	for ( const auto& ppSelectedLayer : pNote->getLayersSelected() ) {
+		if ( ppSelectedLayer == nullptr ) {
+			continue;
+		}
+		const auto& pSample = ppSelectedLayer->pSample;
+		if ( pSample != nullptr &&
+			 pSample->m_bRetired.load( std::memory_order_relaxed ) ) {
+			raise( pSample->m_nLastUsedEpoch, nEpoch );
+		}
+	}
+}
+
+void InstrumentReclaimer::raise( std::atomic<uint64_t>& nEpoch,
+								 uint64_t nValue ) {
+	uint64_t nCurrent = nEpoch.load( std::memory_order_relaxed );
+	while ( nCurrent < nValue &&
+			! nEpoch.compare_exchange_weak( nCurrent, nValue,
+											std::memory_order_relaxed ) ) {
+	}
+}
+
+void InstrumentReclaimer::workerLoop() {
+	while ( true ) {
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_retiredAdded.wait( lock, [&]() {
+				return m_bShutdown || ! m_retired.empty() ||
+					! m_retiredSamples.empty(); } );
+			if ( m_bShutdown ) {
+				break;
+			}
+		}
+
+		const uint64_t nEpoch = synchronize();
+		if ( nEpoch == 0 ) {
+			break;
+		}
+		reclaim( nEpoch );
+
+		if ( m_nRetired.load( std::memory_order_relaxed ) > 0 ||
+			 m_nRetiredSamples.load( std::memory_order_relaxed ) > 0 ) {
+			// Some instruments or samples are still ringing.
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_retiredAdded.wait_for(
+				lock, std::chrono::milliseconds( nRetryInterval ),
+				[&]() { return m_bShutdown.load(); } );
+		}
+	}
+}
+
+uint64_t InstrumentReclaimer::synchronize() {
+	uint64_t nEpoch;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		nEpoch = m_nEpoch.fetch_add( 1, std::memory_order_acq_rel ) + 1;
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() +
+		std::chrono::milliseconds( nGracePeriod );
+	while ( m_nQuiescentEpoch.load( std::memory_order_acquire ) < nEpoch ) {
+		if ( m_bShutdown ) {
+			return 0;
+		}
+
+		if ( std::chrono::steady_clock::now() >= deadline ) {
+			// The audio engine is not processing right now (e.g. no
+			// driver is running or it is stopped). Holding the lock
+			// ensures it does not start doing so while we are
+			// scanning its queues.
+			m_pAudioEngine->lock( RIGHT_HERE );
+			quiescentPoint();
+			m_pAudioEngine->unlock();
+			break;
+		}
+
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+
+	return nEpoch;
+}
+
+void InstrumentReclaimer::reclaim( uint64_t nEpoch ) {
+	// revive() can not take back an instrument in the middle of
+	// unloading its samples.
+	std::lock_guard<std::mutex> unloadLock( m_unloadMutex );
+
+	std::vector<std::shared_ptr<Instrument>> unused;
+	std::vector<std::shared_ptr<Sample>> unusedSamples;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		for ( auto it = m_retired.begin(); it != m_retired.end(); ) {
+			if ( (*it)->m_nLastUsedEpoch.load( std::memory_order_relaxed ) <
+				 nEpoch ) {
+				(*it)->m_bRetired.store( false, std::memory_order_relaxed );
+				unused.push_back( *it );
+				it = m_retired.erase( it );
+			}
+			else {
+				++it;
+			}
+		}
+
+		m_nRetired.store( static_cast<int>(m_retired.size()),
+						 std::memory_order_release );
+
+		for ( auto it = m_retiredSamples.begin();
+			  it != m_retiredSamples.end(); ) {
+			if ( (*it)->m_nLastUsedEpoch.load( std::memory_order_relaxed ) <
+				 nEpoch ) {
+				(*it)->m_bRetired.store( false, std::memory_order_relaxed );
+				unusedSamples.push_back( *it );
+				it = m_retiredSamples.erase( it );
+			}
+			else {
+				++it;
+			}
+		}
+
+		m_nRetiredSamples.store( static_cast<int>(m_retiredSamples.size()),
+								 std::memory_order_release );
+	}
+
+	// In case no one else holds the retired samples, they are freed
+	// right here.
+	for ( const auto& ppSample : unusedSamples ) {
+		INFOLOG( QString( "Retired sample [%1] released" )
+				 .arg( ppSample->get_filepath() ) );
+	}
+	unusedSamples.clear();
+
+	// Unloading is done without holding #m_mutex. Else retire() - and
+	// with it the thread holding the audio engine lock - would have
+	// to wait for it.
+	for ( const auto& ppInstrument : unused ) {
+		ppInstrument->unload_samples();
+		++m_nReclaimed;
+		INFOLOG( QString( "Samples of instrument [%1] unloaded" )
+				 .arg( ppInstrument->get_name() ) );
+	}
+}
+
+QString InstrumentReclaimer::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[InstrumentReclaimer]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nEpoch: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nEpoch.load() ) )
+			.append( QString( "%1%2m_nQuiescentEpoch: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nQuiescentEpoch.load() ) )
+			.append( QString( "%1%2m_nReclaimed: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nReclaimed.load() ) )
+			.append( QString( "%1%2m_nRetiredSamples: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nRetiredSamples.load() ) )
+			.append( QString( "%1%2m_retired:\n" ).arg( sPrefix ).arg( s ) );
+		std::lock_guard<std::mutex> lock( m_mutex );
+		for ( const auto& ppInstrument : m_retired ) {
+			sOutput.append( QString( "%1%2%2%3 (last used in epoch %4)\n" )
+							.arg( sPrefix ).arg( s )
+							.arg( ppInstrument->get_name() )
+							.arg( ppInstrument->m_nLastUsedEpoch.load() ) );
+		}
+	}
+	else {
+		sOutput = QString( "[InstrumentReclaimer]" )
+			.append( QString( " m_nEpoch: %1" ).arg( m_nEpoch.load() ) )
+			.append( QString( ", m_nQuiescentEpoch: %1" )
+					 .arg( m_nQuiescentEpoch.load() ) )
+			.append( QString( ", m_nReclaimed: %1" ).arg( m_nReclaimed.load() ) )
+			.append( QString( ", m_nRetiredSamples: %1" )
+					 .arg( m_nRetiredSamples.load() ) )
+			.append( ", m_retired: [" );
+		std::lock_guard<std::mutex> lock( m_mutex );
+		for ( const auto& ppInstrument : m_retired ) {
+			sOutput.append( QString( " %1" ).arg( ppInstrument->get_name() ) );
+		}
+		sOutput.append( " ]" );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,185 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_INSTRUMENT_RECLAIMER_H
+#define H2C_INSTRUMENT_RECLAIMER_H
+
+#include <core/Object.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <QString>
+
+namespace H2Core
+{
+
+class AudioEngine;
+class Instrument;
+class Note;
+class Sample;
+
+/**
+ * Unloads the samples of instruments removed from the current drumkit
+ * as soon as the audio engine does not use them anymore.
+ *
+ * Removed instruments may still be referenced by notes in the queues
+ * of the #AudioEngine and the #Sampler. Instead of tracking every note
+ * entering and leaving those queues, the reclaimer uses epochs: a
+ * background thread increments a global epoch and waits for the audio
+ * thread to pass a quiescent point - the end of a process cycle - within
+ * it. At this point the audio thread stamps all retired instruments it
+ * still finds in its queues with the current epoch. Once the epoch is
+ * published, all retired instruments not stamped with it are unused and
+ * their samples can be unloaded safely.
+ *
+ * As long as no instrument is retired, the quiescent point does no more
+ * than two atomic operations. When retired ones exist, it walks through
+ * the note queues once. It neither locks nor allocates.
+ *
+ * If the audio engine is not processing, the background thread does the
+ * scan itself while holding the audio engine lock.
+ *
+ * Samples replaced in or removed from a layer of an instrument still in
+ * use are handled the same way. The notes rendering them keep a
+ * reference of their own. Instead of unloading them, the reclaimer
+ * holds another reference till none of those notes is left. This way
+ * their data is freed by the background thread and not by the audio
+ * thread.
+ *
+ * \ingroup docCore docAudioEngine
+ */
+class InstrumentReclaimer : public H2Core::Object<InstrumentReclaimer>
+{
+	H2_OBJECT(InstrumentReclaimer)
+public:
+	/** Time in milliseconds the background thread waits for the audio
+	 * thread to pass a quiescent point before scanning the queues
+	 * itself.*/
+	static constexpr int nGracePeriod = 100;
+	/** Time in milliseconds between two attempts to reclaim
+	 * instruments still in use.*/
+	static constexpr int nRetryInterval = 250;
+
+	InstrumentReclaimer( AudioEngine* pAudioEngine );
+	~InstrumentReclaimer();
+
+	/** Marks @a pInstrument for having its samples unloaded once no
+	 * note of the audio engine is using it anymore.*/
+	void retire( std::shared_ptr<Instrument> pInstrument );
+	/** Takes @a pInstrument back into use (e.g. when undoing the
+	 * removal of an instrument or switching drumkits back and
+	 * forth). Its samples are not unloaded.
+	 *
+	 * In case the samples are being unloaded right now, the call
+	 * blocks till this is done. Samples already unloaded have to be
+	 * loaded again by the caller. Must not be called while holding
+	 * the audio engine lock.*/
+	void revive( std::shared_ptr<Instrument> pInstrument );
+	/** Keeps @a pSample - which was replaced in or removed from an
+	 * #InstrumentLayer - alive till no note of the audio engine is
+	 * rendering it anymore.
+	 *
+	 * Its samples are not unloaded. The reclaimer just drops its
+	 * reference from the background thread. It is thus fine to keep
+	 * using @a pSample elsewhere.*/
+	void retire( std::shared_ptr<Sample> pSample );
+
+	/** To be called by the audio thread at the end of each process
+	 * cycle while holding the audio engine lock. Real-time safe.*/
+	void quiescentPoint();
+
+	/** Number of instruments which were retired but whose samples are
+	 * not unloaded yet.*/
+	int getRetiredCount() const {
+		return m_nRetired.load( std::memory_order_relaxed );
+	}
+	/** Number of instruments whose samples were unloaded so far.*/
+	int getReclaimedCount() const {
+		return m_nReclaimed.load( std::memory_order_relaxed );
+	}
+	/** Number of samples which were retired but are still
+	 * referenced by the reclaimer.*/
+	int getRetiredSampleCount() const {
+		return m_nRetiredSamples.load( std::memory_order_relaxed );
+	}
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	void workerLoop();
+	/** Starts a new epoch and waits till it is observed by the audio
+	 * engine.
+	 *
+	 * \return The epoch all instruments still in use are stamped
+	 *   with. */
+	uint64_t synchronize();
+	/** Stamps all retired instruments and samples referenced by
+	 * @a pNote.*/
+	static void stamp( const Note* pNote, uint64_t nEpoch );
+	/** Sets @a nEpoch to @a nValue in case it is larger. This way
+	 * the audio thread and retire() can not overwrite a more recent
+	 * epoch.*/
+	static void raise( std::atomic<uint64_t>& nEpoch, uint64_t nValue );
+	/** Unloads the samples of all retired instruments and releases
+	 * all retired samples not stamped with @a nEpoch.*/
+	void reclaim( uint64_t nEpoch );
+
+	AudioEngine* m_pAudioEngine;
+
+	/** Incremented by the background thread to start a new grace
+	 * period.*/
+	std::atomic<uint64_t> m_nEpoch;
+	/** Latest epoch the audio engine passed a quiescent point in.*/
+	std::atomic<uint64_t> m_nQuiescentEpoch;
+	/** Size of #m_retired. Allows the audio thread to skip the scan
+	 * without locking.*/
+	std::atomic<int> m_nRetired;
+	std::atomic<int> m_nReclaimed;
+	/** Size of #m_retiredSamples.*/
+	std::atomic<int> m_nRetiredSamples;
+
+	/** Protects #m_retired and #m_retiredSamples. Since retire() stamps the instrument with
+	 * the current epoch while holding it, a new epoch is started
+	 * holding it as well. It is never held while unloading samples as
+	 * retire() is called with the audio engine being locked.*/
+	mutable std::mutex m_mutex;
+	/** Held while unloading samples. This way revive() does not
+	 * return before the samples of the instrument are either
+	 * completely unloaded or not touched at all. Always acquired
+	 * before #m_mutex.*/
+	std::mutex m_unloadMutex;
+	std::condition_variable m_retiredAdded;
+	std::vector<std::shared_ptr<Instrument>> m_retired;
+	std::vector<std::shared_ptr<Sample>> m_retiredSamples;
+	std::atomic<bool> m_bShutdown;
+
+	std::thread m_worker;
+};
+
+};
+
+#endif  // H2C_INSTRUMENT_RECLAIMER_H
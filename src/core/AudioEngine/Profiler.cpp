@@ -0,0 +1,217 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/AudioEngine/Profiler.h>
+
+#include <algorithm>
+#include <QFile>
+#include <QTextStream>
+
+namespace H2Core {
+
+ProfilerHistogram::ProfilerHistogram() {
+	reset();
+}
+
+int ProfilerHistogram::bucketIndex( uint64_t nNs ) {
+	if ( nNs < 4 ) {
+		return static_cast<int>(nNs);
+	}
+	// Position of the most significant bit.
+	int nOctave = 63;
+	while ( ( nNs >> nOctave ) == 0 ) {
+		--nOctave;
+	}
+	// The two bits below the most significant one.
+	const int nSub = static_cast<int>( ( nNs >> ( nOctave - 2 ) ) & 3 );
+
+	return std::min( ( nOctave - 1 ) * 4 + nSub, nBuckets - 1 );
+}
+
+uint64_t ProfilerHistogram::bucketValue( int nIdx ) {
+	if ( nIdx < 4 ) {
+		return static_cast<uint64_t>(nIdx);
+	}
+	const int nOctave = nIdx / 4 + 1;
+	const uint64_t nSub = static_cast<uint64_t>( nIdx % 4 );
+	const uint64_t nLower = ( 4 + nSub ) << ( nOctave - 2 );
+	const uint64_t nUpper = ( 5 + nSub ) << ( nOctave - 2 );
+
+	return ( nLower + nUpper ) / 2;
+}
+
+void ProfilerHistogram::add( uint64_t nNs ) {
+	m_buckets[ bucketIndex( nNs ) ].fetch_add( 1, std::memory_order_relaxed );
+	m_nCount.fetch_add( 1, std::memory_order_relaxed );
+	m_nLast.store( nNs, std::memory_order_relaxed );
+	if ( nNs > m_nMax.load( std::memory_order_relaxed ) ) {
+		m_nMax.store( nNs, std::memory_order_relaxed );
+	}
+}
+
+void ProfilerHistogram::reset() {
+	for ( auto& bucket : m_buckets ) {
+		bucket.store( 0, std::memory_order_relaxed );
+	}
+	m_nMax.store( 0, std::memory_order_relaxed );
+	m_nLast.store( 0, std::memory_order_relaxed );
+	m_nCount.store( 0, std::memory_order_relaxed );
+}
+
+uint64_t ProfilerHistogram::getPercentile( float fQuantile ) const {
+	uint64_t nTotal = 0;
+	uint32_t counts[ nBuckets ];
+	for ( int ii = 0; ii < nBuckets; ++ii ) {
+		counts[ ii ] = m_buckets[ ii ].load( std::memory_order_relaxed );
+		nTotal += counts[ ii ];
+	}
+	if ( nTotal == 0 ) {
+		return 0;
+	}
+
+	const uint64_t nTarget = static_cast<uint64_t>(
+		std::clamp( fQuantile, 0.0f, 1.0f ) * static_cast<float>(nTotal) );
+	uint64_t nSum = 0;
+	for ( int ii = 0; ii < nBuckets; ++ii ) {
+		nSum += counts[ ii ];
+		if ( nSum > nTarget || nSum == nTotal ) {
+			return std::min( bucketValue( ii ), getMax() );
+		}
+	}
+
+	return getMax();
+}
+
+Profiler::Profiler()
+	: m_instrumentHistograms( new ProfilerHistogram[ MAX_INSTRUMENTS ] )
+	, m_bVoiceProfiling( false ) {
+	beginCycle();
+}
+
+Profiler::~Profiler() {
+}
+
+QString Profiler::StageToQString( const Stage& stage ) {
+	switch ( stage ) {
+	case Stage::Total:
+		return "TOTAL";
+	case Stage::LockWait:
+		return "LOCK_WAIT";
+	case Stage::Driver:
+		return "DRIVER";
+	case Stage::NoteQueue:
+		return "NOTE_QUEUE";
+	case Stage::PlayNotes:
+		return "PLAY_NOTES";
+	case Stage::Sampler:
+		return "SAMPLER";
+	case Stage::Voice:
+		return "VOICE";
+	case Stage::FX:
+		return "FX";
+	default:
+		return QString( "Unknown stage [%1]" ).arg( static_cast<int>(stage) );
+	}
+}
+
+void Profiler::recordInstrument( int nInstrumentId, uint64_t nNs ) {
+	if ( nInstrumentId < 0 || nInstrumentId >= MAX_INSTRUMENTS ) {
+		return;
+	}
+	m_instrumentHistograms[ nInstrumentId ].add( nNs );
+}
+
+const ProfilerHistogram* Profiler::getInstrumentHistogram( int nInstrumentId ) const {
+	if ( nInstrumentId < 0 || nInstrumentId >= MAX_INSTRUMENTS ||
+		 m_instrumentHistograms[ nInstrumentId ].getCount() == 0 ) {
+		return nullptr;
+	}
+	return &m_instrumentHistograms[ nInstrumentId ];
+}
+
+void Profiler::reset() {
+	for ( auto& histogram : m_histograms ) {
+		histogram.reset();
+	}
+	for ( int ii = 0; ii < MAX_INSTRUMENTS; ++ii ) {
+		m_instrumentHistograms[ ii ].reset();
+	}
+}
+
+bool Profiler::writeReport( const QString& sPath ) const {
+	QFile file( sPath );
+	if ( ! file.open( QIODevice::WriteOnly | QIODevice::Text ) ) {
+		ERRORLOG( QString( "Unable to open [%1] for writing" ).arg( sPath ) );
+		return false;
+	}
+
+	QTextStream stream( &file );
+	stream << toQString( "", false );
+
+	INFOLOG( QString( "Profiling report written to [%1]" ).arg( sPath ) );
+	return true;
+}
+
+QString Profiler::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+
+	auto formatHistogram = [&]( const ProfilerHistogram& histogram ) {
+		return QString( "count: %1, last: %2us, p50: %3us, p99: %4us, max: %5us" )
+			.arg( histogram.getCount() )
+			.arg( histogram.getLast() / 1000.0, 0, 'f', 1 )
+			.arg( histogram.getPercentile( 0.5 ) / 1000.0, 0, 'f', 1 )
+			.arg( histogram.getPercentile( 0.99 ) / 1000.0, 0, 'f', 1 )
+			.arg( histogram.getMax() / 1000.0, 0, 'f', 1 );
+	};
+
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[Profiler]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_bVoiceProfiling: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( getVoiceProfiling() ) );
+		for ( int ii = 0; ii < static_cast<int>(Stage::Count); ++ii ) {
+			sOutput.append( QString( "%1%2%3: %4\n" ).arg( sPrefix ).arg( s )
+							.arg( StageToQString( static_cast<Stage>(ii) ) )
+							.arg( formatHistogram( m_histograms[ ii ] ) ) );
+		}
+		for ( int ii = 0; ii < MAX_INSTRUMENTS; ++ii ) {
+			if ( m_instrumentHistograms[ ii ].getCount() > 0 ) {
+				sOutput.append( QString( "%1%2INSTRUMENT %3: %4\n" )
+								.arg( sPrefix ).arg( s ).arg( ii )
+								.arg( formatHistogram( m_instrumentHistograms[ ii ] ) ) );
+			}
+		}
+	}
+	else {
+		sOutput = QString( "[Profiler] m_bVoiceProfiling: %1" )
+			.arg( getVoiceProfiling() );
+		for ( int ii = 0; ii < static_cast<int>(Stage::Count); ++ii ) {
+			sOutput.append( QString( ", %1: [%2]" )
+							.arg( StageToQString( static_cast<Stage>(ii) ) )
+							.arg( formatHistogram( m_histograms[ ii ] ) ) );
+		}
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,179 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_PROFILER_H
+#define H2C_PROFILER_H
+
+#include <core/config.h>
+#include <core/Object.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <QString>
+
+namespace H2Core
+{
+
+/**
+ * Lock-free histogram of durations given in nanoseconds.
+ *
+ * Values are sorted into logarithmic buckets with four buckets per
+ * octave. Percentiles are thus accurate up to roughly 20%, which is
+ * plenty to tell which part of the audio processing is taking too
+ * long. Only a single thread is expected to add() values while an
+ * arbitrary number of threads can query them.
+ *
+ * \ingroup docCore docAudioEngine
+ */
+class ProfilerHistogram
+{
+public:
+	static constexpr int nBuckets = 128;
+
+	ProfilerHistogram();
+
+	void add( uint64_t nNs );
+	void reset();
+
+	/** \return Approximate value below which @a fQuantile (in [0, 1])
+	 * of all recorded values lie.*/
+	uint64_t getPercentile( float fQuantile ) const;
+	uint64_t getMax() const {
+		return m_nMax.load( std::memory_order_relaxed );
+	}
+	uint64_t getLast() const {
+		return m_nLast.load( std::memory_order_relaxed );
+	}
+	uint64_t getCount() const {
+		return m_nCount.load( std::memory_order_relaxed );
+	}
+
+private:
+	static int bucketIndex( uint64_t nNs );
+	/** \return Center of bucket @a nIdx in nanoseconds.*/
+	static uint64_t bucketValue( int nIdx );
+
+	std::atomic<uint32_t> m_buckets[ nBuckets ];
+	std::atomic<uint64_t> m_nMax;
+	std::atomic<uint64_t> m_nLast;
+	std::atomic<uint64_t> m_nCount;
+};
+
+/**
+ * Keeps track of the time spent in the individual stages of
+ * AudioEngine::audioEngine_process().
+ *
+ * Stage timings are recorded in every cycle. Since this is done just a
+ * handful of times per cycle, it is always active. Timing individual
+ * voices within the #Sampler requires two clock readings per voice and
+ * rendering cycle and has to be activated explicitly using
+ * setVoiceProfiling().
+ *
+ * \ingroup docCore docAudioEngine
+ */
+class Profiler : public H2Core::Object<Profiler>
+{
+	H2_OBJECT(Profiler)
+public:
+	enum class Stage {
+		/** Whole process callback.*/
+		Total = 0,
+		/** Waiting for the AudioEngine lock.*/
+		LockWait = 1,
+		/** Preparing the buffers of and syncing with the audio driver.*/
+		Driver = 2,
+		/** AudioEngine::updateNoteQueue()*/
+		NoteQueue = 3,
+		/** AudioEngine::processPlayNotes()*/
+		PlayNotes = 4,
+		/** Sampler::process()*/
+		Sampler = 5,
+		/** Rendering of a single voice within Sampler::process(). Only
+		 * recorded if voice profiling is enabled.*/
+		Voice = 6,
+		/** LADSPA effects.*/
+		FX = 7,
+		Count = 8
+	};
+	static QString StageToQString( const Stage& stage );
+
+	Profiler();
+	~Profiler();
+
+	/** Resets the timings of the current cycle. Has to be called by
+	 * the audio thread at the beginning of each process cycle.*/
+	void beginCycle() {
+		for ( auto& nNs : m_currentCycle ) {
+			nNs = 0;
+		}
+	}
+	/** Adds @a nNs to the histogram of @a stage and to the timing of
+	 * the current cycle.*/
+	void record( const Stage& stage, uint64_t nNs ) {
+		m_histograms[ static_cast<int>(stage) ].add( nNs );
+		m_currentCycle[ static_cast<int>(stage) ] += nNs;
+	}
+	/** Time spent in each stage during the current cycle. Only to be
+	 * accessed from within the audio thread.*/
+	const uint64_t* getCurrentCycle() const {
+		return m_currentCycle;
+	}
+	/** Time spent by all voices of instrument @a nInstrumentId within a
+	 * single call to Sampler::process().*/
+	void recordInstrument( int nInstrumentId, uint64_t nNs );
+
+	const ProfilerHistogram& getHistogram( const Stage& stage ) const {
+		return m_histograms[ static_cast<int>(stage) ];
+	}
+	/** \return nullptr in case no value was recorded for
+	 * @a nInstrumentId yet.*/
+	const ProfilerHistogram* getInstrumentHistogram( int nInstrumentId ) const;
+
+	void setVoiceProfiling( bool bEnabled ) {
+		m_bVoiceProfiling.store( bEnabled, std::memory_order_relaxed );
+	}
+	bool getVoiceProfiling() const {
+		return m_bVoiceProfiling.load( std::memory_order_relaxed );
+	}
+
+	/** Discards all recorded values.*/
+	void reset();
+
+	/** Writes a human readable summary of all histograms to
+	 * @a sPath. Must not be called from within the audio thread.*/
+	bool writeReport( const QString& sPath ) const;
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	ProfilerHistogram m_histograms[ static_cast<int>(Stage::Count) ];
+	uint64_t m_currentCycle[ static_cast<int>(Stage::Count) ];
+	/** Indexed by Instrument::__id. Allocated once to not require any
+	 * allocation within the audio thread.*/
+	std::unique_ptr<ProfilerHistogram[]> m_instrumentHistograms;
+	std::atomic<bool> m_bVoiceProfiling;
+};
+
+};
+
+#endif  // H2C_PROFILER_H
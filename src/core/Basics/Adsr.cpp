@@ -21,6 +21,10 @@
  */
 
 #include <core/Basics/Adsr.h>
+#include <core/Helpers/Mix.h>
+
+#include <algorithm>
+#include <cmath>
 
 namespace H2Core
 {
@@ -42,7 +46,8 @@ ADSR::ADSR( unsigned int attack, unsigned int decay, float sustain, unsigned int
 	m_fFramesInState( 0.0 ),
 	m_fValue( 0.0 ),
 	m_fReleaseValue( 0.0 ),
-	m_fQ( fAttackInit )
+	m_fQ( fAttackInit ),
+	m_fRampStep( -1 )
 {
 	normalise();
 }
@@ -55,7 +60,9 @@ ADSR::ADSR( const std::shared_ptr<ADSR> other ) :
 	m_state( other->m_state ),
 	m_fFramesInState( other->m_fFramesInState ),
 	m_fValue( other->m_fValue ),
-	m_fReleaseValue( other->m_fReleaseValue )
+	m_fReleaseValue( other->m_fReleaseValue ),
+	m_fQ( other->m_fQ ),
+	m_fRampStep( -1 )
 {
 	normalise();
 }
@@ -90,80 +97,73 @@ void ADSR::normalise()
 	}
 }
 
+void ADSR::computeRamps( float fStep )
+{
+	auto compute = [&]( Ramp& ramp, double fExponent, unsigned int nFrames ) {
+		const float fFactor = std::pow( fExponent, (double)fStep / nFrames );
+		ramp.fPowers[ 0 ] = 1.0;
+		for ( int ii = 1; ii < nLanes; ++ii ) {
+			ramp.fPowers[ ii ] = ramp.fPowers[ ii - 1 ] * fFactor;
+		}
+		ramp.fLanesFactor = ramp.fPowers[ nLanes - 1 ] * fFactor;
+	};
+
+	compute( m_attackRamp, fAttackExponent, m_nAttack );
+	compute( m_decayRamp, fDecayExponent, m_nDecay );
+	compute( m_releaseRamp, fDecayExponent, m_nRelease );
+	m_fRampStep = fStep;
+}
+
 /**
  * Apply an exponential envelope to a stereo pair of sample fragments.
  *
- * The exponential is generalised by parameters:
- *   - fXOffset -- x offset
- *   - fYOffset -- y offset
- *   - fExponent -- base of the exponential
- *   - fScale -- scale the curve (including reflection)
- *
- * These parameters allow suitable curves for attack, decay and release to be formed.
- *
- * Because some parameters will take on trivial values depending on use, it's desirable to inline this
- * to allow constant propagation to remove redundant operations.
- *
- * The exponential loop isn't naturally vectorisable since there is a loop carried dependency for the
- * exponential variable. However, we can manually unroll the loop and replace the single Q with multiple
- * copies, which allows the SLP vectoriser to piece together a nice loop. On AArch64 we get loops of ~11
- * instructions for 4 frames. 
- *
- * Even if the code is not SLP-vectorised, the unrolled loop should still have better performance
- * characteristics due to more flexible scheduling and reduced loop overhead.
+ * The envelope values are computed in blocks of #nBlockSize and
+ * applied to both channels using the #Mix kernels.
  *
+ * The exponential isn't naturally vectorisable since there is a loop
+ * carried dependency for #m_fQ. Instead, #nLanes copies of it - each
+ * one offset by one more frame - are advanced by the precomputed
+ * Ramp::fLanesFactor. This allows the compiler to vectorise the loop.
  */
-inline double applyExponential( const float fExponent, const float fXOffset, const float fYOffset,
-								const float fScale,
-								float * __restrict__ pA, float * __restrict__ pB,
-								float fQ, int nFrames, int nFramesTotal, float fStep,
-								float * __restrict__ pfADSRVal ) {
-
-	int i = 0;
-	float fVal = *pfADSRVal;
-
-	float fFactor = pow( fExponent, (double)fStep / nFramesTotal );
-
-	if ( nFrames > 4) {
-		float fFactor4 = fFactor * fFactor * fFactor * fFactor;
-		float fQ0 = fQ,
-			fQ1 = fQ0 * fFactor,
-			fQ2 = fQ1 * fFactor,
-			fQ3 = fQ2 * fFactor;
-		for (; i < nFrames - 4; i += 4) {
-			float fVal0 = ( fQ0 - fXOffset ) * fScale + fYOffset,
-				fVal1 = ( fQ1 - fXOffset ) * fScale + fYOffset,
-				fVal2 = ( fQ2 - fXOffset ) * fScale + fYOffset,
-				fVal3 = ( fQ3 - fXOffset ) * fScale + fYOffset;
-
-			pA[i] *= fVal0;
-			pA[i+1] *= fVal1;
-			pA[i+2] *= fVal2;
-			pA[i+3] *= fVal3;
-
-			pB[i] *= fVal0;
-			pB[i+1] *= fVal1;
-			pB[i+2] *= fVal2;
-			pB[i+3] *= fVal3;
-
-			fQ0 *= fFactor4;
-			fQ1 *= fFactor4;
-			fQ2 *= fFactor4;
-			fQ3 *= fFactor4;
-
-			fVal = fVal0;
+void ADSR::applyRamp( const Ramp& ramp, float fScale, float fOffset,
+					  float* pLeft, float* pRight, int nFrames )
+{
+	float fQ = m_fQ;
+	float fGains[ nBlockSize ];
+	float fQs[ nLanes ];
+
+	while ( nFrames > 0 ) {
+		const int nBlockFrames = std::min( nFrames, nBlockSize );
+		const int nFullFrames = nBlockFrames - nBlockFrames % nLanes;
+
+		for ( int ii = 0; ii < nLanes; ++ii ) {
+			fQs[ ii ] = fQ * ramp.fPowers[ ii ];
 		}
-		fQ = fQ0;
-	}
+		for ( int ii = 0; ii < nFullFrames; ii += nLanes ) {
+			for ( int jj = 0; jj < nLanes; ++jj ) {
+				fGains[ ii + jj ] = fQs[ jj ] * fScale + fOffset;
+			}
+			for ( int jj = 0; jj < nLanes; ++jj ) {
+				fQs[ jj ] *= ramp.fLanesFactor;
+			}
+		}
+		// Remaining frames not filling all lanes.
+		const int nRemainder = nBlockFrames - nFullFrames;
+		for ( int jj = 0; jj < nRemainder; ++jj ) {
+			fGains[ nFullFrames + jj ] = fQs[ jj ] * fScale + fOffset;
+		}
+		fQ = fQs[ nRemainder ];
+
+		Mix::multiply( pLeft, fGains, nBlockFrames );
+		Mix::multiply( pRight, fGains, nBlockFrames );
+		m_fValue = fGains[ nBlockFrames - 1 ];
 
-	for (; i < nFrames; i++) {
-		fVal = ( fQ - fXOffset ) * fScale + fYOffset;
-		pA[i] *= fVal;
-		pB[i] *= fVal;
-		fQ *= fFactor;
+		pLeft += nBlockFrames;
+		pRight += nBlockFrames;
+		nFrames -= nBlockFrames;
 	}
-	*pfADSRVal = fVal;
-	return fQ;
+
+	m_fQ = fQ;
 }
 
 /**
@@ -176,6 +176,10 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 {
 	int nBufferPos = 0;
 
+	if ( fStep != m_fRampStep ) {
+		computeRamps( fStep );
+	}
+
 	// If the release point is somehow in the past, move direcly to Release
 	if ( nReleaseFrame <= 0 && m_state != State::Release && m_state != State::Idle ) {
 		WARNINGLOG( QString( "Impossibly early release for ADSR: " ).arg( this->toQString() ) );
@@ -190,9 +194,8 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 			nAttackFrames = ceil( m_nAttack / fStep );
 		}
 
-		m_fQ = applyExponential( fAttackExponent, fAttackInit, 0.0, -1.0,
-								  pLeft, pRight, m_fQ, nAttackFrames, m_nAttack,
-								 fStep, &m_fValue );
+		applyRamp( m_attackRamp, -1.0, fAttackInit, pLeft, pRight,
+				   nAttackFrames );
 
 		nBufferPos += nAttackFrames;
 
@@ -211,8 +214,10 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 			nDecayFrames = ceil( m_nDecay / fStep );
 		}
 
-		m_fQ = applyExponential( fDecayExponent, -fDecayYOffset, m_fSustain, (1.0-m_fSustain),
-								 &pLeft[nBufferPos], &pRight[nBufferPos], m_fQ, nDecayFrames, m_nDecay, fStep, &m_fValue );
+		const float fDecayScale = 1.0 - m_fSustain;
+		applyRamp( m_decayRamp, fDecayScale,
+				   fDecayYOffset * fDecayScale + m_fSustain,
+				   &pLeft[nBufferPos], &pRight[nBufferPos], nDecayFrames );
 
 		nBufferPos += nDecayFrames;
 		m_fFramesInState += nDecayFrames * fStep;
@@ -229,10 +234,8 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 		if ( nSustainFrames != 0 ) {
 			m_fValue = m_fSustain;
 			if ( m_fSustain != 1.0 ) {
-				for ( int i = 0; i < nSustainFrames; i++ ) {
-					pLeft[ nBufferPos + i ] *= m_fSustain;
-					pRight[ nBufferPos + i ] *= m_fSustain;
-				}
+				Mix::scale( &pLeft[ nBufferPos ], m_fSustain, nSustainFrames );
+				Mix::scale( &pRight[ nBufferPos ], m_fSustain, nSustainFrames );
 			}
 			nBufferPos += nSustainFrames;
 		}
@@ -252,8 +255,9 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 			nReleaseFrames = ceil( m_nRelease / fStep );
 		}
 
-		m_fQ = applyExponential( fDecayExponent, -fDecayYOffset, 0.0, m_fReleaseValue,
-								 &pLeft[nBufferPos], &pRight[nBufferPos], m_fQ, nReleaseFrames, m_nRelease, fStep, &m_fValue );
+		applyRamp( m_releaseRamp, m_fReleaseValue,
+				   fDecayYOffset * m_fReleaseValue,
+				   &pLeft[nBufferPos], &pRight[nBufferPos], nReleaseFrames );
 
 		nBufferPos += nReleaseFrames;
 		m_fFramesInState += nReleaseFrames * fStep;
@@ -102,6 +102,10 @@ class ADSR : public Object<ADSR>
 		 * note or sample at which ADSR processing will enter the
 		 * release phase.
 		 * \param fStep the increment to be added to m_fFramesInState.
+		 *
+		 * The coefficients of the exponentials are only recomputed
+		 * in case @a fStep or the duration of a phase changed since
+		 * the last call.
 		 */
 
 		bool applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nReleaseFrame, float fStep );
@@ -128,6 +132,21 @@ class ADSR : public Object<ADSR>
 		 * \return String presentation of current object.*/
 		QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 	private:
+		/** Number of envelope values computed in lockstep. */
+		static constexpr int nLanes = 8;
+		/** Number of envelope values computed at once before being
+		 * applied to the audio buffers. */
+		static constexpr int nBlockSize = 64;
+
+		/** Precomputed multipliers of the exponential of a single
+		 * phase for a particular step size. */
+		struct Ramp {
+			/** Powers 0 to #nLanes - 1 of the per-frame multiplier of
+			 * #m_fQ. */
+			float fPowers[ nLanes ];
+			/** Multiplier advancing #m_fQ by #nLanes frames. */
+			float fLanesFactor;
+		};
 	
 		unsigned int m_nAttack;		///< Attack phase duration in frames
 		unsigned int m_nDecay;		///< Decay phase duration in frames
@@ -151,7 +170,23 @@ class ADSR : public Object<ADSR>
 
 		double m_fQ;				///< exponential decay state
 
+		Ramp m_attackRamp;
+		Ramp m_decayRamp;
+		Ramp m_releaseRamp;
+		/** Step size the ramps were computed for. Negative in case
+		 * they are outdated. */
+		float m_fRampStep;
+
 		void normalise();
+		/** Computes #m_attackRamp, #m_decayRamp, and #m_releaseRamp. */
+		void computeRamps( float fStep );
+		/**
+		 * Multiplies @a nFrames frames of both buffers with the
+		 * exponential `m_fQ * fScale + fOffset` and advances #m_fQ
+		 * and #m_fValue accordingly.
+		 */
+		void applyRamp( const Ramp& ramp, float fScale, float fOffset,
+						float* pLeft, float* pRight, int nFrames );
 };
 
 // DEFINITIONS
@@ -159,6 +194,7 @@ class ADSR : public Object<ADSR>
 inline void ADSR::setAttack( unsigned int value )
 {
 	m_nAttack = value;
+	m_fRampStep = -1;
 }
 
 inline unsigned int ADSR::getAttack() const
@@ -169,6 +205,7 @@ inline unsigned int ADSR::getAttack() const
 inline void ADSR::setDecay( unsigned int value )
 {
 	m_nDecay = value;
+	m_fRampStep = -1;
 }
 
 inline unsigned int ADSR::getDecay() const
@@ -189,6 +226,7 @@ inline float ADSR::getSustain() const
 inline void ADSR::setRelease( unsigned int value )
 {
 	m_nRelease = value;
+	m_fRampStep = -1;
 }
 
 inline unsigned int ADSR::getRelease() const
@@ -20,8 +20,15 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
 #include <QFile>
-#include <QDataStream>
 
 #include <core/Basics/Drumkit.h>
 #include <core/config.h>
@@ -56,6 +63,104 @@
 namespace H2Core
 {
 
+#ifdef H2CORE_HAVE_LIBARCHIVE
+namespace {
+
+/** Reads a list of files chunk by chunk in a separate thread.
+ *
+ * During export this overlaps reading the samples from disk with
+ * compressing them into the archive. The number of chunks kept in
+ * memory is bounded. Destroying the reader before all chunks were
+ * consumed aborts it. */
+class FileChunkReader {
+public:
+	struct Chunk {
+		QByteArray data;
+		/** Last chunk of the current file. */
+		bool bLast = false;
+		/** The current file could not be read (entirely). */
+		bool bError = false;
+	};
+	static constexpr int nChunkSize = 1024 * 1024;
+	static constexpr int nMaxChunks = 16;
+
+	FileChunkReader( const QStringList& files )
+		: m_files( files )
+		, m_bAbort( false ) {
+		m_thread = std::thread( &FileChunkReader::run, this );
+	}
+	~FileChunkReader() {
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_bAbort = true;
+		}
+		m_condition.notify_all();
+		m_thread.join();
+	}
+
+	/** Blocks till the next chunk is available. */
+	Chunk pop() {
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_condition.wait( lock, [&]{ return ! m_chunks.empty(); } );
+		Chunk chunk = std::move( m_chunks.front() );
+		m_chunks.pop_front();
+		lock.unlock();
+		m_condition.notify_all();
+		return chunk;
+	}
+
+private:
+	bool push( Chunk&& chunk ) {
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_condition.wait( lock, [&]{
+			return m_bAbort || m_chunks.size() < nMaxChunks; } );
+		if ( m_bAbort ) {
+			return false;
+		}
+		m_chunks.push_back( std::move( chunk ) );
+		lock.unlock();
+		m_condition.notify_all();
+		return true;
+	}
+
+	void run() {
+		for ( const auto& sFile : m_files ) {
+			QFile file( sFile );
+			if ( ! file.open( QIODevice::ReadOnly ) ) {
+				Chunk chunk;
+				chunk.bLast = true;
+				chunk.bError = true;
+				if ( ! push( std::move( chunk ) ) ) {
+					return;
+				}
+				continue;
+			}
+
+			bool bLast = false;
+			while ( ! bLast ) {
+				Chunk chunk;
+				chunk.data = file.read( nChunkSize );
+				chunk.bError = file.error() != QFileDevice::NoError;
+				chunk.bLast = chunk.bError || chunk.data.size() < nChunkSize;
+				bLast = chunk.bLast;
+				if ( ! push( std::move( chunk ) ) ) {
+					return;
+				}
+			}
+		}
+	}
+
+	const QStringList m_files;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<Chunk> m_chunks;
+	bool m_bAbort;
+	std::thread m_thread;
+};
+
+} // anonymous namespace
+#endif
+
 Drumkit::Drumkit() : m_context( Context::User ),
 					 m_sName( "empty" ),
 					 m_nVersion( 0 ),
@@ -434,6 +539,11 @@ bool Drumkit::saveSamples( const QString& sDrumkitFolder, bool bSilent ) const
 				 .arg( m_sName ).arg( sDrumkitFolder ) );
 	}
 
+	// Filenames are updated right away. The copying itself is done
+	// afterwards using several threads. Samples are keyed by their
+	// destination as each target file must be written only once.
+	std::map<QString, QString> destinations;
+
 	auto pInstrList = getInstruments();
 	for ( int i = 0; i < pInstrList->size(); i++ ) {
 		auto pInstrument = ( *pInstrList )[i];
@@ -446,18 +556,21 @@ bool Drumkit::saveSamples( const QString& sDrumkitFolder, bool bSilent ) const
 						QString dst = sDrumkitFolder + "/" + pLayer->get_sample()->get_filename();
 
 						if ( src != dst ) {
-							QString original_dst = dst;
-
-							// If the destination path does not have an extension and there is a dot in the path, hell will break loose. QFileInfo maybe?
-							int insertPosition = original_dst.length();
-							if ( original_dst.lastIndexOf(".") > 0 ) {
-								insertPosition = original_dst.lastIndexOf(".");
-							}
-
 							pLayer->get_sample()->set_filename( dst );
 
-							if( ! Filesystem::file_copy( src, dst, bSilent ) ) {
-								return false;
+							const auto [ it, bInserted ] =
+								destinations.insert( { dst, src } );
+							if ( ! bInserted && it->second != src ) {
+								// Files are overwritten in case bSilent is
+								// set. Just as copying them one after
+								// another, the last one wins. Else, the
+								// first one is kept.
+								WARNINGLOG( QString( "Samples [%1] and [%2] are both saved as [%3]. Only [%4] is kept." )
+											.arg( it->second ).arg( src ).arg( dst )
+											.arg( bSilent ? src : it->second ) );
+								if ( bSilent ) {
+									it->second = src;
+								}
 							}
 						}
 					}
@@ -466,7 +579,37 @@ bool Drumkit::saveSamples( const QString& sDrumkitFolder, bool bSilent ) const
 		}
 	}
 
-	return true;
+	const std::vector<std::pair<QString, QString>> copies(
+		destinations.begin(), destinations.end() );
+
+	std::atomic<int> nNextCopy( 0 );
+	std::atomic<bool> bSuccess( true );
+	auto copySamples = [&]() {
+		int nCopy;
+		while ( bSuccess &&
+				( nCopy = nNextCopy++ ) < static_cast<int>(copies.size()) ) {
+			const auto& [ sDestination, sSource ] = copies[ nCopy ];
+			if ( ! Filesystem::file_copy( sSource, sDestination, bSilent ) ) {
+				bSuccess = false;
+			}
+		}
+	};
+
+	// Copying is bound by disk access. A few concurrent copies suffice to
+	// keep fast drives busy.
+	const int nCores = static_cast<int>(std::thread::hardware_concurrency());
+	const int nWorkers =
+		std::min( { nCores, 4, static_cast<int>(copies.size()) } ) - 1;
+	std::vector<std::thread> workers;
+	for ( int ii = 0; ii < nWorkers; ++ii ) {
+		workers.push_back( std::thread( copySamples ) );
+	}
+	copySamples();
+	for ( auto& worker : workers ) {
+		worker.join();
+	}
+
+	return bSuccess;
 }
 
 bool Drumkit::saveImage( const QString& sDrumkitDir, bool bSilent ) const
@@ -729,17 +872,20 @@ bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath,
 #endif
 	};
 
+	// Large blocks keep the number of reads low for big kits.
+	const size_t nBlockSize = 1024 * 1024;
 #if ARCHIVE_VERSION_NUMBER < 3000000
-	nRet = archive_read_open_file( a, sSourcePath.toUtf8().constData(), 10240 );
+	nRet = archive_read_open_file( a, sSourcePath.toUtf8().constData(),
+								   nBlockSize );
 #else
   #ifdef WIN32
 	QString sSourcePathPadded = sSourcePath;
 	sSourcePathPadded.append( '\0' );
 	auto sourcePathW = sSourcePathPadded.toStdWString();
-	nRet = archive_read_open_filename_w( a, sourcePathW.c_str(), 10240 );
+	nRet = archive_read_open_filename_w( a, sourcePathW.c_str(), nBlockSize );
   #else
 	nRet = archive_read_open_filename( a, sSourcePath.toUtf8().constData(),
-									   10240 );
+									   nBlockSize );
   #endif
 #endif
 	if ( nRet != ARCHIVE_OK ) {
@@ -759,6 +905,7 @@ bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath,
 
 	// Keep track of where the artifacts where extracted to
 	QString sExtractedDir = "";
+
 		
 	while ( ( nRet = archive_read_next_header( a, &entry ) ) != ARCHIVE_EOF ) {
 		if ( nRet != ARCHIVE_OK ) {
@@ -823,6 +970,7 @@ bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath,
 			return false;
 		}
 	}
+
 	nRet = archive_read_close( a );
 	if ( nRet != ARCHIVE_OK ) {
 		ERRORLOG( QString("Couldn't close archive: %1" )
@@ -1004,9 +1152,7 @@ bool Drumkit::exportTo( const QString& sTargetDir, bool* pUtf8Encoded,
 	struct archive *a;
 	struct archive_entry *entry;
 	struct stat st;
-	const int nBufferSize = 8192;
-	char buff[ nBufferSize ];
-	int nBytesRead, nRet;
+	int nRet;
 
 	// Write it back for the calling routine.
 	if ( pUtf8Encoded != nullptr ) {
@@ -1059,6 +1205,10 @@ bool Drumkit::exportTo( const QString& sTargetDir, bool* pUtf8Encoded,
 		return false;
 	}
 
+	// Files are read in a separate thread while the current one
+	// compresses them. Both traverse `filesUsed` in the same order.
+	FileChunkReader reader( filesUsed );
+
 	for ( const auto& sFilename : filesUsed ) {
 		QFileInfo ffileInfo( sFilename );
 		QString sTargetFilename = sDrumkitName + "/" + ffileInfo.fileName();
@@ -1102,31 +1252,33 @@ bool Drumkit::exportTo( const QString& sTargetDir, bool* pUtf8Encoded,
 			return false;
 		}
 
-		QFile file( sFilename );
-		if ( ! file.open( QIODevice::ReadOnly ) ) {
-			ERRORLOG( QString( "Unable to open file [%1] for reading" )
-				  .arg( sFilename ) );
-			archive_entry_free( entry );
-			continue;
-		}
+		bool bWriteFailed = false;
+		bool bLastChunk = false;
+		while ( ! bLastChunk ) {
+			const auto chunk = reader.pop();
+			bLastChunk = chunk.bLast;
+			if ( chunk.bError ) {
+				ERRORLOG( QString( "Unable to read file [%1]" )
+						  .arg( sFilename ) );
+			}
+			if ( chunk.data.isEmpty() || bWriteFailed ) {
+				// Remaining chunks of a file which could not be written
+				// have to be consumed nevertheless.
+				continue;
+			}
 
-		QDataStream stream( &file );
-		nBytesRead = stream.readRawData( buff, nBufferSize );
-		while ( nBytesRead > 0 ) {
-			nRet = archive_write_data( a, buff, nBytesRead );
-			if ( nRet < 0 ) {
+			const auto nWritten =
+				archive_write_data( a, chunk.data.constData(), chunk.data.size() );
+			if ( nWritten < 0 ) {
 				ERRORLOG( QString( "Error while writing data to entry of [%1]: %2" )
 						  .arg( sFilename ).arg( archive_error_string( a ) ) );
-				break;
+				bWriteFailed = true;
 			}
-			else if ( nRet != nBytesRead ) {
+			else if ( nWritten != chunk.data.size() ) {
 				WARNINGLOG( QString( "Only [%1/%2] bytes written to archive entry of [%3]" )
-							.arg( nRet ).arg( nBytesRead ).arg( sFilename ) );
+							.arg( nWritten ).arg( chunk.data.size() ).arg( sFilename ) );
 			}
-
-			nBytesRead = stream.readRawData( buff, nBufferSize );
 		}
-		file.close();
 		archive_entry_free(entry);
 	}
 	nRet = archive_write_close(a);
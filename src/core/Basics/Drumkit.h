@@ -224,6 +224,9 @@ class Drumkit : public H2Core::Object<Drumkit>
 	 * exportTo() ? well, export is a protected name within C++. So, we needed a
 	 * less obvious name.
 	 *
+	 * Just like install(), it blocks the calling thread and does not
+	 * report any progress.
+	 *
 	 * \param sTargetDir Folder which will contain the resulting .h2drumkit
 	 *   file.
 	 * \param pUtf8Encoded will be set to true in case we were able to enforce
@@ -43,6 +43,8 @@
 namespace H2Core
 {
 
+std::atomic<uint32_t> Instrument::m_nMidiOutNoteRevision( 0 );
+
 Instrument::Instrument( const int id, const QString& name, std::shared_ptr<ADSR> adsr )
 	: __id( id )
 	, __name( name )
@@ -68,8 +70,8 @@ Instrument::Instrument( const int id, const QString& name, std::shared_ptr<ADSR>
 	, __soloed( false )
 	, __muted( false )
 	, __mute_group( -1 )
-	, __queued( 0 )
-	  , m_enqueuedBy( QStringList() )
+	, m_bRetired( false )
+	, m_nLastUsedEpoch( 0 )
 	, __hihat_grp( -1 )
 	, __lower_cc( 0 )
 	, __higher_cc( 127 )
@@ -133,8 +135,8 @@ Instrument::Instrument( std::shared_ptr<Instrument> other )
 	, __soloed( other->is_soloed() )
 	, __muted( other->is_muted() )
 	, __mute_group( other->get_mute_group() )
-	, __queued( 0 )
-	  , m_enqueuedBy( QStringList() )
+	, m_bRetired( false )
+	, m_nLastUsedEpoch( 0 )
 	, __hihat_grp( other->get_hihat_grp() )
 	, __lower_cc( other->get_lower_cc() )
 	, __higher_cc( other->get_higher_cc() )
@@ -156,11 +158,6 @@ Instrument::Instrument( std::shared_ptr<Instrument> other )
 }
 
 Instrument::~Instrument() {
-	if ( __queued > 0 ) {
-		WARNINGLOG( QString( "Instrument [%1] is destroyed while still being enqueued! __queued: %2,\nm_enqueuedNotes:\n\t%3" )
-					.arg( __name ).arg( __queued )
-					.arg( m_enqueuedBy.join( "\n\t" ) ) );
-	}
 }
 
 std::shared_ptr<Instrument> Instrument::load_from( const XMLNode& node,
@@ -574,27 +571,6 @@ void Instrument::save_to( XMLNode& node, bool bSongKit ) const
 	}
 }
 
-void Instrument::enqueue( Note* pNote ) {
-	__queued++;
-
-	m_enqueuedBy.push_back( pNote->prettyName() );
-}
-
-void Instrument::dequeue( Note* pNote ) {
-	if ( __queued <= 0 ) {
-		ERRORLOG( QString( "[%1] is not queued!" ).arg( __name ) );
-		return;
-	}
-
-	__queued--;
-
-	if ( __queued > 0 ) {
-		m_enqueuedBy.removeOne( pNote->prettyName() );
-	} else {
-		m_enqueuedBy.clear();
-	}
-}
-
 void Instrument::set_adsr( std::shared_ptr<ADSR> adsr )
 {
 	__adsr = adsr;
@@ -716,10 +692,10 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( __muted ) )
 			.append( QString( "%1%2mute_group: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( __mute_group ) )
-			.append( QString( "%1%2queued: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( __queued ) )
-			.append( QString( "%1%2m_enqueuedBy: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_enqueuedBy.join( "\n" + sPrefix + s + s  ) ) );
+			.append( QString( "%1%2m_bRetired: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bRetired.load() ) )
+			.append( QString( "%1%2m_nLastUsedEpoch: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nLastUsedEpoch.load() ) );
 		sOutput.append( QString( "%1%2fx_level: [ " ).arg( sPrefix ).arg( s ) );
 		for ( const auto& ff : __fx_level ) {
 			sOutput.append( QString( "%1 " ).arg( ff ) );
@@ -775,9 +751,9 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", soloed: %1" ).arg( __soloed ) )
 			.append( QString( ", muted: %1" ).arg( __muted ) )
 			.append( QString( ", mute_group: %1" ).arg( __mute_group ) )
-			.append( QString( ", queued: %1" ).arg( __queued ) )
-			.append( QString( ", m_enqueuedBy: [%1]" )
-					 .arg( m_enqueuedBy.join( " ; " ) ) );
+			.append( QString( ", m_bRetired: %1" ).arg( m_bRetired.load() ) )
+			.append( QString( ", m_nLastUsedEpoch: %1" )
+					 .arg( m_nLastUsedEpoch.load() ) );
 		sOutput.append( QString( ", fx_level: [ " ) );
 		for ( const auto& ff : __fx_level ) {
 			sOutput.append( QString( "%1 " ).arg( ff ) );
@@ -23,7 +23,9 @@
 #ifndef H2C_INSTRUMENT_H
 #define H2C_INSTRUMENT_H
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 
 #include <core/Object.h>
@@ -44,6 +46,7 @@ class ADSR;
 class Drumkit;
 class InstrumentLayer;
 class InstrumentComponent;
+class InstrumentReclaimer;
 class Note;
 class XMLNode;
 
@@ -55,6 +58,7 @@ Instrument class
 class Instrument : public H2Core::Object<Instrument>
 {
 		H2_OBJECT(Instrument)
+		friend class InstrumentReclaimer;
 	public:
 		enum SampleSelectionAlgo {
 			VELOCITY,
@@ -164,6 +168,10 @@ class Instrument : public H2Core::Object<Instrument>
 		void set_midi_out_note( int note );
 		/** get the midi out note of the instrument */
 		int get_midi_out_note() const;
+		/** Incremented each time the midi out note of any instrument
+		 * is set. Used by #InstrumentList to keep its note lookup table
+		 * up to date. */
+		static uint32_t getMidiOutNoteRevision();
 
 		/** set muted status of the instrument */
 		void set_muted( bool muted );
@@ -242,13 +250,10 @@ class Instrument : public H2Core::Object<Instrument>
 		/** get the soloed status of the instrument */
 		bool is_soloed() const;
 
-		/** enqueue the instrument for @a pNote */
-		void enqueue( Note* pNote );
-		/** dequeue the instrument for @a pNote */
-		void dequeue( Note* pNote );
-		/** get the queued status of the instrument */
-		bool is_queued() const;
-		const QStringList& getEnqueuedBy() const;
+		/** Whether the instrument was handed to the
+		 * #InstrumentReclaimer and its samples are about to be
+		 * unloaded. */
+		bool is_retired() const;
 
 		/** set the stop notes status of the instrument */
 		void set_stop_notes( bool stopnotes );
@@ -372,10 +377,13 @@ class Instrument : public H2Core::Object<Instrument>
 		bool					__soloed;				///< is the instrument in solo mode?
 		bool					__muted;				///< is the instrument muted?
 		int						__mute_group;			///< mute group of the instrument
-		int						__queued;				///< count the number of notes queued within Sampler::__playing_notes_queue or std::priority_queue m_songNoteQueue
-		/** List of short string representations of notes for which this
-		 * instrument was enqueued. */
-		QStringList				m_enqueuedBy;
+		/** Set by the #InstrumentReclaimer while the instrument is
+		 * waiting for its samples to be unloaded.*/
+		std::atomic<bool>		m_bRetired;
+		/** Latest epoch of the #InstrumentReclaimer in which the audio
+		 * engine still found a note of this (retired) instrument.*/
+		std::atomic<uint64_t>	m_nLastUsedEpoch;
+		static std::atomic<uint32_t>	m_nMidiOutNoteRevision;
 		float					__fx_level[MAX_FX];		///< Ladspa FX level array
 		int						__hihat_grp;			///< the instrument is part of a hihat
 		int						__lower_cc;				///< lower cc level
@@ -457,10 +465,16 @@ inline int Instrument::get_midi_out_note() const
 	return __midi_out_note;
 }
 
+inline uint32_t Instrument::getMidiOutNoteRevision()
+{
+	return m_nMidiOutNoteRevision.load();
+}
+
 inline void Instrument::set_midi_out_note( int note )
 {
 	if ( ( note >= MIDI_OUT_NOTE_MIN ) && ( note <= MIDI_OUT_NOTE_MAX ) ) {
 		__midi_out_note = note;
+		m_nMidiOutNoteRevision.fetch_add( 1 );
 	} else {
 		ERRORLOG( QString( "midi out note %1 out of bounds" ).arg( note ) );
 	}
@@ -607,13 +621,9 @@ inline bool Instrument::is_soloed() const
 	return __soloed;
 }
 
-inline bool Instrument::is_queued() const
+inline bool Instrument::is_retired() const
 {
-	return ( __queued > 0 );
-}
-
-inline const QStringList& Instrument::getEnqueuedBy() const {
-	return m_enqueuedBy;
+	return m_bRetired.load( std::memory_order_relaxed );
 }
 
 inline void Instrument::set_stop_notes( bool stopnotes )
@@ -22,9 +22,13 @@
 
 #include <core/Basics/InstrumentComponent.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 
 #include <core/Basics/InstrumentLayer.h>
+#include <core/Helpers/Random.h>
 #include <core/Helpers/Xml.h>
 
 
@@ -51,6 +55,7 @@ InstrumentComponent::InstrumentComponent( const QString& sName, float fGain )
 	for ( int i = 0; i < m_nMaxLayers; i++ ) {
 		m_layers[i] = nullptr;
 	}
+	updateLayerSelection();
 }
 
 InstrumentComponent::InstrumentComponent( std::shared_ptr<InstrumentComponent> other )
@@ -68,6 +73,7 @@ InstrumentComponent::InstrumentComponent( std::shared_ptr<InstrumentComponent> o
 			m_layers[i] = nullptr;
 		}
 	}
+	updateLayerSelection();
 }
 
 InstrumentComponent::~InstrumentComponent()
@@ -81,6 +87,151 @@ void InstrumentComponent::setLayer( std::shared_ptr<InstrumentLayer> layer, int
 {
 	assert( idx >= 0 && idx < m_nMaxLayers );
 	m_layers[ idx ] = layer;
+	updateLayerSelection();
+}
+
+void InstrumentComponent::updateLayerSelection()
+{
+	auto pSelection = std::make_shared<LayerSelection>();
+
+	for ( int ii = 0; ii < m_layers.size(); ++ii ) {
+		const auto& pLayer = m_layers[ ii ];
+		if ( pLayer != nullptr ) {
+			pSelection->layers.push_back( { ii, pLayer->get_start_velocity(),
+											pLayer->get_end_velocity() } );
+		}
+	}
+
+	// Bin boundaries are padded slightly in order to be robust against
+	// rounding errors in selectLayer(). Since the final decision is
+	// based on the actual velocity, additional candidates do no harm.
+	const float fPadding = 1e-4;
+	const int nLastBin = LayerSelection::nBins - 1;
+	for ( int nBin = 0; nBin < LayerSelection::nBins; ++nBin ) {
+		const float fLower = nBin == 0 ?
+			-std::numeric_limits<float>::infinity() :
+			( nBin - 0.5 ) / nLastBin - fPadding;
+		const float fUpper = nBin == nLastBin ?
+			std::numeric_limits<float>::infinity() :
+			( nBin + 0.5 ) / nLastBin + fPadding;
+
+		pSelection->binOffsets[ nBin ] = pSelection->binCandidates.size();
+		for ( int ii = 0; ii < pSelection->layers.size(); ++ii ) {
+			const auto& candidate = pSelection->layers[ ii ];
+			if ( candidate.fStartVelocity <= fUpper &&
+				 candidate.fEndVelocity >= fLower ) {
+				pSelection->binCandidates.push_back( ii );
+			}
+		}
+	}
+	pSelection->binOffsets[ LayerSelection::nBins ] =
+		pSelection->binCandidates.size();
+
+	pSelection->roundRobinCursors =
+		std::make_unique<std::atomic<int>[]>( m_layers.size() );
+	for ( int ii = 0; ii < m_layers.size(); ++ii ) {
+		pSelection->roundRobinCursors[ ii ] = 0;
+	}
+
+	std::atomic_store( &m_pLayerSelection, pSelection );
+}
+
+int InstrumentComponent::selectLayer( float fVelocity,
+									  Instrument::SampleSelectionAlgo algo ) const
+{
+	const auto pSelection = std::atomic_load( &m_pLayerSelection );
+	if ( pSelection == nullptr || pSelection->layers.size() == 0 ) {
+		return -1;
+	}
+
+	const int nBin = std::clamp(
+		static_cast<int>( std::lround( fVelocity *
+									   ( LayerSelection::nBins - 1 ) ) ),
+		0, LayerSelection::nBins - 1 );
+	const int nBegin = pSelection->binOffsets[ nBin ];
+	const int nEnd = pSelection->binOffsets[ nBin + 1 ];
+
+	auto matches = [&]( int nCandidate ) {
+		const auto& candidate = pSelection->layers[ nCandidate ];
+		return fVelocity >= candidate.fStartVelocity &&
+			fVelocity <= candidate.fEndVelocity;
+	};
+
+	// Number of layers covering the velocity and the last one of them.
+	int nMatches = 0;
+	int nLastMatch = -1;
+	for ( int ii = nBegin; ii < nEnd; ++ii ) {
+		const int nCandidate = pSelection->binCandidates[ ii ];
+		if ( matches( nCandidate ) ) {
+			if ( algo == Instrument::VELOCITY ) {
+				return pSelection->layers[ nCandidate ].nLayer;
+			}
+			++nMatches;
+			nLastMatch = nCandidate;
+		}
+	}
+
+	// In some instruments the start and end velocities of a layer
+	// are not set perfectly giving rise to some 'holes'.
+	// Occasionally the velocity of a note can fall into it
+	// causing the sampler to just skip it. Instead, we will
+	// search for the nearest sample and play this one instead.
+	if ( nMatches == 0 ) {
+		WARNINGLOG( QString( "Velocity [%1] did fall into a hole between the layers of component [%2]." )
+					.arg( fVelocity ).arg( m_sName ) );
+
+		float fShortestDistance = 1.0f;
+		int nNearestLayer = -1;
+		for ( const auto& candidate : pSelection->layers ) {
+			const float fDistance =
+				std::fabs( candidate.fStartVelocity - fVelocity );
+			if ( fDistance < fShortestDistance ) {
+				fShortestDistance = fDistance;
+				nNearestLayer = candidate.nLayer;
+			}
+		}
+
+		if ( nNearestLayer == -1 ) {
+			ERRORLOG( QString( "No sample found for component [%1]" )
+					  .arg( m_sName ) );
+		}
+		return nNearestLayer;
+	}
+
+	int nPicked;
+	switch ( algo ) {
+	case Instrument::RANDOM:
+		nPicked = Random::getInt( nMatches );
+		break;
+
+	case Instrument::ROUND_ROBIN: {
+		auto& cursor = pSelection->roundRobinCursors[
+			pSelection->layers[ nLastMatch ].nLayer ];
+		nPicked = cursor.load( std::memory_order_relaxed ) + 1;
+		if ( nPicked >= nMatches ) {
+			nPicked = 0;
+		}
+		cursor.store( nPicked, std::memory_order_relaxed );
+		break;
+	}
+
+	default:
+		ERRORLOG( QString( "Unknown selection algorithm [%1] for component [%2]" )
+				  .arg( algo ).arg( m_sName ) );
+		return -1;
+	}
+
+	for ( int ii = nBegin; ii < nEnd; ++ii ) {
+		const int nCandidate = pSelection->binCandidates[ ii ];
+		if ( matches( nCandidate ) ) {
+			if ( nPicked == 0 ) {
+				return pSelection->layers[ nCandidate ].nLayer;
+			}
+			--nPicked;
+		}
+	}
+
+	return -1;
 }
 
 void InstrumentComponent::setMaxLayers( int nLayers )
@@ -23,6 +23,8 @@
 #ifndef H2C_INSTRUMENTCOMPONENT_H
 #define H2C_INSTRUMENTCOMPONENT_H
 
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <vector>
 #include <memory>
@@ -31,6 +33,7 @@
 
 #include <core/Object.h>
 #include <core/License.h>
+#include <core/Basics/Instrument.h>
 
 namespace H2Core
 {
@@ -70,6 +73,29 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 	const std::vector<std::shared_ptr<InstrumentLayer>> getLayers() const;
 		void				setLayer( std::shared_ptr<InstrumentLayer> layer, int idx );
 
+		/** Selects the layer a note of velocity @a fVelocity will be
+		 * rendered with.
+		 *
+		 * It uses the lookup table compiled by updateLayerSelection()
+		 * and is allocation-free. It is thus safe to be called from
+		 * within the audio thread.
+		 *
+		 * In case @a fVelocity falls into a hole between the velocity
+		 * ranges of the layers, the layer with the nearest start velocity
+		 * will be used instead.
+		 *
+		 * \return Index of the selected layer or -1 in case no
+		 *   suitable layer was found.*/
+		int selectLayer( float fVelocity,
+						 Instrument::SampleSelectionAlgo algo ) const;
+		/** Recompiles the lookup table used by selectLayer().
+		 *
+		 * It is called automatically by setLayer(). But it has to be
+		 * invoked manually after altering the velocity range of a
+		 * contained #InstrumentLayer. Must not be called from within the
+		 * audio thread.*/
+		void updateLayerSelection();
+
 		void				setGain( float gain );
 		float				getGain() const;
 		
@@ -113,6 +139,39 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 		 * Preferences::Preferences(): 16. */
 		static int			m_nMaxLayers;
 		std::vector<std::shared_ptr<InstrumentLayer>>	m_layers;
+
+		/** Precompiled mapping of note velocities to the layers
+		 * covering them.
+		 *
+		 * The velocity range [0,1] is divided into #nBins bins (one per
+		 * MIDI velocity) and each of them holds the layers whose
+		 * velocity range intersects with it. Selecting a layer thus only
+		 * requires to check the few candidates of a single bin.*/
+		struct LayerSelection {
+			static constexpr int nBins = 128;
+
+			struct Candidate {
+				int nLayer;
+				float fStartVelocity;
+				float fEndVelocity;
+			};
+			/** All layers of the component in ascending order of their
+			 * index.*/
+			std::vector<Candidate> layers;
+			/** Indices into #layers grouped by bin.*/
+			std::vector<int> binCandidates;
+			/** Candidates of bin @a i are stored in #binCandidates between
+			 * binOffsets[ i ] and binOffsets[ i + 1 ].*/
+			std::array<int, nBins + 1> binOffsets;
+			/** Position of the last round robin selection. The key is the
+			 * index of the last layer matching a velocity. Used as an
+			 * identifier of the group of layers sharing a velocity
+			 * range.*/
+			std::unique_ptr<std::atomic<int>[]> roundRobinCursors;
+		};
+		/** Replaced as a whole by updateLayerSelection() and accessed
+		 * using atomic operations.*/
+		std::shared_ptr<LayerSelection> m_pLayerSelection;
 };
 
 // DEFINITIONS
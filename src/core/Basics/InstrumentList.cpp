@@ -31,16 +31,21 @@
 #include <core/IO/MidiCommon.h>
 #include <core/License.h>
 
+#include <limits>
 #include <set>
 
 namespace H2Core
 {
 
 InstrumentList::InstrumentList()
+	: m_nRevision( 0 )
+	, m_nMidiNoteTableRevision( std::numeric_limits<uint64_t>::max() )
 {
 }
 
 InstrumentList::InstrumentList( std::shared_ptr<InstrumentList> other ) : Object( *other )
+	, m_nRevision( 0 )
+	, m_nMidiNoteTableRevision( std::numeric_limits<uint64_t>::max() )
 {
 	assert( other );
 	assert( __instruments.size() == 0 );
@@ -136,6 +141,7 @@ void InstrumentList::operator<<( std::shared_ptr<Instrument> instrument )
 		if( __instruments[i]==instrument ) return;
 	}
 	__instruments.push_back( instrument );
+	changed();
 }
 	
 bool InstrumentList::operator==( std::shared_ptr<InstrumentList> pOther ) const {
@@ -173,6 +179,7 @@ void InstrumentList::add( std::shared_ptr<Instrument> instrument )
 		if( __instruments[i]==instrument ) return;
 	}
 	__instruments.push_back( instrument );
+	changed();
 }
 
 void InstrumentList::insert( int idx, std::shared_ptr<Instrument> instrument )
@@ -182,6 +189,7 @@ void InstrumentList::insert( int idx, std::shared_ptr<Instrument> instrument )
 		if( __instruments[i]==instrument ) return;
 	}
 	__instruments.insert( __instruments.begin() + idx, instrument );
+	changed();
 }
 
 std::shared_ptr<Instrument> InstrumentList::operator[]( int idx ) const
@@ -247,12 +255,49 @@ std::shared_ptr<Instrument>  InstrumentList::find( const QString& name ) const
 
 std::shared_ptr<Instrument>  InstrumentList::findMidiNote( const int note ) const
 {
-	for( int i=0; i<__instruments.size(); i++ ) {
-		if ( __instruments[i]->get_midi_out_note()==note ) {
-			return __instruments[i];
+	if ( note < MIDI_OUT_NOTE_MIN || note > MIDI_OUT_NOTE_MAX ) {
+		return nullptr;
+	}
+
+	// The revision is read before building the table. In case a note
+	// is altered in the meantime, the table will just be rebuilt
+	// during the next call.
+	const uint64_t nRevision = getRevision();
+	if ( m_nMidiNoteTableRevision.load() != nRevision ) {
+		std::array<int, MIDI_OUT_NOTE_MAX + 1> table;
+		table.fill( -1 );
+		// Iterate backwards so the first instrument using a note wins.
+		for ( int ii = __instruments.size() - 1; ii >= 0; --ii ) {
+			if ( __instruments[ ii ] == nullptr ) {
+				continue;
+			}
+			const int nNote = __instruments[ ii ]->get_midi_out_note();
+			if ( nNote >= MIDI_OUT_NOTE_MIN && nNote <= MIDI_OUT_NOTE_MAX ) {
+				table[ nNote ] = ii;
+			}
 		}
+		for ( int ii = 0; ii < table.size(); ++ii ) {
+			m_midiNoteTable[ ii ].store( table[ ii ] );
+		}
+		m_nMidiNoteTableRevision.store( nRevision );
 	}
-	return nullptr;
+
+	const int nIndex = m_midiNoteTable[ note ].load();
+	if ( nIndex < 0 || nIndex >= __instruments.size() ) {
+		return nullptr;
+	}
+	return __instruments[ nIndex ];
+}
+
+void InstrumentList::changed()
+{
+	m_nRevision.fetch_add( 1 );
+}
+
+uint64_t InstrumentList::getRevision() const
+{
+	return ( static_cast<uint64_t>( m_nRevision.load() ) << 32 ) |
+		Instrument::getMidiOutNoteRevision();
 }
 
 std::shared_ptr<Instrument> InstrumentList::del( int idx )
@@ -260,6 +305,7 @@ std::shared_ptr<Instrument> InstrumentList::del( int idx )
 	assert( idx >= 0 && idx < __instruments.size() );
 	auto instrument = __instruments[idx];
 	__instruments.erase( __instruments.begin() + idx );
+	changed();
 	return instrument;
 }
 
@@ -268,6 +314,7 @@ std::shared_ptr<Instrument> InstrumentList::del( std::shared_ptr<Instrument> ins
 	for( int i=0; i<__instruments.size(); i++ ) {
 		if( __instruments[i]==instrument ) {
 			__instruments.erase( __instruments.begin() + i );
+			changed();
 			return instrument;
 		}
 	}
@@ -283,6 +330,7 @@ void InstrumentList::move( int idx_a, int idx_b )
 	auto tmp = __instruments[idx_a];
 	__instruments.erase( __instruments.begin() + idx_a );
 	__instruments.insert( __instruments.begin() + idx_b, tmp );
+	changed();
 }
 
 std::vector<std::shared_ptr<InstrumentList::Content>> InstrumentList::summarizeContent() const {
@@ -23,6 +23,9 @@
 #ifndef H2C_INSTRUMENT_LIST_H
 #define H2C_INSTRUMENT_LIST_H
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <core/License.h>
@@ -237,7 +240,9 @@ class InstrumentList : public H2Core::Object<InstrumentList>
 		 * \return String presentation of current object.*/
 		QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 
-		/** Iteration */
+		/** Iteration. Instruments must not be replaced using the
+		 * returned iterators. Use the mutators of this class
+		 * instead. */
 	std::vector<std::shared_ptr<Instrument>>::iterator begin();
 	std::vector<std::shared_ptr<Instrument>>::iterator end();
 
@@ -247,7 +252,22 @@ class InstrumentList : public H2Core::Object<InstrumentList>
 		bool isAnyInstrumentSampleLoaded() const;
 
 	private:
+		/** Has to be called whenever #__instruments is altered. */
+		void changed();
+		/** Combined revision of the list and of the midi out notes
+		 * of all instruments. */
+		uint64_t getRevision() const;
+
 		std::vector<std::shared_ptr<Instrument>> __instruments;            ///< the list of instruments
+		/** Incremented on each change of #__instruments. */
+		std::atomic<uint32_t> m_nRevision;
+		/** Index of the first instrument using a particular midi
+		 * out note or -1. Rebuilt by findMidiNote() whenever
+		 * #m_nMidiNoteTableRevision is outdated. */
+		mutable std::array<std::atomic<int>, MIDI_OUT_NOTE_MAX + 1> m_midiNoteTable;
+		/** Revision (see getRevision()) #m_midiNoteTable was built
+		 * for. */
+		mutable std::atomic<uint64_t> m_nMidiNoteTableRevision;
 };
 
 // DEFINITIONS
@@ -145,6 +145,9 @@ Note::Note( Note* other, std::shared_ptr<Instrument> pInstrument )
 				pSampleInfo->nSelectedLayer = ppSelectedLayerInfo->nSelectedLayer;
 				pSampleInfo->fSamplePosition = ppSelectedLayerInfo->fSamplePosition;
 				pSampleInfo->nNoteLength = ppSelectedLayerInfo->nNoteLength;
+				pSampleInfo->nTrackOutput = ppSelectedLayerInfo->nTrackOutput;
+				pSampleInfo->nTrackRoutingGeneration =
+					ppSelectedLayerInfo->nTrackRoutingGeneration;
 		
 				__layers_selected[ ii ] = pSampleInfo;
 			}
@@ -364,116 +367,22 @@ std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer )
 	}
 	else {
 		// Select an instrument layer.
-		std::vector<int> possibleLayersVector;
-		int nLayersEncountered = 0;
-		float fRoundRobinID;
-		auto pSong = Hydrogen::get_instance()->getSong();
-		
-		for ( unsigned nLayer = 0; nLayer < InstrumentComponent::getMaxLayers(); ++nLayer ) {
-			auto pLayer = pInstrCompo->getLayer( nLayer );
-			if ( pLayer == nullptr ) {
-				continue;
-			}
-			++nLayersEncountered;
-
-			if ( ( __velocity >= pLayer->get_start_velocity() ) &&
-				 ( __velocity <= pLayer->get_end_velocity() ) ) {
-
-				possibleLayersVector.push_back( nLayer );
-				if ( __instrument->sample_selection_alg() == Instrument::VELOCITY ) {
-					break;
-				} else if ( __instrument->sample_selection_alg() == Instrument::ROUND_ROBIN ) {
-					fRoundRobinID = pLayer->get_start_velocity();
-				}
-			}
-		}
-
-		if ( nLayersEncountered == 0 ) {
+		const int nLayerPicked = pInstrCompo->selectLayer(
+			__velocity, __instrument->sample_selection_alg() );
+		if ( nLayerPicked == -1 ) {
 			return nullptr;
 		}
 
-		// In some instruments the start and end velocities of a layer
-		// are not set perfectly giving rise to some 'holes'.
-		// Occasionally the velocity of a note can fall into it
-		// causing the sampler to just skip it. Instead, we will
-		// search for the nearest sample and play this one instead.
-		if ( possibleLayersVector.size() == 0 ){
-			WARNINGLOG( QString( "Velocity [%1] did fall into a hole between the instrument layers for component [%2] of instrument [%3]." )
-						.arg( __velocity ).arg( pInstrCompo->getName() )
-						.arg( __instrument->get_name() ) );
-			
-			float shortestDistance = 1.0f;
-			int nearestLayer = -1;
-			for ( unsigned nLayer = 0; nLayer < InstrumentComponent::getMaxLayers(); ++nLayer ){
-				auto pLayer = pInstrCompo->getLayer( nLayer );
-				if ( pLayer == nullptr ){
-					continue;
-				}
-							
-				if ( std::min( abs( pLayer->get_start_velocity() - __velocity ),
-							   abs( pLayer->get_start_velocity() - __velocity ) ) <
-					 shortestDistance ){
-					shortestDistance =
-						std::min( abs( pLayer->get_start_velocity() - __velocity ),
-								  abs( pLayer->get_start_velocity() - __velocity ) );
-					nearestLayer = nLayer;
-				}
-			}
-
-			// Check whether the search was successful and assign the results.
-			if ( nearestLayer > -1 ){
-				possibleLayersVector.push_back( nearestLayer );
-				if ( __instrument->sample_selection_alg() == Instrument::ROUND_ROBIN ) {
-					fRoundRobinID =
-						pInstrCompo->getLayer( nearestLayer )->get_start_velocity();
-				}
-			} else {
-				ERRORLOG( QString( "No sample found for component [%1] of instrument [%2]" )
-						  .arg( pInstrCompo->getName() )
-						  .arg( __instrument->get_name() ) );
-				return nullptr;
-			}
+		auto pLayer = pInstrCompo->getLayer( nLayerPicked );
+		if ( pLayer == nullptr ) {
+			ERRORLOG( QString( "Unable to retrieve layer [%1] selected for component [%2] of instrument [%3]" )
+					  .arg( nLayerPicked ).arg( pInstrCompo->getName() )
+					  .arg( __instrument->get_name() ) );
+			return nullptr;
 		}
 
-		if ( possibleLayersVector.size() > 0 ) {
-
-			int nLayerPicked;
-			switch ( __instrument->sample_selection_alg() ) {
-			case Instrument::VELOCITY: 
-				nLayerPicked = possibleLayersVector[ 0 ];
-				break;
-				
-			case Instrument::RANDOM:
-				nLayerPicked = possibleLayersVector[ rand() %
-													 possibleLayersVector.size() ];
-				break;
-
-			case Instrument::ROUND_ROBIN: {
-				fRoundRobinID = __instrument->get_id() * 10 + fRoundRobinID;
-				int nIndex = pSong->getLatestRoundRobin( fRoundRobinID ) + 1;
-				if ( nIndex >= possibleLayersVector.size() ) {
-					nIndex = 0;
-				}
-
-				pSong->setLatestRoundRobin( fRoundRobinID, nIndex );
-				nLayerPicked = possibleLayersVector[ nIndex ];
-				break;
-			}
-				
-			default:
-				ERRORLOG( QString( "Unknown selection algorithm [%1] for instrument [%2]" )
-						  .arg( __instrument->sample_selection_alg() )
-						  .arg( __instrument->get_name() ) );
-				return nullptr;
-			} 
-
-			pSelectedLayer->nSelectedLayer = nLayerPicked;
-			auto pLayer = pInstrCompo->getLayer( nLayerPicked );
-			pSample = pLayer->get_sample();
-
-		} else {
-			ERRORLOG( "No samples found during random layer selection. This is a bug and shoul dn't happen!" );
-		}
+		pSelectedLayer->nSelectedLayer = nLayerPicked;
+		pSample = pLayer->get_sample();
 	}
 
 	return pSample;
@@ -825,7 +734,11 @@ QString SelectedLayerInfo::toQString( const QString& sPrefix, bool bShort ) cons
 			.append( QString( "%1%2fSamplePosition: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( fSamplePosition ) )
 			.append( QString( "%1%2nNoteLength: %3\n" ).arg( sPrefix )
-					 .arg( s ).arg( nNoteLength ) );
+					 .arg( s ).arg( nNoteLength ) )
+			.append( QString( "%1%2nTrackOutput: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( nTrackOutput ) )
+			.append( QString( "%1%2nTrackRoutingGeneration: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( nTrackRoutingGeneration ) );
 	}
 	else {
 		sOutput = QString( "[SelectedLayerInfo] " )
@@ -834,7 +747,11 @@ QString SelectedLayerInfo::toQString( const QString& sPrefix, bool bShort ) cons
 			.append( QString( ", fSamplePosition: %1" )
 					 .arg( fSamplePosition ) )
 			.append( QString( ", nNoteLength: %1" )
-					 .arg( nNoteLength ) );
+					 .arg( nNoteLength ) )
+			.append( QString( ", nTrackOutput: %1" )
+					 .arg( nTrackOutput ) )
+			.append( QString( ", nTrackRoutingGeneration: %1" )
+					 .arg( nTrackRoutingGeneration ) );
 	}
 
 	return sOutput;
@@ -53,6 +53,7 @@ namespace H2Core
 class XMLNode;
 class ADSR;
 class Instrument;
+class InstrumentLayer;
 class InstrumentList;
 
 /** Auxiliary variables storing the rendering state of a #H2Core::Note within
@@ -90,9 +91,52 @@ struct SelectedLayerInfo {
 	 * just the fraction between #fSamplePosition and the former #nNoteLength.*/
 	int nNoteLength;
 
+	/** Per-track JACK output port the layer is rendered to. It is
+	 * resolved once per routing of the #H2Core::JackAudioDriver and
+	 * cached in here to avoid a lookup during every process cycle. -1
+	 * if not resolved yet or if there is no such output. */
+	int nTrackOutput = -1;
+	/** Generation of the JACK per-track routing #nTrackOutput was
+	 * resolved for. */
+	int nTrackRoutingGeneration = -1;
+
+	/** Layer corresponding to #nSelectedLayer and its sample. Both are
+	 * resolved when the #H2Core::Sampler starts rendering the note and
+	 * kept alive till it is done. */
+	std::shared_ptr<InstrumentLayer> pLayer;
+	std::shared_ptr<Sample> pSample;
+
+	/** Resampling step of #pSample. It is only recomputed in case the
+	 * pitch (#fStepPitch) or sample rate of the audio driver
+	 * (#nStepSampleRate) changed. */
+	float fStep = 1.0;
+	float fStepPitch = 0.0;
+	int nStepSampleRate = -1;
+
 	QString toQString( const QString& sPrefix = "", bool bShort = true ) const;
 };
 
+/** Pan coefficients of a #H2Core::Note resolved by the
+ * #H2Core::Sampler.
+ *
+ * Evaluating a pan law is comparatively expensive and its inputs do
+ * rarely change while a note is played back. The results are thus
+ * cached and only recomputed if one of the inputs changed. */
+struct VoicePan {
+	bool bValid = false;
+	float fInstrumentPan = 0.0;
+	float fNotePan = 0.0;
+	int nPanLawType = -1;
+	float fPanLawKNorm = 0.0;
+	bool bPreFader = false;
+
+	float fPan_L = 0.0;
+	float fPan_R = 0.0;
+	/** Only used in preFader mode of the JACK per-track outputs. */
+	float fNotePan_L = 0.0;
+	float fNotePan_R = 0.0;
+};
+
 /**
  * A note plays an associated instrument with a velocity left and right pan
  */
@@ -244,6 +288,10 @@ class Note : public H2Core::Object<Note>
 		bool get_just_recorded() const;
 
 	std::shared_ptr<SelectedLayerInfo> get_layer_selected( int nIdx ) const;
+	/** Selected layers of all components. Entries might be nullptr. */
+	const std::vector<std::shared_ptr<SelectedLayerInfo>>& getLayersSelected() const;
+	/** Pan coefficients cached by the #H2Core::Sampler. */
+	VoicePan& getVoicePan();
 
 		void set_probability( float value );
 		float get_probability() const;
@@ -497,6 +545,7 @@ class Note : public H2Core::Object<Note>
 		 * #__instrument. It assumes the same order as
 		 * #Instrument::__components. */
 	std::vector<std::shared_ptr<SelectedLayerInfo>> __layers_selected;
+	VoicePan m_voicePan;
 
 		/** the instrument to be played by this note */
 		std::shared_ptr<Instrument>		__instrument;
@@ -644,6 +693,14 @@ inline std::shared_ptr<SelectedLayerInfo> Note::get_layer_selected( int nCompoId
 	return __layers_selected.at( nCompoIdx );
 }
 
+inline const std::vector<std::shared_ptr<SelectedLayerInfo>>& Note::getLayersSelected() const {
+	return __layers_selected;
+}
+
+inline VoicePan& Note::getVoicePan() {
+	return m_voicePan;
+}
+
 inline int Note::get_humanize_delay() const
 {
 	return __humanize_delay;
@@ -141,18 +141,22 @@ bool Playlist::save( bool bSilent ) const {
 		INFOLOG( QString( "Saving playlist to [%1]" ).arg( m_sFilename ) );
 	}
 
-	XMLDoc doc;
-	XMLNode root = doc.set_root( "playlist", "playlist" );
+	return toXMLDoc( m_sFilename )->write( m_sFilename );
+}
+
+std::unique_ptr<XMLDoc> Playlist::toXMLDoc( const QString& sPath ) const {
+	auto pDoc = std::make_unique<XMLDoc>();
+	XMLNode root = pDoc->set_root( "playlist", "playlist" );
 
 	root.write_int( "formatVersion", nCurrentFormatVersion );
 
-	saveTo( root );
-	return doc.write( m_sFilename );
+	saveTo( root, sPath );
+	return pDoc;
 }
 
-void Playlist::saveTo( XMLNode& node ) const
+void Playlist::saveTo( XMLNode& node, const QString& sPath ) const
 {
-	QFileInfo fileInfo( m_sFilename );
+	QFileInfo fileInfo( sPath );
 
 	XMLNode songs = node.createNode( "songs" );
 
@@ -120,6 +120,11 @@ class Playlist : public H2Core::Object<Playlist>
 		static std::shared_ptr<Playlist> load( const QString& sPath );
 		bool saveAs( const QString& sTargetPath, bool bSilent = false );
 		bool save( bool bSilent = false ) const;
+		/** Assembles the XML document written by save().
+		 *
+		 * \param sPath Path the document will be written to. Used to
+		 *   make the song paths relative (if enabled). */
+		std::unique_ptr<XMLDoc> toXMLDoc( const QString& sPath ) const;
 		/** Formatted string version for debugging purposes.
 		 * \param sPrefix String prefix which will be added in front of
 		 * every new line
@@ -133,7 +138,7 @@ class Playlist : public H2Core::Object<Playlist>
 	private:
 
 		static std::shared_ptr<Playlist> load_from( const XMLNode& root, const QString& sPath );
-		void saveTo( XMLNode& node ) const;
+		void saveTo( XMLNode& node, const QString& sPath ) const;
 
 		void execScript( int index ) const;
 
@@ -28,6 +28,7 @@
 #include <core/Hydrogen.h>
 #include <core/Preferences/Preferences.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/SampleMemory.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/Note.h>
 
@@ -71,6 +72,8 @@ Sample::Sample( const QString& filepath, const License& license, int frames, int
 	__data_l( data_l ),
 	__data_r( data_r ),
 	__is_modified( false ),
+	m_bRetired( false ),
+	m_nLastUsedEpoch( 0 ),
 	m_license( license )
 {
 	if ( filepath.lastIndexOf( "/" ) <= 0 ) {
@@ -89,11 +92,13 @@ Sample::Sample( std::shared_ptr<Sample> pOther ) :
 	__is_modified( pOther->get_is_modified() ),
 	__loops( pOther->__loops ),
 	__rubberband( pOther->__rubberband ),
+	m_bRetired( false ),
+	m_nLastUsedEpoch( 0 ),
 	m_license( pOther->m_license )
 {
 
-	__data_l = new float[__frames];
-	__data_r = new float[__frames];
+	__data_l = SampleMemory::allocate( __frames );
+	__data_r = SampleMemory::allocate( __frames );
 	
 	// Since the third argument of memcpy takes the number of bytes,
 	// which are about to be copied, and the data is given in float,
@@ -115,12 +120,8 @@ Sample::Sample( std::shared_ptr<Sample> pOther ) :
 
 Sample::~Sample()
 {
-	if ( __data_l != nullptr ) {
-		delete[] __data_l;
-	}
-	if ( __data_r != nullptr ) {
-		delete[] __data_r;
-	}
+	SampleMemory::release( __data_l );
+	SampleMemory::release( __data_r );
 }
 
 void Sample::set_filename( const QString& filename )
@@ -231,8 +232,8 @@ bool Sample::load( float fBpm )
 	// Split the loaded frames into left and right channel. 
 	// If only one channels was present in the underlying data,
 	// duplicate its content.
-	__data_l = new float[ sound_info.frames ];
-	__data_r = new float[ sound_info.frames ];
+	__data_l = SampleMemory::allocate( sound_info.frames );
+	__data_r = SampleMemory::allocate( sound_info.frames );
 	if ( sound_info.channels == 1 ) {
 		memcpy( __data_l, buffer, __frames * sizeof( float ) );
 		memcpy( __data_r, buffer, __frames * sizeof( float ) );
@@ -265,13 +266,8 @@ bool Sample::load( float fBpm )
 
 void Sample::unload()
 {
-	if ( __data_l != nullptr ) {
-		delete [] __data_l;
-	}
-
-	if ( __data_r != nullptr ) {
-		delete [] __data_r;
-	}
+	SampleMemory::release( __data_l );
+	SampleMemory::release( __data_r );
 	__frames = __sample_rate = 0;
 	/** #__is_modified = false; leave this unchanged as pan,
 	    velocity, loop and rubberband are kept unchanged */
@@ -317,8 +313,8 @@ bool Sample::apply_loops()
 	int loop_length =  __loops.end_frame - __loops.loop_frame;
 	int new_length = full_length + loop_length * __loops.count;
 
-	float* new_data_l = new float[ new_length ];
-	float* new_data_r = new float[ new_length ];
+	float* new_data_l = SampleMemory::allocate( new_length );
+	float* new_data_r = SampleMemory::allocate( new_length );
 
 	// copy full_length frames to new_data
 	if ( __loops.mode==Loops::REVERSE && ( __loops.count==0 || full_loop ) ) {
@@ -374,8 +370,8 @@ bool Sample::apply_loops()
 		}
 		assert( x==new_length );
 	}
-	delete[] __data_l;
-	delete[] __data_r;
+	SampleMemory::release( __data_l );
+	SampleMemory::release( __data_r );
 	__data_l = new_data_l;
 	__data_r = new_data_r;
 	__frames = new_length;
@@ -606,10 +602,10 @@ void Sample::apply_rubberband( float fBpm ) {
 		retrieved += n;
 	}
 	
-	delete [] __data_l;
-	delete [] __data_r;
-	__data_l = new float[ retrieved ];
-	__data_r = new float[ retrieved ];
+	SampleMemory::release( __data_l );
+	SampleMemory::release( __data_r );
+	__data_l = SampleMemory::allocate( retrieved );
+	__data_r = SampleMemory::allocate( retrieved );
 	memcpy( __data_l, out_data_l, retrieved*sizeof( float ) );
 	memcpy( __data_r, out_data_r, retrieved*sizeof( float ) );
 	delete [] out_data_l;
@@ -694,6 +690,8 @@ bool Sample::exec_rubberband_cli( float fBpm )
 
 	__frames = p_Rubberbanded->get_frames();
 
+	SampleMemory::release( __data_l );
+	SampleMemory::release( __data_r );
 	__data_l = p_Rubberbanded->get_data_l();
 	__data_r = p_Rubberbanded->get_data_r();
 	p_Rubberbanded->__data_l = nullptr;
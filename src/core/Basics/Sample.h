@@ -23,6 +23,8 @@
 #ifndef H2C_SAMPLE_H
 #define H2C_SAMPLE_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <sndfile.h>
@@ -67,6 +69,7 @@ class EnvelopePoint : public H2Core::Object<EnvelopePoint>
 class Sample : public H2Core::Object<Sample>
 {
 		H2_OBJECT(Sample)
+		friend class InstrumentReclaimer;
 	public:
 
 		/** define the type used to store pan envelope points */
@@ -139,6 +142,10 @@ class Sample : public H2Core::Object<Sample>
 		 * \param sample_rate the sample rate of the sample
 		 * \param data_l the left channel array of data
 		 * \param data_r the right channel array of data
+		 *
+		 * The sample takes ownership of @a data_l and @a data_r. They
+		 * have to be allocated either using SampleMemory::allocate()
+		 * or new[].
 		 */
 		Sample( const QString& filepath, const License& license = License(), int frames=0, int sample_rate=0, float* data_l=nullptr, float* data_r=nullptr );
 		/** copy constructor */
@@ -316,6 +323,12 @@ class Sample : public H2Core::Object<Sample>
 		VelocityEnvelope	__velocity_envelope; ///< velocity envelope vector
 		Loops				__loops;             ///< set of loop parameters
 		Rubberband			__rubberband;        ///< set of rubberband parameters
+		/** Set by the #InstrumentReclaimer while it keeps the sample
+		 * alive for notes still rendering it.*/
+		std::atomic<bool>		m_bRetired;
+		/** Latest epoch of the #InstrumentReclaimer in which the audio
+		 * engine still found a note rendering this (retired) sample.*/
+		std::atomic<uint64_t>	m_nLastUsedEpoch;
 		/** loop modes string */
 		static const std::vector<QString> __loop_modes;
 
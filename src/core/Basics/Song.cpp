@@ -23,6 +23,8 @@
 
 #include <cassert>
 #include <memory>
+#include <random>
+#include <unordered_map>
 
 #include <core/Basics/Song.h>
 
@@ -66,6 +68,7 @@ Song::Song( const QString& sName, const QString& sAuthor, float fBpm, float fVol
 	: m_bIsTimelineActivated( false )
 	, m_bIsMuted( false )
 	, m_resolution( nDefaultResolution )
+	, m_bLadspaFXPending( false )
 	, m_fBpm( fBpm )
 	, m_nVersion( 0 )
 	, m_sName( sName )
@@ -81,6 +84,7 @@ Song::Song( const QString& sName, const QString& sAuthor, float fBpm, float fVol
 	, m_fHumanizeTimeValue( 0.0 )
 	, m_fHumanizeVelocityValue( 0.0 )
 	, m_fSwingFactor( 0.0 )
+	, m_nRandomSeed( static_cast<int>( std::random_device()() & 0x7FFFFFFF ) )
 	, m_bIsModified( false )
 	, m_mode( Mode::Pattern )
 	, m_sPlaybackTrackFilename( "" )
@@ -309,6 +313,10 @@ std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sF
 	pSong->setHumanizeVelocityValue( rootNode.read_float( "humanize_velocity", 0.0,
 															false, false, bSilent ) );
 	pSong->setSwingFactor( rootNode.read_float( "swing_factor", 0.0, false, false, bSilent ) );
+	// Songs created prior to version 2.0 do not contain a seed and
+	// stick to the random one set in the constructor.
+	pSong->setRandomSeed( rootNode.read_int( "randomSeed", pSong->getRandomSeed(),
+											 true, false, true ) );
 	pSong->setActionMode( static_cast<Song::ActionMode>(
 		rootNode.read_int( "action_mode",
 							 static_cast<int>( Song::ActionMode::selectMode ),
@@ -410,16 +418,10 @@ std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sF
 	// Pattern sequence
 	pSong->loadPatternGroupVectorFrom( rootNode, bSilent );
 
-#ifdef H2CORE_HAVE_LADSPA
-	// reset FX
-	for ( int fx = 0; fx < MAX_FX; ++fx ) {
-		//LadspaFX* pFX = Effects::get_instance()->getLadspaFX( fx );
-		//delete pFX;
-		Effects::get_instance()->setLadspaFX( nullptr, fx );
-	}
-#endif
-
-	// LADSPA FX
+	// LADSPA FX. They are only instantiated once the song is set
+	// (see applyLadspaFX()).
+	pSong->m_ladspaFXSettings.clear();
+	pSong->m_bLadspaFXPending = true;
 	XMLNode ladspaNode = rootNode.firstChildElement( "ladspa" );
 	if ( ! ladspaNode.isNull() ) {
 		int nFX = 0;
@@ -427,30 +429,21 @@ std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sF
 		while ( ! fxNode.isNull() ) {
 			QString sName = fxNode.read_string( "name", "", false, false, bSilent );
 
-			if ( sName != "no plugin" ) {
-				// FIXME: il caricamento va fatto fare all'engine, solo lui sa il samplerate esatto
-#ifdef H2CORE_HAVE_LADSPA
-				LadspaFX* pFX = LadspaFX::load( fxNode.read_string( "filename", "", false, false, bSilent ),
-												sName, 44100 );
-				Effects::get_instance()->setLadspaFX( pFX, nFX );
-				if ( pFX != nullptr ) {
-					pFX->setEnabled( fxNode.read_bool( "enabled", false, false, false, bSilent ) );
-					pFX->setVolume( fxNode.read_float( "volume", 1.0, false, false, bSilent ) );
-					XMLNode inputControlNode = fxNode.firstChildElement( "inputControlPort" );
-					while ( ! inputControlNode.isNull() ) {
-						QString sName = inputControlNode.read_string( "name", "", false, false, bSilent );
-						float fValue = inputControlNode.read_float( "value", 0.0, false, false, bSilent );
-
-						for ( unsigned nPort = 0; nPort < pFX->inputControlPorts.size(); nPort++ ) {
-							LadspaControlPort* port = pFX->inputControlPorts[ nPort ];
-							if ( QString( port->sName ) == sName ) {
-								port->fControlValue = fValue;
-							}
-						}
-						inputControlNode = inputControlNode.nextSiblingElement( "inputControlPort" );
-					}
+			if ( sName != "no plugin" && nFX < MAX_FX ) {
+				LadspaFXSetting setting;
+				setting.nSlot = nFX;
+				setting.sName = sName;
+				setting.sFilename = fxNode.read_string( "filename", "", false, false, bSilent );
+				setting.bEnabled = fxNode.read_bool( "enabled", false, false, false, bSilent );
+				setting.fVolume = fxNode.read_float( "volume", 1.0, false, false, bSilent );
+				XMLNode inputControlNode = fxNode.firstChildElement( "inputControlPort" );
+				while ( ! inputControlNode.isNull() ) {
+					setting.inputControlValues.push_back(
+						{ inputControlNode.read_string( "name", "", false, false, bSilent ),
+						  inputControlNode.read_float( "value", 0.0, false, false, bSilent ) } );
+					inputControlNode = inputControlNode.nextSiblingElement( "inputControlPort" );
 				}
-#endif
+				pSong->m_ladspaFXSettings.push_back( setting );
 			}
 			nFX++;
 			fxNode = fxNode.nextSiblingElement( "fx" );
@@ -548,21 +541,12 @@ bool Song::save( const QString& sFilename, bool bSilent )
 		INFOLOG( QString( "Saving song to [%1]" ).arg( sFilename ) );
 	}
 
-	XMLDoc doc;
-	XMLNode rootNode = doc.set_root( "song" );
-
-	// In order to comply with the GPL license we have to add a
-	// license notice to the file.
-	if ( getLicense().getType() == License::GPL ) {
-		doc.appendChild( doc.createComment( License::getGPLLicenseNotice( getAuthor() ) ) );
-	}
-
-	saveTo( rootNode, bSilent );
+	auto pDoc = toXMLDoc( bSilent );
 
 	setFilename( sFilename );
 	setIsModified( false );
 
-	if ( ! doc.write( sFilename ) ) {
+	if ( ! pDoc->write( sFilename ) ) {
 		ERRORLOG( QString( "Error writing song to [%1]" ).arg( sFilename ) );
 		return false;
 	}
@@ -574,6 +558,59 @@ bool Song::save( const QString& sFilename, bool bSilent )
 	return true;
 }
 
+std::unique_ptr<XMLDoc> Song::toXMLDoc( bool bSilent ) const
+{
+	auto pDoc = std::make_unique<XMLDoc>();
+	XMLNode rootNode = pDoc->set_root( "song" );
+
+	// In order to comply with the GPL license we have to add a
+	// license notice to the file.
+	if ( getLicense().getType() == License::GPL ) {
+		pDoc->appendChild( pDoc->createComment( License::getGPLLicenseNotice( getAuthor() ) ) );
+	}
+
+	saveTo( rootNode, bSilent );
+
+	return pDoc;
+}
+
+void Song::applyLadspaFX() {
+	if ( ! m_bLadspaFXPending ) {
+		return;
+	}
+	m_bLadspaFXPending = false;
+
+#ifdef H2CORE_HAVE_LADSPA
+	auto pEffects = Effects::get_instance();
+
+	// reset FX
+	for ( int fx = 0; fx < MAX_FX; ++fx ) {
+		pEffects->setLadspaFX( nullptr, fx );
+	}
+
+	for ( const auto& setting : m_ladspaFXSettings ) {
+		// FIXME: il caricamento va fatto fare all'engine, solo lui sa il samplerate esatto
+		LadspaFX* pFX = LadspaFX::load( setting.sFilename, setting.sName, 44100 );
+		pEffects->setLadspaFX( pFX, setting.nSlot );
+		if ( pFX == nullptr ) {
+			continue;
+		}
+		pFX->setEnabled( setting.bEnabled );
+		pFX->setVolume( setting.fVolume );
+		for ( const auto& [ ssName, ffValue ] : setting.inputControlValues ) {
+			for ( unsigned nPort = 0; nPort < pFX->inputControlPorts.size(); nPort++ ) {
+				LadspaControlPort* port = pFX->inputControlPorts[ nPort ];
+				if ( QString( port->sName ) == ssName ) {
+					port->fControlValue = ffValue;
+				}
+			}
+		}
+	}
+#endif
+
+	m_ladspaFXSettings.clear();
+}
+
 void Song::loadVirtualPatternsFrom( const XMLNode& node, bool bSilent ) {
 
 	XMLNode virtualPatternListNode = node.firstChildElement( "virtualPatternList" );
@@ -798,6 +835,7 @@ void Song::saveTo( XMLNode& rootNode, bool bSilent ) const {
 	rootNode.write_float( "humanize_time", m_fHumanizeTimeValue );
 	rootNode.write_float( "humanize_velocity", m_fHumanizeVelocityValue );
 	rootNode.write_float( "swing_factor", m_fSwingFactor );
+	rootNode.write_int( "randomSeed", m_nRandomSeed );
 
 	// "drumkit_info" instead of "drumkit" seem unintuitive but is dictated by a
 	// ancient design desicion and we will stick to it.
@@ -1021,31 +1059,108 @@ void Song::clearMissingSamples() {
 	}
 }
 
-void Song::loadTempPatternList( const QString& sFilename )
+std::shared_ptr<const Song::SequenceSnapshot> Song::getSequenceSnapshot() const
 {
-	XMLDoc doc;
-	if( !doc.read( sFilename ) ) {
-		return;
+	std::unordered_map<const Pattern*, int> patternNumbers;
+	for ( int ii = 0; ii < m_pPatternList->size(); ++ii ) {
+		patternNumbers[ m_pPatternList->get( ii ) ] = ii;
 	}
-	XMLNode root = doc.firstChildElement( "sequence" );
-	if ( root.isNull() ) {
-		ERRORLOG( "sequence node not found" );
-		return;
+
+	auto pSnapshot = std::make_shared<SequenceSnapshot>();
+	pSnapshot->columns.reserve( m_pPatternGroupSequence->size() );
+
+	for ( int ii = 0; ii < m_pPatternGroupSequence->size(); ++ii ) {
+		std::vector<int> column;
+		for ( const auto& ppPattern : *( *m_pPatternGroupSequence )[ ii ] ) {
+			const auto it = patternNumbers.find( ppPattern );
+			if ( it != patternNumbers.end() ) {
+				column.push_back( it->second );
+			}
+		}
+
+		// Share unaltered columns with the previous snapshot.
+		if ( m_pLastSequenceSnapshot != nullptr &&
+			 ii < m_pLastSequenceSnapshot->columns.size() &&
+			 *m_pLastSequenceSnapshot->columns[ ii ] == column ) {
+			pSnapshot->columns.push_back( m_pLastSequenceSnapshot->columns[ ii ] );
+		} else {
+			pSnapshot->columns.push_back(
+				std::make_shared<const std::vector<int>>( std::move( column ) ) );
+		}
 	}
 
-	loadVirtualPatternsFrom( root, false );
-	loadPatternGroupVectorFrom( root, false );
+	for ( int ii = 0; ii < m_pPatternList->size(); ++ii ) {
+		const auto pVirtualPatterns =
+			m_pPatternList->get( ii )->get_virtual_patterns();
+		if ( pVirtualPatterns->empty() ) {
+			continue;
+		}
+		std::vector<int> virtualPatterns;
+		for ( const auto& ppVirtualPattern : *pVirtualPatterns ) {
+			const auto it = patternNumbers.find( ppVirtualPattern );
+			if ( it != patternNumbers.end() ) {
+				virtualPatterns.push_back( it->second );
+			}
+		}
+		pSnapshot->virtualPatterns.push_back(
+			std::make_pair( ii, std::move( virtualPatterns ) ) );
+	}
+
+	m_pLastSequenceSnapshot = pSnapshot;
+	return pSnapshot;
 }
 
-bool Song::saveTempPatternList( const QString& sFilename ) const
+void Song::setSequenceSnapshot( std::shared_ptr<const SequenceSnapshot> pSnapshot )
 {
-	XMLDoc doc;
-	XMLNode root = doc.set_root( "sequence" );
+	if ( pSnapshot == nullptr ) {
+		ERRORLOG( "Invalid snapshot" );
+		return;
+	}
+
+	const int nPatterns = m_pPatternList->size();
+
+	// Virtual patterns are restored first since they determine which
+	// patterns can be added to a column.
+	for ( const auto& ppPattern : *m_pPatternList ) {
+		ppPattern->virtual_patterns_clear();
+	}
+	for ( const auto& [ nPattern, virtualPatterns ] : pSnapshot->virtualPatterns ) {
+		if ( nPattern < 0 || nPattern >= nPatterns ) {
+			ERRORLOG( QString( "Pattern [%1] out of bound [0,%2]" )
+					  .arg( nPattern ).arg( nPatterns - 1 ) );
+			continue;
+		}
+		auto pPattern = m_pPatternList->get( nPattern );
+		for ( const int nnVirtualPattern : virtualPatterns ) {
+			if ( nnVirtualPattern >= 0 && nnVirtualPattern < nPatterns ) {
+				pPattern->virtual_patterns_add(
+					m_pPatternList->get( nnVirtualPattern ) );
+			}
+		}
+	}
+	m_pPatternList->flattened_virtual_patterns_compute();
 
-	saveVirtualPatternsTo( root, false );
-	savePatternGroupVectorTo( root, false );
+	for ( auto& ppColumn : *m_pPatternGroupSequence ) {
+		ppColumn->clear();
+		delete ppColumn;
+	}
+	m_pPatternGroupSequence->clear();
+	m_pPatternGroupSequence->reserve( pSnapshot->columns.size() );
+
+	for ( const auto& ppColumn : pSnapshot->columns ) {
+		auto pPatternList = new PatternList();
+		for ( const int nnPattern : *ppColumn ) {
+			if ( nnPattern >= 0 && nnPattern < nPatterns ) {
+				pPatternList->add( m_pPatternList->get( nnPattern ) );
+			} else {
+				ERRORLOG( QString( "Pattern [%1] out of bound [0,%2]" )
+						  .arg( nnPattern ).arg( nPatterns - 1 ) );
+			}
+		}
+		m_pPatternGroupSequence->push_back( pPatternList );
+	}
 
-	return doc.write( sFilename );
+	m_pLastSequenceSnapshot = pSnapshot;
 }
 
 void Song::setPanLawKNorm( float fKNorm ) {
@@ -1224,13 +1339,10 @@ QString Song::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_fHumanizeVelocityValue ) )
 			.append( QString( "%1%2m_fSwingFactor: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_fSwingFactor ) )
+			.append( QString( "%1%2m_nRandomSeed: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nRandomSeed ) )
 			.append( QString( "%1%2m_bIsModified: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_bIsModified ) )
-			.append( QString( "%1%2m_latestRoundRobins\n" ).arg( sPrefix ).arg( s ) );
-		for ( const auto& mm : m_latestRoundRobins ) {
-			sOutput.append( QString( "%1%2%3 : %4\n" ).arg( sPrefix ).arg( s )
-					 .arg( mm.first ).arg( mm.second ) );
-		}
+					 .arg( m_bIsModified ) );
 		sOutput.append( QString( "%1%2m_mode: %3\n" ).arg( sPrefix ).arg( s )
 						.arg( ModeToQString( m_mode ) ) )
 			.append( QString( "%1%2m_sPlaybackTrackFilename: %3\n" ).arg( sPrefix ).arg( s )
@@ -1292,11 +1404,8 @@ QString Song::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", m_fHumanizeTimeValue: %1" ).arg( m_fHumanizeTimeValue ) )
 			.append( QString( ", m_fHumanizeVelocityValue: %1" ).arg( m_fHumanizeVelocityValue ) )
 			.append( QString( ", m_fSwingFactor: %1" ).arg( m_fSwingFactor ) )
-			.append( QString( ", m_bIsModified: %1" ).arg( m_bIsModified ) )
-			.append( QString( ", m_latestRoundRobins" ) );
-		for ( const auto& mm : m_latestRoundRobins ) {
-			sOutput.append( QString( ", %1 : %4" ).arg( mm.first ).arg( mm.second ) );
-		}
+			.append( QString( ", m_nRandomSeed: %1" ).arg( m_nRandomSeed ) )
+			.append( QString( ", m_bIsModified: %1" ).arg( m_bIsModified ) );
 		sOutput.append( QString( ", m_mode: %1" )
 						.arg( ModeToQString( m_mode ) ) )
 			.append( QString( ", m_sPlaybackTrackFilename: %1" ).arg( m_sPlaybackTrackFilename ) )
@@ -155,6 +155,10 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 	 *   warnings are suppressed.
 	 */
 	bool 			save( const QString& sFilename, bool bSilent = false );
+	/** Assembles the XML document written by save() without writing it
+	 * to disk or altering the filename and modification state of the
+	 * song. */
+	std::unique_ptr<XMLDoc> toXMLDoc( bool bSilent = false ) const;
 
 		static constexpr int nDefaultResolution = 48;
 	bool getIsTimelineActivated() const;
@@ -236,6 +240,9 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 		float			getSwingFactor() const;
 		void			setSwingFactor( float fFactor );
 
+		int				getRandomSeed() const;
+		void			setRandomSeed( int nSeed );
+
 		const Mode&		getMode() const;
 		void			setMode( const Mode& mode );
 							
@@ -244,11 +251,29 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 
 		AutomationPath*	getVelocityAutomationPath() const;
 
-		void			loadTempPatternList( const QString& sFilename );
-		bool			saveTempPatternList( const QString& sFilename ) const;
-							
-		int			getLatestRoundRobin( float fStartVelocity ) const;
-		void			setLatestRoundRobin( float fStartVelocity, int nLatestRoundRobin );
+		/** Immutable in-memory copy of the pattern group vector and
+		 * the virtual patterns. Patterns are referenced by their
+		 * position in #m_pPatternList.
+		 *
+		 * Used by the undo history to restore the song structure
+		 * without writing it to disk. Columns which did not change
+		 * between two consecutive snapshots are shared by both. */
+		struct SequenceSnapshot {
+			/** Pattern numbers contained in each column. */
+			std::vector<std::shared_ptr<const std::vector<int>>> columns;
+			/** Pattern numbers along with the numbers of all patterns
+			 * they directly contain as virtual patterns. */
+			std::vector<std::pair<int, std::vector<int>>> virtualPatterns;
+		};
+		std::shared_ptr<const SequenceSnapshot> getSequenceSnapshot() const;
+		/** Replaces the pattern group vector and virtual patterns by the
+		 * ones stored in @a pSnapshot.
+		 *
+		 * The pattern list has to be in the same state as at the
+		 * creation of @a pSnapshot and the caller has to care for the
+		 * audio engine lock. */
+		void setSequenceSnapshot( std::shared_ptr<const SequenceSnapshot> pSnapshot );
+
 		/** \return #m_sPlaybackTrackFilename */
 		const QString&		getPlaybackTrackFilename() const;
 		/** \param sFilename Sets #m_sPlaybackTrackFilename. */
@@ -291,6 +316,28 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 		const QString& getLastLoadedDrumkitPath() const;
 		void setLastLoadedDrumkitPath( const QString& sPath );
 
+		/** Settings of a single LADSPA FX slot read from a song file. */
+		struct LadspaFXSetting {
+			int nSlot;
+			QString sFilename;
+			QString sName;
+			bool bEnabled;
+			float fVolume;
+			std::vector<std::pair<QString, float>> inputControlValues;
+		};
+
+		/**
+		 * Replaces the global #Effects by the LADSPA FX read from the
+		 * song file.
+		 *
+		 * Loading a song - e.g. while preloading upcoming playlist
+		 * songs - does not touch the effects of the song currently
+		 * played back. Instead, they are set up by Hydrogen::setSong()
+		 * using this function. Only the first call after loading has an
+		 * effect.
+		 */
+		void applyLadspaFX();
+
 		/** Formatted string version for debugging purposes.
 		 * \param sPrefix String prefix which will be added in front of
 		 * every new line
@@ -344,6 +391,9 @@ private:
 		PatternList*	m_pPatternList;
 		///< Sequence of pattern groups
 		std::vector<PatternList*>* m_pPatternGroupSequence;
+		/** Most recent snapshot. Its columns are reused by the next
+		 * call to getSequenceSnapshot(). */
+		mutable std::shared_ptr<const SequenceSnapshot> m_pLastSequenceSnapshot;
 
 		/** Current drumkit
 		 *
@@ -376,8 +426,14 @@ private:
 		 */
 		float			m_fHumanizeVelocityValue;
 		float			m_fSwingFactor;
+		/**
+		 * Seed of the random numbers used for humanization, note
+		 * probability, and random layer selection during export. It is
+		 * stored in the song file in order to render the same song
+		 * bit-identical each time it is exported.
+		 */
+		int				m_nRandomSeed;
 		bool			m_bIsModified;
-		std::map< float, int> 	m_latestRoundRobins;
 		Mode			m_mode;
 		
 		/** Name of the file to be loaded as playback track.
@@ -444,6 +500,10 @@ private:
 	 */
 	QString m_sLastLoadedDrumkitPath;
 
+	/** LADSPA FX read by loadFrom() not yet applied by applyLadspaFX(). */
+	std::vector<LadspaFXSetting> m_ladspaFXSettings;
+	bool m_bLadspaFXPending;
+
 		/** Used to indicate changes in the underlying XSD file. */
 		static constexpr int nCurrentFormatVersion = 2;
 };
@@ -653,33 +713,29 @@ inline float Song::getSwingFactor() const
 	return m_fSwingFactor;
 }
 
-inline const Song::Mode& Song::getMode() const
+inline int Song::getRandomSeed() const
 {
-	return m_mode;
+	return m_nRandomSeed;
 }
 
-inline void Song::setMode( const Song::Mode& mode )
+inline void Song::setRandomSeed( int nSeed )
 {
-	m_mode = mode;
+	m_nRandomSeed = nSeed;
 }
 
-inline AutomationPath* Song::getVelocityAutomationPath() const
+inline const Song::Mode& Song::getMode() const
 {
-	return m_pVelocityAutomationPath;
+	return m_mode;
 }
 
-inline int Song::getLatestRoundRobin( float fStartVelocity ) const
+inline void Song::setMode( const Song::Mode& mode )
 {
-	if ( m_latestRoundRobins.find( fStartVelocity ) == m_latestRoundRobins.end() ) {
-		return 0;
-	} else {
-		return m_latestRoundRobins.at( fStartVelocity );
-	}
+	m_mode = mode;
 }
 
-inline void Song::setLatestRoundRobin( float fStartVelocity, int nLatestRoundRobin )
+inline AutomationPath* Song::getVelocityAutomationPath() const
 {
-	m_latestRoundRobins[ fStartVelocity ] = nLatestRoundRobin;
+	return m_pVelocityAutomationPath;
 }
 
 inline const QString& Song::getPlaybackTrackFilename() const
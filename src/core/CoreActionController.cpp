@@ -38,6 +38,7 @@
 #include "core/OscServer.h"
 #include <core/MidiAction.h>
 #include "core/MidiMap.h"
+#include <core/Helpers/PlaylistPreloader.h>
 #include <core/Helpers/Xml.h>
 #include <core/SoundLibrary/SoundLibraryDatabase.h>
 
@@ -583,6 +584,12 @@ std::shared_ptr<Song> CoreActionController::loadSong( const QString& sPath,
 		}
 	}
 
+	if ( pSong == nullptr ) {
+		// Upcoming songs of the current playlist are loaded in the
+		// background beforehand.
+		pSong = pHydrogen->getPlaylistPreloader()->take( sPath );
+	}
+
 	if ( pSong == nullptr ) {
 		pSong = Song::load( sPath );
 	}
@@ -1115,7 +1122,42 @@ bool CoreActionController::setDrumkit( const QString& sDrumkit ) {
 	return setDrumkit( pDrumkit );
 }
 
-bool CoreActionController::setDrumkit( std::shared_ptr<Drumkit> pNewDrumkit ) {
+bool CoreActionController::switchDrumkit( const QString& sDrumkit,
+										  const DrumkitSwitcher::Quantization& quantization ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	ASSERT_HYDROGEN
+	auto pDrumkit = pHydrogen->getSoundLibraryDatabase()
+		->getDrumkit( sDrumkit );
+	if ( pDrumkit == nullptr ) {
+		ERRORLOG( QString( "Drumkit [%1] could not be loaded." )
+				  .arg( sDrumkit ) );
+		return false;
+	}
+
+	return switchDrumkit( pDrumkit, quantization );
+}
+
+bool CoreActionController::switchDrumkit( std::shared_ptr<Drumkit> pDrumkit,
+										  const DrumkitSwitcher::Quantization& quantization ) {
+	if ( pDrumkit == nullptr ) {
+		ERRORLOG( "Provided Drumkit is not valid" );
+		return false;
+	}
+
+	auto pHydrogen = Hydrogen::get_instance();
+	ASSERT_HYDROGEN
+	if ( pHydrogen->getSong() == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return false;
+	}
+
+	pHydrogen->getDrumkitSwitcher()->request( pDrumkit, quantization );
+
+	return true;
+}
+
+bool CoreActionController::setDrumkit( std::shared_ptr<Drumkit> pNewDrumkit,
+									   bool bRingOut ) {
 	if ( pNewDrumkit == nullptr ) {
 		ERRORLOG( "Provided Drumkit is not valid" );
 		return false;
@@ -1153,8 +1195,10 @@ bool CoreActionController::setDrumkit( std::shared_ptr<Drumkit> pNewDrumkit ) {
 	// of Rubberband end up with a wrong sample length. But this is an
 	// edge-case and the regular user will benefit from a load prior to
 	// the locking resulting in lesser XRUNs.
-	pNewDrumkit->loadSamples(
-		pAudioEngine->getTransportPosition()->getBpm());
+	if ( ! bRingOut || ! pNewDrumkit->areSamplesLoaded() ) {
+		pNewDrumkit->loadSamples(
+			pAudioEngine->getTransportPosition()->getBpm());
+	}
 
 	pAudioEngine->lock( RIGHT_HERE );
 
@@ -1170,8 +1214,10 @@ bool CoreActionController::setDrumkit( std::shared_ptr<Drumkit> pNewDrumkit ) {
 	// Instead of letting all notes associated with this instrument ring till
 	// the end, we discard those for which playback did not started yet and make
 	// the remaining ones enter ADSR release phase.
-	pAudioEngine->clearNoteQueues();
-	pAudioEngine->getSampler()->releasePlayingNotes();
+	if ( ! bRingOut ) {
+		pAudioEngine->clearNoteQueues();
+		pAudioEngine->getSampler()->releasePlayingNotes();
+	}
 
 	pSong->setDrumkit( pNewDrumkit );
 	pSong->getPatternList()->mapTo( pNewDrumkit );
@@ -2123,7 +2169,7 @@ bool CoreActionController::toggleGridCell( int nColumn, int nRow ){
 	
 	// Update the SongEditor.
 	if ( pHydrogen->getGUIState() != Hydrogen::GUIState::headless ) {
-		EventQueue::get_instance()->push_event( EVENT_GRID_CELL_TOGGLED, 0 );
+		EventQueue::get_instance()->push_event( EVENT_GRID_CELL_TOGGLED, nColumn );
 	}
 
 	return true;
@@ -2313,6 +2359,8 @@ bool CoreActionController::setPlaylist( std::shared_ptr<Playlist> pPlaylist ) {
 		return false;
 	}
 	pHydrogen->setPlaylist( pPlaylist );
+	pHydrogen->getPlaylistPreloader()->update(
+		pPlaylist, pPlaylist->getActiveSongNumber() );
 
 	if ( pPlaylist->getFilename() ==
 		 Filesystem::empty_path( Filesystem::Type::Playlist ) ) {
@@ -2395,6 +2443,8 @@ bool CoreActionController::addToPlaylist( std::shared_ptr<PlaylistEntry> pEntry,
 	}
 
 	pPlaylist->setIsModified( true );
+	pHydrogen->getPlaylistPreloader()->update(
+		pPlaylist, pPlaylist->getActiveSongNumber() );
 	EventQueue::get_instance()->push_event( EVENT_PLAYLIST_CHANGED, 0 );
 	return true;
 
@@ -2417,6 +2467,8 @@ bool CoreActionController::removeFromPlaylist( std::shared_ptr<PlaylistEntry> pE
 	}
 
 	pPlaylist->setIsModified( true );
+	pHydrogen->getPlaylistPreloader()->update(
+		pPlaylist, pPlaylist->getActiveSongNumber() );
 	EventQueue::get_instance()->push_event( EVENT_PLAYLIST_CHANGED, 0 );
 	return true;
 
@@ -2438,6 +2490,8 @@ bool CoreActionController::activatePlaylistSong( int nSongNumber ) {
 	EventQueue::get_instance()->push_event( H2Core::EVENT_PLAYLIST_LOADSONG,
 											nSongNumber );
 
+	pHydrogen->getPlaylistPreloader()->update( pPlaylist, nSongNumber );
+
 	return true;
 }
 }
@@ -27,6 +27,7 @@
 #include <memory>
 
 #include <core/Object.h>
+#include <core/Helpers/DrumkitSwitcher.h>
 
 namespace H2Core
 {
@@ -276,8 +277,34 @@ class CoreActionController : public H2Core::Object<CoreActionController> {
 	 * drumkit to its default values.
 	 *
 	 * \param pDrumkit Full-fledged #H2Core::Drumkit to load.
+	 * \param bRingOut If set to false, notes of the previous kit not
+	 *   started yet are discarded and all others are released. If
+	 *   true, they are rendered till the end instead. Samples of @a
+	 *   pDrumkit already loaded are not loaded again.
 	 */
-	static bool setDrumkit( std::shared_ptr<Drumkit> pDrumkit );
+	static bool setDrumkit( std::shared_ptr<Drumkit> pDrumkit,
+							bool bRingOut = false );
+	/** Wrapper around switchDrumkit() that allows loading drumkits by
+	 *	name or path.
+	 *
+	 * \see setDrumkit( const QString& ) */
+	static bool switchDrumkit( const QString& sDrumkit,
+							   const DrumkitSwitcher::Quantization& quantization =
+							   DrumkitSwitcher::Quantization::Bar );
+	/**
+	 * Switches to @a pDrumkit in the background.
+	 *
+	 * In contrast to setDrumkit() the samples of @a pDrumkit are
+	 * loaded in a separate thread, the switch is done at the next beat
+	 * or bar (in case transport is rolling), and notes of the
+	 * previous kit ring out. It is intended for changing kits during
+	 * a performance. The function returns right away.
+	 *
+	 * \see DrumkitSwitcher
+	 */
+	static bool switchDrumkit( std::shared_ptr<Drumkit> pDrumkit,
+							   const DrumkitSwitcher::Quantization& quantization =
+							   DrumkitSwitcher::Quantization::Bar );
 	/** 
 	 * Upgrades the drumkit found at absolute path @a sDrumkitPath.
 	 *
@@ -498,7 +525,7 @@ class CoreActionController : public H2Core::Object<CoreActionController> {
 		static bool removeFromPlaylist( std::shared_ptr<PlaylistEntry> pEntry,
 								 int nIndex = -1 );
 		/** Does not load the corresponding song! Only marks it active in the
-		 * playlist.
+		 * playlist and starts preloading the songs following it.
 		 *
 		 * Song loading was split off to allow the GUI to show error dialogs in
 		 * case something went wrong. */
@@ -156,6 +156,8 @@ enum EventType {
 	EVENT_LOOP_MODE_ACTIVATION,
 	/** Switches between select mode (0) and draw mode (1) in the *SongEditor.*/
 	EVENT_ACTION_MODE_CHANGE,
+	/** A cell of the SongEditor grid was toggled. The value holds the
+		column of the cell.*/
 	EVENT_GRID_CELL_TOGGLED,
 	/** Triggered when transport is moved into a different column
 		(either during playback or when relocated by the user)*/
@@ -26,6 +26,7 @@
 
 #include <core/Preferences/Preferences.h>
 #include <core/FX/LadspaFX.h>
+#include <core/IO/RealtimeThread.h>
 #include <core/Hydrogen.h>
 #include <core/Basics/Song.h>
 #include <core/Helpers/Filesystem.h>
@@ -48,14 +49,31 @@ Effects* Effects::__instance = nullptr;
 Effects::Effects()
 		: m_pRootGroup( nullptr )
 		, m_pRecentGroup( nullptr )
+		, m_nJobCount( 0 )
+		, m_nTicket( 0 )
+		, m_nJobsDone( 0 )
+		, m_nJobFrames( 0 )
+		, m_nJobGeneration( 0 )
+		, m_bQuitWorkers( false )
 {
 	__instance = this;
 
 	for ( int nFX = 0; nFX < MAX_FX; ++nFX ) {
 		m_FXList[ nFX ] = nullptr;
+		m_jobs[ nFX ] = nullptr;
 	}
 
 	getPluginList();
+
+	// The audio thread itself processes effects as well. So, there is
+	// no need for more than MAX_FX - 1 workers.
+	const int nCores = static_cast<int>(std::thread::hardware_concurrency());
+	const int nWorkers = std::min( nCores - 1, MAX_FX - 1 );
+	for ( int ii = 0; ii < nWorkers; ++ii ) {
+		m_workers.push_back( std::thread( &Effects::workerLoop, this ) );
+	}
+	INFOLOG( QString( "Using [%1] worker threads for LADSPA processing" )
+			 .arg( m_workers.size() ) );
 }
 
 
@@ -73,6 +91,15 @@ void Effects::create_instance()
 Effects::~Effects()
 {
 	//INFOLOG( "DESTROY" );
+	{
+		std::lock_guard<std::mutex> lock( m_workerMutex );
+		m_bQuitWorkers = true;
+	}
+	m_workerCondition.notify_all();
+	for ( auto& worker : m_workers ) {
+		worker.join();
+	}
+
 	if ( m_pRootGroup != nullptr ) delete m_pRootGroup;
 
 	//INFOLOG( "destroying " + to_string( m_pluginList.size() ) + " LADSPA plugins" );
@@ -96,6 +123,102 @@ LadspaFX* Effects::getLadspaFX( int nFX ) const
 
 
 
+void Effects::processFX( uint32_t nFrames )
+{
+	int nJobs = 0;
+	for ( int nFX = 0; nFX < MAX_FX; ++nFX ) {
+		if ( m_FXList[ nFX ] != nullptr && m_FXList[ nFX ]->isEnabled() ) {
+			m_jobs[ nJobs ] = m_FXList[ nFX ];
+			++nJobs;
+		}
+	}
+
+	if ( nJobs < 2 || m_workers.size() == 0 ) {
+		// Not worth waking up any worker.
+		for ( int ii = 0; ii < nJobs; ++ii ) {
+			m_jobs[ ii ]->processFX( nFrames );
+		}
+		return;
+	}
+
+	m_nJobFrames = nFrames;
+	m_nJobCount.store( nJobs, std::memory_order_relaxed );
+	m_nJobsDone.store( 0, std::memory_order_relaxed );
+	++m_nJobGeneration;
+	// Publishes the jobs. Workers do only access them after they
+	// claimed an index of the current generation.
+	m_nTicket.store( static_cast<uint64_t>(m_nJobGeneration) << 32,
+					 std::memory_order_release );
+	// Notifying without holding the mutex keeps the audio thread from
+	// blocking. A worker missing the wakeup is harmless as all jobs
+	// not picked up are processed right here.
+	m_workerCondition.notify_all();
+
+	processJobs( m_nJobGeneration );
+
+	// All remaining jobs are already being processed by the
+	// (realtime) workers.
+	while ( m_nJobsDone.load( std::memory_order_acquire ) < nJobs ) {
+		std::this_thread::yield();
+	}
+}
+
+void Effects::processJobs( uint32_t nGeneration )
+{
+	uint64_t nTicket = m_nTicket.load( std::memory_order_acquire );
+	while ( true ) {
+		if ( static_cast<uint32_t>(nTicket >> 32) != nGeneration ) {
+			// A new cycle already started.
+			return;
+		}
+		const int nJob = static_cast<int>(nTicket & 0xFFFFFFFF);
+		if ( nJob >= m_nJobCount.load( std::memory_order_relaxed ) ) {
+			return;
+		}
+		if ( ! m_nTicket.compare_exchange_weak( nTicket, nTicket + 1,
+												std::memory_order_acq_rel,
+												std::memory_order_acquire ) ) {
+			continue;
+		}
+
+		// The ticket could only be claimed while the generation was
+		// still the current one. Since the audio thread waits for
+		// all claimed jobs, the batch can not be replaced while
+		// processing it.
+		m_jobs[ nJob ]->processFX( m_nJobFrames );
+		m_nJobsDone.fetch_add( 1, std::memory_order_release );
+		nTicket = m_nTicket.load( std::memory_order_acquire );
+	}
+}
+
+void Effects::workerLoop()
+{
+	// The audio thread waits for the jobs picked up by the workers.
+	// Running them with ordinary priority would cause priority
+	// inversion.
+	RealtimeThread::promote( "LADSPA worker",
+							 Preferences::get_instance()->m_nRealtimePriority );
+
+	uint32_t nLastGeneration = 0;
+	while ( true ) {
+		{
+			std::unique_lock<std::mutex> lock( m_workerMutex );
+			m_workerCondition.wait( lock, [&]() {
+				return m_bQuitWorkers ||
+					static_cast<uint32_t>(
+						m_nTicket.load( std::memory_order_acquire ) >> 32 ) !=
+					nLastGeneration; } );
+			if ( m_bQuitWorkers ) {
+				return;
+			}
+			nLastGeneration = static_cast<uint32_t>(
+				m_nTicket.load( std::memory_order_acquire ) >> 32 );
+		}
+
+		processJobs( nLastGeneration );
+	}
+}
+
 void  Effects::setLadspaFX( LadspaFX* pFX, int nFX )
 {
 	assert( nFX < MAX_FX );
@@ -30,6 +30,10 @@
 #include <core/Object.h>
 #include <core/FX/LadspaFX.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <cassert>
 
@@ -60,6 +64,19 @@ public:
 	std::vector<LadspaFXInfo*> getPluginList();
 	LadspaFXGroup* getLadspaFXGroup();
 
+	/**
+	 * Runs all enabled effects on the content of their buffers.
+	 *
+	 * Since the individual slots are independent of each other, they
+	 * are distributed among a pool of realtime worker threads. The
+	 * calling (audio) thread processes all slots not yet picked up by
+	 * a worker itself and only waits for those already being
+	 * processed.
+	 *
+	 * Must be called with the AudioEngine locked.
+	 */
+	void processFX( uint32_t nFrames );
+
 
 private:
 	/**
@@ -76,6 +93,33 @@ private:
 
 	LadspaFX* m_FXList[ MAX_FX ];
 
+	/** Worker threads used in processFX(). */
+	std::vector<std::thread> m_workers;
+	/** Effects to be processed in the current cycle. */
+	LadspaFX* m_jobs[ MAX_FX ];
+	std::atomic<int> m_nJobCount;
+	/**
+	 * Generation of the current batch of jobs (upper 32 bits) and
+	 * index of the next job in #m_jobs to be picked up (lower 32
+	 * bits).
+	 *
+	 * Both are claimed together using a single compare-and-swap. A
+	 * thread still holding a ticket of a previous cycle can thus not
+	 * pick up a job of the current one.
+	 */
+	std::atomic<uint64_t> m_nTicket;
+	std::atomic<int> m_nJobsDone;
+	uint32_t m_nJobFrames;
+	/** Generation of the current batch. Only used by the audio thread. */
+	uint32_t m_nJobGeneration;
+	std::atomic<bool> m_bQuitWorkers;
+	std::mutex m_workerMutex;
+	std::condition_variable m_workerCondition;
+
+	void workerLoop();
+	/** Processes jobs of generation @a nGeneration till none is left.*/
+	void processJobs( uint32_t nGeneration );
+
 	Effects();
 
 	void RDFDescend( const QString& sBase, LadspaFXGroup *pGroup, std::vector<LadspaFXInfo*> pluginList );
@@ -0,0 +1,201 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Helpers/AutoSaver.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Xml.h>
+
+#include <QCryptographicHash>
+#include <QSaveFile>
+
+namespace H2Core
+{
+
+AutoSaver::AutoSaver()
+	: m_bBusy( false )
+	, m_bShutdown( false )
+	, m_nWrites( 0 )
+	, m_nSkips( 0 ) {
+	m_worker = std::thread( &AutoSaver::workerLoop, this );
+}
+
+AutoSaver::~AutoSaver() {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+	}
+	m_jobAdded.notify_one();
+	if ( m_worker.joinable() ) {
+		m_worker.join();
+	}
+}
+
+void AutoSaver::save( const QString& sFilename, std::unique_ptr<XMLDoc> pDoc ) {
+	if ( sFilename.isEmpty() || pDoc == nullptr ) {
+		ERRORLOG( "Invalid job" );
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		bool bReplaced = false;
+		for ( auto& jjob : m_jobs ) {
+			if ( jjob.sFilename == sFilename ) {
+				jjob.pDoc = std::move( pDoc );
+				bReplaced = true;
+				break;
+			}
+		}
+		if ( ! bReplaced ) {
+			m_jobs.push_back( { sFilename, std::move( pDoc ) } );
+		}
+	}
+	m_jobAdded.notify_one();
+}
+
+void AutoSaver::remove( const QString& sFilename ) {
+	if ( sFilename.isEmpty() ) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock( m_mutex );
+	for ( auto it = m_jobs.begin(); it != m_jobs.end(); ) {
+		if ( it->sFilename == sFilename ) {
+			it = m_jobs.erase( it );
+		} else {
+			++it;
+		}
+	}
+
+	// The job currently processed might target the very same file.
+	m_jobsDone.wait( lock, [&]() { return ! m_bBusy; } );
+
+	m_hashes.erase( sFilename );
+	if ( Filesystem::file_exists( sFilename, true ) ) {
+		Filesystem::rm( sFilename );
+	}
+}
+
+void AutoSaver::waitForPendingJobs() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_jobsDone.wait( lock, [&]() { return m_jobs.empty() && ! m_bBusy; } );
+}
+
+int AutoSaver::getWriteCount() const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nWrites;
+}
+
+int AutoSaver::getSkipCount() const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nSkips;
+}
+
+void AutoSaver::workerLoop() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( true ) {
+		m_jobAdded.wait( lock, [&]() { return m_bShutdown || ! m_jobs.empty(); } );
+		if ( m_jobs.empty() ) {
+			// Shutdown requested and all jobs are done.
+			break;
+		}
+
+		Job job = std::move( m_jobs.front() );
+		m_jobs.pop_front();
+		m_bBusy = true;
+
+		lock.unlock();
+		process( job );
+		// The document is released outside of the lock as well.
+		job.pDoc.reset();
+		lock.lock();
+
+		m_bBusy = false;
+		m_jobsDone.notify_all();
+	}
+}
+
+void AutoSaver::process( const Job& job ) {
+	const QByteArray content = job.pDoc->toString().toUtf8();
+	const QByteArray hash =
+		QCryptographicHash::hash( content, QCryptographicHash::Sha1 );
+
+	const auto it = m_hashes.find( job.sFilename );
+	if ( it != m_hashes.end() && it->second == hash &&
+		 Filesystem::file_exists( job.sFilename, true ) ) {
+		std::lock_guard<std::mutex> lock( m_mutex );
+		++m_nSkips;
+		return;
+	}
+
+	// QSaveFile writes into a temporary file within the same folder,
+	// syncs it to disk, and renames it on commit().
+	QSaveFile file( job.sFilename );
+	if ( ! file.open( QIODevice::WriteOnly ) ) {
+		ERRORLOG( QString( "Unable to open [%1] for writing: %2" )
+				  .arg( job.sFilename ).arg( file.errorString() ) );
+		return;
+	}
+	if ( file.write( content ) != content.size() ) {
+		ERRORLOG( QString( "Unable to write [%1]: %2" )
+				  .arg( job.sFilename ).arg( file.errorString() ) );
+		file.cancelWriting();
+		return;
+	}
+	if ( ! file.commit() ) {
+		ERRORLOG( QString( "Unable to commit [%1]: %2" )
+				  .arg( job.sFilename ).arg( file.errorString() ) );
+		return;
+	}
+
+	m_hashes[ job.sFilename ] = hash;
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	++m_nWrites;
+}
+
+QString AutoSaver::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	std::lock_guard<std::mutex> lock( m_mutex );
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[AutoSaver]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_jobs: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_jobs.size() ) )
+			.append( QString( "%1%2m_bBusy: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bBusy ) )
+			.append( QString( "%1%2m_nWrites: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nWrites ) )
+			.append( QString( "%1%2m_nSkips: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nSkips ) );
+	}
+	else {
+		sOutput = QString( "[AutoSaver] m_jobs: %1" ).arg( m_jobs.size() )
+			.append( QString( ", m_bBusy: %1" ).arg( m_bBusy ) )
+			.append( QString( ", m_nWrites: %1" ).arg( m_nWrites ) )
+			.append( QString( ", m_nSkips: %1" ).arg( m_nSkips ) );
+	}
+
+	return sOutput;
+}
+
+};
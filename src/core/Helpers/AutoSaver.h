@@ -0,0 +1,118 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_AUTO_SAVER_H
+#define H2C_AUTO_SAVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <QByteArray>
+#include <QString>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+class XMLDoc;
+
+/**
+ * Writes autosave files in the background.
+ *
+ * The caller only has to assemble the XML document of the song or
+ * playlist - which is a pure in-memory operation. Serializing it,
+ * writing it, and syncing it to disk is done by a worker thread. Files
+ * are replaced atomically using a temporary file and a subsequent
+ * rename. This way a crash during autosave never leaves a truncated
+ * file behind.
+ *
+ * The worker keeps a hash of the content last written to each file and
+ * skips writing whenever it did not change.
+ *
+ * \ingroup docCore
+ */
+class AutoSaver : public H2Core::Object<AutoSaver>
+{
+	H2_OBJECT(AutoSaver)
+public:
+	AutoSaver();
+	/** Finishes all pending jobs. */
+	~AutoSaver();
+
+	/** Queues @a pDoc to be written to @a sFilename. A write to the
+	 * same file which was not started yet is replaced by this one.
+	 *
+	 * Ownership of @a pDoc is passed to the worker thread. */
+	void save( const QString& sFilename, std::unique_ptr<XMLDoc> pDoc );
+	/** Drops all pending writes to @a sFilename and removes the file.
+	 *
+	 * Autosave files must be removed using this function instead of
+	 * deleting them directly. Else, a write still pending could
+	 * recreate them. In case the file is written right now, this
+	 * function blocks until the write is done. The file is gone once
+	 * it returns. */
+	void remove( const QString& sFilename );
+	/** Blocks until all queued jobs are done. */
+	void waitForPendingJobs();
+
+	/** Number of files written so far. */
+	int getWriteCount() const;
+	/** Number of writes skipped since the content did not change. */
+	int getSkipCount() const;
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Job {
+		QString sFilename;
+		std::unique_ptr<XMLDoc> pDoc;
+	};
+
+	void workerLoop();
+	void process( const Job& job );
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_jobAdded;
+	std::condition_variable m_jobsDone;
+	std::deque<Job> m_jobs;
+	/** Whether the worker is currently processing a job. */
+	bool m_bBusy;
+	bool m_bShutdown;
+	int m_nWrites;
+	int m_nSkips;
+
+	/** Hashes of the content last written to each file. Accessed by
+	 * the worker thread while #m_bBusy is set or while holding
+	 * #m_mutex otherwise. */
+	std::map<QString, QByteArray> m_hashes;
+
+	std::thread m_worker;
+};
+
+};
+
+#endif  // H2C_AUTO_SAVER_H
@@ -0,0 +1,318 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Helpers/DrumkitSwitcher.h>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/TransportPosition.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
+#include <core/Hydrogen.h>
+#include <core/IO/AudioOutput.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace H2Core
+{
+
+/** Interval in which the transport position is checked while waiting
+ * for the next beat or bar. */
+static constexpr auto pollInterval = std::chrono::milliseconds( 1 );
+/** Resolution of a single beat. */
+static constexpr int nTicksPerBeat = 48;
+
+QString DrumkitSwitcher::QuantizationToQString( const Quantization& quantization ) {
+	switch ( quantization ) {
+	case Quantization::None:
+		return "None";
+	case Quantization::Beat:
+		return "Beat";
+	case Quantization::Bar:
+		return "Bar";
+	default:
+		return QString( "Unknown quantization [%1]" )
+			.arg( static_cast<int>(quantization) );
+	}
+}
+
+DrumkitSwitcher::DrumkitSwitcher()
+	: m_pPendingJob( nullptr )
+	, m_pActiveJob( nullptr )
+	, m_bShutdown( false )
+	, m_bAbort( false ) {
+	m_worker = std::thread( &DrumkitSwitcher::workerLoop, this );
+}
+
+DrumkitSwitcher::~DrumkitSwitcher() {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+		m_pPendingJob = nullptr;
+		m_bAbort = true;
+	}
+	m_jobAdded.notify_one();
+	if ( m_worker.joinable() ) {
+		m_worker.join();
+	}
+}
+
+void DrumkitSwitcher::request( std::shared_ptr<Drumkit> pDrumkit,
+							   const Quantization& quantization ) {
+	if ( pDrumkit == nullptr ) {
+		ERRORLOG( "Invalid drumkit" );
+		return;
+	}
+
+	auto pJob = std::make_shared<Job>();
+	pJob->pDrumkit = pDrumkit;
+	pJob->pSong = Hydrogen::get_instance()->getSong();
+	pJob->quantization = quantization;
+
+	INFOLOG( QString( "Switching to drumkit [%1] at next [%2]" )
+			 .arg( pDrumkit->getName() )
+			 .arg( QuantizationToQString( quantization ) ) );
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_pPendingJob = pJob;
+		if ( m_pActiveJob != nullptr ) {
+			m_bAbort = true;
+		}
+	}
+	m_jobAdded.notify_one();
+}
+
+bool DrumkitSwitcher::isPending() const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_pPendingJob != nullptr || m_pActiveJob != nullptr;
+}
+
+std::shared_ptr<Drumkit> DrumkitSwitcher::getPendingDrumkit() const {
+	const auto pSong = Hydrogen::get_instance()->getSong();
+	std::lock_guard<std::mutex> lock( m_mutex );
+	const auto pJob = m_pPendingJob != nullptr ? m_pPendingJob : m_pActiveJob;
+	if ( pJob == nullptr || pJob->pSong != pSong ) {
+		return nullptr;
+	}
+	return pJob->pDrumkit;
+}
+
+void DrumkitSwitcher::waitForPendingJobs() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_jobsDone.wait( lock, [&]() {
+		return m_pPendingJob == nullptr && m_pActiveJob == nullptr; } );
+}
+
+bool DrumkitSwitcher::isAborted() const {
+	return m_bAbort;
+}
+
+void DrumkitSwitcher::workerLoop() {
+	while ( true ) {
+		std::shared_ptr<Job> pJob;
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_jobAdded.wait( lock, [&]() {
+				return m_bShutdown || m_pPendingJob != nullptr; } );
+			if ( m_bShutdown ) {
+				break;
+			}
+			pJob = m_pPendingJob;
+			m_pPendingJob = nullptr;
+			m_pActiveJob = pJob;
+			m_bAbort = false;
+		}
+
+		auto pHydrogen = Hydrogen::get_instance();
+		bool bSwitched = false;
+		if ( pHydrogen->getSong() == pJob->pSong && pJob->pSong != nullptr &&
+			 pJob->pSong->getDrumkit() != pJob->pDrumkit ) {
+			if ( loadSamples( pJob->pDrumkit ) &&
+				 waitForBoundary( pJob->quantization ) &&
+				 pHydrogen->getSong() == pJob->pSong ) {
+				bSwitched = CoreActionController::setDrumkit( pJob->pDrumkit, true );
+			}
+
+			if ( ! bSwitched ) {
+				INFOLOG( QString( "Switch to drumkit [%1] aborted" )
+						 .arg( pJob->pDrumkit->getName() ) );
+				// Do not keep samples of kits not used.
+				if ( pHydrogen->getSong() == nullptr ||
+					 pHydrogen->getSong()->getDrumkit() != pJob->pDrumkit ) {
+					pJob->pDrumkit->unloadSamples();
+				}
+			}
+		}
+		else {
+			INFOLOG( QString( "Request to switch to drumkit [%1] outdated" )
+					 .arg( pJob->pDrumkit->getName() ) );
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_pActiveJob = nullptr;
+		}
+		m_jobsDone.notify_all();
+	}
+}
+
+bool DrumkitSwitcher::loadSamples( std::shared_ptr<Drumkit> pDrumkit ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pInstruments = pDrumkit->getInstruments();
+	const int nInstruments = pInstruments->size();
+	const float fBpm = pHydrogen->getAudioEngine()->
+		getTransportPosition()->getBpm();
+
+	// Instruments of a kit switched back to might still be waiting for
+	// their samples to be unloaded.
+	for ( const auto& ppInstrument : *pInstruments ) {
+		pHydrogen->removeInstrumentFromDeathRow( ppInstrument );
+	}
+
+	INFOLOG( QString( "Loading samples of drumkit [%1]" )
+			 .arg( pDrumkit->getName() ) );
+
+	std::atomic<int> nNextInstrument( 0 );
+	auto loadInstruments = [&]() {
+		int nInstrument;
+		while ( ! isAborted() &&
+				( nInstrument = nNextInstrument++ ) < nInstruments ) {
+			auto pInstrument = pInstruments->get( nInstrument );
+			if ( pInstrument != nullptr ) {
+				pInstrument->load_samples( fBpm );
+			}
+		}
+	};
+
+	const int nThreads = std::clamp(
+		static_cast<int>( std::thread::hardware_concurrency() ), 1,
+		std::max( nInstruments, 1 ) );
+	std::vector<std::thread> threads;
+	for ( int nn = 1; nn < nThreads; ++nn ) {
+		threads.emplace_back( loadInstruments );
+	}
+	loadInstruments();
+	for ( auto& thread : threads ) {
+		thread.join();
+	}
+
+	return ! isAborted();
+}
+
+bool DrumkitSwitcher::waitForBoundary( const Quantization& quantization ) {
+	if ( quantization == Quantization::None ) {
+		return ! isAborted();
+	}
+
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	auto pPos = pAudioEngine->getTransportPosition();
+
+	// Notes are queued one lookahead ahead of the transport
+	// position. The switch has to happen before the first note at the
+	// boundary is queued. The duration of an additional buffer is
+	// added to account for the current process cycle.
+	auto getMargin = [&]() {
+		auto pDriver = pAudioEngine->getAudioDriver();
+		const double fBufferSize = pDriver != nullptr ?
+			static_cast<double>( pDriver->getBufferSize() ) : 0;
+		return AudioEngine::getLeadLagInTicks() +
+			( AudioEngine::nMaxTimeHumanize + 2 * fBufferSize ) /
+			std::max( static_cast<double>( pPos->getTickSize() ), 1.0 );
+	};
+
+	// Boundaries are aligned to the start of the current pattern.
+	auto getNextBoundary = [&]( double fTick ) {
+		const double fPatternStart = pPos->getPatternStartTick();
+		const double fUnit = quantization == Quantization::Bar ?
+			std::max( pPos->getPatternSize(), 1 ) : nTicksPerBeat;
+		return fPatternStart + fUnit *
+			( std::floor( ( fTick - fPatternStart ) / fUnit ) + 1 );
+	};
+
+	double fTick = pPos->getDoubleTick();
+	double fBoundary = getNextBoundary( fTick );
+	if ( fBoundary - fTick < getMargin() ) {
+		// Notes at the next boundary might already be queued. Use the
+		// one after it.
+		fBoundary = getNextBoundary( fBoundary );
+	}
+
+	while ( ! isAborted() ) {
+		if ( pAudioEngine->getState() != AudioEngine::State::Playing ) {
+			return true;
+		}
+
+		const double fCurrentTick = pPos->getDoubleTick();
+		if ( fCurrentTick < fTick ) {
+			// Transport was relocated.
+			return true;
+		}
+		fTick = fCurrentTick;
+
+		if ( fBoundary - fTick <= getMargin() ) {
+			return true;
+		}
+
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_jobAdded.wait_for( lock, pollInterval, [&]() {
+			return m_bShutdown || m_pPendingJob != nullptr; } );
+	}
+
+	return false;
+}
+
+QString DrumkitSwitcher::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	std::lock_guard<std::mutex> lock( m_mutex );
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[DrumkitSwitcher]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_pPendingJob: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pPendingJob != nullptr &&
+						   m_pPendingJob->pDrumkit != nullptr ?
+						   m_pPendingJob->pDrumkit->getName() : "nullptr" ) )
+			.append( QString( "%1%2m_pActiveJob: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pActiveJob != nullptr &&
+						   m_pActiveJob->pDrumkit != nullptr ?
+						   m_pActiveJob->pDrumkit->getName() : "nullptr" ) );
+	} else {
+		sOutput = QString( "[DrumkitSwitcher]" )
+			.append( QString( " m_pPendingJob: %1" )
+					 .arg( m_pPendingJob != nullptr &&
+						   m_pPendingJob->pDrumkit != nullptr ?
+						   m_pPendingJob->pDrumkit->getName() : "nullptr" ) )
+			.append( QString( ", m_pActiveJob: %1" )
+					 .arg( m_pActiveJob != nullptr &&
+						   m_pActiveJob->pDrumkit != nullptr ?
+						   m_pActiveJob->pDrumkit->getName() : "nullptr" ) );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,129 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_DRUMKIT_SWITCHER_H
+#define H2C_DRUMKIT_SWITCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+class Drumkit;
+class Song;
+
+/**
+ * Switches the drumkit of the current song in the background.
+ *
+ * CoreActionController::setDrumkit() decodes all samples of the new
+ * kit on the caller's thread and cuts off all notes of the previous
+ * one. This is fine while editing a song but not during a
+ * performance. Instead, the worker thread of this class loads the
+ * samples of the requested kit using several threads in parallel,
+ * waits for the next beat or bar (while transport is rolling), and
+ * performs the switch right before the audio engine starts queuing
+ * notes of this boundary. Notes of the previous kit ring out and
+ * the #InstrumentReclaimer unloads their samples afterwards.
+ *
+ * Only the latest request is honored. Requests arriving while another
+ * one is still pending supersede it.
+ *
+ * \ingroup docCore
+ */
+class DrumkitSwitcher : public H2Core::Object<DrumkitSwitcher>
+{
+	H2_OBJECT(DrumkitSwitcher)
+public:
+	/** Position at which the kit is switched. */
+	enum class Quantization {
+		/** As soon as the samples are loaded. */
+		None,
+		Beat,
+		Bar
+	};
+	static QString QuantizationToQString( const Quantization& quantization );
+
+	DrumkitSwitcher();
+	/** Aborts the pending switch. */
+	~DrumkitSwitcher();
+
+	/** Switches the drumkit of the current song to @a pDrumkit. */
+	void request( std::shared_ptr<Drumkit> pDrumkit,
+				  const Quantization& quantization = Quantization::Bar );
+	/** Whether a switch is pending. */
+	bool isPending() const;
+	/** Kit of the latest request for the current song not switched to
+	 * yet.
+	 *
+	 * \return nullptr in case no switch is pending. */
+	std::shared_ptr<Drumkit> getPendingDrumkit() const;
+	/** Blocks until the pending switch is done or was aborted. */
+	void waitForPendingJobs();
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Job {
+		std::shared_ptr<Drumkit> pDrumkit;
+		/** Song the switch was requested for. The request is dropped in
+		 * case a different one was loaded in the meantime. */
+		std::shared_ptr<Song> pSong;
+		Quantization quantization;
+	};
+
+	void workerLoop();
+	/** Loads the samples of all instruments of @a pDrumkit in
+	 * parallel.
+	 *
+	 * \return false in case loading was superseded by another
+	 *   request. */
+	bool loadSamples( std::shared_ptr<Drumkit> pDrumkit );
+	/** Waits till transport is about to reach the next beat or bar.
+	 *
+	 * \return false in case waiting was superseded by another
+	 *   request. */
+	bool waitForBoundary( const Quantization& quantization );
+	/** Whether the job processed by the worker was superseded. */
+	bool isAborted() const;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_jobAdded;
+	std::condition_variable m_jobsDone;
+	/** Request not yet picked up by the worker. */
+	std::shared_ptr<Job> m_pPendingJob;
+	/** Request processed by the worker right now. */
+	std::shared_ptr<Job> m_pActiveJob;
+	bool m_bShutdown;
+	std::atomic<bool> m_bAbort;
+
+	std::thread m_worker;
+};
+
+};
+
+#endif  // H2C_DRUMKIT_SWITCHER_H
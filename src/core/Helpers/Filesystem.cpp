@@ -38,6 +38,13 @@
 #include <core/NsmClient.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 // directories
 #define LOCAL_DATA_PATH "data/"
 #define CACHE           "cache/"
@@ -56,6 +63,7 @@
 #define THEMES          "themes/"
 #define TMP             "hydrogen/"
 #define XSD             "xsd/"
+#define XRUNS           "xruns/"
 
 
 // files
@@ -429,6 +437,56 @@ bool Filesystem::write_to_file( const QString& dst, const QString& content )
 	return true;
 }
 
+bool Filesystem::copyFileInKernel( const QString& sSource,
+								   const QString& sDestination ) {
+#ifdef Q_OS_LINUX
+	const int nSource = open( QFile::encodeName( sSource ).constData(),
+							  O_RDONLY | O_CLOEXEC );
+	if ( nSource < 0 ) {
+		return false;
+	}
+	struct stat sourceStat;
+	if ( fstat( nSource, &sourceStat ) != 0 ) {
+		close( nSource );
+		return false;
+	}
+
+	const QByteArray destination = QFile::encodeName( sDestination );
+	const int nDestination = open( destination.constData(),
+								   O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+								   sourceStat.st_mode & 0777 );
+	if ( nDestination < 0 ) {
+		close( nSource );
+		return false;
+	}
+
+	// Data is moved between both files without passing user space.
+	bool bOk = true;
+	off_t nOffset = 0;
+	while ( nOffset < sourceStat.st_size ) {
+		const ssize_t nCopied = sendfile( nDestination, nSource, &nOffset,
+										  sourceStat.st_size - nOffset );
+		if ( nCopied <= 0 ) {
+			bOk = false;
+			break;
+		}
+	}
+
+	close( nSource );
+	if ( close( nDestination ) != 0 ) {
+		bOk = false;
+	}
+	if ( ! bOk ) {
+		// Let the caller fall back to a regular copy.
+		unlink( destination.constData() );
+	}
+
+	return bOk;
+#else
+	return false;
+#endif
+}
+
 bool Filesystem::file_copy( const QString& src, const QString& dst, bool overwrite, bool bSilent )
 {
 	if( !overwrite && file_exists( dst, true ) ) {
@@ -453,7 +511,7 @@ bool Filesystem::file_copy( const QString& src, const QString& dst, bool overwri
 		rm( dst, true, bSilent );
 	}
 
-	bool bOk = QFile::copy( src, dst );
+	bool bOk = copyFileInKernel( src, dst ) || QFile::copy( src, dst );
 	if ( ! bOk ) {
 		ERRORLOG( QString( "Error while copying [%1] to [%2]" )
 				  .arg( src ).arg( dst ) );
@@ -774,6 +832,10 @@ QString Filesystem::repositories_cache_dir()
 {
 	return __usr_data_path + CACHE + REPOSITORIES;
 }
+QString Filesystem::xruns_dir()
+{
+	return __usr_data_path + XRUNS;
+}
 QString Filesystem::demos_dir()
 {
 	return __sys_data_path + DEMOS;
@@ -1099,6 +1161,7 @@ void Filesystem::info()
 	INFOLOG( QString( "User Click file            : %1" ).arg( usr_click_file_path() ) );
 	INFOLOG( QString( "Cache dir                  : %1" ).arg( cache_dir() ) );
 	INFOLOG( QString( "Reporitories Cache dir     : %1" ).arg( repositories_cache_dir() ) );
+	INFOLOG( QString( "Xruns dir                  : %1" ).arg( xruns_dir() ) );
 	INFOLOG( QString( "User drumkit dir           : %1" ).arg( usr_drumkits_dir() ) );
 	INFOLOG( QString( "Patterns dir               : %1" ).arg( patterns_dir() ) );
 	INFOLOG( QString( "Playlist dir               : %1" ).arg( playlists_dir() ) );
@@ -235,6 +235,8 @@ namespace H2Core
 		static QString cache_dir();
 		/** returns user repository cache path */
 		static QString repositories_cache_dir();
+		/** returns user path snapshots of xruns are written to */
+		static QString xruns_dir();
 		/** returns system demos path */
 		static QString demos_dir();
 		/** returns system xsd path */
@@ -558,6 +560,15 @@ namespace H2Core
 		 * \param silent output not messages if set to true
 		 */
 		static bool check_permissions( const QString& path, const int perms, bool silent );
+		/**
+		 * Copies @a sSource to a not yet existing @a sDestination
+		 * without passing the data through user space (Linux only).
+		 *
+		 * \return false in case the kernel copy is not supported or
+		 * failed. Nothing is left at @a sDestination in this case.
+		 */
+		static bool copyFileInKernel( const QString& sSource,
+									  const QString& sDestination );
 
 		/**
 		 * Path to the system files set in Filesystem::bootstrap().
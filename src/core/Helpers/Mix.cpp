@@ -0,0 +1,128 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Helpers/Mix.h>
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 1 )
+  #include <xmmintrin.h>
+  #define H2_MIX_SSE
+#endif
+
+namespace H2Core {
+
+void Mix::add( float* pDst, const float* pSrc, int nFrames ) {
+	int ii = 0;
+#ifdef H2_MIX_SSE
+	for ( ; ii + 4 <= nFrames; ii += 4 ) {
+		_mm_storeu_ps( pDst + ii, _mm_add_ps( _mm_loadu_ps( pDst + ii ),
+											  _mm_loadu_ps( pSrc + ii ) ) );
+	}
+#endif
+	for ( ; ii < nFrames; ++ii ) {
+		pDst[ ii ] += pSrc[ ii ];
+	}
+}
+
+void Mix::addScaled( float* pDst, const float* pSrc, float fGain, int nFrames ) {
+	int ii = 0;
+#ifdef H2_MIX_SSE
+	const __m128 gain = _mm_set1_ps( fGain );
+	for ( ; ii + 4 <= nFrames; ii += 4 ) {
+		_mm_storeu_ps( pDst + ii,
+					   _mm_add_ps( _mm_loadu_ps( pDst + ii ),
+								   _mm_mul_ps( _mm_loadu_ps( pSrc + ii ), gain ) ) );
+	}
+#endif
+	for ( ; ii < nFrames; ++ii ) {
+		pDst[ ii ] += pSrc[ ii ] * fGain;
+	}
+}
+
+void Mix::scale( float* pDst, float fGain, int nFrames ) {
+	int ii = 0;
+#ifdef H2_MIX_SSE
+	const __m128 gain = _mm_set1_ps( fGain );
+	for ( ; ii + 4 <= nFrames; ii += 4 ) {
+		_mm_storeu_ps( pDst + ii, _mm_mul_ps( _mm_loadu_ps( pDst + ii ), gain ) );
+	}
+#endif
+	for ( ; ii < nFrames; ++ii ) {
+		pDst[ ii ] *= fGain;
+	}
+}
+
+void Mix::multiply( float* pDst, const float* pGain, int nFrames ) {
+	int ii = 0;
+#ifdef H2_MIX_SSE
+	for ( ; ii + 4 <= nFrames; ii += 4 ) {
+		_mm_storeu_ps( pDst + ii, _mm_mul_ps( _mm_loadu_ps( pDst + ii ),
+											  _mm_loadu_ps( pGain + ii ) ) );
+	}
+#endif
+	for ( ; ii < nFrames; ++ii ) {
+		pDst[ ii ] *= pGain[ ii ];
+	}
+}
+
+float Mix::addWithPeak( float* pDst, const float* pSrc, int nFrames, float fPeak ) {
+	int ii = 0;
+#ifdef H2_MIX_SSE
+	__m128 peak = _mm_set1_ps( fPeak );
+	for ( ; ii + 4 <= nFrames; ii += 4 ) {
+		const __m128 src = _mm_loadu_ps( pSrc + ii );
+		_mm_storeu_ps( pDst + ii, _mm_add_ps( _mm_loadu_ps( pDst + ii ), src ) );
+		peak = _mm_max_ps( peak, src );
+	}
+	float peaks[ 4 ];
+	_mm_storeu_ps( peaks, peak );
+	fPeak = std::max( std::max( peaks[ 0 ], peaks[ 1 ] ),
+					  std::max( peaks[ 2 ], peaks[ 3 ] ) );
+#endif
+	for ( ; ii < nFrames; ++ii ) {
+		pDst[ ii ] += pSrc[ ii ];
+		fPeak = std::max( fPeak, pSrc[ ii ] );
+	}
+
+	return fPeak;
+}
+
+float Mix::peak( const float* pSrc, int nFrames, float fPeak ) {
+	int ii = 0;
+#ifdef H2_MIX_SSE
+	__m128 peak = _mm_set1_ps( fPeak );
+	for ( ; ii + 4 <= nFrames; ii += 4 ) {
+		peak = _mm_max_ps( peak, _mm_loadu_ps( pSrc + ii ) );
+	}
+	float peaks[ 4 ];
+	_mm_storeu_ps( peaks, peak );
+	fPeak = std::max( std::max( peaks[ 0 ], peaks[ 1 ] ),
+					  std::max( peaks[ 2 ], peaks[ 3 ] ) );
+#endif
+	for ( ; ii < nFrames; ++ii ) {
+		fPeak = std::max( fPeak, pSrc[ ii ] );
+	}
+
+	return fPeak;
+}
+};
@@ -0,0 +1,64 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_MIX_H
+#define H2C_MIX_H
+
+namespace H2Core
+{
+
+/**
+ * Buffer kernels used to mix audio within the audio engine.
+ *
+ * All of them operate on @a nFrames consecutive samples. Buffers are
+ * not required to be aligned and must not overlap. On x86 SSE is used
+ * to process four samples at once.
+ *
+ * \ingroup docCore docAudioEngine
+ */
+class Mix
+{
+public:
+	/** Adds @a pSrc to @a pDst. */
+	static void add( float* pDst, const float* pSrc, int nFrames );
+	/** Adds @a pSrc scaled by @a fGain to @a pDst. */
+	static void addScaled( float* pDst, const float* pSrc, float fGain,
+						   int nFrames );
+	/** Multiplies @a pDst by @a fGain. */
+	static void scale( float* pDst, float fGain, int nFrames );
+	/** Multiplies @a pDst by the corresponding samples of @a pGain. */
+	static void multiply( float* pDst, const float* pGain, int nFrames );
+	/**
+	 * Adds @a pSrc to @a pDst while keeping track of the largest
+	 * sample of @a pSrc.
+	 *
+	 * \return Maximum of @a fPeak and all samples of @a pSrc.
+	 */
+	static float addWithPeak( float* pDst, const float* pSrc, int nFrames,
+							  float fPeak );
+	/** \return Maximum of @a fPeak and all samples of @a pSrc. */
+	static float peak( const float* pSrc, int nFrames, float fPeak );
+};
+
+};
+
+#endif  // H2C_MIX_H
@@ -0,0 +1,345 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Helpers/PlaylistPreloader.h>
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Playlist.h>
+#include <core/Basics/Sample.h>
+#include <core/Basics/Song.h>
+#include <core/MidiAction.h>
+#include <core/OscServer.h>
+#include <core/Preferences/Preferences.h>
+
+#include <QFileInfo>
+
+#include <algorithm>
+
+namespace H2Core
+{
+
+PlaylistPreloader::PlaylistPreloader()
+	: m_nMemoryUsage( 0 )
+	, m_nMemoryBudget( 0 )
+	, m_bShutdown( false ) {
+	m_worker = std::thread( &PlaylistPreloader::workerLoop, this );
+}
+
+PlaylistPreloader::~PlaylistPreloader() {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+		m_jobs.clear();
+		m_wanted.clear();
+	}
+	m_jobAdded.notify_one();
+	if ( m_worker.joinable() ) {
+		m_worker.join();
+	}
+}
+
+void PlaylistPreloader::update( std::shared_ptr<Playlist> pPlaylist,
+								int nActiveSongNumber ) {
+	auto pPref = Preferences::get_instance();
+	const int nSongs = pPref->getPlaylistPreloadSongs();
+
+	std::vector<Job> jobs;
+	if ( pPlaylist != nullptr ) {
+		const int nFirst = std::max( nActiveSongNumber + 1, 0 );
+		for ( int nn = nFirst; nn < nFirst + nSongs &&
+				  nn < pPlaylist->size(); ++nn ) {
+			const auto pEntry = pPlaylist->get( nn );
+			if ( pEntry == nullptr || ! pEntry->getSongExists() ) {
+				continue;
+			}
+			jobs.push_back(
+				{ QFileInfo( pEntry->getSongPath() ).absoluteFilePath(), nn } );
+		}
+	}
+
+	// Dropped songs are released outside of the lock.
+	std::vector<Entry> dropped;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_nMemoryBudget =
+			static_cast<qint64>( pPref->getPlaylistPreloadMemory() ) * 1024 * 1024;
+
+		m_wanted.clear();
+		for ( const auto& job : jobs ) {
+			m_wanted.push_back( job.sPath );
+		}
+
+		for ( auto it = m_entries.begin(); it != m_entries.end(); ) {
+			if ( std::find( m_wanted.begin(), m_wanted.end(), it->sPath ) ==
+				 m_wanted.end() ) {
+				m_nMemoryUsage -= it->nBytes;
+				dropped.push_back( std::move( *it ) );
+				it = m_entries.erase( it );
+			} else {
+				++it;
+			}
+		}
+
+		m_jobs.clear();
+		for ( const auto& job : jobs ) {
+			const bool bCached = std::find_if(
+				m_entries.begin(), m_entries.end(), [&]( const Entry& entry ) {
+					return entry.sPath == job.sPath; } ) != m_entries.end();
+			if ( ! bCached && job.sPath != m_sLoading ) {
+				m_jobs.push_back( job );
+			}
+		}
+	}
+	m_jobAdded.notify_one();
+
+	for ( const auto& entry : dropped ) {
+		INFOLOG( QString( "Dropping preloaded song [%1]" ).arg( entry.sPath ) );
+	}
+}
+
+void PlaylistPreloader::clear() {
+	// Dropped songs are released outside of the lock.
+	std::vector<Entry> dropped;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_jobs.clear();
+		m_wanted.clear();
+		dropped.swap( m_entries );
+		m_nMemoryUsage = 0;
+	}
+}
+
+std::shared_ptr<Song> PlaylistPreloader::take( const QString& sPath ) {
+	const QString sAbsolutePath = QFileInfo( sPath ).absoluteFilePath();
+
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_jobsDone.wait( lock, [&]() { return m_sLoading != sAbsolutePath; } );
+
+	auto it = std::find_if(
+		m_entries.begin(), m_entries.end(), [&]( const Entry& entry ) {
+			return entry.sPath == sAbsolutePath; } );
+	if ( it == m_entries.end() ) {
+		return nullptr;
+	}
+
+	Entry entry = std::move( *it );
+	m_entries.erase( it );
+	m_nMemoryUsage -= entry.nBytes;
+	lock.unlock();
+
+	if ( QFileInfo( sAbsolutePath ).lastModified() != entry.lastModified ) {
+		INFOLOG( QString( "Preloaded song [%1] was modified in the meantime" )
+				 .arg( sAbsolutePath ) );
+		return nullptr;
+	}
+
+	INFOLOG( QString( "Using preloaded song [%1]" ).arg( sAbsolutePath ) );
+	return entry.pSong;
+}
+
+bool PlaylistPreloader::isReady( const QString& sPath ) const {
+	const QString sAbsolutePath = QFileInfo( sPath ).absoluteFilePath();
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return std::find_if(
+		m_entries.begin(), m_entries.end(), [&]( const Entry& entry ) {
+			return entry.sPath == sAbsolutePath; } ) != m_entries.end();
+}
+
+void PlaylistPreloader::waitForPendingJobs() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_jobsDone.wait( lock, [&]() {
+		return m_jobs.empty() && m_sLoading.isEmpty(); } );
+}
+
+qint64 PlaylistPreloader::getMemoryUsage() const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nMemoryUsage;
+}
+
+void PlaylistPreloader::workerLoop() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( true ) {
+		m_jobAdded.wait( lock, [&]() { return m_bShutdown || ! m_jobs.empty(); } );
+		if ( m_bShutdown ) {
+			break;
+		}
+
+		const Job job = m_jobs.front();
+		m_jobs.pop_front();
+		m_sLoading = job.sPath;
+
+		lock.unlock();
+		const QDateTime lastModified = QFileInfo( job.sPath ).lastModified();
+		auto pSong = load( job );
+		const qint64 nBytes = pSong != nullptr ?
+			sampleMemory( pSong->getDrumkit() ) : 0;
+		lock.lock();
+
+		bool bReady = false;
+		if ( pSong != nullptr && ! m_bShutdown &&
+			 std::find( m_wanted.begin(), m_wanted.end(), job.sPath ) !=
+			 m_wanted.end() ) {
+			if ( m_nMemoryUsage + nBytes <= m_nMemoryBudget ) {
+				m_entries.push_back( { job.sPath, lastModified, pSong, nBytes } );
+				m_nMemoryUsage += nBytes;
+				bReady = true;
+			}
+			else {
+				// The look-ahead is ordered. All subsequent songs would
+				// have been dropped anyway in order to make room for
+				// this one.
+				WARNINGLOG( QString( "Preloading [%1] would exceed the memory budget of [%2] MiB. Stopping look-ahead." )
+							.arg( job.sPath )
+							.arg( m_nMemoryBudget / 1024 / 1024 ) );
+				m_jobs.clear();
+			}
+		}
+		m_sLoading.clear();
+		m_jobsDone.notify_all();
+
+		lock.unlock();
+		if ( bReady ) {
+			INFOLOG( QString( "Song [%1] preloaded" ).arg( job.sPath ) );
+			sendFeedback( job.nSongNumber, 1.0 );
+		}
+		else if ( pSong != nullptr ) {
+			// Release the samples outside of the lock.
+			pSong = nullptr;
+			sendFeedback( job.nSongNumber, 0.0 );
+		}
+		lock.lock();
+	}
+}
+
+std::shared_ptr<Song> PlaylistPreloader::load( const Job& job ) {
+	auto pSong = Song::load( job.sPath );
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		ERRORLOG( QString( "Unable to preload song [%1]" ).arg( job.sPath ) );
+		return nullptr;
+	}
+
+	// Samples are loaded per instrument in order to report progress
+	// and to abort early in case the song dropped out of the
+	// look-ahead.
+	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+	const int nInstruments = pInstrumentList->size();
+	int nLastPercentage = 0;
+	for ( int ii = 0; ii < nInstruments; ++ii ) {
+		if ( ! isWanted( job.sPath ) ) {
+			INFOLOG( QString( "Preloading of [%1] aborted" ).arg( job.sPath ) );
+			return nullptr;
+		}
+		( *pInstrumentList )[ ii ]->load_samples();
+
+		// Final readiness is reported by the worker loop.
+		const int nPercentage = 100 * ( ii + 1 ) / nInstruments;
+		if ( nPercentage - nLastPercentage >= 10 && ii < nInstruments - 1 ) {
+			sendFeedback( job.nSongNumber,
+						  static_cast<float>( nPercentage ) / 100 );
+			nLastPercentage = nPercentage;
+		}
+	}
+
+	return pSong;
+}
+
+bool PlaylistPreloader::isWanted( const QString& sPath ) const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return ! m_bShutdown &&
+		std::find( m_wanted.begin(), m_wanted.end(), sPath ) != m_wanted.end();
+}
+
+qint64 PlaylistPreloader::sampleMemory( std::shared_ptr<Drumkit> pDrumkit ) {
+	if ( pDrumkit == nullptr ) {
+		return 0;
+	}
+
+	qint64 nBytes = 0;
+	for ( const auto& pInstrument : *pDrumkit->getInstruments() ) {
+		for ( const auto& pComponent : *pInstrument->get_components() ) {
+			for ( int nn = 0; nn < InstrumentComponent::getMaxLayers(); ++nn ) {
+				auto pLayer = pComponent->getLayer( nn );
+				if ( pLayer != nullptr && pLayer->get_sample() != nullptr ) {
+					// Left and right channel.
+					nBytes += static_cast<qint64>(
+						pLayer->get_sample()->get_frames() ) * 2 * sizeof( float );
+				}
+			}
+		}
+	}
+
+	return nBytes;
+}
+
+void PlaylistPreloader::sendFeedback( int nSongNumber, float fProgress ) {
+#ifdef H2CORE_HAVE_OSC
+	if ( Preferences::get_instance()->getOscFeedbackEnabled() &&
+		 OscServer::get_instance() != nullptr ) {
+		auto pFeedbackAction =
+			std::make_shared<Action>( "PLAYLIST_SONG_PRELOAD" );
+		pFeedbackAction->setParameter1( QString::number( nSongNumber ) );
+		pFeedbackAction->setValue( QString::number( fProgress ) );
+		OscServer::get_instance()->handleAction( pFeedbackAction );
+	}
+#endif
+}
+
+QString PlaylistPreloader::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	std::lock_guard<std::mutex> lock( m_mutex );
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[PlaylistPreloader]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_jobs: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_jobs.size() ) )
+			.append( QString( "%1%2m_sLoading: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_sLoading ) )
+			.append( QString( "%1%2m_entries:\n" ).arg( sPrefix ).arg( s ) );
+		for ( const auto& entry : m_entries ) {
+			sOutput.append( QString( "%1%2%2%3: %4 bytes\n" ).arg( sPrefix )
+							.arg( s ).arg( entry.sPath ).arg( entry.nBytes ) );
+		}
+		sOutput.append( QString( "%1%2m_nMemoryUsage: %3\n" ).arg( sPrefix )
+						.arg( s ).arg( m_nMemoryUsage ) )
+			.append( QString( "%1%2m_nMemoryBudget: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nMemoryBudget ) );
+	}
+	else {
+		sOutput = QString( "[PlaylistPreloader] m_jobs: %1" ).arg( m_jobs.size() )
+			.append( QString( ", m_sLoading: %1" ).arg( m_sLoading ) )
+			.append( QString( ", m_entries: [" ) );
+		for ( const auto& entry : m_entries ) {
+			sOutput.append( QString( " %1" ).arg( entry.sPath ) );
+		}
+		sOutput.append( QString( " ], m_nMemoryUsage: %1" ).arg( m_nMemoryUsage ) )
+			.append( QString( ", m_nMemoryBudget: %1" ).arg( m_nMemoryBudget ) );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,145 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_PLAYLIST_PRELOADER_H
+#define H2C_PLAYLIST_PRELOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QDateTime>
+#include <QString>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+class Drumkit;
+class Playlist;
+class Song;
+
+/**
+ * Loads the songs following the active one in the current playlist in
+ * the background.
+ *
+ * Switching to another song of a playlist used to involve parsing the
+ * .h2song file and decoding all samples of its drumkit on the spot -
+ * which takes up to several seconds for large kits. Instead, a worker
+ * thread loads the next songs of the playlist, including their
+ * samples, as soon as a playlist song got activated. They are kept in
+ * memory until they are either requested via
+ * CoreActionController::loadSong() or drop out of the look-ahead.
+ *
+ * The number of songs to preload and the memory their samples are
+ * allowed to occupy are set in the Preferences. Once a song would
+ * exceed the memory budget, it as well as all songs following it are
+ * not preloaded.
+ *
+ * Progress and readiness of each song are reported via OSC feedback.
+ *
+ * \ingroup docCore
+ */
+class PlaylistPreloader : public H2Core::Object<PlaylistPreloader>
+{
+	H2_OBJECT(PlaylistPreloader)
+public:
+	PlaylistPreloader();
+	/** Aborts the song currently loaded. */
+	~PlaylistPreloader();
+
+	/** Preloads the songs following @a nActiveSongNumber in @a
+	 * pPlaylist. Songs not among them anymore are dropped.
+	 *
+	 * In case @a nActiveSongNumber is -1, the first songs of the
+	 * playlist will be preloaded. */
+	void update( std::shared_ptr<Playlist> pPlaylist, int nActiveSongNumber );
+	/** Drops all preloaded songs and pending jobs. */
+	void clear();
+
+	/** Hands over the preloaded song stored in @a sPath. Its samples
+	 * are already loaded.
+	 *
+	 * In case the song is loaded right now, this function blocks until
+	 * it is done.
+	 *
+	 * \return nullptr in case the song was not preloaded or its file
+	 *   was modified in the meantime. */
+	std::shared_ptr<Song> take( const QString& sPath );
+	/** Whether the song stored in @a sPath is ready to be taken. */
+	bool isReady( const QString& sPath ) const;
+	/** Blocks until all queued songs are loaded. */
+	void waitForPendingJobs();
+
+	/** Memory occupied by the samples of all preloaded songs in
+	 * bytes. */
+	qint64 getMemoryUsage() const;
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Job {
+		QString sPath;
+		int nSongNumber;
+	};
+	struct Entry {
+		QString sPath;
+		QDateTime lastModified;
+		std::shared_ptr<Song> pSong;
+		qint64 nBytes;
+	};
+
+	void workerLoop();
+	/** Loads song and samples of @a job.
+	 *
+	 * \return nullptr in case loading failed or was aborted. */
+	std::shared_ptr<Song> load( const Job& job );
+	/** Whether @a sPath is still part of the look-ahead. */
+	bool isWanted( const QString& sPath ) const;
+
+	static qint64 sampleMemory( std::shared_ptr<Drumkit> pDrumkit );
+	static void sendFeedback( int nSongNumber, float fProgress );
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_jobAdded;
+	std::condition_variable m_jobsDone;
+	std::deque<Job> m_jobs;
+	std::vector<Entry> m_entries;
+	/** Paths of all songs within the current look-ahead. */
+	std::vector<QString> m_wanted;
+	/** Path of the song the worker is loading right now. Empty in case
+	 * it is idle. */
+	QString m_sLoading;
+	qint64 m_nMemoryUsage;
+	qint64 m_nMemoryBudget;
+	bool m_bShutdown;
+
+	std::thread m_worker;
+};
+
+};
+
+#endif  // H2C_PLAYLIST_PRELOADER_H
@@ -21,18 +21,154 @@
 
 #include <core/Helpers/Random.h>
 
+#include <cmath>
+#include <cstdlib>
+
 namespace H2Core {
 
+std::atomic<uint64_t> Random::m_nSeed( 0x2545F4914F6CDD1DULL );
+std::atomic<int> Random::m_nSeedEpoch( 0 );
+
+namespace {
+
+inline uint64_t rotl( uint64_t x, int k ) {
+	return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+inline uint64_t splitMix64( uint64_t& nState ) {
+	uint64_t z = ( nState += 0x9E3779B97F4A7C15ULL );
+	z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+	z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+	return z ^ ( z >> 31 );
+}
+
+/** Uniform value in the open interval (0,1). Used by the ziggurat
+ * method which takes its logarithm.*/
+inline float toOpenUnit( uint64_t nValue ) {
+	return ( static_cast<float>( nValue >> 40 ) + 0.5f ) * ( 1.0f / 16777216.0f );
+}
+
+/** Tables of the ziggurat method by Marsaglia and Tsang (2000) for
+ * a standard normal distribution using 128 layers. */
+struct Ziggurat {
+	uint32_t kn[ 128 ];
+	float wn[ 128 ];
+	float fn[ 128 ];
+
+	Ziggurat() {
+		const double m1 = 2147483648.0;
+		const double vn = 9.91256303526217e-3;
+		double dn = 3.442619855899;
+		double tn = dn;
+		const double q = vn / std::exp( -0.5 * dn * dn );
+
+		kn[ 0 ] = static_cast<uint32_t>( ( dn / q ) * m1 );
+		kn[ 1 ] = 0;
+		wn[ 0 ] = static_cast<float>( q / m1 );
+		wn[ 127 ] = static_cast<float>( dn / m1 );
+		fn[ 0 ] = 1.0f;
+		fn[ 127 ] = static_cast<float>( std::exp( -0.5 * dn * dn ) );
+
+		for ( int ii = 126; ii >= 1; --ii ) {
+			dn = std::sqrt( -2.0 * std::log( vn / dn +
+											 std::exp( -0.5 * dn * dn ) ) );
+			kn[ ii + 1 ] = static_cast<uint32_t>( ( dn / tn ) * m1 );
+			tn = dn;
+			fn[ ii ] = static_cast<float>( std::exp( -0.5 * dn * dn ) );
+			wn[ ii ] = static_cast<float>( dn / m1 );
+		}
+	}
+};
+
+const Ziggurat ziggurat;
+
+}
+
+void Random::Generator::seed( uint64_t nSeed ) {
+	uint64_t nState = nSeed;
+	for ( auto& ss : state ) {
+		ss = splitMix64( nState );
+	}
+}
+
+uint64_t Random::Generator::next() {
+	const uint64_t nResult = rotl( state[ 1 ] * 5, 7 ) * 9;
+	const uint64_t t = state[ 1 ] << 17;
+
+	state[ 2 ] ^= state[ 0 ];
+	state[ 3 ] ^= state[ 1 ];
+	state[ 1 ] ^= state[ 2 ];
+	state[ 0 ] ^= state[ 3 ];
+	state[ 2 ] ^= t;
+	state[ 3 ] = rotl( state[ 3 ], 45 );
+
+	return nResult;
+}
+
+Random::Generator& Random::getGenerator() {
+	thread_local Generator generator;
+
+	const int nEpoch = m_nSeedEpoch.load( std::memory_order_acquire );
+	if ( generator.nEpoch != nEpoch ) {
+		generator.seed( m_nSeed.load( std::memory_order_relaxed ) );
+		generator.nEpoch = nEpoch;
+	}
+
+	return generator;
+}
+
+void Random::setSeed( uint64_t nSeed ) {
+	m_nSeed.store( nSeed, std::memory_order_relaxed );
+	m_nSeedEpoch.fetch_add( 1, std::memory_order_release );
+}
+
+uint64_t Random::getSeed() {
+	return m_nSeed.load( std::memory_order_relaxed );
+}
+
+float Random::getUniform() {
+	return static_cast<float>( getGenerator().next() >> 40 ) *
+		( 1.0f / 16777216.0f );
+}
+
+int Random::getInt( int nMax ) {
+	if ( nMax <= 0 ) {
+		return 0;
+	}
+	return static_cast<int>(
+		( ( getGenerator().next() >> 32 ) * static_cast<uint64_t>( nMax ) ) >> 32 );
+}
+
 float Random::getGaussian( float fStandardDeviation ) {
-	// gaussian distribution -- dimss
-	float x1, x2, w;
-	do {
-		x1 = 2.0 * ( ( ( float ) rand() ) / static_cast<float>(RAND_MAX) ) - 1.0;
-		x2 = 2.0 * ( ( ( float ) rand() ) / static_cast<float>(RAND_MAX) ) - 1.0;
-		w = x1 * x1 + x2 * x2;
-	} while ( w >= 1.0 );
-
-	w = sqrtf( ( -2.0 * logf( w ) ) / w );
-	return x1 * w * fStandardDeviation + 0.0; // tunable
+	auto& generator = getGenerator();
+	const float fR = 3.442620f;
+
+	for ( ;; ) {
+		const int32_t hz = static_cast<int32_t>( generator.next() >> 32 );
+		const int iz = hz & 127;
+		const float x = hz * ziggurat.wn[ iz ];
+
+		// Fast path taken in about 99% of all cases.
+		if ( static_cast<uint32_t>( std::abs( static_cast<int64_t>( hz ) ) ) <
+			 ziggurat.kn[ iz ] ) {
+			return x * fStandardDeviation;
+		}
+
+		if ( iz == 0 ) {
+			// Sample from the tail of the distribution.
+			float fX, fY;
+			do {
+				fX = -std::log( toOpenUnit( generator.next() ) ) / fR;
+				fY = -std::log( toOpenUnit( generator.next() ) );
+			} while ( fY + fY < fX * fX );
+			return ( hz > 0 ? fR + fX : -fR - fX ) * fStandardDeviation;
+		}
+
+		if ( ziggurat.fn[ iz ] + toOpenUnit( generator.next() ) *
+			 ( ziggurat.fn[ iz - 1 ] - ziggurat.fn[ iz ] ) <
+			 std::exp( -0.5f * x * x ) ) {
+			return x * fStandardDeviation;
+		}
+	}
 }
 };
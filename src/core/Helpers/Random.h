@@ -22,6 +22,9 @@
 #ifndef H2C_RANDOM_H
 #define H2C_RANDOM_H
 
+#include <atomic>
+#include <cstdint>
+
 #include <core/Object.h>
 
 namespace H2Core
@@ -30,6 +33,15 @@ namespace H2Core
 /**
  * Container for functions generating random number.
  *
+ * All numbers are drawn from a xoshiro256** generator. Each thread owns
+ * a separate instance of it. Drawing numbers thus neither involves any
+ * locking nor does it interfere with other threads, which makes all
+ * functions safe to be called from within the audio thread.
+ *
+ * All generators are initialized using a common seed (see setSeed()).
+ * Reseeding e.g. at the beginning of an export yields the very same
+ * sequence of random numbers and, thus, bit-identical humanization.
+ *
  * \ingroup docCore
  */
 class Random : public H2Core::Object<Random>
@@ -40,9 +52,38 @@ public:
 	 * Draws an uncorrelated random value from a Gaussian distribution
 	 * of mean 0 and @a fStandardDeviation.
 	 *
+	 * The ziggurat method is used for sampling.
+	 *
 	 * @param fStandardDeviation Defines the width of the distribution used.
 	 */
 	static float getGaussian( float fStandardDeviation );
+	/** \return Uniformly distributed random value in [0,1). */
+	static float getUniform();
+	/** \return Uniformly distributed random integer in [0,@a nMax). */
+	static int getInt( int nMax );
+
+	/** Sets the seed all per-thread generators will be (lazily)
+	 * reinitialized with before drawing their next number. */
+	static void setSeed( uint64_t nSeed );
+	static uint64_t getSeed();
+
+private:
+	struct Generator {
+		uint64_t state[ 4 ];
+		/** Value of #m_nSeedEpoch the generator was seeded in. */
+		int nEpoch = -1;
+
+		void seed( uint64_t nSeed );
+		uint64_t next();
+	};
+
+	/** Generator of the calling thread. It is reseeded in case
+	 * setSeed() was called in the meantime. */
+	static Generator& getGenerator();
+
+	static std::atomic<uint64_t> m_nSeed;
+	/** Incremented on every call to setSeed(). */
+	static std::atomic<int> m_nSeedEpoch;
 };
 
 };
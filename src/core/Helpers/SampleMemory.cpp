@@ -0,0 +1,280 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Helpers/SampleMemory.h>
+#include <core/Preferences/Preferences.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifndef WIN32
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace H2Core
+{
+
+/** Size of huge pages on x86_64 and aarch64 using 4k base pages. Arenas
+ * are aligned to it so the kernel is able to back them by huge
+ * pages. */
+static constexpr size_t nHugePageSize = 2 * 1024 * 1024;
+
+std::mutex SampleMemory::m_mutex;
+std::vector<std::unique_ptr<SampleMemory::Arena>> SampleMemory::m_arenas;
+std::map<float*, SampleMemory::Allocation> SampleMemory::m_allocations;
+size_t SampleMemory::m_nLockedBytes = 0;
+size_t SampleMemory::m_nUnlockedBytes = 0;
+size_t SampleMemory::m_nLockedArenaBytes = 0;
+bool SampleMemory::m_bLockFailed = false;
+
+float* SampleMemory::allocate( int nFrames )
+{
+	if ( nFrames <= 0 ) {
+		return nullptr;
+	}
+
+#ifndef WIN32
+	const auto pPref = Preferences::get_instance();
+	if ( pPref != nullptr && pPref->m_bLockSampleMemory ) {
+		const size_t nSize = ( static_cast<size_t>( nFrames ) * sizeof( float ) +
+							   nAlignment - 1 ) / nAlignment * nAlignment;
+
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		Arena* pArena = nullptr;
+		size_t nOffset = 0;
+		for ( const auto& ppArena : m_arenas ) {
+			if ( allocateFrom( ppArena.get(), nSize, &nOffset ) ) {
+				pArena = ppArena.get();
+				break;
+			}
+		}
+		if ( pArena == nullptr ) {
+			pArena = createArena( nSize );
+			if ( pArena != nullptr ) {
+				allocateFrom( pArena, nSize, &nOffset );
+			}
+		}
+
+		if ( pArena != nullptr ) {
+			float* pData = reinterpret_cast<float*>( pArena->pBase + nOffset );
+			m_allocations[ pData ] = { pArena, nOffset, nSize };
+			pArena->nUsed += nSize;
+			if ( pArena->bLocked ) {
+				m_nLockedBytes += nSize;
+			} else {
+				m_nUnlockedBytes += nSize;
+			}
+			return pData;
+		}
+		// Mapping a new arena failed. Fall back to the ordinary heap.
+	}
+#endif
+
+	return new float[ nFrames ];
+}
+
+void SampleMemory::release( float* pData )
+{
+	if ( pData == nullptr ) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		auto it = m_allocations.find( pData );
+		if ( it != m_allocations.end() ) {
+			const Allocation allocation = it->second;
+			m_allocations.erase( it );
+
+			Arena* pArena = allocation.pArena;
+			pArena->nUsed -= allocation.nSize;
+			if ( pArena->bLocked ) {
+				m_nLockedBytes -= allocation.nSize;
+			} else {
+				m_nUnlockedBytes -= allocation.nSize;
+			}
+
+			if ( pArena->nUsed == 0 ) {
+				destroyArena( pArena );
+				return;
+			}
+
+			auto itRegion = pArena->freeRegions.emplace(
+				allocation.nOffset, allocation.nSize ).first;
+			auto itNext = std::next( itRegion );
+			if ( itNext != pArena->freeRegions.end() &&
+				 itRegion->first + itRegion->second == itNext->first ) {
+				itRegion->second += itNext->second;
+				pArena->freeRegions.erase( itNext );
+			}
+			if ( itRegion != pArena->freeRegions.begin() ) {
+				auto itPrev = std::prev( itRegion );
+				if ( itPrev->first + itPrev->second == itRegion->first ) {
+					itPrev->second += itRegion->second;
+					pArena->freeRegions.erase( itRegion );
+				}
+			}
+			return;
+		}
+	}
+
+	// Not handed out by an arena.
+	delete[] pData;
+}
+
+size_t SampleMemory::getLockedBytes()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nLockedBytes;
+}
+
+size_t SampleMemory::getUnlockedBytes()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nUnlockedBytes;
+}
+
+bool SampleMemory::allocateFrom( Arena* pArena, size_t nSize, size_t* pOffset )
+{
+	// First fit. Samples of a kit are usually loaded and unloaded
+	// together, so fragmentation is of little concern.
+	for ( auto it = pArena->freeRegions.begin();
+		  it != pArena->freeRegions.end(); ++it ) {
+		if ( it->second >= nSize ) {
+			*pOffset = it->first;
+			const size_t nRemainingOffset = it->first + nSize;
+			const size_t nRemainingSize = it->second - nSize;
+			pArena->freeRegions.erase( it );
+			if ( nRemainingSize > 0 ) {
+				pArena->freeRegions.emplace( nRemainingOffset, nRemainingSize );
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+SampleMemory::Arena* SampleMemory::createArena( size_t nMinSize )
+{
+#ifdef WIN32
+	return nullptr;
+#else
+	const size_t nSize = std::max( nArenaSize, ( nMinSize + nHugePageSize - 1 ) /
+								   nHugePageSize * nHugePageSize );
+
+	// Map one huge page more than required to be able to align the
+	// arena and return the surplus afterwards.
+	const size_t nMappingSize = nSize + nHugePageSize;
+	void* pMapping = mmap( nullptr, nMappingSize, PROT_READ | PROT_WRITE,
+						   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	if ( pMapping == MAP_FAILED ) {
+		ERRORLOG( QString( "Unable to map [%1] bytes of sample memory: %2" )
+				  .arg( nMappingSize ).arg( strerror( errno ) ) );
+		return nullptr;
+	}
+
+	char* pRaw = static_cast<char*>( pMapping );
+	char* pBase = reinterpret_cast<char*>(
+		( reinterpret_cast<uintptr_t>( pRaw ) + nHugePageSize - 1 ) &
+		~static_cast<uintptr_t>( nHugePageSize - 1 ) );
+	if ( pBase > pRaw ) {
+		munmap( pRaw, pBase - pRaw );
+	}
+	const size_t nTail = ( pRaw + nMappingSize ) - ( pBase + nSize );
+	if ( nTail > 0 ) {
+		munmap( pBase + nSize, nTail );
+	}
+
+#ifdef MADV_HUGEPAGE
+	madvise( pBase, nSize, MADV_HUGEPAGE );
+#endif
+
+	auto pArena = std::make_unique<Arena>();
+	pArena->pBase = pBase;
+	pArena->nSize = nSize;
+	pArena->bLocked = false;
+	pArena->nUsed = 0;
+	pArena->freeRegions.emplace( 0, nSize );
+
+	const size_t nLimit = static_cast<size_t>(
+		std::max( Preferences::get_instance()->m_nSampleMemoryLockLimit, 0 ) ) *
+		1024 * 1024;
+	if ( ! m_bLockFailed && m_nLockedArenaBytes + nSize <= nLimit ) {
+		// mlock() faults in all pages of the arena as well.
+		if ( mlock( pBase, nSize ) == 0 ) {
+			pArena->bLocked = true;
+			m_nLockedArenaBytes += nSize;
+		}
+		else {
+			m_bLockFailed = true;
+			WARNINGLOG( QString( "Unable to lock sample memory: %1. Please check RLIMIT_MEMLOCK (ulimit -l). Further arenas will not be locked." )
+						.arg( strerror( errno ) ) );
+		}
+	}
+
+	if ( ! pArena->bLocked ) {
+		// Pre-fault all pages. They might still be swapped out later
+		// on but at least the first access of a freshly loaded sample
+		// will not hit the disk.
+		const size_t nPageSize = static_cast<size_t>( sysconf( _SC_PAGESIZE ) );
+		for ( size_t nn = 0; nn < nSize; nn += nPageSize ) {
+			pBase[ nn ] = 0;
+		}
+	}
+
+	m_arenas.push_back( std::move( pArena ) );
+	logUsage();
+
+	return m_arenas.back().get();
+#endif
+}
+
+void SampleMemory::destroyArena( Arena* pArena )
+{
+#ifndef WIN32
+	munmap( pArena->pBase, pArena->nSize );
+	if ( pArena->bLocked ) {
+		m_nLockedArenaBytes -= pArena->nSize;
+	}
+#endif
+
+	m_arenas.erase( std::remove_if( m_arenas.begin(), m_arenas.end(),
+									[&]( const std::unique_ptr<Arena>& ppArena ) {
+										return ppArena.get() == pArena; } ),
+					m_arenas.end() );
+	logUsage();
+}
+
+void SampleMemory::logUsage()
+{
+	INFOLOG( QString( "[%1] arenas. Sample data: [%2] bytes locked, [%3] bytes unlocked. Locked arenas: [%4] bytes" )
+			 .arg( m_arenas.size() ).arg( m_nLockedBytes )
+			 .arg( m_nUnlockedBytes ).arg( m_nLockedArenaBytes ) );
+}
+
+};
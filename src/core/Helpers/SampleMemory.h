@@ -0,0 +1,121 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_SAMPLE_MEMORY_H
+#define H2C_SAMPLE_MEMORY_H
+
+#include <core/Object.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace H2Core
+{
+
+/**
+ * Allocator for the audio data of all Sample%s.
+ *
+ * When Preferences::m_bLockSampleMemory is set, sample data is placed
+ * in large, aligned arenas instead of being allocated individually
+ * using new[]. Each arena is pre-faulted on creation and locked into
+ * RAM using mlock() as long as the overall amount of locked memory
+ * stays within Preferences::m_nSampleMemoryLockLimit. This way the
+ * first hit of a rarely used layer does not cause a major page fault
+ * within the audio thread. On Linux the kernel is additionally asked
+ * to back the arenas by huge pages.
+ *
+ * Arenas exceeding the limit are still pre-faulted but may be swapped
+ * out by the kernel. Their size is reported as unlocked bytes.
+ *
+ * Without the preference set (and on Windows) allocate() falls back to
+ * new[]. release() accepts data allocated both ways and even arrays
+ * created by new[] outside of this class. This allows the option to be
+ * toggled while samples are loaded.
+ *
+ * All functions are thread-safe. They must not be called by the audio
+ * thread.
+ *
+ * \ingroup docCore */
+class SampleMemory : public H2Core::Object<SampleMemory>
+{
+	H2_OBJECT(SampleMemory)
+public:
+	/** Alignment of all data handed out by the arenas in bytes. */
+	static constexpr size_t nAlignment = 64;
+	/** Minimum size of a single arena in bytes. */
+	static constexpr size_t nArenaSize = 64 * 1024 * 1024;
+
+	/** \return Array of @a nFrames floats or nullptr if @a nFrames is
+	 *   not positive. Its content is not initialized. */
+	static float* allocate( int nFrames );
+	/** Releases data obtained from allocate(). */
+	static void release( float* pData );
+
+	/** Bytes of sample data residing in locked arenas. */
+	static size_t getLockedBytes();
+	/** Bytes of sample data residing in arenas which could not be
+	 * locked. */
+	static size_t getUnlockedBytes();
+
+private:
+	struct Arena {
+		/** Start of the mapping. Aligned to the size of huge
+		 * pages. */
+		char* pBase;
+		size_t nSize;
+		bool bLocked;
+		/** Bytes currently handed out. */
+		size_t nUsed;
+		/** Unused regions keyed by their offset. Adjacent regions are
+		 * merged on release(). */
+		std::map<size_t, size_t> freeRegions;
+	};
+
+	struct Allocation {
+		Arena* pArena;
+		size_t nOffset;
+		size_t nSize;
+	};
+
+	static Arena* createArena( size_t nMinSize );
+	static void destroyArena( Arena* pArena );
+	static bool allocateFrom( Arena* pArena, size_t nSize, size_t* pOffset );
+	static void logUsage();
+
+	static std::mutex m_mutex;
+	static std::vector<std::unique_ptr<Arena>> m_arenas;
+	static std::map<float*, Allocation> m_allocations;
+	static size_t m_nLockedBytes;
+	static size_t m_nUnlockedBytes;
+	/** Size of all locked arenas. Compared against the limit. */
+	static size_t m_nLockedArenaBytes;
+	/** Whether mlock() failed due to insufficient permissions. It will
+	 * not be tried again to avoid flooding the log. */
+	static bool m_bLockFailed;
+};
+
+};
+
+#endif  // H2C_SAMPLE_MEMORY_H
@@ -48,6 +48,7 @@
 #include <core/Basics/Drumkit.h>
 #include <core/H2Exception.h>
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/InstrumentReclaimer.h>
 #include <core/AudioEngine/TransportPosition.h>
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentComponent.h>
@@ -62,6 +63,9 @@
 #include <core/Basics/PatternList.h>
 #include <core/Basics/Note.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/DrumkitSwitcher.h>
+#include <core/Helpers/PlaylistPreloader.h>
+#include <core/Helpers/Random.h>
 #include <core/FX/LadspaFX.h>
 #include <core/FX/Effects.h>
 #include <core/SoundLibrary/SoundLibraryDatabase.h>
@@ -130,6 +134,8 @@ Hydrogen::Hydrogen() : m_nSelectedInstrumentNumber( 0 )
 
 	m_pAudioEngine = new AudioEngine();
 	m_pPlaylist = std::make_shared<Playlist>();
+	m_pPlaylistPreloader = std::make_unique<PlaylistPreloader>();
+	m_pDrumkitSwitcher = std::make_unique<DrumkitSwitcher>();
 
 	EventQueue::get_instance()->push_event( EVENT_STATE, static_cast<int>(AudioEngine::State::Initialized) );
 
@@ -152,6 +158,11 @@ Hydrogen::~Hydrogen()
 {
 	INFOLOG( "[~Hydrogen]" );
 
+	// The preloader reports via OSC and has to be stopped first. The
+	// drumkit switcher relies on the audio engine.
+	m_pPlaylistPreloader = nullptr;
+	m_pDrumkitSwitcher = nullptr;
+
 #ifdef H2CORE_HAVE_OSC
 	NsmClient* pNsmClient = NsmClient::get_instance();
 	if( pNsmClient ) {
@@ -168,8 +179,6 @@ Hydrogen::~Hydrogen()
 	m_pAudioEngine->prepare();
 	m_pAudioEngine->unlock();
 
-	killInstruments();
-
 	delete m_pAudioEngine;
 
 	__instance = nullptr;
@@ -223,10 +232,6 @@ void Hydrogen::sequencerStop()
 
 	m_pAudioEngine->stop();
 	Preferences::get_instance()->setRecordEvents(false);
-
-	// Delete redundant instruments still alive after switching the
-	// drumkit to a smaller one.
-	killInstruments();
 }
 
 Song::PlaybackTrack Hydrogen::getPlaybackTrackState() const {
@@ -286,6 +291,13 @@ void Hydrogen::setSong( std::shared_ptr<Song> pSong )
 		return;
 	}
 
+	// Set up the LADSPA FX stored in the new song. This is not done
+	// while loading it, since this would alter the effects of the
+	// current song when preloading upcoming playlist songs.
+	if ( pSong != nullptr ) {
+		pSong->applyLadspaFX();
+	}
+
 	m_pAudioEngine->lock( RIGHT_HERE );
 
 	// Move to the beginning.
@@ -317,7 +329,10 @@ void Hydrogen::setSong( std::shared_ptr<Song> pSong )
 	// are activated, m_pSong has to be set prior to the call of
 	// AudioEngine::setSong().
 	m_pSong = pSong;
-	if ( pSong != nullptr && pSong->getDrumkit() != nullptr ) {
+	if ( pSong != nullptr && pSong->getDrumkit() != nullptr &&
+		 ! pSong->getDrumkit()->areSamplesLoaded() ) {
+		// Songs handed over by the PlaylistPreloader come with all
+		// their samples loaded already.
 		pSong->getDrumkit()->loadSamples();
 	}
 
@@ -678,6 +693,12 @@ void Hydrogen::startExportSong( const QString& filename)
 {
 	AudioEngine* pAudioEngine = m_pAudioEngine;
 	CoreActionController::locateToTick( 0 );
+
+	// Start from the same state of the random number generators on
+	// every export to render humanization and probability identically.
+	if ( m_pSong != nullptr ) {
+		Random::setSeed( static_cast<uint64_t>( m_pSong->getRandomSeed() ) );
+	}
 	pAudioEngine->play();
 	pAudioEngine->getSampler()->stopPlayingNotes();
 
@@ -1067,44 +1088,19 @@ void Hydrogen::initJackTimebaseControl()
 }
 
 void Hydrogen::addInstrumentToDeathRow( std::shared_ptr<Instrument> pInstr ) {
-	m_instrumentDeathRow.push_back( pInstr );
-	killInstruments();
+	m_pAudioEngine->getInstrumentReclaimer()->retire( pInstr );
 }
 
 void Hydrogen::removeInstrumentFromDeathRow( std::shared_ptr<Instrument> pInstr ) {
-	for ( auto it = m_instrumentDeathRow.begin();
-		  it != m_instrumentDeathRow.end(); ) {
-        if ( *it == pInstr ) {
-            it = m_instrumentDeathRow.erase( it );
-		} else {
-            ++it;
-		}
-    }
+	m_pAudioEngine->getInstrumentReclaimer()->revive( pInstr );
 }
 
-void Hydrogen::killInstruments() {
-	std::shared_ptr<Instrument> pInstr;
-
-	while ( m_instrumentDeathRow.size() > 0 &&
-			( m_instrumentDeathRow.front() == nullptr ||
-			  ( m_instrumentDeathRow.front() != nullptr &&
-				m_instrumentDeathRow.front()->is_queued() == 0 ) ) ) {
-		pInstr = m_instrumentDeathRow.front();
-		m_instrumentDeathRow.pop_front();
-
-		if ( pInstr != nullptr  ) {
-			pInstr->unload_samples();
-		}
-	}
-
-	if ( m_instrumentDeathRow.size() > 0 ) {
-		pInstr = m_instrumentDeathRow.front();
-		if ( pInstr != nullptr ) {
-			INFOLOG( QString( "Instrument [%1] still has active notes:\n\t%2 " )
-					 .arg( pInstr->get_name() )
-					 .arg( pInstr->getEnqueuedBy().join( "\n\t" ) ) );
-		}
+void Hydrogen::addSampleToDeathRow( std::shared_ptr<Sample> pSample ) {
+	if ( pSample == nullptr || m_pAudioEngine == nullptr ||
+		 m_pAudioEngine->getInstrumentReclaimer() == nullptr ) {
+		return;
 	}
+	m_pAudioEngine->getInstrumentReclaimer()->retire( pSample );
 }
 
 
@@ -1597,14 +1593,9 @@ QString Hydrogen::toQString( const QString& sPrefix, bool bShort ) const {
 		} else {
 			sOutput.append( QString( "nullptr\n" ) );
 		}
-		sOutput.append( QString( "%1%2m_instrumentDeathRow:\n" ).arg( sPrefix ).arg( s ) );
-		for ( const auto& ii : m_instrumentDeathRow ) {
-			if ( ii != nullptr ) {
-				sOutput.append( QString( "%1" ).arg( ii->toQString( sPrefix + s + s, bShort ) ) );
-			} else {
-				sOutput.append( QString( "nullptr\n" ) );
-			}
-		}
+		sOutput.append( QString( "%1%2m_pInstrumentReclaimer:\n" ).arg( sPrefix ).arg( s ) );
+		sOutput.append( QString( "%1" ).arg( m_pAudioEngine->getInstrumentReclaimer()
+											->toQString( sPrefix + s + s, bShort ) ) );
 		sOutput.append( QString( "%1%2m_nSelectedInstrumentNumber: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nSelectedInstrumentNumber ) )
 			.append( QString( "%1%2m_nSelectedPatternNumber: %3\n" ).arg( sPrefix ).arg( s )
@@ -1631,6 +1622,12 @@ QString Hydrogen::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( "%1%2m_pPlaylist: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_pPlaylist == nullptr ? "nullptr" :
 						   m_pPlaylist->toQString( sPrefix + s, bShort ) ) )
+			.append( QString( "%1%2m_pPlaylistPreloader: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pPlaylistPreloader == nullptr ? "nullptr" :
+						   m_pPlaylistPreloader->toQString( sPrefix + s, bShort ) ) )
+			.append( QString( "%1%2m_pDrumkitSwitcher: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_pDrumkitSwitcher == nullptr ? "nullptr" :
+						   m_pDrumkitSwitcher->toQString( sPrefix + s, bShort ) ) )
 			.append( QString( "%1%2m_nHihatOpenness: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nHihatOpenness ) )
 			.append( QString( "%1%2lastMidiEvent: %3\n" ).arg( sPrefix ).arg( s )
@@ -1670,14 +1667,9 @@ QString Hydrogen::toQString( const QString& sPrefix, bool bShort ) const {
 		} else {
 			sOutput.append( QString( "nullptr" ) );
 		}						 
-		sOutput.append( QString( ", m_instrumentDeathRow: [" ) );
-		for ( const auto& ii : m_instrumentDeathRow ) {
-			if ( ii != nullptr ) {
-				sOutput.append( QString( "%1" ).arg( ii->toQString( sPrefix + s + s, bShort ) ) );
-			} else {
-				sOutput.append( QString( " nullptr" ) );
-			}
-		}
+		sOutput.append( QString( ", m_pInstrumentReclaimer: %1" )
+						.arg( m_pAudioEngine->getInstrumentReclaimer()
+							  ->toQString( sPrefix + s + s, bShort ) ) );
 		sOutput.append( QString( ", m_nSelectedInstrumentNumber: %1" )
 						.arg( m_nSelectedInstrumentNumber ) )
 			.append( QString( ", m_nSelectedPatternNumber: %1" )
@@ -1702,6 +1694,12 @@ QString Hydrogen::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", m_pPlaylist: %1" )
 					 .arg( m_pPlaylist == nullptr ? "nullptr" :
 						   m_pPlaylist->toQString( "", bShort ) ) )
+			.append( QString( ", m_pPlaylistPreloader: %1" )
+					 .arg( m_pPlaylistPreloader == nullptr ? "nullptr" :
+						   m_pPlaylistPreloader->toQString( "", bShort ) ) )
+			.append( QString( ", m_pDrumkitSwitcher: %1" )
+					 .arg( m_pDrumkitSwitcher == nullptr ? "nullptr" :
+						   m_pDrumkitSwitcher->toQString( "", bShort ) ) )
 			.append( QString( ", m_nHihatOpenness: %1" ).arg( m_nHihatOpenness ) )
 			.append( QString( ", lastMidiEvent: %1" )
 					 .arg( MidiMessage::EventToQString( m_lastMidiEvent ) ) )
@@ -42,6 +42,9 @@ namespace H2Core
 	class AudioEngine;
 	class SoundLibraryDatabase;
 	class Playlist;
+	class PlaylistPreloader;
+	class DrumkitSwitcher;
+	class Sample;
 
 ///
 /// Hydrogen Audio Engine.
@@ -155,6 +158,12 @@ public:
 	}
 	std::shared_ptr<Playlist> getPlaylist() const;
 	void setPlaylist( std::shared_ptr<Playlist> pPlaylist );
+	PlaylistPreloader* getPlaylistPreloader() const {
+		return m_pPlaylistPreloader.get();
+	}
+	DrumkitSwitcher* getDrumkitSwitcher() const {
+		return m_pDrumkitSwitcher.get();
+	}
 
 // ***** SEQUENCER ********
 	/// Start the internal sequencer
@@ -428,15 +437,24 @@ public:
 	 * note queues, the instrument's samples must not be unloaded right away
 	 * (the instrumet's destructor might not be called after deleting it since
 	 * it might live on in the undo/redo stack of the GUI). Instead, this
-	 * function will add it to a list of instruments marked for deletion and it
-	 * will be dealt with at a later time (after audio rendering was stopped).
+	 * function hands it to the #InstrumentReclaimer, which unloads its
+	 * samples as soon as the audio engine does not use it anymore.
 	 */
 	void addInstrumentToDeathRow( std::shared_ptr<Instrument> pInstr );
+	/**
+	 * Add @a pSample, which was just replaced in or removed from an
+	 * #InstrumentLayer, to death row.
+	 *
+	 * Notes still rendering it hold a reference of their own. In order
+	 * to not have its data freed by the audio thread once they are
+	 * done, the #InstrumentReclaimer keeps it alive till then.
+	 */
+	void addSampleToDeathRow( std::shared_ptr<Sample> pSample );
 
 		/** Since we are flushing the samples of the instruments in the death
-		 * row at a delayed point in time (like when stopping transport), we
-		 * have to take care not to get into trouble when switching
-		 * instrument/kits back and forth (like in undo/redo). */
+		 * row at a delayed point in time, we have to take care not to get
+		 * into trouble when switching instrument/kits back and forth (like
+		 * in undo/redo). */
 		void removeInstrumentFromDeathRow( std::shared_ptr<Instrument> pInstr );
 
 	/**
@@ -473,8 +491,6 @@ private:
 	 */
 	Hydrogen();
 
-		void killInstruments();
-
 	void			midiNoteOn( Note *note );
 
 	/**
@@ -539,8 +555,6 @@ private:
 	 */
 	std::shared_ptr<Timeline>	m_pTimeline;
 
-	/// Deleting instruments too soon leads to potential crashes.
-	std::list<std::shared_ptr<Instrument>> 	m_instrumentDeathRow;
 	
 	/**
 	 * Instrument currently focused/selected in the GUI. 
@@ -579,6 +593,12 @@ private:
 	std::shared_ptr<SoundLibraryDatabase> m_pSoundLibraryDatabase;
 
 	std::shared_ptr<Playlist> m_pPlaylist;
+	/** Loads the upcoming songs of #m_pPlaylist in the background. */
+	std::unique_ptr<PlaylistPreloader> m_pPlaylistPreloader;
+	/** Switches drumkits in the background.
+	 *
+	 * \see CoreActionController::switchDrumkit() */
+	std::unique_ptr<DrumkitSwitcher> m_pDrumkitSwitcher;
 
 		/** Controls the instrument selection within a hihat group. */
 		int m_nHihatOpenness;
@@ -25,6 +25,9 @@
 #if defined(H2CORE_HAVE_ALSA) || _DOXYGEN_
 
 #include <pthread.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <core/Preferences/Preferences.h>
 #include <core/EventQueue.h>
@@ -53,97 +56,200 @@ static int alsa_xrun_recovery( snd_pcm_t *handle, int err )
 	return err;
 }
 
+/// Converts @a nFrames frames of the rendered buffers into the sample
+/// format negotiated with the device and writes them into @a pAreas
+/// starting at @a nOffset.
+static void alsa_write_frames( const snd_pcm_channel_area_t* pAreas,
+							   snd_pcm_uframes_t nOffset,
+							   snd_pcm_uframes_t nFrames,
+							   snd_pcm_format_t format,
+							   const float* pIn_L, const float* pIn_R )
+{
+	for ( int nChannel = 0; nChannel < 2; ++nChannel ) {
+		const float* pIn = nChannel == 0 ? pIn_L : pIn_R;
+		const snd_pcm_channel_area_t& area = pAreas[ nChannel ];
+		const unsigned nStep = area.step / 8;
+		char* pOut = static_cast<char*>( area.addr ) + area.first / 8 +
+			nOffset * nStep;
+
+		switch ( format ) {
+		case SND_PCM_FORMAT_FLOAT:
+			for ( snd_pcm_uframes_t ii = 0; ii < nFrames; ++ii ) {
+				*reinterpret_cast<float*>( pOut ) = pIn[ ii ];
+				pOut += nStep;
+			}
+			break;
+		case SND_PCM_FORMAT_S32:
+			for ( snd_pcm_uframes_t ii = 0; ii < nFrames; ++ii ) {
+				*reinterpret_cast<int32_t*>( pOut ) = static_cast<int32_t>(
+					std::clamp( pIn[ ii ], -1.0f, 1.0f ) * 2147483647.0 );
+				pOut += nStep;
+			}
+			break;
+		case SND_PCM_FORMAT_S24_3LE:
+			for ( snd_pcm_uframes_t ii = 0; ii < nFrames; ++ii ) {
+				const int32_t nValue = static_cast<int32_t>(
+					std::clamp( pIn[ ii ], -1.0f, 1.0f ) * 8388607.0f );
+				pOut[ 0 ] = static_cast<char>( nValue & 0xff );
+				pOut[ 1 ] = static_cast<char>( ( nValue >> 8 ) & 0xff );
+				pOut[ 2 ] = static_cast<char>( ( nValue >> 16 ) & 0xff );
+				pOut += nStep;
+			}
+			break;
+		default:
+			for ( snd_pcm_uframes_t ii = 0; ii < nFrames; ++ii ) {
+				*reinterpret_cast<int16_t*>( pOut ) = static_cast<int16_t>(
+					std::clamp( pIn[ ii ], -1.0f, 1.0f ) * 32767.0f );
+				pOut += nStep;
+			}
+		}
+	}
+}
+
+/// Reports an xrun or write error @a nErr and tries to bring the
+/// playback stream in a nice state again.
+static void alsa_handle_error( AlsaAudioDriver* pDriver, int nErr )
+{
+	___ERRORLOG( QString( "Error while writing playback stream: %1" )
+				 .arg( snd_strerror( nErr ) ) );
+	pDriver->m_nXRuns++;
+	EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
+
+	int err;
+	if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, nErr, 0 ) ) < 0 ) {
+		___ERRORLOG( QString( "Can't recover from XRUN: %1" )
+					 .arg( snd_strerror( err ) ) );
+	}
+}
+
 void* alsaAudioDriver_processCaller( void* param )
 {
 	Base *__object = (Base*)param;
 	AlsaAudioDriver *pDriver = ( AlsaAudioDriver* )param;
 
-	// stolen from amSynth
-	struct sched_param sched;
-	sched.sched_priority = 50;
-	int res = sched_setscheduler( 0, SCHED_FIFO, &sched );
-	sched_getparam( 0, &sched );
-	if ( res ) {
-		__ERRORLOG( "Can't set realtime scheduling for ALSA Driver" );
-	}
-	__INFOLOG( QString( "Scheduling priority = %1" ).arg( sched.sched_priority ) );
+	pDriver->m_realtimeThread.enter();
 
 	sleep( 1 );
 
+	snd_pcm_t* pHandle = pDriver->m_pPlayback_handle;
+
 	int err;
-	if ( ( err = snd_pcm_prepare( pDriver->m_pPlayback_handle ) ) < 0 ) {
+	if ( ( err = snd_pcm_prepare( pHandle ) ) < 0 ) {
 		__ERRORLOG( QString( "Cannot prepare audio interface for use: %1" )
 					.arg( snd_strerror ( err ) ) );
 	}
 
-	int nFrames = pDriver->m_nBufferSize;
+	const snd_pcm_uframes_t nFrames = pDriver->m_nBufferSize;
 	__INFOLOG( QString( "nFrames: %1" ).arg( nFrames ) );
-	short pBuffer[ nFrames * 2 ];
 
 	float *pOut_L = pDriver->m_pOut_L;
 	float *pOut_R = pDriver->m_pOut_R;
 
+	// Layout of the interleaved buffer used without mmap access.
+	const unsigned nSampleBits = snd_pcm_format_physical_width( pDriver->m_format );
+	snd_pcm_channel_area_t bufferAreas[ 2 ];
+	for ( unsigned nChannel = 0; nChannel < 2; ++nChannel ) {
+		bufferAreas[ nChannel ].addr = pDriver->m_pBuffer;
+		bufferAreas[ nChannel ].first = nChannel * nSampleBits;
+		bufferAreas[ nChannel ].step = 2 * nSampleBits;
+	}
+
 	int nTimeoutInMilliseconds = 100;
 
 	while ( pDriver->m_bIsRunning ) {
-		// prepare the audio data
-		pDriver->m_processCallback( nFrames, nullptr );
-
-		for ( int i = 0; i < nFrames; ++i ) {
-			pBuffer[ i * 2 ] = ( short )( pOut_L[ i ] * 32768.0 );
-			pBuffer[ i * 2 + 1 ] = ( short )( pOut_R[ i ] * 32768.0 );
+		const snd_pcm_sframes_t nAvail = snd_pcm_avail_update( pHandle );
+		if ( nAvail < 0 ) {
+			alsa_handle_error( pDriver, nAvail );
+			continue;
 		}
 
-		// Check whether the playback stream is ready to process
-		// input.
-		if ( ( err = snd_pcm_wait( pDriver->m_pPlayback_handle,
-								   nTimeoutInMilliseconds ) ) < 1 ) {
-			// Playback stream is not ready. Since we opened the stream
-			// in blocking mode, the call to snd_pcm_writei() may take
-			// forever and cause the audio engine to stop working
-			// entirely. In addition, this also prevents the audio
-			// driver to be stopped and thus prevents the user from
-			// selecting a different/working version.
+		if ( nAvail < static_cast<snd_pcm_sframes_t>( nFrames ) ) {
+			if ( snd_pcm_state( pHandle ) == SND_PCM_STATE_PREPARED ) {
+				// The buffer is filled but the start threshold was not
+				// reached.
+				snd_pcm_start( pHandle );
+			}
+
+			// Sleep until the device is able to take another period.
+			// We do not block in the write call itself. Else, the
+			// audio engine could stop working entirely in case the
+			// device does not respond and the driver could not be
+			// stopped (preventing the user from selecting a different
+			// one).
+			err = poll( pDriver->m_pPollFds, pDriver->m_nPollFds,
+						nTimeoutInMilliseconds );
 			if ( err == 0 ) {
 				___ERRORLOG( QString( "timeout after [%1] milliseconds" )
 							 .arg( nTimeoutInMilliseconds ) );
-			} else {
-				___ERRORLOG( QString( "Error while waiting for playback stream: %1" )
-							 .arg( snd_strerror( err ) ) );
+				pDriver->m_nXRuns++;
+				EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
+				continue;
+			}
+			else if ( err < 0 ) {
+				if ( errno == EINTR ) {
+					// Interrupted by a signal.
+					continue;
+				}
+
+				// The poll descriptors themselves are broken. Retrying
+				// would just spin in a realtime thread.
+				___ERRORLOG( QString( "Unable to poll playback stream: %1. Stopping driver thread." )
+							 .arg( strerror( errno ) ) );
+				break;
+			}
+
+			unsigned short nRevents;
+			snd_pcm_poll_descriptors_revents( pHandle, pDriver->m_pPollFds,
+											  pDriver->m_nPollFds, &nRevents );
+			if ( nRevents & POLLERR ) {
+				alsa_handle_error( pDriver, snd_pcm_state( pHandle ) ==
+								   SND_PCM_STATE_SUSPENDED ? -ESTRPIPE : -EPIPE );
 			}
-			pDriver->m_nXRuns++;
-			EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
-		} else {
-
-			// Playback stream is ready, let's write out the audio
-			// buffer.
-			if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
-				___ERRORLOG( QString( "Error while writing playback stream: %1" )
-							 .arg( snd_strerror( err ) ) );
-
-				// Try to bring the playback device in a nice state
-				// again and retry writing the output buffer.
-				if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) == 0 ) {
-					___INFOLOG( "Successfully recovered from error. Attempt to write buffer again." );
-					if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
-						___ERRORLOG( QString( "Unable to write playback stream again: %1" )
-									 .arg( snd_strerror( err ) ) );
-						pDriver->m_nXRuns++;
-						EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
-						if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) < 0 ) {
-							__ERRORLOG( QString( "Can't recover from XRUN: %1" )
-										.arg( snd_strerror( err ) ) );
-						}
-					}
-				} else {
-					__ERRORLOG( QString( "Can't recover from XRUN: %1" )
-								.arg( snd_strerror( err ) ) );
-					pDriver->m_nXRuns++;
-					EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
+			continue;
+		}
+
+		// prepare the audio data
+		pDriver->m_processCallback( nFrames, nullptr );
+
+		if ( pDriver->m_bUseMmap ) {
+			// Render straight into the buffer of the device. It might
+			// hand out the requested area in several chunks in case it
+			// wraps around.
+			snd_pcm_uframes_t nWritten = 0;
+			while ( nWritten < nFrames ) {
+				const snd_pcm_channel_area_t* pAreas;
+				snd_pcm_uframes_t nOffset;
+				snd_pcm_uframes_t nChunk = nFrames - nWritten;
+				if ( ( err = snd_pcm_mmap_begin( pHandle, &pAreas, &nOffset,
+												 &nChunk ) ) < 0 ) {
+					alsa_handle_error( pDriver, err );
+					break;
 				}
+
+				alsa_write_frames( pAreas, nOffset, nChunk, pDriver->m_format,
+								   &pOut_L[ nWritten ], &pOut_R[ nWritten ] );
+
+				const snd_pcm_sframes_t nCommitted =
+					snd_pcm_mmap_commit( pHandle, nOffset, nChunk );
+				if ( nCommitted < 0 ||
+					 static_cast<snd_pcm_uframes_t>( nCommitted ) != nChunk ) {
+					alsa_handle_error( pDriver, nCommitted < 0 ? nCommitted : -EPIPE );
+					break;
+				}
+				nWritten += nChunk;
+			}
+		}
+		else {
+			alsa_write_frames( bufferAreas, 0, nFrames, pDriver->m_format,
+							   pOut_L, pOut_R );
+			if ( ( err = snd_pcm_writei( pHandle, pDriver->m_pBuffer,
+										 nFrames ) ) < 0 ) {
+				alsa_handle_error( pDriver, err );
 			}
 		}
 	}
+
+	pDriver->m_realtimeThread.leave();
 	return nullptr;
 }
 
@@ -189,6 +295,12 @@ AlsaAudioDriver::AlsaAudioDriver( audioProcessCallback processCallback )
 		, m_nBufferSize( 0 )
 		, m_pPlayback_handle( nullptr )
 		, m_processCallback( processCallback )
+		, m_format( SND_PCM_FORMAT_UNKNOWN )
+		, m_bUseMmap( false )
+		, m_pBuffer( nullptr )
+		, m_pPollFds( nullptr )
+		, m_nPollFds( 0 )
+		, m_realtimeThread( "ALSA" )
 {
 	m_nSampleRate = Preferences::get_instance()->m_nSampleRate;
 	m_sAlsaAudioDevice = Preferences::get_instance()->m_sAlsaAudioDevice;
@@ -271,19 +383,46 @@ int AlsaAudioDriver::connect()
 				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
 		return 1;
 	}
-//	snd_pcm_hw_params_set_access( m_pPlayback_handle, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED  );
 
+	// Prefer rendering straight into the buffer of the device.
+	m_bUseMmap = true;
 	if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
 											   hw_params,
-											   SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
-		ERRORLOG( QString( "error in snd_pcm_hw_params_set_access: %1" )
-				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+											   SND_PCM_ACCESS_MMAP_INTERLEAVED ) ) < 0 ) {
+		INFOLOG( QString( "mmap access not supported (%1). Using read/write access instead." )
+				 .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+		m_bUseMmap = false;
+		if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
+												   hw_params,
+												   SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
+			ERRORLOG( QString( "error in snd_pcm_hw_params_set_access: %1" )
+					  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+			return 1;
+		}
+	}
+
+	// Sample formats ordered by preference. Floating point samples can
+	// be passed to the device without any conversion.
+	const snd_pcm_format_t formats[] = { SND_PCM_FORMAT_FLOAT,
+										 SND_PCM_FORMAT_S32,
+										 SND_PCM_FORMAT_S24_3LE,
+										 SND_PCM_FORMAT_S16 };
+	m_format = SND_PCM_FORMAT_UNKNOWN;
+	for ( const auto& format : formats ) {
+		if ( snd_pcm_hw_params_test_format( m_pPlayback_handle,
+											hw_params, format ) == 0 ) {
+			m_format = format;
+			break;
+		}
+	}
+	if ( m_format == SND_PCM_FORMAT_UNKNOWN ) {
+		ERRORLOG( "Device does not support any of the available sample formats" );
 		return 1;
 	}
 
 	if ( ( err = snd_pcm_hw_params_set_format( m_pPlayback_handle,
 											   hw_params,
-											   SND_PCM_FORMAT_S16_LE ) ) < 0 ) {
+											   m_format ) ) < 0 ) {
 		ERRORLOG( QString( "error in snd_pcm_hw_params_set_format: %1" )
 				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
 		return 1;
@@ -308,7 +447,7 @@ int AlsaAudioDriver::connect()
 	// *_get_buffer_size) is sized to keep at least 2 periods' worth
 	// of data.
 	//
-	unsigned nPeriods = 2;
+	unsigned nPeriods = Preferences::get_instance()->m_nAlsaPeriods;
 	if ( ( err = snd_pcm_hw_params_set_periods_near( m_pPlayback_handle,
 													 hw_params,
 													 &nPeriods,
@@ -339,11 +478,45 @@ int AlsaAudioDriver::connect()
 
 	snd_pcm_hw_params_get_rate( hw_params, &m_nSampleRate, nullptr );
 
+	snd_pcm_uframes_t buffer_size;
+	snd_pcm_hw_params_get_buffer_size( hw_params, &buffer_size );
+
 	INFOLOG( QString( "*** PERIOD SIZE: %1" ).arg( period_size ) );
 	INFOLOG( QString( "*** SAMPLE RATE: %1" ).arg( m_nSampleRate ) );
-	INFOLOG( QString( "*** BUFFER SIZE: %1" ).arg( nPeriods * m_nBufferSize ) );
+	INFOLOG( QString( "*** BUFFER SIZE: %1" ).arg( buffer_size ) );
+	INFOLOG( QString( "*** FORMAT: %1, ACCESS: %2" )
+			 .arg( snd_pcm_format_name( m_format ) )
+			 .arg( m_bUseMmap ? "mmap" : "read/write" ) );
+
+	// Wake up the process thread once a whole period can be written
+	// and start playback as soon as the buffer is filled.
+	snd_pcm_sw_params_t *sw_params;
+	snd_pcm_sw_params_alloca( &sw_params );
+	if ( ( err = snd_pcm_sw_params_current( m_pPlayback_handle, sw_params ) ) < 0 ||
+		 ( err = snd_pcm_sw_params_set_avail_min( m_pPlayback_handle, sw_params,
+												  period_size ) ) < 0 ||
+		 ( err = snd_pcm_sw_params_set_start_threshold( m_pPlayback_handle, sw_params,
+														buffer_size ) ) < 0 ||
+		 ( err = snd_pcm_sw_params( m_pPlayback_handle, sw_params ) ) < 0 ) {
+		ERRORLOG( QString( "error while setting software parameters: %1" )
+				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+		return 1;
+	}
 
-	//snd_pcm_hw_params_free( hw_params );
+	m_nPollFds = snd_pcm_poll_descriptors_count( m_pPlayback_handle );
+	if ( m_nPollFds <= 0 ) {
+		ERRORLOG( "Unable to retrieve poll descriptors" );
+		return 1;
+	}
+	m_pPollFds = new struct pollfd[ m_nPollFds ];
+	snd_pcm_poll_descriptors( m_pPlayback_handle, m_pPollFds, m_nPollFds );
+
+	if ( ! m_bUseMmap ) {
+		const size_t nBytes = m_nBufferSize * 2 *
+			snd_pcm_format_physical_width( m_format ) / 8;
+		m_pBuffer = new char[ nBytes ];
+		memset( m_pBuffer, 0, nBytes );
+	}
 
 	m_pOut_L = new float[ m_nBufferSize ];
 	m_pOut_R = new float[ m_nBufferSize ];
@@ -353,6 +526,8 @@ int AlsaAudioDriver::connect()
 
 	m_bIsRunning = true;
 
+	m_realtimeThread.prepare();
+
 	// start the main thread
 	pthread_attr_t attr;
 	pthread_attr_init( &attr );
@@ -379,6 +554,13 @@ void AlsaAudioDriver::disconnect()
 
 	delete[] m_pOut_R;
 	m_pOut_R = nullptr;
+
+	delete[] m_pBuffer;
+	m_pBuffer = nullptr;
+
+	delete[] m_pPollFds;
+	m_pPollFds = nullptr;
+	m_nPollFds = 0;
 }
 
 unsigned AlsaAudioDriver::getBufferSize()
@@ -415,14 +597,20 @@ QString AlsaAudioDriver::toQString( const QString& sPrefix, bool bShort ) const
 			.append( QString( "%1%2m_nXRuns: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nXRuns ) )
 			.append( QString( "%1%2m_nSampleRate: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_nSampleRate ) );
+					 .arg( m_nSampleRate ) )
+			.append( QString( "%1%2m_format: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( snd_pcm_format_name( m_format ) ) )
+			.append( QString( "%1%2m_bUseMmap: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bUseMmap ) );
 	} else {
 		sOutput = QString( "[AlsaAudioDriver]" )
 			.append( QString( " m_bIsRunning: %1" ).arg( m_bIsRunning ) )
 			.append( QString( ", m_nBufferSize: %1" ).arg( m_nBufferSize ) )
 			.append( QString( ", m_sAlsaAudioDevice: %1" ).arg( m_sAlsaAudioDevice ) )
 			.append( QString( ", m_nXRuns: %1" ).arg( m_nXRuns ) )
-			.append( QString( ", m_nSampleRate: %1" ).arg( m_nSampleRate ) );
+			.append( QString( ", m_nSampleRate: %1" ).arg( m_nSampleRate ) )
+			.append( QString( ", m_format: %1" ).arg( snd_pcm_format_name( m_format ) ) )
+			.append( QString( ", m_bUseMmap: %1" ).arg( m_bUseMmap ) );
 	}
 
 	return sOutput;
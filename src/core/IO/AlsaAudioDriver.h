@@ -24,10 +24,12 @@
 
 #include <core/IO/AudioOutput.h>
 #include <core/IO/NullDriver.h>
+#include <core/IO/RealtimeThread.h>
 
 #if defined(H2CORE_HAVE_ALSA) || _DOXYGEN_
 
 #include <inttypes.h>
+#include <poll.h>
 #include <alsa/asoundlib.h>
 
 namespace H2Core
@@ -46,6 +48,22 @@ public:
 	QString m_sAlsaAudioDevice;
 	audioProcessCallback m_processCallback;
 	int m_nXRuns;
+	/** Sample format negotiated with the device. Floating point, 32
+	 * bit, and packed 24 bit integers are preferred over 16 bit
+	 * ones. */
+	snd_pcm_format_t m_format;
+	/** Whether audio is rendered straight into the buffer of the
+	 * device (SND_PCM_ACCESS_MMAP_INTERLEAVED). If not supported,
+	 * #m_pBuffer is written using snd_pcm_writei(). */
+	bool m_bUseMmap;
+	/** Interleaved buffer in #m_format. Only used without mmap
+	 * access. */
+	char* m_pBuffer;
+	/** Descriptors polled by the process thread to wait for the next
+	 * period. */
+	struct pollfd* m_pPollFds;
+	int m_nPollFds;
+	RealtimeThread m_realtimeThread;
 
 	AlsaAudioDriver( audioProcessCallback processCallback );
 	~AlsaAudioDriver();
@@ -546,8 +546,10 @@ void AlsaMidiDriver::getPortInfo( const QString& sPortName, int& nClient, int& n
 	ERRORLOG( "Midi port " + sPortName + " not found" );
 }
 
-void AlsaMidiDriver::handleQueueNote(Note* pNote)
+void AlsaMidiDriver::handleQueueNote( Note* pNote, int nFrameOffset )
 {
+	UNUSED( nFrameOffset );
+
 	if ( seq_handle == nullptr ) {
 		ERRORLOG( "seq_handle = NULL " );
 		return;
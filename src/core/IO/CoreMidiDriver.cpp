@@ -238,8 +238,10 @@ std::vector<QString> CoreMidiDriver::getOutputPortList()
 	return cmPortList;
 }
 
-void CoreMidiDriver::handleQueueNote(Note* pNote)
+void CoreMidiDriver::handleQueueNote( Note* pNote, int nFrameOffset )
 {
+	UNUSED( nFrameOffset );
+
 	if (cmH2Dst == 0 ) {
 		ERRORLOG( "cmH2Dst = 0 " );
 		return;
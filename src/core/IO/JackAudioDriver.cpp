@@ -29,10 +29,13 @@
 #include <cassert>
 #include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <thread>
 #include <jack/metadata.h>
 
 #include <core/Hydrogen.h>
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/FlightRecorder.h>
 #include <core/AudioEngine/TransportPosition.h>
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Instrument.h>
@@ -108,6 +111,11 @@ int JackAudioDriver::jackXRunCallback( void *arg ) {
 	// position.
 	JackAudioDriver::m_nIntegrationLastRelocationFrame = -1;
 #endif
+	auto pFlightRecorder =
+		Hydrogen::get_instance()->getAudioEngine()->getFlightRecorder();
+	if ( pFlightRecorder != nullptr ) {
+		pFlightRecorder->notifyXrun( FlightRecorder::XrunSource::Driver );
+	}
 	EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
 	return 0;
 }
@@ -123,6 +131,9 @@ JackAudioDriver* JackAudioDriver::pJackDriverInstance = nullptr;
 JackAudioDriver::JackAudioDriver( JackProcessCallback m_processCallback )
 	: AudioOutput()
 	, m_nTrackPortCount( 0 )
+	, m_nTrackRoutingGeneration( -1 )
+	, m_bTrackRoutingPending( false )
+	, m_bTrackPortWorkerShutdown( false )
 	, m_pClient( nullptr )
 	, m_pOutputPort1( nullptr )
 	, m_pOutputPort2( nullptr )
@@ -151,12 +162,28 @@ JackAudioDriver::JackAudioDriver( JackProcessCallback m_processCallback )
 
 	memset( m_pTrackOutputPortsL, 0, sizeof(m_pTrackOutputPortsL) );
 	memset( m_pTrackOutputPortsR, 0, sizeof(m_pTrackOutputPortsR) );
+	memset( m_trackRoutings, 0, sizeof(m_trackRoutings) );
+	memset( m_pTrackBuffersL, 0, sizeof(m_pTrackBuffersL) );
+	memset( m_pTrackBuffersR, 0, sizeof(m_pTrackBuffersR) );
+	m_pTrackRouting.store( nullptr );
+	m_pTrackRoutingInUse.store( nullptr );
 
 	m_JackTransportState  = JackTransportStopped;
+
+	m_trackPortWorker = std::thread( &JackAudioDriver::trackPortWorkerLoop, this );
 }
 
 JackAudioDriver::~JackAudioDriver()
 {
+	{
+		std::lock_guard<std::mutex> lock( m_trackPortMutex );
+		m_bTrackPortWorkerShutdown = true;
+	}
+	m_trackPortCondition.notify_one();
+	if ( m_trackPortWorker.joinable() ) {
+		m_trackPortWorker.join();
+	}
+
 	disconnect();
 }
 
@@ -269,8 +296,24 @@ void JackAudioDriver::deactivate()
 			ERRORLOG( "Error in jack_deactivate" );
 		}
 	}
+	std::lock_guard<std::mutex> lock( m_trackPortMutex );
+
+	// The process callback is not running anymore. Retired ports can
+	// be dropped right away.
+	if ( m_pClient != nullptr ) {
+		for ( const auto& port : m_retiredTrackPorts ) {
+			jack_port_unregister( m_pClient, port.pPortL );
+			jack_port_unregister( m_pClient, port.pPortR );
+		}
+	}
+	m_retiredTrackPorts.clear();
+	m_bTrackRoutingPending = false;
+
 	memset( m_pTrackOutputPortsL, 0, sizeof(m_pTrackOutputPortsL) );
 	memset( m_pTrackOutputPortsR, 0, sizeof(m_pTrackOutputPortsR) );
+
+	m_pTrackRouting.store( nullptr );
+	m_pTrackRoutingInUse.store( nullptr );
 }
 
 unsigned JackAudioDriver::getBufferSize()
@@ -285,16 +328,32 @@ unsigned JackAudioDriver::getSampleRate()
 
 void JackAudioDriver::clearPerTrackAudioBuffers( uint32_t nFrames )
 {
-	if ( m_pClient != nullptr &&
+	// Acknowledge the latest routing. From now on the ports of the
+	// previous one won't be touched anymore.
+	TrackRouting* pRouting = m_pTrackRouting.load( std::memory_order_acquire );
+	m_pTrackRoutingInUse.store( pRouting, std::memory_order_release );
+
+	if ( m_pClient != nullptr && pRouting != nullptr &&
 		 Preferences::get_instance()->m_bJackTrackOuts ) {
 		float* pBuffer;
 
-		for ( int ii = 0; ii < m_nTrackPortCount; ++ii ) {
-			pBuffer = getTrackOut_L( ii );
+		for ( int ii = 0; ii < pRouting->nPortCount; ++ii ) {
+			pBuffer = nullptr;
+			if ( pRouting->portsL[ ii ] != nullptr ) {
+				pBuffer = static_cast<jack_default_audio_sample_t*>(
+					jack_port_get_buffer( pRouting->portsL[ ii ], nFrames ) );
+			}
+			m_pTrackBuffersL[ ii ] = pBuffer;
 			if ( pBuffer != nullptr ) {
 				memset( pBuffer, 0, nFrames * sizeof( float ) );
 			}
-			pBuffer = getTrackOut_R( ii );
+
+			pBuffer = nullptr;
+			if ( pRouting->portsR[ ii ] != nullptr ) {
+				pBuffer = static_cast<jack_default_audio_sample_t*>(
+					jack_port_get_buffer( pRouting->portsR[ ii ], nFrames ) );
+			}
+			m_pTrackBuffersR[ ii ] = pBuffer;
 			if ( pBuffer != nullptr ) {
 				memset( pBuffer, 0, nFrames * sizeof( float ) );
 			}
@@ -796,44 +855,60 @@ float* JackAudioDriver::getOut_R()
 	return out;
 }
 
-float* JackAudioDriver::getTrackOut_L( unsigned nTrack )
+float* JackAudioDriver::getTrackOut_L( unsigned nTrack ) const
 {
-	if ( nTrack > static_cast<unsigned>(m_nTrackPortCount) ) {
+	const auto pRouting = m_pTrackRoutingInUse.load( std::memory_order_relaxed );
+	if ( pRouting == nullptr ||
+		 nTrack >= static_cast<unsigned>(pRouting->nPortCount) ) {
 		return nullptr;
 	}
 
-	jack_port_t* pPort = m_pTrackOutputPortsL[nTrack];
-	jack_default_audio_sample_t* out = nullptr;
-	if( pPort ) {
-		out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer( pPort, JackAudioDriver::jackServerBufferSize));
-	}
-	return out;
+	return m_pTrackBuffersL[ nTrack ];
 }
 
-float* JackAudioDriver::getTrackOut_R( unsigned nTrack )
+float* JackAudioDriver::getTrackOut_R( unsigned nTrack ) const
 {
-	if( nTrack > static_cast<unsigned>(m_nTrackPortCount) ) {
+	const auto pRouting = m_pTrackRoutingInUse.load( std::memory_order_relaxed );
+	if ( pRouting == nullptr ||
+		 nTrack >= static_cast<unsigned>(pRouting->nPortCount) ) {
 		return nullptr;
 	}
 
-	jack_port_t* pPort = m_pTrackOutputPortsR[nTrack];
-	jack_default_audio_sample_t* out = nullptr;
-	if( pPort ) {
-		out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer( pPort, JackAudioDriver::jackServerBufferSize));
+	return m_pTrackBuffersR[ nTrack ];
+}
+
+int JackAudioDriver::getTrackNumber( int nInstrumentId, int nComponentIdx ) const
+{
+	const auto pRouting = m_pTrackRoutingInUse.load( std::memory_order_relaxed );
+	if ( pRouting == nullptr ||
+		 nInstrumentId < 0 || nInstrumentId >= MAX_INSTRUMENTS ||
+		 nComponentIdx < 0 || nComponentIdx >= MAX_COMPONENTS ) {
+		return -1;
+	}
+
+	return pRouting->trackMap[ nInstrumentId ][ nComponentIdx ];
+}
+
+int JackAudioDriver::getTrackRoutingGeneration() const
+{
+	const auto pRouting = m_pTrackRoutingInUse.load( std::memory_order_relaxed );
+	if ( pRouting == nullptr ) {
+		return -1;
 	}
-	return out;
+
+	return pRouting->nGeneration;
 }
 
 float* JackAudioDriver::getTrackOut_L( std::shared_ptr<Instrument> instr,
 									   int nComponentIdx )
 {
-	return getTrackOut_L(m_trackMap[instr->get_id()][ nComponentIdx ]);
+	return getTrackOut_L( getTrackNumber( instr->get_id(), nComponentIdx ) );
 }
 
 float* JackAudioDriver::getTrackOut_R( std::shared_ptr<Instrument> instr,
 									   int nComponentIdx )
 {
-	return getTrackOut_R(m_trackMap[instr->get_id()][ nComponentIdx ]);
+	return getTrackOut_R( getTrackNumber( instr->get_id(), nComponentIdx ) );
 }
 
 
@@ -1078,11 +1153,13 @@ void JackAudioDriver::makeTrackOutputs( std::shared_ptr<Song> pSong )
 
 	WARNINGLOG( QString( "Creating / renaming %1 ports" ).arg( nInstruments ) );
 
+	std::unique_lock<std::mutex> lock( m_trackPortMutex );
+
 	int nTrackCount = 0;
 
 	for( int i = 0 ; i < MAX_INSTRUMENTS ; i++ ){
 		for ( int j = 0 ; j < MAX_COMPONENTS ; j++ ){
-			m_trackMap[i][j] = 0;
+			m_trackMap[i][j] = -1;
 		}
 	}
 	// Creates a new output track or reassigns an existing one for
@@ -1102,22 +1179,102 @@ void JackAudioDriver::makeTrackOutputs( std::shared_ptr<Song> pSong )
 			nTrackCount++;
 		}
 	}
-	// clean up unused ports
-	jack_port_t *pPortL, *pPortR;
+
+	// Surplus ports are retired. The audio thread might still write
+	// to them till it picked up the routing published next.
 	for ( int n = nTrackCount; n < m_nTrackPortCount; n++ ) {
-		pPortL = m_pTrackOutputPortsL[n];
-		pPortR = m_pTrackOutputPortsR[n];
+		m_retiredTrackPorts.push_back( { m_pTrackOutputPortsL[n],
+										 m_pTrackOutputPortsR[n],
+										 m_nTrackRoutingGeneration + 1 } );
 		m_pTrackOutputPortsL[n] = nullptr;
-		if ( jack_port_unregister( m_pClient, pPortL ) != 0 ) {
-			ERRORLOG( QString( "Unable to unregister left port [%1]" ).arg( n ) );
-		}
 		m_pTrackOutputPortsR[n] = nullptr;
-		if ( jack_port_unregister( m_pClient, pPortR ) != 0 ) {
-			ERRORLOG( QString( "Unable to unregister right port [%1]" ).arg( n ) );
-		}
 	}
-
 	m_nTrackPortCount = nTrackCount;
+
+	m_bTrackRoutingPending = ! publishTrackRouting();
+	if ( m_bTrackRoutingPending || m_retiredTrackPorts.size() > 0 ) {
+		lock.unlock();
+		m_trackPortCondition.notify_one();
+	}
+}
+
+bool JackAudioDriver::publishTrackRouting()
+{
+	TrackRouting* pCurrent = m_pTrackRouting.load( std::memory_order_acquire );
+	TrackRouting* pInUse = m_pTrackRoutingInUse.load( std::memory_order_acquire );
+
+	// In case the previous routing was not picked up yet, the audio
+	// thread might still use the one we are about to fill. This is
+	// only safe to overwrite if the process callback never picked up
+	// any routing since the client was activated.
+	if ( pInUse != pCurrent && pInUse != nullptr ) {
+		return false;
+	}
+
+	TrackRouting* pNext = pCurrent == &m_trackRoutings[ 0 ] ?
+		&m_trackRoutings[ 1 ] : &m_trackRoutings[ 0 ];
+
+	memcpy( pNext->trackMap, m_trackMap, sizeof( m_trackMap ) );
+	memset( pNext->portsL, 0, sizeof( pNext->portsL ) );
+	memset( pNext->portsR, 0, sizeof( pNext->portsR ) );
+	for ( int ii = 0; ii < m_nTrackPortCount; ++ii ) {
+		pNext->portsL[ ii ] = m_pTrackOutputPortsL[ ii ];
+		pNext->portsR[ ii ] = m_pTrackOutputPortsR[ ii ];
+	}
+	pNext->nPortCount = m_nTrackPortCount;
+	pNext->nGeneration = ++m_nTrackRoutingGeneration;
+
+	m_pTrackRouting.store( pNext, std::memory_order_release );
+
+	return true;
+}
+
+bool JackAudioDriver::isTrackRoutingPickedUp( int nGeneration ) const
+{
+	const auto pCurrent = m_pTrackRouting.load( std::memory_order_acquire );
+	const auto pInUse = m_pTrackRoutingInUse.load( std::memory_order_acquire );
+	if ( pInUse != pCurrent && pInUse != nullptr ) {
+		// The process callback did not pick up the latest routing yet.
+		return false;
+	}
+
+	return pCurrent == nullptr || pCurrent->nGeneration >= nGeneration;
+}
+
+void JackAudioDriver::trackPortWorkerLoop()
+{
+	std::unique_lock<std::mutex> lock( m_trackPortMutex );
+	while ( ! m_bTrackPortWorkerShutdown ) {
+		if ( m_bTrackRoutingPending ) {
+			m_bTrackRoutingPending = ! publishTrackRouting();
+		}
+
+		for ( auto it = m_retiredTrackPorts.begin();
+			  it != m_retiredTrackPorts.end(); ) {
+			if ( m_pClient != nullptr &&
+				 isTrackRoutingPickedUp( it->nGeneration ) ) {
+				if ( jack_port_unregister( m_pClient, it->pPortL ) != 0 ) {
+					ERRORLOG( "Unable to unregister left track port" );
+				}
+				if ( jack_port_unregister( m_pClient, it->pPortR ) != 0 ) {
+					ERRORLOG( "Unable to unregister right track port" );
+				}
+				it = m_retiredTrackPorts.erase( it );
+			}
+			else {
+				++it;
+			}
+		}
+
+		if ( m_bTrackRoutingPending || m_retiredTrackPorts.size() > 0 ) {
+			// Wait for the process callback to pick up the latest
+			// routing. It does so at the beginning of each cycle.
+			m_trackPortCondition.wait_for( lock, std::chrono::milliseconds( 10 ) );
+		}
+		else {
+			m_trackPortCondition.wait( lock );
+		}
+	}
 }
 
 void JackAudioDriver::setTrackOutput( int n, std::shared_ptr<Instrument> pInstrument, std::shared_ptr<InstrumentComponent> pInstrumentComponent, std::shared_ptr<Song> pSong )
@@ -1144,6 +1301,14 @@ void JackAudioDriver::setTrackOutput( int n, std::shared_ptr<Instrument> pInstru
 	// have to be created.
 	if ( m_nTrackPortCount <= n ) {
 		for ( int m = m_nTrackPortCount; m <= n; m++ ) {
+			if ( m_retiredTrackPorts.size() > 0 ) {
+				// Not unregistered yet. It will be renamed below.
+				m_pTrackOutputPortsL[m] = m_retiredTrackPorts.back().pPortL;
+				m_pTrackOutputPortsR[m] = m_retiredTrackPorts.back().pPortR;
+				m_retiredTrackPorts.pop_back();
+				continue;
+			}
+
 			sComponentName = QString( "Track_%1_" ).arg( m + 1 );
 			m_pTrackOutputPortsL[m] =
 				jack_port_register( m_pClient, ( sComponentName + "L" ).toLocal8Bit(),
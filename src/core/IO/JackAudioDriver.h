@@ -30,9 +30,14 @@
 #if defined(H2CORE_HAVE_JACK) || _DOXYGEN_
 // JACK support is enabled.
 
+#include <atomic>
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <pthread.h>
+#include <thread>
+#include <vector>
 #include <jack/jack.h>
 #include <jack/transport.h>
 
@@ -167,8 +172,12 @@ public:
 
 	virtual int getXRuns() const override;
 
-	/** Resets the buffers contained in #m_pTrackOutputPortsL and
-	 * #m_pTrackOutputPortsR.
+	/** Picks up the latest routing published by makeTrackOutputs(),
+	 * resolves the buffers of all its ports for the current cycle,
+	 * and resets them.
+	 *
+	 * Must be called from within the audio process callback prior
+	 * to any of the track output getters.
 	 * 
 	 * @param nFrames Size of the buffers used in the audio process
 	 * callback function.
@@ -206,26 +215,48 @@ public:
 	/**
 	 * Get content of left output port of a specific track.
 	 *
-	 * \param nTrack Track number. Must not be bigger than
-	 * #m_nTrackPortCount.
+	 * The buffer was already resolved in
+	 * clearPerTrackAudioBuffers() and this function does neither
+	 * query the JACK server nor lock anything.
+	 *
+	 * \param nTrack Track number. Must be smaller than the number of
+	 * ports in the routing currently in use.
 	 *
 	 * \return Pointer to buffer content of type
-	 * _jack_default_audio_sample_t*_ (jack/types.h)
+	 * _jack_default_audio_sample_t*_ (jack/types.h) or nullptr for
+	 * an invalid track.
 	 */
-	float* getTrackOut_L( unsigned nTrack );
+	float* getTrackOut_L( unsigned nTrack ) const;
 	/**
 	 * Get content of right output port of a specific track.
 	 *
-	 * \param nTrack Track number. Must not be bigger than
-	 * #m_nTrackPortCount.
+	 * \param nTrack Track number. Must be smaller than the number of
+	 * ports in the routing currently in use.
 	 *
 	 * \return Pointer to buffer content of type
-	 * _jack_default_audio_sample_t*_ (jack/types.h)
+	 * _jack_default_audio_sample_t*_ (jack/types.h) or nullptr for
+	 * an invalid track.
+	 */
+	float* getTrackOut_R( unsigned nTrack ) const;
+	/**
+	 * Looks up the track a component of an instrument is routed to
+	 * in the routing used during the current process cycle.
+	 *
+	 * Only to be called from within the audio process callback. The
+	 * result stays valid as long as getTrackRoutingGeneration() does
+	 * not change and can thus be cached by the rendering voice.
+	 *
+	 * \return Track number or -1 in case there is no such track.
 	 */
-	float* getTrackOut_R( unsigned nTrack );
+	int getTrackNumber( int nInstrumentId, int nComponentIdx ) const;
+	/** Incremented each time makeTrackOutputs() publishes a new
+	 * routing - across deactivation and reactivation of the client
+	 * as well. Only to be called from within the audio process
+	 * callback. */
+	int getTrackRoutingGeneration() const;
 	/** 
 	 * Convenience function looking up the track number of a component of an
-	 * instrument in #m_trackMap. Using the number it then calls
+	 * instrument using getTrackNumber(). Using the number it then calls
 	 * getTrackOut_L( unsigned ) and returns its result.
 	 *
 	 * \param instr Pointer to an Instrument
@@ -237,7 +268,7 @@ public:
 	float* getTrackOut_L( std::shared_ptr<Instrument> instr, int nComponentIdx );
 	/** 
 	 * Convenience function looking up the track number of a component of an
-	 * instrument in #m_trackMap. Using the number it then calls
+	 * instrument using getTrackNumber(). Using the number it then calls
 	 * getTrackOut_R( unsigned ) and returns its result.
 	 *
 	 * \param instr Pointer to an Instrument
@@ -458,7 +489,10 @@ private:
 
 	/**
 	 * Renames the @a n 'th port of JACK client and creates it if
-	 * it's not already present. 
+	 * it's not already present. Retired ports are reused before new
+	 * ones are registered.
+	 *
+	 * Requires #m_trackPortMutex to be locked.
   	 *
 	 * \param n Track number for which a port should be renamed
 	 *   (and created).
@@ -513,6 +547,90 @@ private:
 	 */
 	jack_port_t*		 	m_pTrackOutputPortsR[MAX_INSTRUMENTS];
 
+	/**
+	 * Read-only copy of #m_trackMap and the track output ports for
+	 * the audio thread.
+	 *
+	 * #m_trackMap, #m_pTrackOutputPortsL, and #m_pTrackOutputPortsR
+	 * are only accessed by makeTrackOutputs(). Once they are
+	 * updated, their content is copied into the element of
+	 * #m_trackRoutings not used by the audio thread and published
+	 * using #m_pTrackRouting. This way per-track outputs can be
+	 * altered while the audio engine is running without locking it.
+	 */
+	struct TrackRouting {
+		int trackMap[MAX_INSTRUMENTS][MAX_COMPONENTS];
+		jack_port_t* portsL[MAX_INSTRUMENTS];
+		jack_port_t* portsR[MAX_INSTRUMENTS];
+		int nPortCount;
+		int nGeneration;
+	};
+	/** Double buffer of routings. */
+	TrackRouting			m_trackRoutings[2];
+	/** Latest routing published by makeTrackOutputs(). */
+	std::atomic<TrackRouting*>	m_pTrackRouting;
+	/** Routing the audio thread is currently using. Set in
+	 * clearPerTrackAudioBuffers() at the beginning of each cycle.
+	 * Ports of the previous routing may not be unregistered before
+	 * it was picked up. */
+	std::atomic<TrackRouting*>	m_pTrackRoutingInUse;
+	/** Buffers of the ports in #m_pTrackRoutingInUse resolved during
+	 * the current process cycle. Only accessed by the audio
+	 * thread. */
+	float*					m_pTrackBuffersL[MAX_INSTRUMENTS];
+	float*					m_pTrackBuffersR[MAX_INSTRUMENTS];
+	/** Last generation assigned to a routing. Only accessed by
+	 * publishTrackRouting() and not reset on deactivation. This way
+	 * a generation cached by a voice never refers to a different
+	 * routing.*/
+	int						m_nTrackRoutingGeneration;
+	/** Publishes the current content of #m_trackMap and the track
+	 * ports to the audio thread. It does not wait for the routing to
+	 * be picked up.
+	 *
+	 * Requires #m_trackPortMutex to be locked.
+	 *
+	 * \return false in case the previous routing was not picked up
+	 *   yet. The audio thread might still be using the buffer the
+	 *   new routing would be written to. Thus, nothing is
+	 *   published.*/
+	bool publishTrackRouting();
+
+	/** Ports dropped from the routing by makeTrackOutputs(). The
+	 * process callback might still write to them till it picked up a
+	 * routing of generation #nGeneration. */
+	struct RetiredTrackPort {
+		jack_port_t* pPortL;
+		jack_port_t* pPortR;
+		int nGeneration;
+	};
+	/** Unregistered by #m_trackPortWorker once they are not used by
+	 * the process callback anymore. Till then they are reused in case
+	 * makeTrackOutputs() requires additional ports. */
+	std::vector<RetiredTrackPort> m_retiredTrackPorts;
+	/** Whether makeTrackOutputs() altered the routing but
+	 * publishTrackRouting() failed. It is retried by
+	 * #m_trackPortWorker. */
+	bool					m_bTrackRoutingPending;
+	/** Whether the process callback does not use any routing older
+	 * than generation @a nGeneration anymore.
+	 *
+	 * Requires #m_trackPortMutex to be locked. */
+	bool isTrackRoutingPickedUp( int nGeneration ) const;
+	/** Guards #m_trackMap, the track output ports,
+	 * #m_nTrackPortCount, #m_retiredTrackPorts, and
+	 * #m_bTrackRoutingPending. It is never locked by the audio
+	 * thread. */
+	std::mutex				m_trackPortMutex;
+	std::condition_variable	m_trackPortCondition;
+	bool					m_bTrackPortWorkerShutdown;
+	/** Publishes pending routings and unregisters retired ports. This
+	 * way neither makeTrackOutputs() - called while the audio engine
+	 * is locked - nor the process callback have to wait for each
+	 * other. */
+	std::thread				m_trackPortWorker;
+	void trackPortWorkerLoop();
+
 	/**
 	 * Current transport state returned by
 	 * _jack_transport_query()_ (jack/transport.h).  
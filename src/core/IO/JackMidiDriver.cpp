@@ -38,6 +38,8 @@
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentList.h>
 
+#include <algorithm>
+
 #ifdef H2CORE_HAVE_LASH
 #include <core/Lash/LashClient.h>
 #endif
@@ -45,18 +47,6 @@
 namespace H2Core
 {
 
-void
-JackMidiDriver::lock(void)
-{
-	pthread_mutex_lock(&mtx);
-}
-
-void
-JackMidiDriver::unlock(void)
-{
-	pthread_mutex_unlock(&mtx);
-}
-
 void
 JackMidiDriver::JackMidiWrite(jack_nframes_t nframes)
 {
@@ -158,9 +148,6 @@ JackMidiDriver::JackMidiRead(jack_nframes_t nframes)
 {
 	uint8_t *buffer;
 	void *buf;
-	jack_nframes_t t;
-	uint8_t data[1];
-	uint8_t len;
 
 	if (output_port == nullptr) {
 		return;
@@ -177,68 +164,116 @@ JackMidiDriver::JackMidiRead(jack_nframes_t nframes)
 	jack_midi_clear_buffer(buf);
 #endif
 
-	t = 0;
-	lock();
-	while ((t < nframes) &&
-		   (rx_out_pos != rx_in_pos)) {
+	const jack_nframes_t nCycleStart = jack_last_frame_time( jack_client );
+
+	// Fetch all messages queued since the last cycle and merge those
+	// of the audio thread with the ones of all other threads.
+	for ( jack_ringbuffer_t* pRing : { m_pRealtimeBuffer, m_pOutputBuffer } ) {
+		while ( m_nPendingEvents < JACK_MIDI_BUFFER_MAX &&
+				jack_ringbuffer_read_space( pRing ) >= sizeof( Event ) ) {
+			Event& event = m_pendingEvents[ m_nPendingEvents ];
+			jack_ringbuffer_read( pRing, reinterpret_cast<char*>(&event),
+								  sizeof( Event ) );
+			if ( ! event.bScheduled ) {
+				event.nTime = nCycleStart;
+			}
 
-				len = jack_buffer[4 * rx_in_pos];
-		if (len == 0) {
-			rx_in_pos++;
-			if (rx_in_pos >= JACK_MIDI_BUFFER_MAX) {
-				rx_in_pos = 0;
+			// JACK requires messages to be ordered in time. Insertion
+			// sort keeps messages due at the same frame - like the note
+			// off preceding a note on - in the order they were queued.
+			int nn = m_nPendingEvents;
+			while ( nn > 0 && static_cast<int32_t>(
+						m_pendingEvents[ nn - 1 ].nTime - event.nTime ) > 0 ) {
+				--nn;
 			}
-			continue;
+			if ( nn < m_nPendingEvents ) {
+				const Event newEvent = event;
+				for ( int mm = m_nPendingEvents; mm > nn; --mm ) {
+					m_pendingEvents[ mm ] = m_pendingEvents[ mm - 1 ];
+				}
+				m_pendingEvents[ nn ] = newEvent;
+			}
+			++m_nPendingEvents;
+		}
+	}
+
+	int nSent = 0;
+	jack_nframes_t nLastFrame = 0;
+	while ( nSent < m_nPendingEvents ) {
+		const Event& event = m_pendingEvents[ nSent ];
+
+		// Wrap-around safe difference of the frame times.
+		int32_t nOffset = static_cast<int32_t>( event.nTime - nCycleStart );
+		if ( nOffset >= static_cast<int32_t>( nframes ) ) {
+			// Due in one of the upcoming cycles.
+			break;
+		}
+		if ( nOffset < 0 ) {
+			// The message was queued by the audio driver during a cycle
+			// in which this callback was already called (the order of
+			// JACK clients within the graph is not fixed). Sending it
+			// one period later at the same position within the buffer
+			// still keeps the distances between notes intact.
+			nOffset = std::max( nOffset + static_cast<int32_t>( nframes ), 0 );
 		}
+		const jack_nframes_t nFrame =
+			std::max( static_cast<jack_nframes_t>( nOffset ), nLastFrame );
 
 #ifdef JACK_MIDI_NEEDS_NFRAMES
-		buffer = jack_midi_event_reserve(buf, t, len, nframes);
+		buffer = jack_midi_event_reserve(buf, nFrame, event.nLength, nframes);
 #else
-		buffer = jack_midi_event_reserve(buf, t, len);
+		buffer = jack_midi_event_reserve(buf, nFrame, event.nLength);
 #endif
 		if (buffer == nullptr) {
+			// Port buffer is full. Try again in the next cycle.
 			break;
 		}
-		t++;
-		rx_in_pos++;
-		if (rx_in_pos >= JACK_MIDI_BUFFER_MAX) {
-			rx_in_pos = 0;
+		memcpy( buffer, event.data, event.nLength );
+		nLastFrame = nFrame;
+		++nSent;
+	}
+
+	if ( nSent > 0 ) {
+		for ( int nn = nSent; nn < m_nPendingEvents; ++nn ) {
+			m_pendingEvents[ nn - nSent ] = m_pendingEvents[ nn ];
 		}
-		memcpy(buffer, jack_buffer + (4 * rx_in_pos) + 1, len);
+		m_nPendingEvents -= nSent;
 	}
-	unlock();
 }
 
 void
-JackMidiDriver::JackMidiOutEvent(uint8_t buf[4], uint8_t len)
+JackMidiDriver::JackMidiOutEvent( uint8_t *buf, uint8_t len, bool bScheduled,
+								  jack_nframes_t nTime )
 {
-	uint32_t next_pos;
-
-	lock();
-
-	next_pos = rx_out_pos + 1;
-	if (next_pos >= JACK_MIDI_BUFFER_MAX) {
-		next_pos = 0;
+	if ( m_pRealtimeBuffer == nullptr || m_pOutputBuffer == nullptr ) {
+		return;
 	}
 
-	if (next_pos == rx_in_pos) {
-		/* buffer is full */
-		unlock();
+	Event event;
+	event.nTime = nTime;
+	event.bScheduled = bScheduled;
+	event.nLength = std::min( len, static_cast<uint8_t>(3) );
+	memcpy( event.data, buf, 3 );
+
+	if ( std::this_thread::get_id() ==
+		 m_audioThreadId.load( std::memory_order_relaxed ) ) {
+		// Sole writer of this ring. No locking required.
+		if ( jack_ringbuffer_write_space( m_pRealtimeBuffer ) >= sizeof( Event ) ) {
+			jack_ringbuffer_write( m_pRealtimeBuffer,
+								   reinterpret_cast<const char*>(&event),
+								   sizeof( Event ) );
+		}
+		/* else: buffer is full */
 		return;
 	}
 
-	if (len > 3) {
-		len = 3;
+	std::lock_guard<std::mutex> lock( m_outputMutex );
+	if ( jack_ringbuffer_write_space( m_pOutputBuffer ) >= sizeof( Event ) ) {
+		jack_ringbuffer_write( m_pOutputBuffer,
+							   reinterpret_cast<const char*>(&event),
+							   sizeof( Event ) );
 	}
-
-	jack_buffer[(4 * next_pos)] = len;
-	jack_buffer[(4 * next_pos) + 1] = buf[0];
-	jack_buffer[(4 * next_pos) + 2] = buf[1];
-	jack_buffer[(4 * next_pos) + 3] = buf[2];
-
-	rx_out_pos = next_pos;
-
-	unlock();
+	/* else: buffer is full */
 }
 
 static int
@@ -267,13 +302,22 @@ JackMidiShutdown(void *arg)
 JackMidiDriver::JackMidiDriver()
 	: MidiInput(), MidiOutput(), Object<JackMidiDriver>()
 {
-	pthread_mutex_init(&mtx, nullptr);
-
 	running = 0;
-	rx_in_pos = 0;
-	rx_out_pos = 0;
 	output_port = nullptr;
 	input_port = nullptr;
+	m_nPendingEvents = 0;
+
+	m_pRealtimeBuffer =
+		jack_ringbuffer_create( JACK_MIDI_BUFFER_MAX * sizeof( Event ) );
+	m_pOutputBuffer =
+		jack_ringbuffer_create( JACK_MIDI_BUFFER_MAX * sizeof( Event ) );
+	// Prevent page faults in the process callback.
+	if ( m_pRealtimeBuffer != nullptr ) {
+		jack_ringbuffer_mlock( m_pRealtimeBuffer );
+	}
+	if ( m_pOutputBuffer != nullptr ) {
+		jack_ringbuffer_mlock( m_pOutputBuffer );
+	}
 
 	QString jackMidiClientId = "Hydrogen";
 
@@ -334,7 +378,13 @@ JackMidiDriver::~JackMidiDriver()
 			ERRORLOG("Failed close jack midi client");
 		}
 	}
-	pthread_mutex_destroy(&mtx);
+
+	if ( m_pRealtimeBuffer != nullptr ) {
+		jack_ringbuffer_free( m_pRealtimeBuffer );
+	}
+	if ( m_pOutputBuffer != nullptr ) {
+		jack_ringbuffer_free( m_pOutputBuffer );
+	}
 
 }
 
@@ -383,13 +433,19 @@ JackMidiDriver::getPortInfo(const QString& sPortName, int& nClient, int& nPort)
 	nPort = 0;
 }
 
-void JackMidiDriver::handleQueueNote(Note* pNote)
+void JackMidiDriver::handleQueueNote( Note* pNote, int nFrameOffset )
 {
 	if ( pNote == nullptr || pNote->get_instrument() == nullptr ) {
 		ERRORLOG( "Invalid note" );
 		return;
 	}
 
+	// Notes are queued by the audio thread only. Messages it sends -
+	// including the note offs queued by the Sampler - are written to
+	// the lock-free ring from now on.
+	m_audioThreadId.store( std::this_thread::get_id(),
+						   std::memory_order_relaxed );
+
 	uint8_t buffer[4];
 	int channel;
 	int key;
@@ -410,19 +466,30 @@ void JackMidiDriver::handleQueueNote(Note* pNote)
 		return;
 	}
 
+	if ( jack_client == nullptr ) {
+		return;
+	}
+
+	// This function is called from within the process cycle of the
+	// audio driver. Both the JACK audio and MIDI client share the
+	// same frame time and the note is due at the start of the current
+	// cycle plus its offset within the rendered buffer.
+	const jack_nframes_t nTime = jack_last_frame_time( jack_client ) +
+		std::max( nFrameOffset, 0 );
+
 	buffer[0] = 0x80 | channel;	/* note off */
 	buffer[1] = key;
 	buffer[2] = 0;
 	buffer[3] = 0;
 
-	JackMidiOutEvent(buffer, 3);
+	JackMidiOutEvent(buffer, 3, true, nTime);
 
 	buffer[0] = 0x90 | channel;	/* note on */
 	buffer[1] = key;
 	buffer[2] = vel;
 	buffer[3] = 0;
 
-	JackMidiOutEvent(buffer, 3);
+	JackMidiOutEvent(buffer, 3, true, nTime);
 }
 
 void
@@ -485,16 +552,13 @@ QString JackMidiDriver::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_bActive ) )
 			.append( QString( "%1%2running: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( running ) )
-			.append( QString( "%1%2rx_in_pos: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( rx_in_pos ) )
-			.append( QString( "%1%2rx_out_pos: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( rx_out_pos ) );
+			.append( QString( "%1%2m_nPendingEvents: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nPendingEvents ) );
 	} else {
 		sOutput = QString( "[JackMidiDriver]" )
 			.append( QString( " m_bActive: %1" ).arg( m_bActive ) )
 			.append( QString( ", running: %1" ).arg( running ) )
-			.append( QString( ", rx_in_pos: %1" ).arg( rx_in_pos ) )
-			.append( QString( ", rx_out_pos: %1" ).arg( rx_out_pos ) );
+			.append( QString( ", m_nPendingEvents: %1" ).arg( m_nPendingEvents ) );
 	}
 
 	return sOutput;
@@ -32,7 +32,9 @@
 
 #if defined(H2CORE_HAVE_JACK) || _DOXYGEN_
 
-#include <pthread.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include <jack/jack.h>
 #include <jack/midiport.h>
@@ -41,7 +43,7 @@
 #include <string>
 #include <vector>
 
-#define	JACK_MIDI_BUFFER_MAX 64	/* events */
+#define	JACK_MIDI_BUFFER_MAX 256	/* events */
 
 namespace H2Core
 {
@@ -63,26 +65,55 @@ public:
 	void JackMidiWrite(jack_nframes_t nframes);
 	void JackMidiRead(jack_nframes_t nframes);
 	
-	virtual void handleQueueNote(Note* pNote) override;
+	virtual void handleQueueNote( Note* pNote, int nFrameOffset ) override;
 	virtual void handleQueueNoteOff( int channel, int key, int velocity ) override;
 	virtual void handleQueueAllNoteOff() override;
 	virtual void handleOutgoingControlChange( int param, int value, int channel ) override;
 
 	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 private:
-	void JackMidiOutEvent(uint8_t *buf, uint8_t len);
-
-	void lock();
-	void unlock();
+	/** Outgoing MIDI message. */
+	struct Event {
+		/** JACK frame time the message is due at. */
+		jack_nframes_t nTime;
+		/** Whether #nTime was set. If not, the message will be sent at
+		 * the beginning of the next process cycle. */
+		bool bScheduled;
+		uint8_t nLength;
+		uint8_t data[3];
+	};
+
+	/** Queues a message for the JACK process callback.
+	 *
+	 * It is safe to be called from any thread. Messages of the audio
+	 * thread are written to #m_pRealtimeBuffer without locking, all
+	 * others to #m_pOutputBuffer while holding #m_outputMutex. */
+	void JackMidiOutEvent( uint8_t *buf, uint8_t len, bool bScheduled = false,
+						   jack_nframes_t nTime = 0 );
 
 	jack_port_t *output_port;
 	jack_port_t *input_port;
 	jack_client_t *jack_client;
-	pthread_mutex_t mtx;
 	int running;
-		uint8_t jack_buffer[JACK_MIDI_BUFFER_MAX * 4];
-	uint32_t rx_in_pos;
-	uint32_t rx_out_pos;
+
+	/** Lock-free single-reader single-writer ring holding #Event
+	 * instances queued by the audio thread (#m_audioThreadId) and read
+	 * in the process callback. */
+	jack_ringbuffer_t* m_pRealtimeBuffer;
+	/** Ring holding the #Event instances queued by all other threads,
+	 * e.g. outgoing control changes triggered by the GUI. */
+	jack_ringbuffer_t* m_pOutputBuffer;
+	/** Serializes the writers of #m_pOutputBuffer. The audio thread
+	 * never takes it. */
+	std::mutex m_outputMutex;
+	/** Thread which called handleQueueNote() most recently. Since
+	 * notes are only queued while rendering, this is the audio
+	 * thread. */
+	std::atomic<std::thread::id> m_audioThreadId;
+	/** Messages read from #m_pRealtimeBuffer and #m_pOutputBuffer which
+	 * are not sent yet. Only accessed by the process callback. */
+	Event m_pendingEvents[ JACK_MIDI_BUFFER_MAX ];
+	int m_nPendingEvents;
 };
 
 };
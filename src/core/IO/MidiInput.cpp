@@ -168,9 +168,7 @@ void MidiInput::handleControlChangeMessage( const MidiMessage& msg )
 
 	for ( const auto& ppAction : pMidiMap->getCCActions( msg.m_nData1 ) ) {
 		if ( ppAction != nullptr && ! ppAction->isNull() ) {
-			auto pNewAction = std::make_shared<Action>( ppAction );
-			pNewAction->setValue( QString::number( msg.m_nData2 ) );
-			pMidiActionManager->handleAction( pNewAction );
+			pMidiActionManager->handleAction( ppAction, msg.m_nData2 );
 		}
 	}
 
@@ -190,9 +188,7 @@ void MidiInput::handleProgramChangeMessage( const MidiMessage& msg )
 
 	for ( const auto& ppAction : pMidiMap->getPCActions() ) {
 		if ( ppAction != nullptr && ! ppAction->isNull() ) {
-			auto pNewAction = std::make_shared<Action>( ppAction );
-			pNewAction->setValue( QString::number( msg.m_nData1 ) );
-			pMidiActionManager->handleAction( pNewAction );
+			pMidiActionManager->handleAction( ppAction, msg.m_nData1 );
 		}
 	}
 
@@ -223,9 +219,7 @@ void MidiInput::handleNoteOnMessage( const MidiMessage& msg )
 	bool bActionSuccess = false;
 	for ( const auto& ppAction : pMidiMap->getNoteActions( msg.m_nData1 ) ) {
 		if ( ppAction != nullptr && ! ppAction->isNull() ) {
-			auto pNewAction = std::make_shared<Action>( ppAction );
-			pNewAction->setValue( QString::number( msg.m_nData2 ) );
-			if ( pMidiActionManager->handleAction( pNewAction ) ) {
+			if ( pMidiActionManager->handleAction( ppAction, msg.m_nData2 ) ) {
 				bActionSuccess = true;
 			}
 		}
@@ -46,7 +46,16 @@ public:
 	
 	virtual std::vector<QString> getInputPortList() = 0;
 
-	virtual void handleQueueNote(Note* pNote) = 0;
+	/** Sends note on (preceded by a note off) for @a pNote.
+	 *
+	 * Called by the Sampler once it starts rendering @a pNote.
+	 *
+	 * \param pNote Note to send.
+	 * \param nFrameOffset Offset of the start of @a pNote - including
+	 *   humanization - within the audio buffer currently processed.
+	 *   Drivers able to schedule messages use it to send them
+	 *   sample-accurately. */
+	virtual void handleQueueNote( Note* pNote, int nFrameOffset ) = 0;
 	virtual void handleQueueNoteOff( int channel, int key, int velocity ) = 0;
 	virtual void handleQueueAllNoteOff() = 0;
 	virtual void handleOutgoingControlChange( int param, int value, int channel ) = 0;
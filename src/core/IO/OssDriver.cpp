@@ -42,18 +42,8 @@ unsigned nNextFrames = 0;
 
 void* ossDriver_processCaller( void* param )
 {
-	Base * __object = ( Base * )param;
-	// stolen from amSynth
-	struct sched_param sched;
-	sched.sched_priority = 50;
-	int res = sched_setscheduler( 0, SCHED_FIFO, &sched );
-	sched_getparam( 0, &sched );
-	if ( res ) {
-		__WARNINGLOG( "Can't set realtime scheduling for OSS Driver" );
-	}
-	__INFOLOG( QString( "Scheduling priority = %1" ).arg( sched.sched_priority ) );
-
 	OssDriver *ossDriver = ( OssDriver* )param;
+	ossDriver->m_realtimeThread.enter();
 
 	sleep( 1 );
 
@@ -62,6 +52,8 @@ void* ossDriver_processCaller( void* param )
 		ossDriver->write();
 	}
 
+	ossDriver->m_realtimeThread.leave();
+
 	pthread_exit( NULL );
 	return NULL;
 }
@@ -69,6 +61,7 @@ void* ossDriver_processCaller( void* param )
 
 OssDriver::OssDriver( audioProcessCallback processCallback )
 		: AudioOutput()
+		, m_realtimeThread( "OSS" )
 {
 	audioBuffer = NULL;
 	ossDriver_running = false;
@@ -190,6 +183,8 @@ int OssDriver::connect()
 		return 1;
 	}
 
+	m_realtimeThread.prepare();
+
 	// start main thread
 	ossDriver_running = true;
 	pthread_attr_t attr;
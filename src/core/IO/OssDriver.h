@@ -25,6 +25,7 @@
 
 #include <core/IO/AudioOutput.h>
 #include <core/IO/NullDriver.h>
+#include <core/IO/RealtimeThread.h>
 
 // check if OSS support is enabled
 #if defined(H2CORE_HAVE_OSS) || _DOXYGEN_
@@ -68,6 +69,8 @@ public:
 	OssDriver( audioProcessCallback processCallback );
 	~OssDriver();
 
+	RealtimeThread m_realtimeThread;
+
 	int init( unsigned bufferSize );
 	int connect();
 	void disconnect();
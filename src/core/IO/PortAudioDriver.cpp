@@ -44,6 +44,8 @@ int portAudioCallback(
 		return 1;
 	}
 
+	pDriver->m_realtimeThread.ensureEntered();
+
 	while ( framesPerBuffer > 0 ) {
 		unsigned long nFrames = std::min( (unsigned long) MAX_BUFFER_SIZE, framesPerBuffer );
 		pDriver->m_processCallback( nFrames, nullptr );
@@ -66,6 +68,7 @@ PortAudioDriver::PortAudioDriver( audioProcessCallback processCallback )
 		, m_processCallback( processCallback )
 		, m_pOut_L( nullptr )
 		, m_pOut_R( nullptr )
+		, m_realtimeThread( "PortAudio" )
 		, m_pStream( nullptr )
 {
 	m_nSampleRate = Preferences::get_instance()->m_nSampleRate;
@@ -277,6 +280,9 @@ int PortAudioDriver::connect()
 	}
 	INFOLOG( QString( "PortAudio outpot latency: %1 s" ).arg( pStreamInfo->outputLatency ) );
 
+	// The callback itself only promotes its thread.
+	m_realtimeThread.prepare();
+
 	err = Pa_StartStream( m_pStream );
 
 
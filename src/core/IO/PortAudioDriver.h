@@ -25,6 +25,7 @@
 
 #include <core/IO/AudioOutput.h>
 #include <core/IO/NullDriver.h>
+#include <core/IO/RealtimeThread.h>
 
 #include <unistd.h>
 
@@ -44,6 +45,9 @@ public:
 	audioProcessCallback m_processCallback;
 	float* m_pOut_L;
 	float* m_pOut_R;
+	/** PortAudio runs the callback in a thread of its own. It is
+	 * promoted during the first call. */
+	RealtimeThread m_realtimeThread;
 
 	PortAudioDriver( audioProcessCallback processCallback );
 	virtual ~PortAudioDriver();
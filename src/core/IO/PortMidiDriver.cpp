@@ -470,8 +470,10 @@ std::vector<QString> PortMidiDriver::getOutputPortList()
 	return portList;
 }
 
-void PortMidiDriver::handleQueueNote(Note* pNote)
+void PortMidiDriver::handleQueueNote( Note* pNote, int nFrameOffset )
 {
+	UNUSED( nFrameOffset );
+
 	if ( m_pMidiOut == nullptr ) {
 		return;
 	}
@@ -39,7 +39,8 @@ PulseAudioDriver::PulseAudioDriver(audioProcessCallback processCallback)
 		m_stream(nullptr),
 		m_connected(false),
 		m_outL(nullptr),
-		m_outR(nullptr)
+		m_outR(nullptr),
+		m_realtimeThread( "PulseAudio" )
 {
 	pthread_mutex_init(&m_mutex, nullptr);
 	pthread_cond_init(&m_cond, nullptr);
@@ -82,6 +83,7 @@ int PulseAudioDriver::connect()
 	fcntl(m_pipe[0], F_SETFL, fcntl(m_pipe[0], F_GETFL) | O_NONBLOCK);
 
 	m_ready = 0;
+	m_realtimeThread.prepare();
 	if (pthread_create(&m_thread, nullptr, s_thread_body, this))
 	{
 		close(m_pipe[0]);
@@ -166,6 +168,10 @@ void* PulseAudioDriver::s_thread_body(void* arg)
 
 int PulseAudioDriver::thread_body()
 {
+	// All audio is rendered within the callbacks of the main loop
+	// run by this thread.
+	m_realtimeThread.enter();
+
 	m_main_loop = pa_mainloop_new();
 	pa_mainloop_api* api = pa_mainloop_get_api(m_main_loop);
 	pa_io_event* ioev = api->io_new(api, m_pipe[0], PA_IO_EVENT_INPUT,
@@ -189,6 +195,8 @@ int PulseAudioDriver::thread_body()
 	pa_context_unref(m_ctx);
 	pa_mainloop_free(m_main_loop);
 
+	m_realtimeThread.leave();
+
 	return retval;
 }
 
@@ -24,6 +24,7 @@
 
 
 #include <core/IO/AudioOutput.h>
+#include <core/IO/RealtimeThread.h>
 
 #if defined(H2CORE_HAVE_PULSEAUDIO) || _DOXYGEN_
 
@@ -72,6 +73,7 @@ private:
 	unsigned				m_buffer_size;
 	float*					m_outL;
 	float*					m_outR;
+	RealtimeThread			m_realtimeThread;
 
 	static void* s_thread_body(void*);
 	int thread_body();
@@ -0,0 +1,245 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/IO/RealtimeThread.h>
+#include <core/Preferences/Preferences.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#ifndef WIN32
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+namespace H2Core
+{
+
+std::atomic<bool> RealtimeThread::m_bMemoryLocked( false );
+
+RealtimeThread::RealtimeThread( const QString& sName )
+	: m_sName( sName )
+	, m_nPriority( 0 )
+	, m_nCpu( -1 )
+	, m_nMinorFaults( 0 )
+	, m_nMajorFaults( 0 )
+{
+}
+
+RealtimeThread::~RealtimeThread()
+{
+}
+
+void RealtimeThread::prepare()
+{
+#ifndef WIN32
+	if ( Preferences::get_instance()->m_bRealtimeLockMemory ) {
+		lockMemory();
+	}
+#endif
+}
+
+void RealtimeThread::enter( bool bSilent )
+{
+	m_threadId = std::this_thread::get_id();
+	m_nPriority = 0;
+	m_nCpu = -1;
+
+	const auto pPref = Preferences::get_instance();
+
+	m_nPriority = promote( m_sName, pPref->m_nRealtimePriority, bSilent );
+
+#ifdef __linux__
+	const int nCpu = pPref->m_nRealtimeCpu;
+	if ( nCpu >= 0 ) {
+		if ( nCpu >= CPU_SETSIZE ) {
+			if ( ! bSilent ) {
+				WARNINGLOG( QString( "[%1] Invalid CPU [%2]" ).arg( m_sName ).arg( nCpu ) );
+			}
+		}
+		else {
+			cpu_set_t cpuSet;
+			CPU_ZERO( &cpuSet );
+			CPU_SET( nCpu, &cpuSet );
+			const int nRes = pthread_setaffinity_np( pthread_self(),
+													 sizeof( cpuSet ), &cpuSet );
+			if ( nRes == 0 ) {
+				m_nCpu = nCpu;
+			} else if ( ! bSilent ) {
+				WARNINGLOG( QString( "[%1] Unable to pin thread to CPU [%2]: %3" )
+							.arg( m_sName ).arg( nCpu ).arg( strerror( nRes ) ) );
+			}
+		}
+	}
+#endif
+
+	if ( ! queryPageFaults( &m_nMinorFaults, &m_nMajorFaults ) ) {
+		m_nMinorFaults = 0;
+		m_nMajorFaults = 0;
+	}
+
+	if ( ! bSilent ) {
+		INFOLOG( QString( "[%1] realtime priority: %2, CPU: %3, memory locked: %4" )
+				 .arg( m_sName ).arg( m_nPriority )
+				 .arg( m_nCpu >= 0 ? QString::number( m_nCpu ) : "any" )
+				 .arg( m_bMemoryLocked ? "true" : "false" ) );
+	}
+}
+
+int RealtimeThread::promote( const QString& sName, int nPriority,
+							 bool bSilent )
+{
+	int nObtained = 0;
+#if ! defined(WIN32) && ! defined(__APPLE__)
+	// On macOS the audio callbacks are run by time-constraint
+	// threads of CoreAudio, which must not be turned into ordinary
+	// SCHED_FIFO ones.
+	if ( nPriority > 0 ) {
+		nPriority = std::clamp( nPriority,
+								sched_get_priority_min( SCHED_FIFO ),
+								sched_get_priority_max( SCHED_FIFO ) );
+#ifdef __linux__
+		// Unprivileged users are only allowed to request priorities
+		// up to RLIMIT_RTPRIO (as e.g. granted by membership in the
+		// "audio" group). Instead of failing altogether we use the
+		// highest priority available.
+		struct rlimit limit;
+		if ( geteuid() != 0 && getrlimit( RLIMIT_RTPRIO, &limit ) == 0 &&
+			 limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur > 0 &&
+			 static_cast<rlim_t>(nPriority) > limit.rlim_cur ) {
+			if ( ! bSilent ) {
+				WARNINGLOG( QString( "[%1] Requested realtime priority [%2] exceeds RLIMIT_RTPRIO. Using [%3] instead." )
+							.arg( sName ).arg( nPriority ).arg( limit.rlim_cur ) );
+			}
+			nPriority = static_cast<int>(limit.rlim_cur);
+		}
+#endif
+		struct sched_param param;
+		param.sched_priority = nPriority;
+		const int nRes = pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+		if ( nRes != 0 && ! bSilent ) {
+			WARNINGLOG( QString( "[%1] Unable to set realtime scheduling with priority [%2]: %3" )
+						.arg( sName ).arg( nPriority ).arg( strerror( nRes ) ) );
+		}
+	}
+
+	// Report what we actually got.
+	int nPolicy;
+	struct sched_param param;
+	if ( pthread_getschedparam( pthread_self(), &nPolicy, &param ) == 0 &&
+		 ( nPolicy == SCHED_FIFO || nPolicy == SCHED_RR ) ) {
+		nObtained = param.sched_priority;
+	}
+#endif
+
+	return nObtained;
+}
+
+void RealtimeThread::leave()
+{
+	long nMinorFaults, nMajorFaults;
+	if ( m_threadId == std::this_thread::get_id() &&
+		 queryPageFaults( &nMinorFaults, &nMajorFaults ) ) {
+		const QString sMsg = QString( "[%1] page faults during playback: %2 minor, %3 major" )
+			.arg( m_sName ).arg( nMinorFaults - m_nMinorFaults )
+			.arg( nMajorFaults - m_nMajorFaults );
+		// Major faults require disk access within the audio thread
+		// and are a likely cause of xruns.
+		if ( nMajorFaults > m_nMajorFaults ) {
+			WARNINGLOG( sMsg );
+		} else {
+			INFOLOG( sMsg );
+		}
+	}
+
+	m_threadId = std::thread::id();
+}
+
+void RealtimeThread::lockMemory()
+{
+#ifndef WIN32
+	static std::once_flag lockOnce;
+	std::call_once( lockOnce, []() {
+		int nFlags = MCL_CURRENT;
+
+		// Locking future pages with a finite RLIMIT_MEMLOCK would
+		// cause allocations to fail as soon as the limit is
+		// reached. Instead, only the pages present right now are
+		// locked.
+		struct rlimit limit;
+		if ( getrlimit( RLIMIT_MEMLOCK, &limit ) == 0 &&
+			 limit.rlim_cur == RLIM_INFINITY ) {
+			nFlags |= MCL_FUTURE;
+		}
+
+		if ( mlockall( nFlags ) == 0 ) {
+			m_bMemoryLocked = true;
+			___INFOLOG( QString( "Memory locked%1" )
+						.arg( nFlags & MCL_FUTURE ? " (including future allocations)" : "" ) );
+		} else {
+			___WARNINGLOG( QString( "Unable to lock memory: %1" )
+						   .arg( strerror( errno ) ) );
+		}
+	} );
+#endif
+}
+
+bool RealtimeThread::queryPageFaults( long* pMinor, long* pMajor )
+{
+#ifdef __linux__
+	struct rusage usage;
+	if ( getrusage( RUSAGE_THREAD, &usage ) == 0 ) {
+		*pMinor = usage.ru_minflt;
+		*pMajor = usage.ru_majflt;
+		return true;
+	}
+#endif
+	return false;
+}
+
+QString RealtimeThread::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[RealtimeThread]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_sName: %3\n" ).arg( sPrefix ).arg( s ).arg( m_sName ) )
+			.append( QString( "%1%2m_nPriority: %3\n" ).arg( sPrefix ).arg( s ).arg( m_nPriority ) )
+			.append( QString( "%1%2m_nCpu: %3\n" ).arg( sPrefix ).arg( s ).arg( m_nCpu ) )
+			.append( QString( "%1%2m_bMemoryLocked: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bMemoryLocked ? "true" : "false" ) );
+	} else {
+		sOutput = QString( "[RealtimeThread]" )
+			.append( QString( " m_sName: %1" ).arg( m_sName ) )
+			.append( QString( ", m_nPriority: %1" ).arg( m_nPriority ) )
+			.append( QString( ", m_nCpu: %1" ).arg( m_nCpu ) )
+			.append( QString( ", m_bMemoryLocked: %1" )
+					 .arg( m_bMemoryLocked ? "true" : "false" ) );
+	}
+
+	return sOutput;
+}
+};
@@ -0,0 +1,137 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2_REALTIME_THREAD_H
+#define H2_REALTIME_THREAD_H
+
+#include <core/Object.h>
+
+#include <atomic>
+#include <thread>
+
+namespace H2Core
+{
+
+/**
+ * Realtime setup shared by the audio threads of all drivers not
+ * relying on JACK.
+ *
+ * JACK takes care of scheduling, memory locking, and CPU placement of
+ * its process thread by itself. For all other drivers this class
+ * promotes the thread calling audioEngine_process() to SCHED_FIFO
+ * using Preferences::m_nRealtimePriority, pins it to
+ * Preferences::m_nRealtimeCpu, and locks the memory of the process
+ * using mlockall() in case Preferences::m_bRealtimeLockMemory is set.
+ *
+ * Drivers call prepare() right before their audio thread is started.
+ * Drivers spawning their own thread call enter() at its beginning and
+ * leave() right before it terminates. The latter reports the number
+ * of page faults which occurred in between. Drivers whose callbacks
+ * are run by a thread of the audio library instead (PortAudio,
+ * CoreAudio) call ensureEntered() at the beginning of each callback.
+ *
+ * \ingroup docCore docAudioDriver */
+class RealtimeThread : public Object<RealtimeThread>
+{
+	H2_OBJECT(RealtimeThread)
+public:
+	/** \param sName used in log messages to tell the threads of
+	 *   different drivers apart. */
+	RealtimeThread( const QString& sName );
+	~RealtimeThread();
+
+	/** Locks the memory of the process in case
+	 * Preferences::m_bRealtimeLockMemory is set. To be called by
+	 * the driver - outside of the audio thread - before the latter is
+	 * started as mlockall() has to fault in all pages of the
+	 * process. */
+	void prepare();
+	/** Promotes the calling thread. Failures are not fatal. The audio
+	 * thread will just run with ordinary priority.
+	 *
+	 * \param bSilent Whether to omit all log messages. Use this from
+	 *   within the callbacks of an audio library. */
+	void enter( bool bSilent = false );
+	/** Calls enter() in case it was not called by the current
+	 * thread before. Cheap enough to be used in every process
+	 * callback. Nothing is logged. The outcome can be queried using
+	 * getPriority() and getCpu(). */
+	void ensureEntered() {
+		if ( m_threadId != std::this_thread::get_id() ) {
+			enter( true );
+		}
+	}
+	/** Logs the page faults encountered by the calling thread since
+	 * enter(). Has to be called by the same thread. */
+	void leave();
+
+	/** Realtime priority obtained by the thread. 0 if it is
+	 * scheduled non-realtime. */
+	int getPriority() const {
+		return m_nPriority;
+	}
+	/** CPU the thread is pinned to. -1 if it is not pinned. */
+	int getCpu() const {
+		return m_nCpu;
+	}
+	/** Whether the memory of the process is locked. */
+	static bool isMemoryLocked() {
+		return m_bMemoryLocked;
+	}
+
+	/**
+	 * Switches the calling thread to SCHED_FIFO with @a nPriority
+	 * (limited by RLIMIT_RTPRIO) without pinning it or locking
+	 * memory. Used for helper threads the audio thread waits for.
+	 *
+	 * \param bSilent Whether to omit warnings on failure.
+	 *
+	 * \return Realtime priority obtained. 0 if the thread is
+	 *   scheduled non-realtime.
+	 */
+	static int promote( const QString& sName, int nPriority,
+						bool bSilent = false );
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	/** Locks all current and - if permitted by RLIMIT_MEMLOCK -
+	 * future pages of the process. Done only once per process. */
+	static void lockMemory();
+
+	/** Page faults of the calling thread. Returns false if they
+	 * can not be queried on this platform. */
+	static bool queryPageFaults( long* pMinor, long* pMajor );
+
+	QString m_sName;
+	std::thread::id m_threadId;
+	int m_nPriority;
+	int m_nCpu;
+	long m_nMinorFaults;
+	long m_nMajorFaults;
+
+	static std::atomic<bool> m_bMemoryLocked;
+};
+
+};
+
+#endif // H2_REALTIME_THREAD_H
@@ -78,6 +78,12 @@ Action::Action( const QString& sType ) {
 	m_sParameter2 = "0";
 	m_sParameter3 = "0";
 	m_sValue = "0";
+	m_nTypeId = MidiActionManager::getTypeId( sType );
+	m_nParameter1 = 0;
+	m_nParameter2 = 0;
+	m_nParameter3 = 0;
+	m_nValue = 0;
+	m_fParameter1 = 0;
 }
 
 Action::Action( const std::shared_ptr<Action> pOther ) {
@@ -86,10 +92,18 @@ Action::Action( const std::shared_ptr<Action> pOther ) {
        m_sParameter2 = pOther->m_sParameter2;
        m_sParameter3 = pOther->m_sParameter3;
        m_sValue = pOther->m_sValue;
+       m_nTypeId = pOther->m_nTypeId;
+       m_nParameter1 = pOther->m_nParameter1;
+       m_nParameter2 = pOther->m_nParameter2;
+       m_nParameter3 = pOther->m_nParameter3;
+       m_nValue = pOther->m_nValue;
+       m_fParameter1 = pOther->m_fParameter1;
 }
 
 bool Action::isNull() const {
-	return m_sType == Action::getNullActionType();
+	// Supported types are never null. This spares the string comparison
+	// while handling MIDI events.
+	return m_nTypeId == -1 && m_sType == Action::getNullActionType();
 }
 
 bool Action::isEquivalentTo( const std::shared_ptr<Action> pOther ) const {
@@ -145,74 +159,93 @@ MidiActionManager::MidiActionManager() {
 
 	m_nLastBpmChangeCCParameter = -1;
 	/*
-		the m_actionMap holds all Action identifiers which hydrogen is able to interpret.
-		it holds pointer to member function
+	  the m_actionList holds all Action identifiers which hydrogen is able to interpret.
 	*/
-	m_actionMap.insert(std::make_pair("PLAY", std::make_pair( &MidiActionManager::play, 0 ) ));
-	m_actionMap.insert(std::make_pair("PLAY/STOP_TOGGLE", std::make_pair( &MidiActionManager::play_stop_pause_toggle, 0 ) ));
-	m_actionMap.insert(std::make_pair("PLAY/PAUSE_TOGGLE", std::make_pair( &MidiActionManager::play_stop_pause_toggle, 0 ) ));
-	m_actionMap.insert(std::make_pair("STOP", std::make_pair( &MidiActionManager::stop, 0 ) ));
-	m_actionMap.insert(std::make_pair("PAUSE", std::make_pair( &MidiActionManager::pause, 0 ) ));
-	m_actionMap.insert(std::make_pair("RECORD_READY", std::make_pair( &MidiActionManager::record_ready, 0 ) ));
-	m_actionMap.insert(std::make_pair("RECORD/STROBE_TOGGLE", std::make_pair( &MidiActionManager::record_strobe_toggle, 0 ) ));
-	m_actionMap.insert(std::make_pair("RECORD_STROBE", std::make_pair( &MidiActionManager::record_strobe, 0 ) ));
-	m_actionMap.insert(std::make_pair("RECORD_EXIT", std::make_pair( &MidiActionManager::record_exit, 0 ) ));
-	m_actionMap.insert(std::make_pair("MUTE", std::make_pair( &MidiActionManager::mute, 0 ) ));
-	m_actionMap.insert(std::make_pair("UNMUTE", std::make_pair( &MidiActionManager::unmute, 0 ) ));
-	m_actionMap.insert(std::make_pair("MUTE_TOGGLE", std::make_pair( &MidiActionManager::mute_toggle, 0 ) ));
-	m_actionMap.insert(std::make_pair("STRIP_MUTE_TOGGLE", std::make_pair( &MidiActionManager::strip_mute_toggle, 1 ) ));
-	m_actionMap.insert(std::make_pair("STRIP_SOLO_TOGGLE", std::make_pair( &MidiActionManager::strip_solo_toggle, 1 ) ));	
-	m_actionMap.insert(std::make_pair(">>_NEXT_BAR", std::make_pair( &MidiActionManager::next_bar, 0 ) ));
-	m_actionMap.insert(std::make_pair("<<_PREVIOUS_BAR", std::make_pair( &MidiActionManager::previous_bar, 0 ) ));
-	m_actionMap.insert(std::make_pair("BPM_INCR", std::make_pair( &MidiActionManager::bpm_increase, 1 ) ));
-	m_actionMap.insert(std::make_pair("BPM_DECR", std::make_pair( &MidiActionManager::bpm_decrease, 1 ) ));
-	m_actionMap.insert(std::make_pair("BPM_CC_RELATIVE", std::make_pair( &MidiActionManager::bpm_cc_relative, 1 ) ));
-	m_actionMap.insert(std::make_pair("BPM_FINE_CC_RELATIVE", std::make_pair( &MidiActionManager::bpm_fine_cc_relative, 1 ) ));
-	m_actionMap.insert(std::make_pair("MASTER_VOLUME_RELATIVE", std::make_pair( &MidiActionManager::master_volume_relative, 0 ) ));
-	m_actionMap.insert(std::make_pair("MASTER_VOLUME_ABSOLUTE", std::make_pair( &MidiActionManager::master_volume_absolute, 0 ) ));
-	m_actionMap.insert(std::make_pair("STRIP_VOLUME_RELATIVE", std::make_pair( &MidiActionManager::strip_volume_relative, 1 ) ));
-	m_actionMap.insert(std::make_pair("STRIP_VOLUME_ABSOLUTE", std::make_pair( &MidiActionManager::strip_volume_absolute, 1 ) ));
-	m_actionMap.insert(std::make_pair("EFFECT_LEVEL_ABSOLUTE", std::make_pair( &MidiActionManager::effect_level_absolute, 2 ) ));
-	m_actionMap.insert(std::make_pair("EFFECT_LEVEL_RELATIVE", std::make_pair( &MidiActionManager::effect_level_relative, 2 ) ));
-	m_actionMap.insert(std::make_pair("GAIN_LEVEL_ABSOLUTE", std::make_pair( &MidiActionManager::gain_level_absolute, 3 ) ));
-	m_actionMap.insert(std::make_pair("PITCH_LEVEL_ABSOLUTE", std::make_pair( &MidiActionManager::pitch_level_absolute, 3 ) ));
-	m_actionMap.insert(std::make_pair("SELECT_NEXT_PATTERN", std::make_pair( &MidiActionManager::select_next_pattern, 1 ) ));
-	m_actionMap.insert(std::make_pair("SELECT_ONLY_NEXT_PATTERN", std::make_pair( &MidiActionManager::select_only_next_pattern, 1 ) ));
-	m_actionMap.insert(std::make_pair("SELECT_NEXT_PATTERN_CC_ABSOLUTE", std::make_pair( &MidiActionManager::select_next_pattern_cc_absolute, 0 ) ));
-	m_actionMap.insert(std::make_pair("SELECT_ONLY_NEXT_PATTERN_CC_ABSOLUTE", std::make_pair( &MidiActionManager::select_only_next_pattern_cc_absolute, 0 ) ));
-	m_actionMap.insert(std::make_pair("SELECT_NEXT_PATTERN_RELATIVE", std::make_pair( &MidiActionManager::select_next_pattern_relative, 1 ) ));
-	m_actionMap.insert(std::make_pair("SELECT_AND_PLAY_PATTERN", std::make_pair( &MidiActionManager::select_and_play_pattern, 1 ) ));
-	m_actionMap.insert(std::make_pair("PAN_RELATIVE", std::make_pair( &MidiActionManager::pan_relative, 1 ) ));
-	m_actionMap.insert(std::make_pair("PAN_ABSOLUTE", std::make_pair( &MidiActionManager::pan_absolute, 1 ) ));
-	m_actionMap.insert(std::make_pair("PAN_ABSOLUTE_SYM", std::make_pair( &MidiActionManager::pan_absolute_sym, 1 ) ));
-	m_actionMap.insert(std::make_pair("INSTRUMENT_PITCH",
-									  std::make_pair( &MidiActionManager::instrument_pitch, 1 ) ));
-	m_actionMap.insert(std::make_pair("FILTER_CUTOFF_LEVEL_ABSOLUTE", std::make_pair( &MidiActionManager::filter_cutoff_level_absolute, 1 ) ));
-	m_actionMap.insert(std::make_pair("BEATCOUNTER", std::make_pair( &MidiActionManager::beatcounter, 0 ) ));
-	m_actionMap.insert(std::make_pair("TAP_TEMPO", std::make_pair( &MidiActionManager::tap_tempo, 0 ) ));
-	m_actionMap.insert(std::make_pair("PLAYLIST_SONG", std::make_pair( &MidiActionManager::playlist_song, 1 ) ));
-	m_actionMap.insert(std::make_pair("PLAYLIST_NEXT_SONG", std::make_pair( &MidiActionManager::playlist_next_song, 0 ) ));
-	m_actionMap.insert(std::make_pair("PLAYLIST_PREV_SONG", std::make_pair( &MidiActionManager::playlist_previous_song, 0 ) ));
-	m_actionMap.insert(std::make_pair("TOGGLE_METRONOME", std::make_pair( &MidiActionManager::toggle_metronome, 0 ) ));
-	m_actionMap.insert(std::make_pair("SELECT_INSTRUMENT", std::make_pair( &MidiActionManager::select_instrument, 0 ) ));
-	m_actionMap.insert(std::make_pair("UNDO_ACTION", std::make_pair( &MidiActionManager::undo_action, 0 ) ));
-	m_actionMap.insert(std::make_pair("REDO_ACTION", std::make_pair( &MidiActionManager::redo_action, 0 ) ));
-	m_actionMap.insert(std::make_pair("CLEAR_SELECTED_INSTRUMENT", std::make_pair(
-										  &MidiActionManager::clear_selected_instrument, 0 ) ));
-	m_actionMap.insert(std::make_pair("CLEAR_PATTERN", std::make_pair(
-										  &MidiActionManager::clear_pattern, 0 ) ));
-	m_actionMap.insert(std::make_pair("LOAD_NEXT_DRUMKIT", std::make_pair(
-										  &MidiActionManager::loadNextDrumkit, 0 ) ));
-	m_actionMap.insert(std::make_pair("LOAD_PREV_DRUMKIT", std::make_pair(
-										  &MidiActionManager::loadPrevDrumkit, 0 ) ));
+	for ( const auto& ddefinition : getActionDefinitions() ) {
+		m_actionList << ddefinition.sType;
+	}
+	m_actionList.sort();
+	m_actionList.prepend( "" );
+}
 
+const std::vector<MidiActionManager::ActionDefinition>& MidiActionManager::getActionDefinitions() {
 	/*
-	  the m_actionList holds all Action identifiers which hydrogen is able to interpret.
+		holds all Action identifiers which hydrogen is able to interpret
+		along with a pointer to the member function performing them.
 	*/
-	m_actionList <<"";
-	for ( const auto& ppAction : m_actionMap ) {
-		m_actionList << ppAction.first;
+	static const std::vector<ActionDefinition> definitions = {
+		{ "PLAY", &MidiActionManager::play, 0 },
+		{ "PLAY/STOP_TOGGLE", &MidiActionManager::play_stop_pause_toggle, 0 },
+		{ "PLAY/PAUSE_TOGGLE", &MidiActionManager::play_stop_pause_toggle, 0 },
+		{ "STOP", &MidiActionManager::stop, 0 },
+		{ "PAUSE", &MidiActionManager::pause, 0 },
+		{ "RECORD_READY", &MidiActionManager::record_ready, 0 },
+		{ "RECORD/STROBE_TOGGLE", &MidiActionManager::record_strobe_toggle, 0 },
+		{ "RECORD_STROBE", &MidiActionManager::record_strobe, 0 },
+		{ "RECORD_EXIT", &MidiActionManager::record_exit, 0 },
+		{ "MUTE", &MidiActionManager::mute, 0 },
+		{ "UNMUTE", &MidiActionManager::unmute, 0 },
+		{ "MUTE_TOGGLE", &MidiActionManager::mute_toggle, 0 },
+		{ "STRIP_MUTE_TOGGLE", &MidiActionManager::strip_mute_toggle, 1 },
+		{ "STRIP_SOLO_TOGGLE", &MidiActionManager::strip_solo_toggle, 1 },
+		{ ">>_NEXT_BAR", &MidiActionManager::next_bar, 0 },
+		{ "<<_PREVIOUS_BAR", &MidiActionManager::previous_bar, 0 },
+		{ "BPM_INCR", &MidiActionManager::bpm_increase, 1 },
+		{ "BPM_DECR", &MidiActionManager::bpm_decrease, 1 },
+		{ "BPM_CC_RELATIVE", &MidiActionManager::bpm_cc_relative, 1 },
+		{ "BPM_FINE_CC_RELATIVE", &MidiActionManager::bpm_fine_cc_relative, 1 },
+		{ "MASTER_VOLUME_RELATIVE", &MidiActionManager::master_volume_relative, 0 },
+		{ "MASTER_VOLUME_ABSOLUTE", &MidiActionManager::master_volume_absolute, 0 },
+		{ "STRIP_VOLUME_RELATIVE", &MidiActionManager::strip_volume_relative, 1 },
+		{ "STRIP_VOLUME_ABSOLUTE", &MidiActionManager::strip_volume_absolute, 1 },
+		{ "EFFECT_LEVEL_ABSOLUTE", &MidiActionManager::effect_level_absolute, 2 },
+		{ "EFFECT_LEVEL_RELATIVE", &MidiActionManager::effect_level_relative, 2 },
+		{ "GAIN_LEVEL_ABSOLUTE", &MidiActionManager::gain_level_absolute, 3 },
+		{ "PITCH_LEVEL_ABSOLUTE", &MidiActionManager::pitch_level_absolute, 3 },
+		{ "SELECT_NEXT_PATTERN", &MidiActionManager::select_next_pattern, 1 },
+		{ "SELECT_ONLY_NEXT_PATTERN", &MidiActionManager::select_only_next_pattern, 1 },
+		{ "SELECT_NEXT_PATTERN_CC_ABSOLUTE", &MidiActionManager::select_next_pattern_cc_absolute, 0 },
+		{ "SELECT_ONLY_NEXT_PATTERN_CC_ABSOLUTE", &MidiActionManager::select_only_next_pattern_cc_absolute, 0 },
+		{ "SELECT_NEXT_PATTERN_RELATIVE", &MidiActionManager::select_next_pattern_relative, 1 },
+		{ "SELECT_AND_PLAY_PATTERN", &MidiActionManager::select_and_play_pattern, 1 },
+		{ "PAN_RELATIVE", &MidiActionManager::pan_relative, 1 },
+		{ "PAN_ABSOLUTE", &MidiActionManager::pan_absolute, 1 },
+		{ "PAN_ABSOLUTE_SYM", &MidiActionManager::pan_absolute_sym, 1 },
+		{ "INSTRUMENT_PITCH", &MidiActionManager::instrument_pitch, 1 },
+		{ "FILTER_CUTOFF_LEVEL_ABSOLUTE", &MidiActionManager::filter_cutoff_level_absolute, 1 },
+		{ "BEATCOUNTER", &MidiActionManager::beatcounter, 0 },
+		{ "TAP_TEMPO", &MidiActionManager::tap_tempo, 0 },
+		{ "PLAYLIST_SONG", &MidiActionManager::playlist_song, 1 },
+		{ "PLAYLIST_NEXT_SONG", &MidiActionManager::playlist_next_song, 0 },
+		{ "PLAYLIST_PREV_SONG", &MidiActionManager::playlist_previous_song, 0 },
+		{ "TOGGLE_METRONOME", &MidiActionManager::toggle_metronome, 0 },
+		{ "SELECT_INSTRUMENT", &MidiActionManager::select_instrument, 0 },
+		{ "UNDO_ACTION", &MidiActionManager::undo_action, 0 },
+		{ "REDO_ACTION", &MidiActionManager::redo_action, 0 },
+		{ "CLEAR_SELECTED_INSTRUMENT", &MidiActionManager::clear_selected_instrument, 0 },
+		{ "CLEAR_PATTERN", &MidiActionManager::clear_pattern, 0 },
+		{ "LOAD_NEXT_DRUMKIT", &MidiActionManager::loadNextDrumkit, 0 },
+		{ "LOAD_PREV_DRUMKIT", &MidiActionManager::loadPrevDrumkit, 0 },
+	};
+
+	return definitions;
+}
+
+int MidiActionManager::getTypeId( const QString& sActionType ) {
+	static const std::map<QString, int> typeIds = []() {
+		std::map<QString, int> typeIds;
+		const auto& definitions = getActionDefinitions();
+		for ( int ii = 0; ii < static_cast<int>(definitions.size()); ++ii ) {
+			typeIds[ definitions[ ii ].sType ] = ii;
+		}
+		return typeIds;
+	}();
+
+	const auto it = typeIds.find( sActionType );
+	if ( it == typeIds.end() ) {
+		return -1;
 	}
+	return it->second;
 }
 
 
@@ -227,7 +260,7 @@ void MidiActionManager::create_instance() {
 	}
 }
 
-bool MidiActionManager::play( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::play( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -240,7 +273,7 @@ bool MidiActionManager::play( std::shared_ptr<Action> pAction, Hydrogen* pHydrog
 	return true;
 }
 
-bool MidiActionManager::pause( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::pause( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -251,7 +284,7 @@ bool MidiActionManager::pause( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
 	return true;
 }
 
-bool MidiActionManager::stop( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::stop( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -262,7 +295,7 @@ bool MidiActionManager::stop( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
 	return CoreActionController::locateToColumn( 0 );
 }
 
-bool MidiActionManager::play_stop_pause_toggle( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::play_stop_pause_toggle( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -292,7 +325,7 @@ bool MidiActionManager::play_stop_pause_toggle( std::shared_ptr<Action> pAction,
 }
 
 //mutes the master, not a single strip
-bool MidiActionManager::mute( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::mute( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -302,7 +335,7 @@ bool MidiActionManager::mute( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
 	return CoreActionController::setMasterIsMuted( true );
 }
 
-bool MidiActionManager::unmute( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::unmute( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -312,7 +345,7 @@ bool MidiActionManager::unmute( std::shared_ptr<Action> , Hydrogen* pHydrogen )
 	return CoreActionController::setMasterIsMuted( false );
 }
 
-bool MidiActionManager::mute_toggle( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::mute_toggle( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -322,7 +355,7 @@ bool MidiActionManager::mute_toggle( std::shared_ptr<Action> , Hydrogen* pHydrog
 	return CoreActionController::setMasterIsMuted( !pHydrogen->getSong()->getIsMuted() );
 }
 
-bool MidiActionManager::strip_mute_toggle( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::strip_mute_toggle( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -331,8 +364,7 @@ bool MidiActionManager::strip_mute_toggle( std::shared_ptr<Action> pAction, Hydr
 		return false;
 	}
 	
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -345,7 +377,7 @@ bool MidiActionManager::strip_mute_toggle( std::shared_ptr<Action> pAction, Hydr
 	return CoreActionController::setStripIsMuted( nLine, !pInstr->is_muted() );
 }
 
-bool MidiActionManager::strip_solo_toggle( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::strip_solo_toggle( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -354,8 +386,7 @@ bool MidiActionManager::strip_solo_toggle( std::shared_ptr<Action> pAction, Hydr
 		return false;
 	}
 	
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -368,7 +399,7 @@ bool MidiActionManager::strip_solo_toggle( std::shared_ptr<Action> pAction, Hydr
 	return CoreActionController::setStripIsSoloed( nLine, !pInstr->is_soloed() );
 }
 
-bool MidiActionManager::beatcounter( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::beatcounter( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -378,7 +409,7 @@ bool MidiActionManager::beatcounter( std::shared_ptr<Action> , Hydrogen* pHydrog
 	return pHydrogen->handleBeatCounter();
 }
 
-bool MidiActionManager::tap_tempo( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::tap_tempo( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -389,21 +420,18 @@ bool MidiActionManager::tap_tempo( std::shared_ptr<Action> , Hydrogen* pHydrogen
 	return true;
 }
 
-bool MidiActionManager::select_next_pattern( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
-	bool ok;
-	return nextPatternSelection( pAction->getParameter1().toInt(&ok,10) );
+bool MidiActionManager::select_next_pattern( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
+	return nextPatternSelection( pAction->getIntParameter1() );
 }
 
 
-bool MidiActionManager::select_next_pattern_relative( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
-	bool ok;
+bool MidiActionManager::select_next_pattern_relative( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
 	return nextPatternSelection( pHydrogen->getSelectedPatternNumber() +
-								 pAction->getParameter1().toInt(&ok,10) );
+								 pAction->getIntParameter1() );
 }
 
-bool MidiActionManager::select_next_pattern_cc_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
-	bool ok;
-	return nextPatternSelection( pAction->getValue().toInt(&ok,10) );
+bool MidiActionManager::select_next_pattern_cc_absolute( std::shared_ptr<Action>, int nValue, Hydrogen* pHydrogen ) {
+	return nextPatternSelection( nValue );
 }
 
 bool MidiActionManager::nextPatternSelection( int nPatternNumber ) {
@@ -433,14 +461,12 @@ bool MidiActionManager::nextPatternSelection( int nPatternNumber ) {
 	return true;
 }
 
-bool MidiActionManager::select_only_next_pattern( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
-	bool ok;
-	return onlyNextPatternSelection( pAction->getParameter1().toInt(&ok,10) );
+bool MidiActionManager::select_only_next_pattern( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
+	return onlyNextPatternSelection( pAction->getIntParameter1() );
 }
 
-bool MidiActionManager::select_only_next_pattern_cc_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
-	bool ok;
-	return onlyNextPatternSelection( pAction->getValue().toInt(&ok,10) );
+bool MidiActionManager::select_only_next_pattern_cc_absolute( std::shared_ptr<Action>, int nValue, Hydrogen* pHydrogen ) {
+	return onlyNextPatternSelection( nValue );
 }
 
 bool MidiActionManager::onlyNextPatternSelection( int nPatternNumber ) {
@@ -475,14 +501,14 @@ bool MidiActionManager::onlyNextPatternSelection( int nPatternNumber ) {
 	return pHydrogen->flushAndAddNextPattern( nPatternNumber );
 }
 
-bool MidiActionManager::select_and_play_pattern( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::select_and_play_pattern( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
 		return false;
 	}
 	
-	if ( ! select_next_pattern( pAction, pHydrogen ) ) {
+	if ( ! select_next_pattern( pAction, nValue, pHydrogen ) ) {
 		return false;
 	}
 
@@ -493,7 +519,7 @@ bool MidiActionManager::select_and_play_pattern( std::shared_ptr<Action> pAction
 	return true;
 }
 
-bool MidiActionManager::select_instrument( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::select_instrument( std::shared_ptr<Action>, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -502,8 +528,7 @@ bool MidiActionManager::select_instrument( std::shared_ptr<Action> pAction, Hydr
 		return false;
 	}
 	
-	bool ok;
-	int  nInstrumentNumber = pAction->getValue().toInt(&ok,10) ;
+	int nInstrumentNumber = nValue;
 
 	if ( pSong->getDrumkit()->getInstruments()->size() < nInstrumentNumber ) {
 		nInstrumentNumber = pSong->getDrumkit()->getInstruments()->size() -1;
@@ -515,7 +540,7 @@ bool MidiActionManager::select_instrument( std::shared_ptr<Action> pAction, Hydr
 	return true;
 }
 
-bool MidiActionManager::effect_level_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen) {
+bool MidiActionManager::effect_level_absolute( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -524,10 +549,9 @@ bool MidiActionManager::effect_level_absolute( std::shared_ptr<Action> pAction,
 		return false;
 	}
 	
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int fx_param = pAction->getValue().toInt(&ok,10);
-	int fx_id = pAction->getParameter2().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int fx_param = nValue;
+	int fx_id = pAction->getIntParameter2();
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -550,7 +574,7 @@ bool MidiActionManager::effect_level_absolute( std::shared_ptr<Action> pAction,
 	return true;
 }
 
-bool MidiActionManager::effect_level_relative( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::effect_level_relative( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -559,10 +583,9 @@ bool MidiActionManager::effect_level_relative( std::shared_ptr<Action> pAction,
 		return false;
 	}
 	
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int fx_param = pAction->getValue().toInt(&ok,10);
-	int fx_id = pAction->getParameter2().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int fx_param = nValue;
+	int fx_id = pAction->getIntParameter2();
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -588,7 +611,7 @@ bool MidiActionManager::effect_level_relative( std::shared_ptr<Action> pAction,
 }
 
 //sets the volume of a master output to a given level (percentage)
-bool MidiActionManager::master_volume_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::master_volume_absolute( std::shared_ptr<Action>, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -597,8 +620,7 @@ bool MidiActionManager::master_volume_absolute( std::shared_ptr<Action> pAction,
 		return false;
 	}
 
-	bool ok;
-	int nVolume = pAction->getValue().toInt(&ok,10);
+	int nVolume = nValue;
 
 	if ( nVolume != 0 ) {
 		pSong->setVolume( 1.5* ( (float) (nVolume / 127.0 ) ));
@@ -610,7 +632,7 @@ bool MidiActionManager::master_volume_absolute( std::shared_ptr<Action> pAction,
 }
 
 //increments/decrements the volume of the whole song
-bool MidiActionManager::master_volume_relative( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::master_volume_relative( std::shared_ptr<Action>, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -619,8 +641,7 @@ bool MidiActionManager::master_volume_relative( std::shared_ptr<Action> pAction,
 		return false;
 	}
 
-	bool ok;
-	int nVolume = pAction->getValue().toInt(&ok,10);
+	int nVolume = nValue;
 
 	if ( nVolume != 0 ) {
 		if ( nVolume == 1 && pSong->getVolume() < 1.5 ) {
@@ -636,7 +657,7 @@ bool MidiActionManager::master_volume_relative( std::shared_ptr<Action> pAction,
 }
 
 //sets the volume of a mixer strip to a given level (percentage)
-bool MidiActionManager::strip_volume_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::strip_volume_absolute( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -645,9 +666,8 @@ bool MidiActionManager::strip_volume_absolute( std::shared_ptr<Action> pAction,
 		return false;
 	}
 
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int nVolume = pAction->getValue().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int nVolume = nValue;
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -670,7 +690,7 @@ bool MidiActionManager::strip_volume_absolute( std::shared_ptr<Action> pAction,
 }
 
 //increments/decrements the volume of one mixer strip
-bool MidiActionManager::strip_volume_relative( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::strip_volume_relative( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 
 	// Preventive measure to avoid bad things.
@@ -679,9 +699,8 @@ bool MidiActionManager::strip_volume_relative( std::shared_ptr<Action> pAction,
 		return false;
 	}
 
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int nVolume = pAction->getValue().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int nVolume = nValue;
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 
@@ -711,7 +730,7 @@ bool MidiActionManager::strip_volume_relative( std::shared_ptr<Action> pAction,
 }
 
 // sets the absolute panning of a given mixer channel
-bool MidiActionManager::pan_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::pan_absolute( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -720,9 +739,8 @@ bool MidiActionManager::pan_absolute( std::shared_ptr<Action> pAction, Hydrogen*
 		return false;
 	}
 
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int pan_param = pAction->getValue().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int pan_param = nValue;
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 
@@ -742,7 +760,7 @@ bool MidiActionManager::pan_absolute( std::shared_ptr<Action> pAction, Hydrogen*
 }
 
 // sets the absolute panning of a given mixer channel
-bool MidiActionManager::pan_absolute_sym( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::pan_absolute_sym( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -751,9 +769,8 @@ bool MidiActionManager::pan_absolute_sym( std::shared_ptr<Action> pAction, Hydro
 		return false;
 	}
 
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int pan_param = pAction->getValue().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int pan_param = nValue;
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -774,7 +791,7 @@ bool MidiActionManager::pan_absolute_sym( std::shared_ptr<Action> pAction, Hydro
 
 // changes the panning of a given mixer channel
 // this is useful if the panning is set by a rotary control knob
-bool MidiActionManager::pan_relative( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::pan_relative( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -783,9 +800,8 @@ bool MidiActionManager::pan_relative( std::shared_ptr<Action> pAction, Hydrogen*
 		return false;
 	}
 
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int pan_param = pAction->getValue().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int pan_param = nValue;
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -810,7 +826,7 @@ bool MidiActionManager::pan_relative( std::shared_ptr<Action> pAction, Hydrogen*
 	return true;
 }
 
-bool MidiActionManager::gain_level_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::gain_level_absolute( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -819,11 +835,10 @@ bool MidiActionManager::gain_level_absolute( std::shared_ptr<Action> pAction, Hy
 		return false;
 	}
 	
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int gain_param = pAction->getValue().toInt(&ok,10);
-	int component_id = pAction->getParameter2().toInt(&ok,10);
-	int layer_id = pAction->getParameter3().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int gain_param = nValue;
+	int component_id = pAction->getIntParameter2();
+	int layer_id = pAction->getIntParameter3();
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 	
@@ -857,7 +872,7 @@ bool MidiActionManager::gain_level_absolute( std::shared_ptr<Action> pAction, Hy
 	return true;
 }
 
-bool MidiActionManager::pitch_level_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::pitch_level_absolute( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -866,11 +881,10 @@ bool MidiActionManager::pitch_level_absolute( std::shared_ptr<Action> pAction, H
 		return false;
 	}
 	
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int pitch_param = pAction->getValue().toInt(&ok,10);
-	int component_id = pAction->getParameter2().toInt(&ok,10);
-	int layer_id = pAction->getParameter3().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int pitch_param = nValue;
+	int component_id = pAction->getIntParameter2();
+	int layer_id = pAction->getIntParameter3();
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 
@@ -906,12 +920,11 @@ bool MidiActionManager::pitch_level_absolute( std::shared_ptr<Action> pAction, H
 	return true;
 }
 
-bool MidiActionManager::instrument_pitch( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::instrument_pitch( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 
-	bool ok;
 	float fPitch;
-	const int nInstrument = pAction->getParameter1().toInt(&ok,10);
-	const int nPitchMidi = pAction->getValue().toInt(&ok,10);
+	const int nInstrument = pAction->getIntParameter1();
+	const int nPitchMidi = nValue;
 	if ( nPitchMidi != 0 ) {
 		fPitch = ( Instrument::fPitchMax - Instrument::fPitchMin ) *
 			( (float) (nPitchMidi / 127.0 ) ) + Instrument::fPitchMin;
@@ -922,7 +935,7 @@ bool MidiActionManager::instrument_pitch( std::shared_ptr<Action> pAction, Hydro
 	return CoreActionController::setInstrumentPitch( nInstrument, fPitch );
 }
 
-bool MidiActionManager::filter_cutoff_level_absolute( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::filter_cutoff_level_absolute( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	
 	// Preventive measure to avoid bad things.
@@ -931,9 +944,8 @@ bool MidiActionManager::filter_cutoff_level_absolute( std::shared_ptr<Action> pA
 		return false;
 	}
 	
-	bool ok;
-	int nLine = pAction->getParameter1().toInt(&ok,10);
-	int filter_cutoff_param = pAction->getValue().toInt(&ok,10);
+	int nLine = pAction->getIntParameter1();
+	int filter_cutoff_param = nValue;
 
 	auto pInstrList = pSong->getDrumkit()->getInstruments();
 
@@ -961,7 +973,7 @@ bool MidiActionManager::filter_cutoff_level_absolute( std::shared_ptr<Action> pA
  * increments/decrements the BPM
  * this is useful if the bpm is set by a rotary control knob
  */
-bool MidiActionManager::bpm_cc_relative( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::bpm_cc_relative( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -973,10 +985,9 @@ bool MidiActionManager::bpm_cc_relative( std::shared_ptr<Action> pAction, Hydrog
 
 	//this Action should be triggered only by CC commands
 
-	bool ok;
-	int mult = pAction->getParameter1().toInt(&ok,10);
+	int mult = pAction->getIntParameter1();
 	//this value should be 1 to decrement and something other then 1 to increment the bpm
-	int cc_param = pAction->getValue().toInt(&ok,10);
+	int cc_param = nValue;
 
 	if( m_nLastBpmChangeCCParameter == -1) {
 		m_nLastBpmChangeCCParameter = cc_param;
@@ -1003,7 +1014,7 @@ bool MidiActionManager::bpm_cc_relative( std::shared_ptr<Action> pAction, Hydrog
  * increments/decrements the BPM
  * this is useful if the bpm is set by a rotary control knob
  */
-bool MidiActionManager::bpm_fine_cc_relative( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::bpm_fine_cc_relative( std::shared_ptr<Action> pAction, int nValue, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1014,10 +1025,9 @@ bool MidiActionManager::bpm_fine_cc_relative( std::shared_ptr<Action> pAction, H
 	const float fBpm = pAudioEngine->getTransportPosition()->getBpm();
 
 	//this Action should be triggered only by CC commands
-	bool ok;
-	int mult = pAction->getParameter1().toInt(&ok,10);
+	int mult = pAction->getIntParameter1();
 	//this value should be 1 to decrement and something other then 1 to increment the bpm
-	int cc_param = pAction->getValue().toInt(&ok,10);
+	int cc_param = nValue;
 
 	if( m_nLastBpmChangeCCParameter == -1) {
 		m_nLastBpmChangeCCParameter = cc_param;
@@ -1039,7 +1049,7 @@ bool MidiActionManager::bpm_fine_cc_relative( std::shared_ptr<Action> pAction, H
 	return true;
 }
 
-bool MidiActionManager::bpm_increase( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::bpm_increase( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1049,7 +1059,7 @@ bool MidiActionManager::bpm_increase( std::shared_ptr<Action> pAction, Hydrogen*
 	auto pAudioEngine = pHydrogen->getAudioEngine();
 	const float fBpm = pAudioEngine->getTransportPosition()->getBpm();
 
-	const float fMult = pAction->getParameter1().toFloat();
+	const float fMult = pAction->getFloatParameter1();
 
 	CoreActionController::setBpm( fBpm + 1 * fMult );
 	
@@ -1058,7 +1068,7 @@ bool MidiActionManager::bpm_increase( std::shared_ptr<Action> pAction, Hydrogen*
 	return true;
 }
 
-bool MidiActionManager::bpm_decrease( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::bpm_decrease( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1068,7 +1078,7 @@ bool MidiActionManager::bpm_decrease( std::shared_ptr<Action> pAction, Hydrogen*
 	auto pAudioEngine = pHydrogen->getAudioEngine();
 	const float fBpm = pAudioEngine->getTransportPosition()->getBpm();
 
-	const float fMult = pAction->getParameter1().toFloat();
+	const float fMult = pAction->getFloatParameter1();
 
 	CoreActionController::setBpm( fBpm - 1 * fMult );
 	
@@ -1077,7 +1087,7 @@ bool MidiActionManager::bpm_decrease( std::shared_ptr<Action> pAction, Hydrogen*
 	return true;
 }
 
-bool MidiActionManager::next_bar( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::next_bar( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	const auto pSong = pHydrogen->getSong();
 	if ( pSong == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1119,7 +1129,7 @@ bool MidiActionManager::next_bar( std::shared_ptr<Action> , Hydrogen* pHydrogen
 }
 
 
-bool MidiActionManager::previous_bar( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::previous_bar( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	const auto pSong = pHydrogen->getSong();
 	if ( pSong == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1188,23 +1198,22 @@ bool MidiActionManager::setSongFromPlaylist( int nSongNumber, Hydrogen* pHydroge
 	return true;
 }
 
-bool MidiActionManager::playlist_song( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
-	bool ok;
-	int songnumber = pAction->getParameter1().toInt(&ok,10);
+bool MidiActionManager::playlist_song( std::shared_ptr<Action> pAction, int, Hydrogen* pHydrogen ) {
+	int songnumber = pAction->getIntParameter1();
 	return setSongFromPlaylist( songnumber, pHydrogen );
 }
 
-bool MidiActionManager::playlist_next_song( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::playlist_next_song( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	int songnumber = pHydrogen->getPlaylist()->getActiveSongNumber();
 	return setSongFromPlaylist( ++songnumber, pHydrogen );
 }
 
-bool MidiActionManager::playlist_previous_song( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::playlist_previous_song( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	int songnumber = pHydrogen->getPlaylist()->getActiveSongNumber();
 	return setSongFromPlaylist( --songnumber, pHydrogen );
 }
 
-bool MidiActionManager::record_ready( std::shared_ptr<Action> pAction, Hydrogen* pHydrogen ) {
+bool MidiActionManager::record_ready( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1222,7 +1231,7 @@ bool MidiActionManager::record_ready( std::shared_ptr<Action> pAction, Hydrogen*
 	return true;
 }
 
-bool MidiActionManager::record_strobe_toggle( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::record_strobe_toggle( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1238,7 +1247,7 @@ bool MidiActionManager::record_strobe_toggle( std::shared_ptr<Action> , Hydrogen
 	return true;
 }
 
-bool MidiActionManager::record_strobe( std::shared_ptr<Action> , Hydrogen* pHydrogen ) {
+bool MidiActionManager::record_strobe( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1251,7 +1260,7 @@ bool MidiActionManager::record_strobe( std::shared_ptr<Action> , Hydrogen* pHydr
 	return true;
 }
 
-bool MidiActionManager::record_exit( std::shared_ptr<Action> , Hydrogen* pHydrogen) {
+bool MidiActionManager::record_exit( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1264,7 +1273,7 @@ bool MidiActionManager::record_exit( std::shared_ptr<Action> , Hydrogen* pHydrog
 	return true;
 }
 
-bool MidiActionManager::toggle_metronome( std::shared_ptr<Action> , Hydrogen* pHydrogen) {
+bool MidiActionManager::toggle_metronome( std::shared_ptr<Action>, int, Hydrogen* pHydrogen ) {
 	// Preventive measure to avoid bad things.
 	if ( pHydrogen->getSong() == nullptr ) {
 		ERRORLOG( "No song set yet" );
@@ -1279,32 +1288,32 @@ bool MidiActionManager::toggle_metronome( std::shared_ptr<Action> , Hydrogen* pH
 	return true;
 }
 
-bool MidiActionManager::undo_action( std::shared_ptr<Action> , Hydrogen* ) {
+bool MidiActionManager::undo_action( std::shared_ptr<Action>, int, Hydrogen* ) {
 	EventQueue::get_instance()->push_event( EVENT_UNDO_REDO, 0);// 0 = undo
 	return true;
 }
 
-bool MidiActionManager::redo_action( std::shared_ptr<Action> , Hydrogen* ) {
+bool MidiActionManager::redo_action( std::shared_ptr<Action>, int, Hydrogen* ) {
 	EventQueue::get_instance()->push_event( EVENT_UNDO_REDO, 1);// 1 = redo
 	return true;
 }
 
-bool MidiActionManager::loadNextDrumkit( std::shared_ptr<Action>, Hydrogen* ) {
+bool MidiActionManager::loadNextDrumkit( std::shared_ptr<Action>, int, Hydrogen* ) {
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
-	return CoreActionController::setDrumkit(
+	return CoreActionController::switchDrumkit(
 		pHydrogen->getSoundLibraryDatabase()->getNextDrumkit() );
 }
 
-bool MidiActionManager::loadPrevDrumkit( std::shared_ptr<Action>, Hydrogen* ) {
+bool MidiActionManager::loadPrevDrumkit( std::shared_ptr<Action>, int, Hydrogen* ) {
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
-	return CoreActionController::setDrumkit(
+	return CoreActionController::switchDrumkit(
 		pHydrogen->getSoundLibraryDatabase()->getPreviousDrumkit() );
 }
 
 int MidiActionManager::getParameterNumber( const QString& sActionType ) const {
-	auto foundActionPair = m_actionMap.find( sActionType );
-	if ( foundActionPair != m_actionMap.end() ) {
-		return foundActionPair->second.second;
+	const int nTypeId = getTypeId( sActionType );
+	if ( nTypeId != -1 ) {
+		return getActionDefinitions()[ nTypeId ].nParameters;
 	} else {
 		ERRORLOG( QString( "MIDI Action type [%1] couldn't be found" ).arg( sActionType ) );
 	}
@@ -1312,7 +1321,7 @@ int MidiActionManager::getParameterNumber( const QString& sActionType ) const {
 	return -1;
 }
 
-bool MidiActionManager::clear_selected_instrument( std::shared_ptr<Action> pAction,
+bool MidiActionManager::clear_selected_instrument( std::shared_ptr<Action>, int,
 												   Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	if ( pSong == nullptr ) {
@@ -1329,7 +1338,7 @@ bool MidiActionManager::clear_selected_instrument( std::shared_ptr<Action> pActi
 	return CoreActionController::clearInstrumentInPattern( nInstr );
 }
 
-bool MidiActionManager::clear_pattern( std::shared_ptr<Action> pAction,
+bool MidiActionManager::clear_pattern( std::shared_ptr<Action>, int,
 										   Hydrogen* pHydrogen ) {
 	auto pSong = pHydrogen->getSong();
 	if ( pSong == nullptr ) {
@@ -1368,8 +1377,6 @@ bool MidiActionManager::handleActions( const std::vector<std::shared_ptr<Action>
 }
 
 bool MidiActionManager::handleAction( const std::shared_ptr<Action> pAction ) {
-
-	Hydrogen *pHydrogen = Hydrogen::get_instance();
 	/*
 		return false if action is null
 		(for example if no Action exists for an event)
@@ -1378,15 +1385,24 @@ bool MidiActionManager::handleAction( const std::shared_ptr<Action> pAction ) {
 		return false;
 	}
 
-	QString sActionString = pAction->getType();
+	return handleAction( pAction, pAction->getIntValue() );
+}
 
-	auto foundActionPair = m_actionMap.find( sActionString );
-	if( foundActionPair != m_actionMap.end() ) {
-		action_f action = foundActionPair->second.first;
-		return (this->*action)(pAction, pHydrogen);
-	} else {
-		ERRORLOG( QString( "MIDI Action type [%1] couldn't be found" ).arg( sActionString ) );
+bool MidiActionManager::handleAction( const std::shared_ptr<Action> pAction,
+									  int nValue ) {
+	if( pAction == nullptr ) {
+		return false;
+	}
+
+	// The type was already resolved when creating the action.
+	const int nTypeId = pAction->getTypeId();
+	const auto& definitions = getActionDefinitions();
+	if ( nTypeId < 0 || nTypeId >= static_cast<int>(definitions.size()) ) {
+		ERRORLOG( QString( "MIDI Action type [%1] couldn't be found" )
+				  .arg( pAction->getType() ) );
+		return false;
 	}
 
-	return false;
+	action_f action = definitions[ nTypeId ].function;
+	return (this->*action)( pAction, nValue, Hydrogen::get_instance() );
 }
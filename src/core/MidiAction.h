@@ -25,6 +25,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #include <cassert>
 
 /** \ingroup docCore docMIDI */
@@ -43,18 +44,23 @@ class Action : public H2Core::Object<Action> {
 
 		void setParameter1( const QString& text ){
 			m_sParameter1 = text;
+			m_nParameter1 = text.toInt();
+			m_fParameter1 = text.toFloat();
 		}
 
 		void setParameter2( const QString& text ){
 			m_sParameter2 = text;
+			m_nParameter2 = text.toInt();
 		}
 
 		void setParameter3( const QString& text ){
 			m_sParameter3 = text;
+			m_nParameter3 = text.toInt();
 		}
 
 		void setValue( const QString& text ){
 			m_sValue = text;
+			m_nValue = text.toInt();
 		}
 
 		const QString& getParameter1() const {
@@ -77,6 +83,33 @@ class Action : public H2Core::Object<Action> {
 			return m_sType;
 		}
 
+	/** Parameters and value converted to integers when being set. This
+	 * way handling an action does not require any string parsing. */
+	int getIntParameter1() const {
+		return m_nParameter1;
+	}
+	int getIntParameter2() const {
+		return m_nParameter2;
+	}
+	int getIntParameter3() const {
+		return m_nParameter3;
+	}
+	int getIntValue() const {
+		return m_nValue;
+	}
+	/** Same as getIntParameter1() for actions using their first
+	 * parameter as a factor. */
+	float getFloatParameter1() const {
+		return m_fParameter1;
+	}
+	/** Index of #m_sType within the actions known to
+	 * #MidiActionManager. It is resolved once on construction.
+	 *
+	 * \return -1 in case the type is not supported. */
+	int getTypeId() const {
+		return m_nTypeId;
+	}
+
 	/**
 	 * @returns whether the current action and @a pOther identically
 	 *   in all member except of #m_sValue. If true, they are associated
@@ -130,6 +163,13 @@ class Action : public H2Core::Object<Action> {
 		QString m_sParameter2;
 		QString m_sParameter3;
 		QString m_sValue;
+
+		int m_nTypeId;
+		int m_nParameter1;
+		int m_nParameter2;
+		int m_nParameter3;
+		int m_nValue;
+		float m_fParameter1;
 };
 
 namespace H2Core
@@ -156,67 +196,74 @@ class MidiActionManager : public H2Core::Object<MidiActionManager>
 		 */
 	QStringList m_actionList;
 
-		typedef bool (MidiActionManager::*action_f)(std::shared_ptr<Action> , H2Core::Hydrogen * );
+		/** Performs an action. The integer argument is the value of
+		 * the incoming event (e.g. the velocity of a MIDI note). */
+		typedef bool (MidiActionManager::*action_f)(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		struct ActionDefinition {
+			QString sType;
+			/** Pointer to member function performing the desired
+			 * action. */
+			action_f function;
+			/** How many additional Action parameters are required. */
+			int nParameters;
+		};
 		/**
 		 * Holds all Action identifiers which Hydrogen is able to
-		 * interpret.  
-		 *
-		 * It holds a pair consisting of a pointer to member function
-		 * performing the desired action and an integer specifying how
-		 * many additional Action parameters are required to do so.
+		 * interpret. The position of an entry within the returned
+		 * vector is the type id of the corresponding Action.
 		 */
-	std::map<QString, std::pair<action_f,int>> m_actionMap;
-		bool play(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool play_stop_pause_toggle(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool stop(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool pause(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool record_ready(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool record_strobe_toggle(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool record_strobe(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool record_exit(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool mute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool unmute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool mute_toggle(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool strip_mute_toggle(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool strip_solo_toggle(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool next_bar(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool previous_bar(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool bpm_increase(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool bpm_decrease(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool bpm_cc_relative(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool bpm_fine_cc_relative(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool master_volume_relative(std::shared_ptr<Action> , H2Core::Hydrogen *);
-		bool master_volume_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool strip_volume_relative(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool strip_volume_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool effect_level_relative(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool effect_level_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool select_next_pattern(std::shared_ptr<Action> , H2Core::Hydrogen * );
-	bool select_only_next_pattern(std::shared_ptr<Action> , H2Core::Hydrogen * );
-	bool select_only_next_pattern_cc_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool select_next_pattern_cc_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool select_next_pattern_relative(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool select_and_play_pattern(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool pan_relative(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool pan_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-	bool pan_absolute_sym(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool instrument_pitch(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool filter_cutoff_level_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool beatcounter(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool tap_tempo(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool playlist_song(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool playlist_next_song(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool playlist_previous_song(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool toggle_metronome(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool select_instrument(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool undo_action(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool redo_action(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool gain_level_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool pitch_level_absolute(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool clear_selected_instrument(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool clear_pattern(std::shared_ptr<Action> , H2Core::Hydrogen * );
-		bool loadNextDrumkit( std::shared_ptr<Action>, H2Core::Hydrogen* );
-		bool loadPrevDrumkit( std::shared_ptr<Action>, H2Core::Hydrogen* );
+		static const std::vector<ActionDefinition>& getActionDefinitions();
+		bool play(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool play_stop_pause_toggle(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool stop(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool pause(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool record_ready(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool record_strobe_toggle(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool record_strobe(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool record_exit(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool mute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool unmute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool mute_toggle(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool strip_mute_toggle(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool strip_solo_toggle(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool next_bar(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool previous_bar(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool bpm_increase(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool bpm_decrease(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool bpm_cc_relative(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool bpm_fine_cc_relative(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool master_volume_relative(std::shared_ptr<Action> , int, H2Core::Hydrogen *);
+		bool master_volume_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool strip_volume_relative(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool strip_volume_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool effect_level_relative(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool effect_level_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool select_next_pattern(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+	bool select_only_next_pattern(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+	bool select_only_next_pattern_cc_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool select_next_pattern_cc_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool select_next_pattern_relative(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool select_and_play_pattern(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool pan_relative(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool pan_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+	bool pan_absolute_sym(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool instrument_pitch(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool filter_cutoff_level_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool beatcounter(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool tap_tempo(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool playlist_song(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool playlist_next_song(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool playlist_previous_song(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool toggle_metronome(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool select_instrument(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool undo_action(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool redo_action(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool gain_level_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool pitch_level_absolute(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool clear_selected_instrument(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool clear_pattern(std::shared_ptr<Action> , int, H2Core::Hydrogen * );
+		bool loadNextDrumkit( std::shared_ptr<Action>, int, H2Core::Hydrogen* );
+		bool loadPrevDrumkit( std::shared_ptr<Action>, int, H2Core::Hydrogen* );
 
 		int m_nLastBpmChangeCCParameter;
 
@@ -243,6 +290,15 @@ class MidiActionManager : public H2Core::Object<MidiActionManager>
 		 * @return true - if @a action was handled successfully.
 		 */
 		bool handleAction( const std::shared_ptr<Action> action );
+		/**
+		 * Executes @a action using @a nValue instead of the value
+		 * stored in it. This way the actions stored in the #MidiMap
+		 * can be handled directly for each incoming MIDI event without
+		 * copying them.
+		 *
+		 * @return true - if @a action was handled successfully.
+		 */
+		bool handleAction( const std::shared_ptr<Action> action, int nValue );
 		/**
 		 * If #__instance equals 0, a new MidiActionManager
 		 * singleton will be created and stored in it.
@@ -263,6 +319,11 @@ class MidiActionManager : public H2Core::Object<MidiActionManager>
 	 * \return -1 in case the @a couldn't be found.
 	 */
 	int getParameterNumber( const QString& sActionType ) const;
+	/**
+	 * \return Id used by Action::getTypeId() to dispatch
+	 *   @a sActionType or -1 in case it couldn't be found.
+	 */
+	static int getTypeId( const QString& sActionType );
 
 		MidiActionManager();
 		~MidiActionManager();
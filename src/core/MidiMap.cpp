@@ -23,6 +23,7 @@
 #include <core/MidiAction.h>
 #include "MidiMap.h"
 #include <map>
+#include <thread>
 #include <QMutexLocker>
 
 namespace H2Core {
@@ -42,7 +43,8 @@ namespace H2Core {
 * @author Sebastian Moors
 *
 */
-MidiMap::MidiMap()
+MidiMap::MidiMap() : m_pLookupTable( new LookupTable )
+				   , m_nLookupTableReaders( 0 )
 {
 	QMutexLocker mx(&__mutex);
 
@@ -55,6 +57,46 @@ MidiMap::MidiMap()
 MidiMap::~MidiMap()
 {
 	QMutexLocker mx(&__mutex);
+
+	delete m_pLookupTable.exchange( nullptr );
+}
+
+void MidiMap::compile()
+{
+	auto pTable = new LookupTable;
+
+	auto add = [&]( ActionList& actions, std::shared_ptr<Action> pAction,
+					const QString& sEvent ) {
+		if ( pAction == nullptr || pAction->isNull() ) {
+			return;
+		}
+		if ( ! actions.push_back( pAction ) ) {
+			WARNINGLOG( QString( "More than [%1] actions bound to %2. Action [%3] will not be triggered." )
+						.arg( nMaxActionsPerEvent ).arg( sEvent )
+						.arg( pAction->getType() ) );
+		}
+	};
+
+	for ( const auto& [nnPitch, ppAction] : m_noteActionMap ) {
+		add( pTable->noteActions[ nnPitch ], ppAction,
+			 QString( "NOTE event [%1]" ).arg( nnPitch ) );
+	}
+	for ( const auto& [nnParam, ppAction] : m_ccActionMap ) {
+		add( pTable->ccActions[ nnParam ], ppAction,
+			 QString( "CC event [%1]" ).arg( nnParam ) );
+	}
+	for ( const auto& ppAction : m_pcActionVector ) {
+		add( pTable->pcActions, ppAction, "PC event" );
+	}
+
+	auto pOldTable = m_pLookupTable.exchange( pTable );
+
+	// Readers only copy a single action list. Once all of them are
+	// done, the old table can not be accessed anymore.
+	while ( m_nLookupTableReaders.load() != 0 ) {
+		std::this_thread::yield();
+	}
+	delete pOldTable;
 }
 
 std::shared_ptr<MidiMap> MidiMap::loadFrom( const H2Core::XMLNode& node,
@@ -90,7 +132,7 @@ std::shared_ptr<MidiMap> MidiMap::loadFrom( const H2Core::XMLNode& node,
 
 			pMidiMap->registerNoteEvent(
 				eventNode.firstChildElement( "eventParameter").text().toInt(),
-				pAction );
+				pAction, false );
 		}
 		else if ( sNodeName == "ccEvent" ){
 			std::shared_ptr<Action> pAction = std::make_shared<Action>(
@@ -103,7 +145,7 @@ std::shared_ptr<MidiMap> MidiMap::loadFrom( const H2Core::XMLNode& node,
 				eventNode.firstChildElement( "parameter3" ).text() );
 			pMidiMap->registerCCEvent(
 				eventNode.firstChildElement( "eventParameter" ).text().toInt(),
-				pAction );
+				pAction, false );
 		}
 		else if ( sNodeName == "pcEvent" ){
 			std::shared_ptr<Action> pAction = std::make_shared<Action>(
@@ -114,7 +156,7 @@ std::shared_ptr<MidiMap> MidiMap::loadFrom( const H2Core::XMLNode& node,
 				eventNode.firstChildElement( "parameter2" ).text() );
 			pAction->setParameter3(
 				eventNode.firstChildElement( "parameter3" ).text() );
-			pMidiMap->registerPCEvent( pAction );
+			pMidiMap->registerPCEvent( pAction, false );
 		}
 		else {
 			WARNINGLOG( QString( "Unknown MIDI map node [%1]" )
@@ -124,6 +166,9 @@ std::shared_ptr<MidiMap> MidiMap::loadFrom( const H2Core::XMLNode& node,
 		eventNode = eventNode.nextSiblingElement( "midiEvent" );
 	}
 
+	// The lookup table is compiled only once for the whole map.
+	pMidiMap->updateLookupTable();
+
 	return pMidiMap;
 }
 
@@ -203,6 +248,8 @@ void MidiMap::reset()
 	m_pcActionVector.resize( 1 );
 	m_pcActionVector[ 0 ] = std::make_shared<Action>(
 		Action::getNullActionType() );
+
+	compile();
 }
 
 void MidiMap::registerMMCEvent( const QString& sEventString, std::shared_ptr<Action> pAction )
@@ -239,7 +286,8 @@ void MidiMap::registerMMCEvent( const QString& sEventString, std::shared_ptr<Act
 	m_mmcActionMap.insert( { sEventString, pAction } );
 }
 
-void MidiMap::registerNoteEvent( int nNote, std::shared_ptr<Action> pAction )
+void MidiMap::registerNoteEvent( int nNote, std::shared_ptr<Action> pAction,
+								 bool bUpdateLookupTable )
 {
 	QMutexLocker mx(&__mutex);
 
@@ -268,9 +316,13 @@ void MidiMap::registerNoteEvent( int nNote, std::shared_ptr<Action> pAction )
 	}
 
 	m_noteActionMap.insert( { nNote, pAction } );
+	if ( bUpdateLookupTable ) {
+		compile();
+	}
 }
 
-void MidiMap::registerCCEvent( int nParameter, std::shared_ptr<Action> pAction ){
+void MidiMap::registerCCEvent( int nParameter, std::shared_ptr<Action> pAction,
+								bool bUpdateLookupTable ){
 	QMutexLocker mx(&__mutex);
 
 	if ( pAction == nullptr || pAction->isNull() ) {
@@ -297,9 +349,13 @@ void MidiMap::registerCCEvent( int nParameter, std::shared_ptr<Action> pAction )
 	}
 
 	m_ccActionMap.insert( { nParameter, pAction } );
+	if ( bUpdateLookupTable ) {
+		compile();
+	}
 }
 
-void MidiMap::registerPCEvent( std::shared_ptr<Action> pAction ){
+void MidiMap::registerPCEvent( std::shared_ptr<Action> pAction,
+								bool bUpdateLookupTable ){
 	QMutexLocker mx(&__mutex);
 
 	if ( pAction == nullptr || pAction->isNull() ) {
@@ -319,48 +375,24 @@ void MidiMap::registerPCEvent( std::shared_ptr<Action> pAction ){
 	}
 
 	m_pcActionVector.push_back( pAction );
-}
-
-std::vector<std::shared_ptr<Action>> MidiMap::getMMCActions( const QString& sEventString )
-{
-	QMutexLocker mx(&__mutex);
-
-	std::vector<std::shared_ptr<Action>> actions;
-
-	auto range = m_mmcActionMap.equal_range( sEventString );
- 
-    for ( auto ii = range.first; ii != range.second; ++ii ) {
-		if ( ii->second != nullptr ) {
-			actions.push_back( ii->second );
-		}
+	if ( bUpdateLookupTable ) {
+		compile();
 	}
-
-	return actions;
 }
 
-std::vector<std::shared_ptr<Action>> MidiMap::getNoteActions( int nNote )
-{
+void MidiMap::updateLookupTable() {
 	QMutexLocker mx(&__mutex);
 
-	std::vector<std::shared_ptr<Action>> actions;
-
-	auto range = m_noteActionMap.equal_range( nNote );
- 
-    for ( auto ii = range.first; ii != range.second; ++ii ) {
-		if ( ii->second != nullptr ) {
-			actions.push_back( ii->second );
-		}
-	}
-
-	return actions;
+	compile();
 }
 
-std::vector<std::shared_ptr<Action>> MidiMap::getCCActions( int nParameter ) {
+std::vector<std::shared_ptr<Action>> MidiMap::getMMCActions( const QString& sEventString )
+{
 	QMutexLocker mx(&__mutex);
 
 	std::vector<std::shared_ptr<Action>> actions;
 
-	auto range = m_ccActionMap.equal_range( nParameter );
+	auto range = m_mmcActionMap.equal_range( sEventString );
  
     for ( auto ii = range.first; ii != range.second; ++ii ) {
 		if ( ii->second != nullptr ) {
@@ -22,6 +22,8 @@
 #ifndef MIDIMAP_H
 #define MIDIMAP_H
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <map>
@@ -42,6 +44,47 @@ class MidiMap : public H2Core::Object<MidiMap>
 {
 	H2_OBJECT(MidiMap)
 public:
+	/** Maximum number of actions which can be bound to a single MIDI
+	 * event and triggered by it during MIDI input handling. */
+	static constexpr int nMaxActionsPerEvent = 16;
+
+	/**
+	 * Fixed-size list of all actions bound to a single MIDI event.
+	 *
+	 * Copying it does not allocate memory and it can be iterated
+	 * like an ordinary container.
+	 */
+	class ActionList {
+	public:
+		ActionList() : m_nSize( 0 ) {}
+
+		/** @return `false` in case the list is already full. */
+		bool push_back( std::shared_ptr<Action> pAction ) {
+			if ( m_nSize >= nMaxActionsPerEvent ) {
+				return false;
+			}
+			m_actions[ m_nSize ] = pAction;
+			++m_nSize;
+			return true;
+		}
+		int size() const {
+			return m_nSize;
+		}
+		bool empty() const {
+			return m_nSize == 0;
+		}
+		const std::shared_ptr<Action>* begin() const {
+			return m_actions.data();
+		}
+		const std::shared_ptr<Action>* end() const {
+			return m_actions.data() + m_nSize;
+		}
+
+	private:
+		std::array<std::shared_ptr<Action>, nMaxActionsPerEvent> m_actions;
+		int m_nSize;
+	};
+
 	MidiMap();
 	~MidiMap();
 
@@ -53,25 +96,49 @@ public:
 
 	/** Sets up the relation between a mmc event and an action */
 	void registerMMCEvent( const QString&, std::shared_ptr<Action> );
-	/** Sets up the relation between a note event and an action */
-	void registerNoteEvent( int , std::shared_ptr<Action> );
-	/** Sets up the relation between a cc event and an action */
-	void registerCCEvent( int , std::shared_ptr<Action> );
-	/** Sets up the relation between a program change and an action */
-	void registerPCEvent( std::shared_ptr<Action> );
+	/** Sets up the relation between a note event and an action
+	 *
+	 * \param bUpdateLookupTable Whether the change should be
+	 *   published right away. When registering several events in a
+	 *   row, pass `false` and call updateLookupTable() once all of
+	 *   them are added. */
+	void registerNoteEvent( int , std::shared_ptr<Action>,
+							bool bUpdateLookupTable = true );
+	/** Sets up the relation between a cc event and an action
+	 *
+	 * \param bUpdateLookupTable See registerNoteEvent(). */
+	void registerCCEvent( int , std::shared_ptr<Action>,
+						  bool bUpdateLookupTable = true );
+	/** Sets up the relation between a program change and an action
+	 *
+	 * \param bUpdateLookupTable See registerNoteEvent(). */
+	void registerPCEvent( std::shared_ptr<Action>,
+						  bool bUpdateLookupTable = true );
+	/** Publishes all events registered since the last update to the
+	 * MIDI input handling. */
+	void updateLookupTable();
 
 	const std::multimap<QString, std::shared_ptr<Action>>& getMMCActionMap() const;
 	const std::multimap<int, std::shared_ptr<Action>>& getNoteActionMap() const;
 	const std::multimap<int, std::shared_ptr<Action>>& getCCActionMap() const;
+	/** All registered pc actions. Unlike getPCActions() this is not
+	 * limited to ActionList::nMaxActionsPerEvent entries.*/
+	const std::vector<std::shared_ptr<Action>>& getPCActionVector() const;
 	
 	/** Returns all MMC actions which are linked to the given event. */
 	std::vector<std::shared_ptr<Action>> getMMCActions( const QString& sEventString );
-	/** Returns all note actions which are linked to the given event. */
-	std::vector<std::shared_ptr<Action>> getNoteActions( int nNote );
-	/** Returns the cc action which was linked to the given event. */
-	std::vector<std::shared_ptr<Action>> getCCActions( int nParameter );
-	/** Returns the pc action which was linked to the given event. */
-	const std::vector<std::shared_ptr<Action>>& getPCActions() const;
+	/** Returns all note actions which are linked to the given event.
+	 *
+	 * Lock-free and does not allocate memory. */
+	ActionList getNoteActions( int nNote ) const;
+	/** Returns all cc actions which are linked to the given event.
+	 *
+	 * Lock-free and does not allocate memory. */
+	ActionList getCCActions( int nParameter ) const;
+	/** Returns all pc actions.
+	 *
+	 * Lock-free and does not allocate memory. */
+	ActionList getPCActions() const;
 		
 	std::vector<int> findCCValuesByActionParam1( const QString& sActionType,
 												 const QString& sParam1 );
@@ -94,12 +161,39 @@ public:
 	 * \return String presentation of current object.*/
 	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 private:
+	/**
+	 * Dense representation of #m_noteActionMap, #m_ccActionMap, and
+	 * #m_pcActionVector indexed by the MIDI event parameter.
+	 *
+	 * It is used by the MIDI input handling and never altered once
+	 * published. Instead, a new one is compiled after the map was
+	 * changed and swapped in.
+	 */
+	struct LookupTable {
+		std::array<ActionList, 128> noteActions;
+		std::array<ActionList, 128> ccActions;
+		ActionList pcActions;
+	};
+
+	/** Compiles a new #LookupTable from the multimaps, publishes it,
+	 * and deletes the previous one as soon as no reader accesses it
+	 * anymore.
+	 *
+	 * Must be called with #__mutex being locked. */
+	void compile();
+	/** Copies an action list out of the current #LookupTable. */
+	template <typename F>
+	ActionList lookup( F getList ) const;
 
 	std::multimap<int, std::shared_ptr<Action>> m_noteActionMap;
 	std::multimap<int, std::shared_ptr<Action>> m_ccActionMap;
 	std::multimap<QString, std::shared_ptr<Action>> m_mmcActionMap;
 	std::vector<std::shared_ptr<Action>> m_pcActionVector;
 
+	std::atomic<LookupTable*> m_pLookupTable;
+	/** Number of threads currently copying from #m_pLookupTable. */
+	mutable std::atomic<int> m_nLookupTableReaders;
+
 	QMutex __mutex;
 };
 
@@ -112,10 +206,36 @@ inline const std::multimap<int, std::shared_ptr<Action>>& MidiMap::getNoteAction
 inline const std::multimap<int, std::shared_ptr<Action>>& MidiMap::getCCActionMap() const {
 	return m_ccActionMap;
 }
-inline const std::vector<std::shared_ptr<Action>>& MidiMap::getPCActions() const {
+inline const std::vector<std::shared_ptr<Action>>& MidiMap::getPCActionVector() const {
 	return m_pcActionVector;
 }
 
+template <typename F>
+inline MidiMap::ActionList MidiMap::lookup( F getList ) const {
+	m_nLookupTableReaders.fetch_add( 1 );
+	const ActionList actions = getList( *m_pLookupTable.load() );
+	m_nLookupTableReaders.fetch_sub( 1 );
+	return actions;
+}
+inline MidiMap::ActionList MidiMap::getNoteActions( int nNote ) const {
+	if ( nNote < 0 || nNote > 127 ) {
+		return ActionList();
+	}
+	return lookup( [&]( const LookupTable& table ) {
+		return table.noteActions[ nNote ]; } );
+}
+inline MidiMap::ActionList MidiMap::getCCActions( int nParameter ) const {
+	if ( nParameter < 0 || nParameter > 127 ) {
+		return ActionList();
+	}
+	return lookup( [&]( const LookupTable& table ) {
+		return table.ccActions[ nParameter ]; } );
+}
+inline MidiMap::ActionList MidiMap::getPCActions() const {
+	return lookup( []( const LookupTable& table ) {
+		return table.pcActions; } );
+}
+
 };
 
 #endif
@@ -25,7 +25,9 @@
 #include "core/Preferences/Preferences.h"
 
 #include <pthread.h>
+#include <string_view>
 #include <unistd.h>
+#include <unordered_map>
 
 //currently H2CORE_HAVE_OSC means: liblo is present..
 #if defined(H2CORE_HAVE_OSC) || _DOXYGEN_
@@ -41,6 +43,7 @@
 #include "core/EventQueue.h"
 #include "core/Hydrogen.h"
 #include "core/AudioEngine/AudioEngine.h"
+#include "core/AudioEngine/Profiler.h"
 #include "core/Basics/Song.h"
 #include "core/MidiAction.h"
 #include "core/IO/MidiCommon.h"
@@ -156,6 +159,11 @@ int OscServer::incomingMessageLogging(const char *	path,
 									  lo_message	data,
 									  void *		user_data) {
 
+	if ( ! __logger->should_log( H2Core::Logger::Info ) ) {
+		// Do not assemble the summary of each message in vain.
+		return 1;
+	}
+
 	QString sSummary = QString( "Incoming OSC Message for path [%1]" ).arg( path );
 	for ( int ii = 0; ii < argc; ii++) {
 		QString formattedArgument = qPrettyPrint( (lo_type)types[ii], argv[ii] );
@@ -168,6 +176,86 @@ int OscServer::incomingMessageLogging(const char *	path,
 	return 1;
 }
 
+const OscServer::StripRoute* OscServer::findStripRoute( const char* sPath,
+														int* pStrip )
+{
+	// Built once. Keys refer to string literals.
+	static const std::unordered_map<std::string_view, StripRoute> routes = {
+		{ "STRIP_VOLUME_ABSOLUTE", { false, []( int nStrip, float fValue ) {
+			STRIP_VOLUME_ABSOLUTE_Handler( nStrip, fValue );
+		} } },
+		{ "STRIP_VOLUME_RELATIVE", { false, []( int nStrip, float fValue ) {
+			STRIP_VOLUME_RELATIVE_Handler( QString::number( nStrip ),
+										   QString::number( fValue, 'f', 0 ) );
+		} } },
+		{ "PAN_ABSOLUTE", { false, []( int nStrip, float fValue ) {
+			INFOLOG( QString( "processing message as changing pan of strip [%1] in absolute numbers" )
+					 .arg( nStrip ) );
+			H2Core::CoreActionController::setStripPan( nStrip, fValue, false );
+		} } },
+		{ "PAN_ABSOLUTE_SYM", { false, []( int nStrip, float fValue ) {
+			INFOLOG( QString( "processing message as changing pan of strip [%1] in symmetric, absolute numbers" )
+					 .arg( nStrip ) );
+			H2Core::CoreActionController::setStripPanSym( nStrip, fValue, false );
+		} } },
+		{ "PAN_RELATIVE", { false, []( int nStrip, float fValue ) {
+			INFOLOG( QString( "processing message as changing pan of strip [%1] in relative numbers" )
+					 .arg( nStrip ) );
+			std::shared_ptr<Action> pAction = std::make_shared<Action>("PAN_RELATIVE");
+			pAction->setParameter1( QString::number( nStrip ) );
+			pAction->setValue( QString::number( fValue, 'f', 0 ) );
+			MidiActionManager::get_instance()->handleAction( pAction );
+		} } },
+		{ "FILTER_CUTOFF_LEVEL_ABSOLUTE", { false, []( int nStrip, float fValue ) {
+			FILTER_CUTOFF_LEVEL_ABSOLUTE_Handler( QString::number( nStrip ),
+												  QString::number( fValue, 'f', 0 ) );
+		} } },
+		{ "STRIP_MUTE_TOGGLE", { true, []( int nStrip, float ) {
+			INFOLOG( QString( "processing message as toggling mute of strip [%1]" )
+					 .arg( nStrip ) );
+			H2Core::CoreActionController::toggleStripIsMuted( nStrip );
+		} } },
+		{ "STRIP_SOLO_TOGGLE", { true, []( int nStrip, float ) {
+			INFOLOG( QString( "processing message as toggling solo of strip [%1]" )
+					 .arg( nStrip ) );
+			H2Core::CoreActionController::toggleStripIsSoloed( nStrip );
+		} } }
+	};
+
+	constexpr std::string_view sPrefix( "/Hydrogen/" );
+	const std::string_view path( sPath );
+	if ( path.substr( 0, sPrefix.size() ) != sPrefix ) {
+		return nullptr;
+	}
+
+	const auto nSlash = path.find( '/', sPrefix.size() );
+	if ( nSlash == std::string_view::npos ) {
+		return nullptr;
+	}
+
+	const auto search =
+		routes.find( path.substr( sPrefix.size(), nSlash - sPrefix.size() ) );
+	if ( search == routes.end() ) {
+		return nullptr;
+	}
+
+	// The last segment is the one-based strip number.
+	const auto sNumber = path.substr( nSlash + 1 );
+	if ( sNumber.empty() || sNumber.size() > 6 ) {
+		return nullptr;
+	}
+	int nNumber = 0;
+	for ( const char cDigit : sNumber ) {
+		if ( cDigit < '0' || cDigit > '9' ) {
+			return nullptr;
+		}
+		nNumber = 10 * nNumber + ( cDigit - '0' );
+	}
+
+	*pStrip = nNumber - 1;
+	return &search->second;
+}
+
 int OscServer::generic_handler(const char *	path,
 							   const char *	types,
 							   lo_arg **	argv,
@@ -184,160 +272,21 @@ int OscServer::generic_handler(const char *	path,
 	}
 
 	bool bMessageProcessed = false;
-	
-	int nNumberOfStrips = pSong->getDrumkit()->getInstruments()->size();
-	
-	//First we're trying to map TouchOSC messages from multi-fader widgets
-	QString oscPath( path );
-	QRegExp rxStripVol( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/(\\d+)" );
-	int pos = rxStripVol.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if( argc == 1 ){
-			int nStrip = rxStripVol.cap(1).toInt() -1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				STRIP_VOLUME_ABSOLUTE_Handler( nStrip , argv[0]->f );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips  ) );
-			}
-		}
-	}
 
-	QRegExp rxStripVolRel( "/Hydrogen/STRIP_VOLUME_RELATIVE/(\\d+)" );
-	pos = rxStripVolRel.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if( argc == 1 ){
-			int nStrip = rxStripVolRel.cap(1).toInt() - 1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				STRIP_VOLUME_RELATIVE_Handler( QString::number( nStrip ),
-											   QString::number( argv[0]->f, 'f', 0 ) );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips ) );
-			}
-		}
-	}
-	
-	QRegExp rxStripPanAbs( "/Hydrogen/PAN_ABSOLUTE/(\\d+)" );
-	pos = rxStripPanAbs.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if( argc == 1 ){
-			int nStrip = rxStripPanAbs.cap(1).toInt() - 1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				INFOLOG( QString( "processing message as changing pan of strip [%1] in absolute numbers" )
-						 .arg( nStrip ) );
-				H2Core::CoreActionController::setStripPan(
-					nStrip, argv[0]->f, false );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips ) );
-			}
-		}
-	}
-
-	QRegExp rxStripPanAbsSym( "/Hydrogen/PAN_ABSOLUTE_SYM/(\\d+)" );
-	pos = rxStripPanAbsSym.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if( argc == 1 ){
-			int nStrip = rxStripPanAbsSym.cap(1).toInt() - 1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				INFOLOG( QString( "processing message as changing pan of strip [%1] in symmetric, absolute numbers" )
-						 .arg( nStrip ) );
-				H2Core::CoreActionController::setStripPanSym( nStrip, argv[0]->f, false );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips ) );
-			}
+	// Map TouchOSC messages from multi-fader widgets
+	int nStrip;
+	const auto pRoute = findStripRoute( path, &nStrip );
+	if ( pRoute != nullptr &&
+		 ( argc == 1 || ( argc == 0 && pRoute->bArgumentOptional ) ) ) {
+		const int nNumberOfStrips = pSong->getDrumkit()->getInstruments()->size();
+		if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
+			pRoute->handler( nStrip, argc > 0 ? argv[0]->f : 0 );
+			bMessageProcessed = true;
 		}
-	}
-	
-	QRegExp rxStripPanRel( "/Hydrogen/PAN_RELATIVE/(\\d+)" );
-	pos = rxStripPanRel.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if( argc == 1 ){
-			int nStrip = rxStripPanRel.cap(1).toInt() - 1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				INFOLOG( QString( "processing message as changing pan of strip [%1] in relative numbers" )
-						 .arg( nStrip ) );
-				std::shared_ptr<Action> pAction = std::make_shared<Action>("PAN_RELATIVE");
-				pAction->setParameter1( QString::number( nStrip ) );
-				pAction->setValue( QString::number( argv[0]->f, 'f', 0 ) );
-				MidiActionManager::get_instance()->handleAction( pAction );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips ) );
-			}
-		}
-	}
-
-	QRegExp rxStripFilterCutoffAbs( "/Hydrogen/FILTER_CUTOFF_LEVEL_ABSOLUTE/(\\d+)" );
-	pos = rxStripFilterCutoffAbs.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if( argc == 1 ){
-			int nStrip = rxStripFilterCutoffAbs.cap(1).toInt() - 1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				FILTER_CUTOFF_LEVEL_ABSOLUTE_Handler( QString::number( nStrip ),
-													  QString::number( argv[0]->f, 'f', 0 ) );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips ) );
-			}
-		}
-	}
-	
-	QRegExp rxStripMute( "/Hydrogen/STRIP_MUTE_TOGGLE/(\\d+)" );
-	pos = rxStripMute.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if( argc <= 1 ){
-			int nStrip = rxStripMute.cap(1).toInt() - 1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				INFOLOG( QString( "processing message as toggling mute of strip [%1]" )
-						 .arg( nStrip ) );
-				H2Core::CoreActionController::toggleStripIsMuted( nStrip );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips ) );
-			}
-		}
-	}
-	
-	QRegExp rxStripSolo( "/Hydrogen/STRIP_SOLO_TOGGLE/(\\d+)" );
-	pos = rxStripSolo.indexIn( oscPath );
-	if ( pos > -1 ) {
-		if ( argc <= 1 ) {
-			int nStrip = rxStripSolo.cap(1).toInt() - 1;
-			if ( nStrip > -1 && nStrip < nNumberOfStrips ) {
-				INFOLOG( QString( "processing message as toggling solo of strip [%1]" )
-						 .arg( nStrip ) );
-				H2Core::CoreActionController::toggleStripIsSoloed( nStrip );
-				bMessageProcessed = true;
-			}
-			else {
-				ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
-						  .arg( nStrip + 1 ).arg( 1 )
-						  .arg( nNumberOfStrips ) );
-			}
+		else {
+			ERRORLOG( QString( "Provided strip number [%1] out of bound [%2,%3]" )
+					  .arg( nStrip + 1 ).arg( 1 )
+					  .arg( nNumberOfStrips ) );
 		}
 	}
 
@@ -938,7 +887,7 @@ void OscServer::SONG_EDITOR_TOGGLE_GRID_CELL_Handler(lo_arg **argv, int argc) {
 void OscServer::LOAD_DRUMKIT_Handler(lo_arg **argv, int argc) {
 	INFOLOG( "processing message" );
 
-	H2Core::CoreActionController::setDrumkit(
+	H2Core::CoreActionController::switchDrumkit(
 		QString::fromUtf8( &argv[0]->s ) );
 }
 
@@ -1059,6 +1008,59 @@ void OscServer::PLAYLIST_REMOVE_SONG_Handler(lo_arg **argv, int argc) {
 	H2Core::CoreActionController::removeFromPlaylist( pEntry, nIndex );
 }
 
+void OscServer::PROFILER_QUERY_Handler(lo_arg **argv, int argc) {
+	INFOLOG( "processing message" );
+	auto pProfiler = H2Core::Hydrogen::get_instance()->getAudioEngine()->getProfiler();
+	auto pOscServer = OscServer::get_instance();
+
+	auto broadcastHistogram = [&]( const QString& sPath,
+								   const H2Core::ProfilerHistogram& histogram ) {
+		lo_message reply = lo_message_new();
+		lo_message_add_float( reply, static_cast<float>(histogram.getCount()) );
+		lo_message_add_float( reply, histogram.getLast() / 1000.0 );
+		lo_message_add_float( reply, histogram.getPercentile( 0.5 ) / 1000.0 );
+		lo_message_add_float( reply, histogram.getPercentile( 0.99 ) / 1000.0 );
+		lo_message_add_float( reply, histogram.getMax() / 1000.0 );
+
+		QByteArray ba = sPath.toLatin1();
+		pOscServer->broadcastMessage( ba.data(), reply );
+
+		lo_message_free( reply );
+	};
+
+	for ( int ii = 0; ii < static_cast<int>(H2Core::Profiler::Stage::Count); ++ii ) {
+		const auto stage = static_cast<H2Core::Profiler::Stage>(ii);
+		broadcastHistogram( QString( "/Hydrogen/PROFILER/%1" )
+							.arg( H2Core::Profiler::StageToQString( stage ) ),
+							pProfiler->getHistogram( stage ) );
+	}
+
+	for ( int ii = 0; ii < MAX_INSTRUMENTS; ++ii ) {
+		const auto pHistogram = pProfiler->getInstrumentHistogram( ii );
+		if ( pHistogram != nullptr ) {
+			broadcastHistogram( QString( "/Hydrogen/PROFILER/INSTRUMENT/%1" )
+								.arg( ii ), *pHistogram );
+		}
+	}
+}
+
+void OscServer::PROFILER_RESET_Handler(lo_arg **argv, int argc) {
+	INFOLOG( "processing message" );
+	H2Core::Hydrogen::get_instance()->getAudioEngine()->getProfiler()->reset();
+}
+
+void OscServer::PROFILER_VOICES_Handler(lo_arg **argv, int argc) {
+	INFOLOG( "processing message" );
+	H2Core::Hydrogen::get_instance()->getAudioEngine()->getProfiler()->
+		setVoiceProfiling( argv[0]->f != 0 );
+}
+
+void OscServer::PROFILER_DUMP_Handler(lo_arg **argv, int argc) {
+	INFOLOG( "processing message" );
+	H2Core::Hydrogen::get_instance()->getAudioEngine()->getProfiler()->
+		writeReport( QString::fromUtf8( &argv[0]->s ) );
+}
+
 // -------------------------------------------------------------------
 // Helper functions
 
@@ -1205,6 +1207,23 @@ void OscServer::handleAction( std::shared_ptr<Action> pAction )
 		
 		lo_message_free( reply );
 	}
+
+	// Progress of the PlaylistPreloader. A value of 1 indicates the
+	// song is ready and 0 that it was dropped.
+	if( pAction->getType() == "PLAYLIST_SONG_PRELOAD"){
+		bool ok;
+		float fValue = pAction->getValue().toFloat(&ok);
+
+		lo_message reply = lo_message_new();
+		lo_message_add_float( reply, fValue );
+
+		QByteArray ba = QString("/Hydrogen/PLAYLIST_SONG_PRELOAD/%1").arg(pAction->getParameter1()).toLatin1();
+		const char *c_str2 = ba.data();
+
+		broadcastMessage( c_str2, reply);
+		
+		lo_message_free( reply );
+	}
 }
 
 bool OscServer::init()
@@ -1382,6 +1401,19 @@ bool OscServer::init()
 	m_pServerThread->add_method("/Hydrogen/PLAYLIST_REMOVE_SONG", "f",
 								PLAYLIST_REMOVE_SONG_Handler);
 
+	m_pServerThread->add_method("/Hydrogen/PROFILER_QUERY", "",
+								PROFILER_QUERY_Handler);
+	m_pServerThread->add_method("/Hydrogen/PROFILER_QUERY", "f",
+								PROFILER_QUERY_Handler);
+	m_pServerThread->add_method("/Hydrogen/PROFILER_RESET", "",
+								PROFILER_RESET_Handler);
+	m_pServerThread->add_method("/Hydrogen/PROFILER_RESET", "f",
+								PROFILER_RESET_Handler);
+	m_pServerThread->add_method("/Hydrogen/PROFILER_VOICES", "f",
+								PROFILER_VOICES_Handler);
+	m_pServerThread->add_method("/Hydrogen/PROFILER_DUMP", "s",
+								PROFILER_DUMP_Handler);
+
 	m_pServerThread->add_method(nullptr, nullptr, generic_handler, nullptr);
 
 	m_bInitialized = true;
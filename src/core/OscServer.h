@@ -225,9 +225,11 @@ class OscServer : public H2Core::Object<OscServer>
 		 * - \e /Hydrogen/PAN_RELATIVE/[x]
 		 * - \e /Hydrogen/STRIP_MUTE_TOGGLE/[x]
 		 * - \e /Hydrogen/STRIP_SOLO_TOGGLE/[x]
+		 * - \e /Hydrogen/PLAYLIST_SONG_PRELOAD/[x]
 		 *
 		 * [x] The last part of the URI is determined by
-		 * Action::parameter1 and specifies an individual strip.
+		 * Action::parameter1 and specifies an individual strip (or the
+		 * number of the preloaded playlist song).
 		 *
 		 * Only called if H2Core::Preferences::m_bOscServerEnabled is
 		 * true.
@@ -781,7 +783,7 @@ class OscServer : public H2Core::Object<OscServer>
 		 */
 		static void SONG_EDITOR_TOGGLE_GRID_CELL_Handler(lo_arg **argv, int argc);
 		/**
-		 * Triggers CoreActionController::setDrumkit().
+		 * Triggers CoreActionController::switchDrumkit().
 		 *
 		 * The handler expects the user to provide the drumkit name. 
 		 * (row the pattern resides in within the SongEditor). The
@@ -843,6 +845,31 @@ class OscServer : public H2Core::Object<OscServer>
 		static void PLAYLIST_ADD_CURRENT_SONG_Handler(lo_arg **argv, int argc);
 		static void PLAYLIST_REMOVE_SONG_Handler(lo_arg **argv, int argc);
 
+		/**
+		 * Broadcasts the current state of the H2Core::Profiler.
+		 *
+		 * For each stage of the audio processing a message at
+		 * \e /Hydrogen/PROFILER/[STAGE] and, if voice profiling is
+		 * enabled, for each instrument played a message at
+		 * \e /Hydrogen/PROFILER/INSTRUMENT/[x] is sent. All of them
+		 * contain the number of recorded cycles followed by the last,
+		 * median (p50), 99th percentile (p99), and maximum duration in
+		 * microseconds.
+		 */
+		static void PROFILER_QUERY_Handler(lo_arg **argv, int argc);
+		/** Discards all values recorded by the H2Core::Profiler.*/
+		static void PROFILER_RESET_Handler(lo_arg **argv, int argc);
+		/**
+		 * Enables (1) or disables (0) the profiling of individual
+		 * voices and instruments within the H2Core::Sampler.
+		 */
+		static void PROFILER_VOICES_Handler(lo_arg **argv, int argc);
+		/**
+		 * Writes a summary of the H2Core::Profiler to the absolute
+		 * path provided as argument.
+		 */
+		static void PROFILER_DUMP_Handler(lo_arg **argv, int argc);
+
 		/** 
 		 * Catches any incoming messages and display them. 
 		 *
@@ -878,6 +905,25 @@ class OscServer : public H2Core::Object<OscServer>
 
 	private:
 		OscServer();
+
+		/** Message addressing a particular strip, like
+		 * \e /Hydrogen/STRIP_VOLUME_ABSOLUTE/[x]. */
+		struct StripRoute {
+			/** Whether the message is accepted without argument
+			 * too. */
+			bool bArgumentOptional;
+			/** @a nStrip is zero-based. */
+			void (*handler)( int nStrip, float fValue );
+		};
+		/** Looks up the route of @a sPath in a table compiled on first
+		 * use and parses the strip number contained in it. Neither a
+		 * QString nor a regular expression is created per message.
+		 *
+		 * \param sPath OSC path of the incoming message.
+		 * \param pStrip Set to the zero-based strip number.
+		 *
+		 * \return nullptr in case @a sPath is not a strip route. */
+		static const StripRoute* findStripRoute( const char* sPath, int* pStrip );
 		
 		/** Helper function which sends a message with msgText to all 
 		 * connected clients. **/
@@ -109,6 +109,11 @@ Preferences::Preferences()
 	, m_nMaxNotes( 256 )
 	, m_nBufferSize( 1024 )
 	, m_nSampleRate( 44100 )
+	, m_nRealtimePriority( 50 )
+	, m_nRealtimeCpu( -1 )
+	, m_bRealtimeLockMemory( false )
+	, m_bLockSampleMemory( false )
+	, m_nSampleMemoryLockLimit( 1024 )
 	, m_sOSSDevice( "/dev/dsp" )
 	, m_sMidiPortName(  Preferences::getNullMidiPort() )
 	, m_sMidiOutputPortName(  Preferences::getNullMidiPort() )
@@ -121,6 +126,7 @@ Preferences::Preferences()
 	, m_bOscFeedbackEnabled( true )
 	, m_nOscTemporaryPort( -1 )
 	, m_nOscServerPort( 9000 )
+	, m_nAlsaPeriods( 2 )
 	, m_sPortAudioDevice( "" )
 	, m_sPortAudioHostAPI( "" )
 	, m_nLatencyTarget( 0 )
@@ -137,6 +143,8 @@ Preferences::Preferences()
 	, m_sDefaultEditor( "" )
 	, m_sPreferredLanguage( "" )
 	, m_bUseRelativeFilenamesForPlaylists( false )
+	, m_nPlaylistPreloadSongs( 1 )
+	, m_nPlaylistPreloadMemory( 1024 )
 	, m_bShowDevelWarning( false )
 	, m_bShowNoteOverwriteWarning( true )
 	, m_sLastSongFilename( "" )
@@ -289,6 +297,11 @@ Preferences::Preferences( std::shared_ptr<Preferences> pOther )
 	, m_nMaxNotes( pOther->m_nMaxNotes )
 	, m_nBufferSize( pOther->m_nBufferSize )
 	, m_nSampleRate( pOther->m_nSampleRate )
+	, m_nRealtimePriority( pOther->m_nRealtimePriority )
+	, m_nRealtimeCpu( pOther->m_nRealtimeCpu )
+	, m_bRealtimeLockMemory( pOther->m_bRealtimeLockMemory )
+	, m_bLockSampleMemory( pOther->m_bLockSampleMemory )
+	, m_nSampleMemoryLockLimit( pOther->m_nSampleMemoryLockLimit )
 	, m_sOSSDevice( pOther->m_sOSSDevice )
 	, m_sMidiDriver( pOther->m_sMidiDriver )
 	, m_sMidiPortName( pOther->m_sMidiPortName )
@@ -303,6 +316,7 @@ Preferences::Preferences( std::shared_ptr<Preferences> pOther )
 	, m_nOscTemporaryPort( pOther->m_nOscTemporaryPort )
 	, m_nOscServerPort( pOther->m_nOscServerPort )
 	, m_sAlsaAudioDevice( pOther->m_sAlsaAudioDevice )
+	, m_nAlsaPeriods( pOther->m_nAlsaPeriods )
 	, m_sPortAudioDevice( pOther->m_sPortAudioDevice )
 	, m_sPortAudioHostAPI( pOther->m_sPortAudioHostAPI )
 	, m_nLatencyTarget( pOther->m_nLatencyTarget )
@@ -320,6 +334,8 @@ Preferences::Preferences( std::shared_ptr<Preferences> pOther )
 	, m_sDefaultEditor( pOther->m_sDefaultEditor )
 	, m_sPreferredLanguage( pOther->m_sPreferredLanguage )
 	, m_bUseRelativeFilenamesForPlaylists( pOther->m_bUseRelativeFilenamesForPlaylists )
+	, m_nPlaylistPreloadSongs( pOther->m_nPlaylistPreloadSongs )
+	, m_nPlaylistPreloadMemory( pOther->m_nPlaylistPreloadMemory )
 	, m_bShowDevelWarning( pOther->m_bShowDevelWarning )
 	, m_bShowNoteOverwriteWarning( pOther->m_bShowNoteOverwriteWarning )
 	, m_sLastSongFilename( pOther->m_sLastSongFilename )
@@ -471,6 +487,12 @@ std::shared_ptr<Preferences> Preferences::load( const QString& sPath, const bool
 	pPref->m_bUseRelativeFilenamesForPlaylists = rootNode.read_bool(
 		"useRelativeFilenamesForPlaylists",
 		pPref->m_bUseRelativeFilenamesForPlaylists, false, false, bSilent );
+	pPref->m_nPlaylistPreloadSongs = std::max( rootNode.read_int(
+		"playlistPreloadSongs", pPref->m_nPlaylistPreloadSongs,
+		true, false, bSilent ), 0 );
+	pPref->m_nPlaylistPreloadMemory = std::max( rootNode.read_int(
+		"playlistPreloadMemory", pPref->m_nPlaylistPreloadMemory,
+		true, false, bSilent ), 0 );
 	pPref->m_bHideKeyboardCursor = rootNode.read_bool(
 		"hideKeyboardCursorWhenUnused",
 		pPref->m_bHideKeyboardCursor, false, false, bSilent );
@@ -584,6 +606,20 @@ std::shared_ptr<Preferences> Preferences::load( const QString& sPath, const bool
 			"buffer_size", pPref->m_nBufferSize, false, false, bSilent );
 		pPref->m_nSampleRate = audioEngineNode.read_int(
 			"samplerate", pPref->m_nSampleRate, false, false, bSilent );
+		pPref->m_nRealtimePriority = std::clamp( audioEngineNode.read_int(
+			"realtime_priority", pPref->m_nRealtimePriority, true, false,
+			bSilent ), 0, 99 );
+		pPref->m_nRealtimeCpu = std::max( audioEngineNode.read_int(
+			"realtime_cpu", pPref->m_nRealtimeCpu, true, false, bSilent ), -1 );
+		pPref->m_bRealtimeLockMemory = audioEngineNode.read_bool(
+			"realtime_lock_memory", pPref->m_bRealtimeLockMemory, true, false,
+			bSilent );
+		pPref->m_bLockSampleMemory = audioEngineNode.read_bool(
+			"lock_sample_memory", pPref->m_bLockSampleMemory, true, false,
+			bSilent );
+		pPref->m_nSampleMemoryLockLimit = std::max( audioEngineNode.read_int(
+			"sample_memory_lock_limit", pPref->m_nSampleMemoryLockLimit, true,
+			false, bSilent ), 0 );
 
 		//// OSS DRIVER ////
 		const XMLNode ossDriverNode =
@@ -691,6 +727,9 @@ std::shared_ptr<Preferences> Preferences::load( const QString& sPath, const bool
 			pPref->m_sAlsaAudioDevice = alsaAudioDriverNode.read_string(
 				"alsa_audio_device",
 				pPref->m_sAlsaAudioDevice, false, false, bSilent );
+			pPref->m_nAlsaPeriods = std::clamp( alsaAudioDriverNode.read_int(
+				"alsa_periods", pPref->m_nAlsaPeriods, true, false, bSilent ),
+												2, 16 );
 		} else {
 			WARNINGLOG( "<alsa_audio_driver> node not found" );
 		}
@@ -1087,6 +1126,8 @@ bool Preferences::saveTo( const QString& sPath, const bool bSilent ) const {
 	rootNode.write_bool( "useTheRubberbandBpmChangeEvent", m_bUseTheRubberbandBpmChangeEvent );
 
 	rootNode.write_bool( "useRelativeFilenamesForPlaylists", m_bUseRelativeFilenamesForPlaylists );
+	rootNode.write_int( "playlistPreloadSongs", m_nPlaylistPreloadSongs );
+	rootNode.write_int( "playlistPreloadMemory", m_nPlaylistPreloadMemory );
 	rootNode.write_bool( "hideKeyboardCursorWhenUnused", m_bHideKeyboardCursor );
 	
 	// instrument input mode
@@ -1156,6 +1197,11 @@ bool Preferences::saveTo( const QString& sPath, const bool bSilent ) const {
 		audioEngineNode.write_int( "maxNotes", m_nMaxNotes );
 		audioEngineNode.write_int( "buffer_size", m_nBufferSize );
 		audioEngineNode.write_int( "samplerate", m_nSampleRate );
+		audioEngineNode.write_int( "realtime_priority", m_nRealtimePriority );
+		audioEngineNode.write_int( "realtime_cpu", m_nRealtimeCpu );
+		audioEngineNode.write_bool( "realtime_lock_memory", m_bRealtimeLockMemory );
+		audioEngineNode.write_bool( "lock_sample_memory", m_bLockSampleMemory );
+		audioEngineNode.write_int( "sample_memory_lock_limit", m_nSampleMemoryLockLimit );
 
 		//// OSS DRIVER ////
 		XMLNode ossDriverNode = audioEngineNode.createNode( "oss_driver" );
@@ -1223,6 +1269,7 @@ bool Preferences::saveTo( const QString& sPath, const bool bSilent ) const {
 		XMLNode alsaAudioDriverNode = audioEngineNode.createNode( "alsa_audio_driver" );
 		{
 			alsaAudioDriverNode.write_string( "alsa_audio_device", m_sAlsaAudioDevice );
+			alsaAudioDriverNode.write_int( "alsa_periods", m_nAlsaPeriods );
 		}
 
 		/// MIDI DRIVER ///
@@ -1691,6 +1738,16 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( s ).arg( m_nBufferSize ) )
 			.append( QString( "%1%2m_nSampleRate: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_nSampleRate ) )
+			.append( QString( "%1%2m_nRealtimePriority: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nRealtimePriority ) )
+			.append( QString( "%1%2m_nRealtimeCpu: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nRealtimeCpu ) )
+			.append( QString( "%1%2m_bRealtimeLockMemory: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_bRealtimeLockMemory ) )
+			.append( QString( "%1%2m_bLockSampleMemory: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_bLockSampleMemory ) )
+			.append( QString( "%1%2m_nSampleMemoryLockLimit: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nSampleMemoryLockLimit ) )
 			.append( QString( "%1%2m_sOSSDevice: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_sOSSDevice ) )
 			.append( QString( "%1%2m_sMidiDriver: %3\n" ).arg( sPrefix )
@@ -1719,6 +1776,8 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( s ).arg( m_nOscServerPort ) )
 			.append( QString( "%1%2m_sAlsaAudioDevice: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_sAlsaAudioDevice ) )
+			.append( QString( "%1%2m_nAlsaPeriods: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nAlsaPeriods ) )
 			.append( QString( "%1%2m_sPortAudioDevice: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_sPortAudioDevice ) )
 			.append( QString( "%1%2m_sPortAudioHostAPI: %3\n" ).arg( sPrefix )
@@ -1753,6 +1812,10 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( s ).arg( m_sPreferredLanguage ) )
 			.append( QString( "%1%2m_bUseRelativeFilenamesForPlaylists: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_bUseRelativeFilenamesForPlaylists ) )
+			.append( QString( "%1%2m_nPlaylistPreloadSongs: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nPlaylistPreloadSongs ) )
+			.append( QString( "%1%2m_nPlaylistPreloadMemory: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nPlaylistPreloadMemory ) )
 			.append( QString( "%1%2m_bShowDevelWarning: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_bShowDevelWarning ) )
 			.append( QString( "%1%2m_bShowNoteOverwriteWarning: %3\n" ).arg( sPrefix )
@@ -1939,6 +2002,16 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_nBufferSize ) )
 			.append( QString( ", m_nSampleRate: %1" )
 					 .arg( m_nSampleRate ) )
+			.append( QString( ", m_nRealtimePriority: %1" )
+					 .arg( m_nRealtimePriority ) )
+			.append( QString( ", m_nRealtimeCpu: %1" )
+					 .arg( m_nRealtimeCpu ) )
+			.append( QString( ", m_bRealtimeLockMemory: %1" )
+					 .arg( m_bRealtimeLockMemory ) )
+			.append( QString( ", m_bLockSampleMemory: %1" )
+					 .arg( m_bLockSampleMemory ) )
+			.append( QString( ", m_nSampleMemoryLockLimit: %1" )
+					 .arg( m_nSampleMemoryLockLimit ) )
 			.append( QString( ", m_sOSSDevice: %1" )
 					 .arg( m_sOSSDevice ) )
 			.append( QString( ", m_sMidiDriver: %1" )
@@ -1967,6 +2040,8 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_nOscServerPort ) )
 			.append( QString( ", m_sAlsaAudioDevice: %1" )
 					 .arg( m_sAlsaAudioDevice ) )
+			.append( QString( ", m_nAlsaPeriods: %1" )
+					 .arg( m_nAlsaPeriods ) )
 			.append( QString( ", m_sPortAudioDevice: %1" )
 					 .arg( m_sPortAudioDevice ) )
 			.append( QString( ", m_sPortAudioHostAPI: %1" )
@@ -2001,6 +2076,10 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_sPreferredLanguage ) )
 			.append( QString( ", m_bUseRelativeFilenamesForPlaylists: %1" )
 					 .arg( m_bUseRelativeFilenamesForPlaylists ) )
+			.append( QString( ", m_nPlaylistPreloadSongs: %1" )
+					 .arg( m_nPlaylistPreloadSongs ) )
+			.append( QString( ", m_nPlaylistPreloadMemory: %1" )
+					 .arg( m_nPlaylistPreloadMemory ) )
 			.append( QString( ", m_bShowDevelWarning: %1" )
 					 .arg( m_bShowDevelWarning ) )
 			.append( QString( ", m_bShowNoteOverwriteWarning: %1" )
@@ -276,6 +276,26 @@ public:
 	 * rate of the freshly opened JACK client.
 	 */
 	unsigned			m_nSampleRate;
+	/** SCHED_FIFO priority requested for the audio thread of all
+	 * drivers but JACK. 0 disables realtime scheduling.
+	 *
+	 * \see RealtimeThread */
+	int					m_nRealtimePriority;
+	/** CPU the audio thread of all drivers but JACK is pinned
+	 * to. -1 disables pinning. */
+	int					m_nRealtimeCpu;
+	/** Whether the memory of the process is locked using mlockall()
+	 * before an audio thread of a driver other than JACK is
+	 * started. Off by default as the whole process - including the
+	 * GUI - would be pinned in RAM. */
+	bool				m_bRealtimeLockMemory;
+	/** Whether sample data is allocated in pre-faulted and locked
+	 * arenas.
+	 *
+	 * \see SampleMemory */
+	bool				m_bLockSampleMemory;
+	/** Maximum amount of sample memory locked in MiB. */
+	int					m_nSampleMemoryLockLimit;
 
 	//	OSS driver properties ___
 	QString				m_sOSSDevice;		///< Device used for output
@@ -350,6 +370,9 @@ public:
 
 	//	alsa audio driver properties ___
 	QString				m_sAlsaAudioDevice;
+	/** Number of periods the buffer of the ALSA device is split
+	 * into. The period size itself is set by #m_nBufferSize. */
+	int					m_nAlsaPeriods;
 
 	// PortAudio properties
 	QString				m_sPortAudioDevice;
@@ -414,6 +437,10 @@ public:
 
 	bool			isPlaylistUsingRelativeFilenames() const;
 	void			setUseRelativeFilenamesForPlaylists( bool value );
+	int				getPlaylistPreloadSongs() const;
+	void			setPlaylistPreloadSongs( int nSongs );
+	int				getPlaylistPreloadMemory() const;
+	void			setPlaylistPreloadMemory( int nMiB );
 
 	bool			getShowDevelWarning() const;
 	void			setShowDevelWarning( bool value );
@@ -627,6 +654,12 @@ private:
 	QString				m_sPreferredLanguage;
 
 	bool				m_bUseRelativeFilenamesForPlaylists;
+	/** Number of songs following the active one in the playlist which
+	 * are loaded in the background. 0 disables preloading. */
+	int					m_nPlaylistPreloadSongs;
+	/** Memory in MiB the samples of all preloaded playlist songs are
+	 * allowed to occupy. */
+	int					m_nPlaylistPreloadMemory;
 	
 	///< Show development version warning?
 	bool				m_bShowDevelWarning;
@@ -949,6 +982,22 @@ inline bool Preferences::isPlaylistUsingRelativeFilenames() const {
 	return m_bUseRelativeFilenamesForPlaylists;
 }
 
+inline int Preferences::getPlaylistPreloadSongs() const {
+	return m_nPlaylistPreloadSongs;
+}
+
+inline void Preferences::setPlaylistPreloadSongs( int nSongs ) {
+	m_nPlaylistPreloadSongs = nSongs;
+}
+
+inline int Preferences::getPlaylistPreloadMemory() const {
+	return m_nPlaylistPreloadMemory;
+}
+
+inline void Preferences::setPlaylistPreloadMemory( int nMiB ) {
+	m_nPlaylistPreloadMemory = nMiB;
+}
+
 inline void Preferences::setLastSongFilename( const QString& filename ) {
 	m_sLastSongFilename = filename;
 }
@@ -29,6 +29,9 @@
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/AutomationPath.h>
+#include <core/Helpers/Random.h>
+
+#include <algorithm>
 
 #include <QFile>
 #include <QTextCodec>
@@ -97,39 +100,34 @@ SMFTrack::~SMFTrack()
 
 QByteArray SMFTrack::getBuffer() const
 {
-	QByteArray trackData;
-
-	for ( unsigned i = 0; i < m_eventList.size(); i++ ) {
-		SMFEvent *pEv = m_eventList[ i ];
-		auto buf = pEv->getBuffer();
-
-		for ( unsigned j = 0; j < buf.size(); j++ ) {
-			trackData.push_back( buf[ j ] );
-		}
-	}
-
-
 	SMFBuffer buf;
+	// Note events take up at most 7 bytes (4 bytes delta time and 3
+	// bytes payload).
+	buf.reserve( 12 + 64 * m_eventList.size() + 7 * m_noteEvents.size() );
 
 	buf.writeDWord( 1297379947 );		// MTrk
-	buf.writeDWord( trackData.size() + 4 );	// Track length
-
-	auto trackBuf = buf.getBuffer();
+	buf.writeDWord( 0 );				// Track length (filled in below)
 
-	for ( unsigned i = 0; i < trackData.size(); i++ ) {
-		trackBuf.push_back( trackData[i] );
+	for ( const auto& pEvent : m_eventList ) {
+		buf.m_buffer.append( pEvent->getBuffer() );
 	}
 
+	for ( const auto& event : m_noteEvents ) {
+		buf.writeVarLen( event.nDeltaTime );
+		buf.writeByte( event.nType + event.nChannel );
+		buf.writeByte( event.nPitch );
+		buf.writeByte( event.nVelocity );
+	}
 
 	//  track end
-	trackBuf.push_back( static_cast<char>(0x00) );		// delta
-	trackBuf.push_back( static_cast<char>(0xFF) );
-	trackBuf.push_back( static_cast<char>(0x2F) );
-	trackBuf.push_back( static_cast<char>(0x00) );
-
+	buf.writeByte( 0x00 );		// delta
+	buf.writeByte( 0xFF );
+	buf.writeByte( 0x2F );
+	buf.writeByte( 0x00 );
 
+	buf.writeDWordAt( 4, buf.m_buffer.size() - 8 );
 
-	return trackBuf;
+	return buf.m_buffer;
 }
 
 QString SMFTrack::toQString() const {
@@ -141,6 +139,15 @@ void SMFTrack::addEvent( SMFEvent *pEvent )
 	m_eventList.push_back( pEvent );
 }
 
+void SMFTrack::addNoteEvents( std::vector<SMFNoteEvent>&& events )
+{
+	if ( m_noteEvents.empty() ) {
+		m_noteEvents = std::move( events );
+	} else {
+		m_noteEvents.insert( m_noteEvents.end(), events.begin(), events.end() );
+	}
+}
+
 
 
 // ::::::::::::::::::::::
@@ -193,6 +200,23 @@ QString SMF::toQString() const {
 	return QString( getBuffer().toHex( ' ' ) );
 }
 
+bool SMF::writeTo( QIODevice* pDevice ) const
+{
+	const auto header = m_pHeader->getBuffer();
+	if ( pDevice->write( header ) != header.size() ) {
+		return false;
+	}
+
+	for ( const auto& pTrack : m_trackList ) {
+		const auto track = pTrack->getBuffer();
+		if ( pDevice->write( track ) != track.size() ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 
 
 // :::::::::::::::::::...
@@ -234,7 +258,6 @@ void SMFWriter::save( const QString& sFilename, std::shared_ptr<Song> pSong )
 	// here writers must prepare to receive pattern events
 	prepareEvents( pSong, pSmf );
 
-	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
 	// ogni pattern sara' una diversa traccia
 	int nTick = 1;
 	for ( unsigned nPatternList = 0 ;
@@ -255,56 +278,55 @@ void SMFWriter::save( const QString& sFilename, std::shared_ptr<Song> pSong )
 				nMaxPatternLength = pPattern->get_length();
 			}
 
-			for ( unsigned nNote = 0; nNote < pPattern->get_length(); nNote++ ) {
-				const Pattern::notes_t* notes = pPattern->get_notes();
-				FOREACH_NOTE_CST_IT_BOUND_LENGTH(notes,it,nNote,pPattern) {
-					Note *pNote = it->second;
-					if ( pNote != nullptr &&
-						 pNote->get_instrument() != nullptr ) {
-						float rnd = (float)rand()/(float)RAND_MAX;
-						if ( pNote->get_probability() < rnd ) {
-							continue;
-						}
-
-						float fPos = nPatternList + (float)nNote/(float)nMaxPatternLength;
-						float fVelocityAdjustment =  pAutomationPath->get_value(fPos);
-						int nVelocity =
-							(int)( 127.0 * pNote->get_velocity() * fVelocityAdjustment );
-
-						auto pInstr = pNote->get_instrument();
-						int nPitch = pNote->get_midi_key();
-						
-						int nChannel =  pInstr->get_midi_out_channel();
-						if ( nChannel == -1 ) {
-							nChannel = DRUM_CHANNEL;
-						}
-						
-						int nLength = pNote->get_length();
-						if ( nLength == -1 ) {
-							nLength = NOTE_LENGTH;
-						}
-						
-						// get events for specific instrument
-						EventList* eventList = getEvents(pSong, pInstr);
-						eventList->push_back(
-							new SMFNoteOnEvent(
-								nStartTicks + nNote,
-								nChannel,
-								nPitch,
-								nVelocity
-								)
-							);
-							
-						eventList->push_back(
-							new SMFNoteOffEvent(
-								nStartTicks + nNote + nLength,
-								nChannel,
-								nPitch,
-								nVelocity
-								)
-							);
-					}
+			// Notes are already sorted by their position.
+			for ( const auto& [ nNote, pNote ] : *pPattern->get_notes() ) {
+				if ( nNote >= pPattern->get_length() ) {
+					break;
 				}
+				if ( nNote < 0 || pNote == nullptr ||
+					 pNote->get_instrument() == nullptr ) {
+					continue;
+				}
+				if ( pNote->get_probability() < Random::getUniform() ) {
+					continue;
+				}
+
+				float fPos = nPatternList + (float)nNote/(float)nMaxPatternLength;
+				float fVelocityAdjustment =  pAutomationPath->get_value(fPos);
+				int nVelocity =
+					(int)( 127.0 * pNote->get_velocity() * fVelocityAdjustment );
+
+				auto pInstr = pNote->get_instrument();
+				int nPitch = pNote->get_midi_key();
+
+				int nChannel =  pInstr->get_midi_out_channel();
+				if ( nChannel == -1 ) {
+					nChannel = DRUM_CHANNEL;
+				}
+				if ( nChannel >= 16 ) {
+					ERRORLOG( QString( "nChannel >= 16! nChannel=%1" ).arg( nChannel ) );
+				}
+
+				int nLength = pNote->get_length();
+				if ( nLength == -1 ) {
+					nLength = NOTE_LENGTH;
+				}
+
+				// get events for specific instrument
+				EventList* pEventList = getEvents( pSong, pInstr );
+				if ( pEventList == nullptr ) {
+					continue;
+				}
+				pEventList->push_back( {
+						static_cast<int>(nStartTicks + nNote), 0, NOTE_ON,
+						static_cast<uint8_t>(nChannel),
+						static_cast<uint8_t>(nPitch),
+						static_cast<uint8_t>(nVelocity) } );
+				pEventList->push_back( {
+						static_cast<int>(nStartTicks + nNote + nLength), 0, NOTE_OFF,
+						static_cast<uint8_t>(nChannel),
+						static_cast<uint8_t>(nPitch),
+						static_cast<uint8_t>(nVelocity) } );
 			}
 		}
 		nTick += nMaxPatternLength;
@@ -320,19 +342,19 @@ void SMFWriter::save( const QString& sFilename, std::shared_ptr<Song> pSong )
 
 void SMFWriter::sortEvents( EventList *pEvents )
 {
-	// awful bubble sort..
-	for ( unsigned i = 0; i < pEvents->size(); i++ ) {
-		for ( std::vector<SMFEvent*>::iterator it = pEvents->begin() ;
-			  it != ( pEvents->end() - 1 ) ;
-			  it++ ) {
-			SMFEvent *pEvent = *it;
-			SMFEvent *pNextEvent = *( it + 1 );
-			if ( pNextEvent->m_nTicks < pEvent->m_nTicks ) {
-				// swap
-				*it = pNextEvent;
-				*( it +1 ) = pEvent;
-			}
-		}
+	std::stable_sort( pEvents->begin(), pEvents->end(),
+					  []( const SMFNoteEvent& a, const SMFNoteEvent& b ) {
+						  return a.nTicks < b.nTicks;
+					  });
+}
+
+
+void SMFWriter::computeDeltaTimes( EventList *pEvents )
+{
+	int nLastTick = 1;
+	for ( auto& event : *pEvents ) {
+		event.nDeltaTime = ( event.nTicks - nLastTick ) * 4;
+		nLastTick = event.nTicks;
 	}
 }
 
@@ -347,9 +369,10 @@ void SMFWriter::saveSMF( const QString& sFilename, SMF*  pSmf )
 		return;
 	}
 
-	QDataStream stream( &file );
-	const auto buffer = pSmf->getBuffer();
-	stream.writeRawData( buffer.constData(), buffer.size() );
+	if ( ! pSmf->writeTo( &file ) ) {
+		ERRORLOG( QString( "Unable to write MIDI file [%1]: %2" )
+				  .arg( sFilename ).arg( file.errorString() ) );
+	}
 
 	file.close();
 }
@@ -415,20 +438,11 @@ void SMF1WriterSingle::prepareEvents( std::shared_ptr<Song> pSong, SMF* pSmf )
 void SMF1WriterSingle::packEvents( std::shared_ptr<Song> pSong, SMF* pSmf )
 {
 	sortEvents( &m_eventList );
+	computeDeltaTimes( &m_eventList );
 
 	SMFTrack *pTrack1 = new SMFTrack();
 	pSmf->addTrack( pTrack1 );
-
-	unsigned nLastTick = 1;
-	for( auto& pEvent : m_eventList ) {
-		pEvent->m_nDeltaTime = ( pEvent->m_nTicks - nLastTick ) * 4;
-		nLastTick = pEvent->m_nTicks;
-
-		// infoLog( " pos: " + toString( (*it)->m_nTicks ) + ", delta: "
-		//          + toString( (*it)->m_nDeltaTime ) );
-
-		pTrack1->addEvent( pEvent );
-	}
+	pTrack1->addNoteEvents( std::move( m_eventList ) );
 
 	m_eventList.clear();
 }
@@ -453,18 +467,23 @@ void SMF1WriterMulti::prepareEvents( std::shared_ptr<Song> pSong, SMF* pSmf )
 {
 	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
 	m_eventLists.clear();
+	m_eventLists.resize( pInstrumentList->size() );
+	m_instrumentIndices.clear();
 	for( unsigned nInstr=0; nInstr <  pInstrumentList->size(); nInstr++ ){
-		m_eventLists.push_back( new EventList() );
+		m_instrumentIndices[ pInstrumentList->get( nInstr ).get() ] = nInstr;
 	}
 }
 
 
 EventList* SMF1WriterMulti::getEvents( std::shared_ptr<Song> pSong,  std::shared_ptr<Instrument> pInstr )
 {
-	int nInstr = pSong->getDrumkit()->getInstruments()->index(pInstr);
-	EventList* pEventList = m_eventLists.at( nInstr );
-	
-	return pEventList;
+	const auto it = m_instrumentIndices.find( pInstr.get() );
+	if ( it == m_instrumentIndices.end() ) {
+		WARNINGLOG( QString( "Instrument [%1] is not part of the drumkit. Its notes are skipped." )
+					.arg( pInstr != nullptr ? pInstr->get_name() : "nullptr" ) );
+		return nullptr;
+	}
+	return &m_eventLists.at( it->second );
 }
 
 
@@ -472,32 +491,21 @@ void SMF1WriterMulti::packEvents( std::shared_ptr<Song> pSong, SMF* pSmf )
 {
 	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
 	for ( unsigned nTrack = 0; nTrack < m_eventLists.size(); nTrack++ ) {
-		EventList* pEventList = m_eventLists.at( nTrack );
+		EventList* pEventList = &m_eventLists.at( nTrack );
 		auto instrument =  pInstrumentList->get( nTrack );
 
 		sortEvents( pEventList );
+		computeDeltaTimes( pEventList );
 
 		SMFTrack *pTrack = new SMFTrack();
 		pSmf->addTrack( pTrack );
 		
 		//Set instrument name as track name
 		pTrack->addEvent( new SMFTrackNameMetaEvent( instrument->get_name() , 0 ) );
-		
-		unsigned nLastTick = 1;
-		for ( std::vector<SMFEvent*>::iterator it = pEventList->begin();
-			it != pEventList->end();
-			 it++ ) {
-			SMFEvent *pEvent = *it;
-			pEvent->m_nDeltaTime = ( pEvent->m_nTicks - nLastTick ) * 4;
-			nLastTick = pEvent->m_nTicks;
-
-			pTrack->addEvent( *it );
-		}
-
-		// we can safely delete vector with events now
-		delete pEventList;
+		pTrack->addNoteEvents( std::move( *pEventList ) );
 	}
 	m_eventLists.clear();
+	m_instrumentIndices.clear();
 }
 
 
@@ -540,17 +548,9 @@ void SMF0Writer::prepareEvents( std::shared_ptr<Song> pSong, SMF* pSmf )
 void SMF0Writer::packEvents( std::shared_ptr<Song> pSong, SMF* pSmf )
 {
 	sortEvents( &m_eventList );
+	computeDeltaTimes( &m_eventList );
 
-	unsigned nLastTick = 1;
-	for ( std::vector<SMFEvent*>::iterator it = m_eventList.begin();
-		it != m_eventList.end();
-		 it++ ) {
-		SMFEvent *pEvent = *it;
-		pEvent->m_nDeltaTime = ( pEvent->m_nTicks - nLastTick ) * 4;
-		nLastTick = pEvent->m_nTicks;
-		
-		m_pTrack->addEvent( *it );
-	}
+	m_pTrack->addNoteEvents( std::move( m_eventList ) );
 
 	m_eventList.clear();
 }
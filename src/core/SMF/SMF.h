@@ -27,10 +27,14 @@
 
 #include <string>
 #include <cstdio>
+#include <unordered_map>
+#include <vector>
 #include <QByteArray>
 
 #include <core/SMF/SMFEvent.h>
 
+class QIODevice;
+
 namespace H2Core
 {
 
@@ -67,12 +71,16 @@ public:
 	~SMFTrack();
 
 	void addEvent( SMFEvent *pEvent );
+	/** Appends note events. They are written after all events added
+	 * using addEvent(). Their delta times have to be set already. */
+	void addNoteEvents( std::vector<SMFNoteEvent>&& events );
 
 	virtual QByteArray getBuffer() const override;
 	virtual QString toQString() const override;
 
 private:
 	std::vector<SMFEvent*> m_eventList;
+	std::vector<SMFNoteEvent> m_noteEvents;
 };
 
 
@@ -89,6 +97,10 @@ public:
 	virtual QByteArray getBuffer() const override;
 	virtual QString toQString() const override;
 
+	/** Writes the header and all tracks chunk by chunk into @a pDevice
+	 * without assembling the whole file in memory first. */
+	bool writeTo( QIODevice* pDevice ) const;
+
 private:
 	std::vector<SMFTrack*> m_trackList;
 
@@ -97,7 +109,7 @@ private:
 
 
 
-typedef std::vector<SMFEvent*> EventList;
+typedef std::vector<SMFNoteEvent> EventList;
 
 
 /** \ingroup docCore docMIDI */
@@ -110,11 +122,18 @@ public:
 	void save( const QString& sFilename, std::shared_ptr<Song> pSong );
 
 protected:
+	/** Orders the events by their tick while retaining the relative
+	 * order of events sharing the same tick. */
 	void sortEvents( EventList* pEventList );
+	/** Sets the delta times of all events in @a pEventList, which has
+	 * to be sorted already. */
+	void computeDeltaTimes( EventList* pEventList );
 	SMFTrack* createTrack0( std::shared_ptr<Song> pSong );
 	
 	virtual SMF* createSMF( std::shared_ptr<Song> pSong ) = 0;
 	virtual void prepareEvents( std::shared_ptr<Song> pSong, SMF* pSmf )=0;
+	/** \return List the notes of @a pInstr are added to or nullptr in
+	 *   case they should be skipped. */
 	virtual EventList* getEvents( std::shared_ptr<Song> pSong, std::shared_ptr<Instrument> pInstr ) = 0;
 	virtual void  packEvents( std::shared_ptr<Song> pSong, SMF* pSmf ) = 0;
 	
@@ -166,7 +185,9 @@ protected:
 	virtual EventList* getEvents( std::shared_ptr<Song> pSong, std::shared_ptr<Instrument> pInstr ) override;
 private:
 	// contains events for each instrument in separate vector
-	std::vector<EventList*> m_eventLists;
+	std::vector<EventList> m_eventLists;
+	/** Maps instruments onto their index in #m_eventLists. */
+	std::unordered_map<const Instrument*, int> m_instrumentIndices;
 };
 
 
@@ -50,6 +50,21 @@ void SMFBuffer::writeDWord( long nVal ) {
 
 
 
+void SMFBuffer::writeDWordAt( int nOffset, long nVal ) {
+	m_buffer[ nOffset ] = static_cast<char>( nVal >> 24 );
+	m_buffer[ nOffset + 1 ] = static_cast<char>( nVal >> 16 );
+	m_buffer[ nOffset + 2 ] = static_cast<char>( nVal >> 8 );
+	m_buffer[ nOffset + 3 ] = static_cast<char>( nVal );
+}
+
+
+
+void SMFBuffer::reserve( int nBytes ) {
+	m_buffer.reserve( nBytes );
+}
+
+
+
 void SMFBuffer::writeString( const QString& sMsg ) {
 	writeVarLen( sMsg.length() );
 
@@ -62,7 +77,6 @@ void SMFBuffer::writeVarLen( long value ) {
 	long buffer;
 	buffer = value & 0x7f;
 	while ( ( value >>= 7 ) > 0 ) {
-		INFOLOG( "." );
 		buffer <<= 8;
 		buffer |= 0x80;
 		buffer += ( value & 0x7f );
@@ -223,59 +237,4 @@ QString SMFEvent::toQString() const {
 	return QString( getBuffer().toHex( ' ' ) );
 }
 
-
-// ::::::::::::::
-
-SMFNoteOnEvent::SMFNoteOnEvent( unsigned nTicks, int nChannel, int nPitch, int nVelocity )
-		: SMFEvent( nTicks )
-		, m_nChannel( nChannel )
-		, m_nPitch( nPitch )
-		, m_nVelocity( nVelocity )
-{
-	if ( nChannel >= 16 ) {
-		ERRORLOG( QString( "nChannel >= 16! nChannel=%1" ).arg( nChannel ) );
-	}
-}
-
-
-
-QByteArray SMFNoteOnEvent::getBuffer() const
-{
-	SMFBuffer buf;
-	buf.writeVarLen( m_nDeltaTime );
-	buf.writeByte( NOTE_ON + m_nChannel );
-	buf.writeByte( m_nPitch );
-	buf.writeByte( m_nVelocity );
-
-	return buf.getBuffer();
-}
-
-
-// :::::::::::
-
-
-SMFNoteOffEvent::SMFNoteOffEvent( unsigned nTicks, int nChannel, int nPitch, int nVelocity )
-		: SMFEvent( nTicks )
-		, m_nChannel( nChannel )
-		, m_nPitch( nPitch )
-		, m_nVelocity( nVelocity )
-{
-	if ( nChannel >= 16 ) {
-		ERRORLOG( QString( "nChannel >= 16! nChannel=%1" ).arg( nChannel ) );
-	}
-}
-
-
-
-QByteArray SMFNoteOffEvent::getBuffer() const
-{
-	SMFBuffer buf;
-	buf.writeVarLen( m_nDeltaTime );
-	buf.writeByte( NOTE_OFF + m_nChannel );
-	buf.writeByte( m_nPitch );
-	buf.writeByte( m_nVelocity );
-
-	return buf.getBuffer();
-}
-
 };
@@ -23,6 +23,8 @@
 #ifndef SMF_EVENT_H
 #define SMF_EVENT_H
 
+#include <cstdint>
+
 #include <QByteArray>
 #include <QString>
 #include <core/Object.h>
@@ -42,8 +44,12 @@ public:
 	void writeByte( char nByte );
 	void writeWord( int nVal );
 	void writeDWord( long nVal );
+	/** Overwrites four bytes starting at @a nOffset. Used to fill in
+	 * the length of a chunk after its content was written. */
+	void writeDWordAt( int nOffset, long nVal );
 	void writeString( const QString& sMsg );
 	void writeVarLen( long nVal );
+	void reserve( int nBytes );
 
 	QByteArray m_buffer;
 
@@ -75,6 +81,25 @@ enum SMFMetaEventType {
 };
 
 
+/** Note on or off event.
+ *
+ * In contrast to the #SMFEvent classes it is stored by value and does
+ * neither require a heap allocation nor virtual dispatch. It is used
+ * for the bulk of the events exported by the #SMFWriter.
+ *
+ * \ingroup docCore docMIDI */
+struct SMFNoteEvent {
+	int nTicks;
+	int nDeltaTime;
+	/** Either #NOTE_ON or #NOTE_OFF. */
+	uint8_t nType;
+	uint8_t nChannel;
+	uint8_t nPitch;
+	uint8_t nVelocity;
+};
+
+
+
 /** \ingroup docCore docMIDI */
 class SMFBase
 {
@@ -159,41 +184,6 @@ private:
 	unsigned m_nBeats, m_nNote, m_nMTPMC , m_nTSNP24 , m_nTicks;
 };
 
-
-
-/** \ingroup docCore docMIDI */
-class SMFNoteOnEvent : public SMFEvent, public H2Core::Object<SMFNoteOnEvent>
-{
-	H2_OBJECT(SMFNoteOnEvent)
-public:
-	SMFNoteOnEvent( unsigned nTicks, int nChannel, int nPitch, int nVelocity );
-
-	virtual QByteArray getBuffer() const override;
-
-protected:
-	unsigned m_nChannel;
-	unsigned m_nPitch;
-	unsigned m_nVelocity;
-};
-
-
-
-/** \ingroup docCore docMIDI */
-class SMFNoteOffEvent : public SMFEvent, public H2Core::Object<SMFNoteOffEvent>
-{
-	H2_OBJECT(SMFNoteOffEvent)
-public:
-	SMFNoteOffEvent(  unsigned nTicks, int nChannel, int nPitch, int nVelocity );
-
-	virtual QByteArray getBuffer() const override;
-
-protected:
-	unsigned m_nChannel;
-	unsigned m_nPitch;
-	unsigned m_nVelocity;
-
-};
-
 };
 
 #endif
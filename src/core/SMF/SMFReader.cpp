@@ -0,0 +1,505 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/SMF/SMFReader.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
+#include <core/Timeline.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <map>
+#include <tuple>
+
+#include <QFile>
+#include <QFileInfo>
+
+namespace H2Core
+{
+
+/** Number of ticks of a quarter note in Hydrogen. */
+static constexpr int nTicksPerQuarter = 48;
+
+SMFReader::SMFReader()
+	: m_nFormat( 0 )
+	, m_nTracks( 0 )
+	, m_nDivision( 0 )
+{
+}
+
+SMFReader::~SMFReader()
+{
+}
+
+int SMFReader::toTick( long long nFileTick ) const
+{
+	return static_cast<int>( ( nFileTick * nTicksPerQuarter + m_nDivision / 2 ) /
+							 m_nDivision );
+}
+
+static int readWord( const QByteArray& data, int nOffset )
+{
+	return ( static_cast<unsigned char>( data[ nOffset ] ) << 8 ) |
+		static_cast<unsigned char>( data[ nOffset + 1 ] );
+}
+
+static unsigned readDWord( const QByteArray& data, int nOffset )
+{
+	return ( static_cast<unsigned>( readWord( data, nOffset ) ) << 16 ) |
+		static_cast<unsigned>( readWord( data, nOffset + 2 ) );
+}
+
+bool SMFReader::load( const QString& sFilename, std::shared_ptr<Song> pSong )
+{
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		ERRORLOG( "Invalid song" );
+		return false;
+	}
+
+	QFile file( sFilename );
+	if ( ! file.open( QIODevice::ReadOnly ) ) {
+		ERRORLOG( QString( "Unable to open [%1]" ).arg( sFilename ) );
+		return false;
+	}
+
+	m_notes.clear();
+	m_tempoChanges.clear();
+	m_timeSignatures.clear();
+
+	if ( ! readHeader( &file ) ) {
+		ERRORLOG( QString( "[%1] is not a supported Standard MIDI File" )
+				  .arg( sFilename ) );
+		return false;
+	}
+
+	// Tracks are read one chunk at a time. Unknown chunks are skipped
+	// as demanded by the specification.
+	int nTracksRead = 0;
+	while ( nTracksRead < m_nTracks && ! file.atEnd() ) {
+		const QByteArray chunkHeader = file.read( 8 );
+		if ( chunkHeader.size() < 8 ) {
+			break;
+		}
+		const unsigned nLength = readDWord( chunkHeader, 4 );
+		const QByteArray chunk = file.read( nLength );
+		if ( static_cast<unsigned>( chunk.size() ) < nLength ) {
+			ERRORLOG( QString( "Chunk [%1] in [%2] is truncated" )
+					  .arg( QString::fromLatin1( chunkHeader.left( 4 ) ) ).arg( sFilename ) );
+			return false;
+		}
+		if ( chunkHeader.left( 4 ) != "MTrk" ) {
+			continue;
+		}
+		if ( ! readTrack( chunk ) ) {
+			ERRORLOG( QString( "Unable to parse track [%1] of [%2]" )
+					  .arg( nTracksRead ).arg( sFilename ) );
+			return false;
+		}
+		++nTracksRead;
+	}
+
+	if ( nTracksRead < m_nTracks ) {
+		WARNINGLOG( QString( "Only [%1] of [%2] tracks found in [%3]" )
+					.arg( nTracksRead ).arg( m_nTracks ).arg( sFilename ) );
+	}
+
+	if ( m_notes.empty() ) {
+		ERRORLOG( QString( "No notes found in [%1]" ).arg( sFilename ) );
+		return false;
+	}
+
+	if ( ! buildSong( pSong, sFilename ) ) {
+		return false;
+	}
+
+	INFOLOG( QString( "[%1] imported: [%2] notes, [%3] columns, [%4] patterns" )
+			 .arg( sFilename ).arg( m_notes.size() )
+			 .arg( pSong->getPatternGroupVector()->size() )
+			 .arg( pSong->getPatternList()->size() ) );
+	return true;
+}
+
+bool SMFReader::readHeader( QIODevice* pDevice )
+{
+	const QByteArray header = pDevice->read( 8 );
+	if ( header.size() < 8 || header.left( 4 ) != "MThd" ) {
+		ERRORLOG( "MThd chunk missing" );
+		return false;
+	}
+	const unsigned nLength = readDWord( header, 4 );
+	if ( nLength < 6 ) {
+		ERRORLOG( QString( "Invalid header length [%1]" ).arg( nLength ) );
+		return false;
+	}
+	const QByteArray data = pDevice->read( nLength );
+	if ( static_cast<unsigned>( data.size() ) < nLength ) {
+		ERRORLOG( "Truncated header" );
+		return false;
+	}
+
+	m_nFormat = readWord( data, 0 );
+	m_nTracks = readWord( data, 2 );
+	m_nDivision = readWord( data, 4 );
+
+	if ( m_nFormat != 0 && m_nFormat != 1 ) {
+		ERRORLOG( QString( "Unsupported format [%1]. Only format 0 and 1 files can be imported" )
+				  .arg( m_nFormat ) );
+		return false;
+	}
+	if ( ( m_nDivision & 0x8000 ) != 0 ) {
+		ERRORLOG( "SMPTE time division is not supported" );
+		return false;
+	}
+	if ( m_nDivision == 0 ) {
+		ERRORLOG( "Invalid time division [0]" );
+		return false;
+	}
+
+	return true;
+}
+
+bool SMFReader::readTrack( const QByteArray& track )
+{
+	const int nSize = track.size();
+	int nPos = 0;
+	long long nFileTick = 0;
+	int nRunningStatus = 0;
+
+	auto byteAt = [&]( int nOffset ) {
+		return static_cast<int>( static_cast<unsigned char>( track[ nOffset ] ) );
+	};
+	// Variable-length quantities span at most four bytes.
+	auto readVarLen = [&]( int* pValue ) {
+		int nValue = 0;
+		for ( int ii = 0; ii < 4; ++ii ) {
+			if ( nPos >= nSize ) {
+				return false;
+			}
+			const int nByte = byteAt( nPos++ );
+			nValue = ( nValue << 7 ) | ( nByte & 0x7f );
+			if ( ( nByte & 0x80 ) == 0 ) {
+				*pValue = nValue;
+				return true;
+			}
+		}
+		return false;
+	};
+
+	while ( nPos < nSize ) {
+		int nDelta;
+		if ( ! readVarLen( &nDelta ) || nPos >= nSize ) {
+			ERRORLOG( QString( "Malformed delta time at byte [%1]" ).arg( nPos ) );
+			return false;
+		}
+		nFileTick += nDelta;
+
+		int nStatus = byteAt( nPos );
+		if ( nStatus == 0xff ) {
+			// Meta event
+			nRunningStatus = 0;
+			if ( nPos + 1 >= nSize ) {
+				return false;
+			}
+			const int nType = byteAt( nPos + 1 );
+			nPos += 2;
+			int nLength;
+			if ( ! readVarLen( &nLength ) || nPos + nLength > nSize ) {
+				ERRORLOG( QString( "Malformed meta event [%1]" ).arg( nType ) );
+				return false;
+			}
+
+			if ( nType == 0x2f ) {
+				// End of track
+				break;
+			}
+			else if ( nType == 0x51 && nLength == 3 ) {
+				const int nMicroSecondsPerQuarter =
+					( byteAt( nPos ) << 16 ) | ( byteAt( nPos + 1 ) << 8 ) |
+					byteAt( nPos + 2 );
+				if ( nMicroSecondsPerQuarter > 0 ) {
+					m_tempoChanges.push_back(
+						{ toTick( nFileTick ),
+						  60000000.0f / static_cast<float>( nMicroSecondsPerQuarter ) } );
+				}
+			}
+			else if ( nType == 0x58 && nLength >= 2 ) {
+				const int nNumerator = byteAt( nPos );
+				const int nDenominatorExponent = byteAt( nPos + 1 );
+				if ( nNumerator > 0 && nDenominatorExponent <= 5 ) {
+					m_timeSignatures.push_back(
+						{ toTick( nFileTick ), nNumerator,
+						  1 << nDenominatorExponent } );
+				} else {
+					WARNINGLOG( QString( "Ignoring invalid time signature [%1/2^%2]" )
+								.arg( nNumerator ).arg( nDenominatorExponent ) );
+				}
+			}
+			nPos += nLength;
+			continue;
+		}
+		else if ( nStatus == 0xf0 || nStatus == 0xf7 ) {
+			// SysEx events are skipped.
+			nRunningStatus = 0;
+			++nPos;
+			int nLength;
+			if ( ! readVarLen( &nLength ) || nPos + nLength > nSize ) {
+				ERRORLOG( "Malformed SysEx event" );
+				return false;
+			}
+			nPos += nLength;
+			continue;
+		}
+
+		if ( ( nStatus & 0x80 ) != 0 ) {
+			if ( nStatus >= 0xf0 ) {
+				ERRORLOG( QString( "Invalid status byte [%1]" )
+						  .arg( nStatus, 0, 16 ) );
+				return false;
+			}
+			nRunningStatus = nStatus;
+			++nPos;
+		}
+		else if ( nRunningStatus == 0 ) {
+			ERRORLOG( QString( "Data byte without running status at byte [%1]" )
+					  .arg( nPos ) );
+			return false;
+		}
+		else {
+			nStatus = nRunningStatus;
+		}
+
+		// Program change and channel pressure carry a single data
+		// byte, all other channel messages two.
+		const int nType = nStatus & 0xf0;
+		const int nDataBytes = ( nType == 0xc0 || nType == 0xd0 ) ? 1 : 2;
+		if ( nPos + nDataBytes > nSize ) {
+			ERRORLOG( "Truncated channel message" );
+			return false;
+		}
+
+		if ( nType == 0x90 ) {
+			const int nKey = byteAt( nPos ) & 0x7f;
+			const int nVelocity = byteAt( nPos + 1 ) & 0x7f;
+			// Note-on events with zero velocity are note-offs.
+			if ( nVelocity > 0 ) {
+				m_notes.push_back( { toTick( nFileTick ), nKey, nVelocity } );
+			}
+		}
+		nPos += nDataBytes;
+	}
+
+	return true;
+}
+
+bool SMFReader::buildSong( std::shared_ptr<Song> pSong,
+						   const QString& sFilename )
+{
+	// Events of different tracks are merged while retaining the order
+	// of simultaneous ones.
+	auto compareTicks = []( const auto& a, const auto& b ) {
+		return a.nTick < b.nTick;
+	};
+	std::stable_sort( m_notes.begin(), m_notes.end(), compareTicks );
+	std::stable_sort( m_tempoChanges.begin(), m_tempoChanges.end(), compareTicks );
+	std::stable_sort( m_timeSignatures.begin(), m_timeSignatures.end(),
+					  compareTicks );
+
+	const int nLastTick = m_notes.back().nTick;
+
+	// Time signature changes take effect at the start of the next bar.
+	struct Bar {
+		int nStart;
+		int nLength;
+		int nDenominator;
+	};
+	std::vector<Bar> bars;
+	{
+		int nNumerator = 4;
+		int nDenominator = 4;
+		size_t nextSignature = 0;
+		int nBarStart = 0;
+		while ( nBarStart <= nLastTick ) {
+			while ( nextSignature < m_timeSignatures.size() &&
+					m_timeSignatures[ nextSignature ].nTick <= nBarStart ) {
+				nNumerator = m_timeSignatures[ nextSignature ].nNumerator;
+				nDenominator = m_timeSignatures[ nextSignature ].nDenominator;
+				++nextSignature;
+			}
+			const int nLength = std::max(
+				nNumerator * 4 * nTicksPerQuarter / nDenominator, 1 );
+			bars.push_back( { nBarStart, nLength, nDenominator } );
+			nBarStart += nLength;
+		}
+	}
+
+	auto columnAt = [&]( int nTick ) {
+		const auto it = std::upper_bound(
+			bars.begin(), bars.end(), nTick,
+			[]( int nValue, const Bar& bar ) { return nValue < bar.nStart; } );
+		return static_cast<int>( std::distance( bars.begin(), it ) ) - 1;
+	};
+
+	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+	std::array<std::shared_ptr<Instrument>, 128> instrumentsByKey;
+	for ( int nnKey = 0; nnKey < 128; ++nnKey ) {
+		instrumentsByKey[ nnKey ] = pInstrumentList->findMidiNote( nnKey );
+	}
+
+	auto pPatternList = new PatternList();
+	auto pPatternGroupVector = new std::vector<PatternList*>;
+	pPatternGroupVector->reserve( bars.size() );
+
+	const QString sInfo = QString( "Imported from %1" )
+		.arg( QFileInfo( sFilename ).fileName() );
+
+	// Bars with identical content are mapped onto the same pattern.
+	std::map<std::vector<int>, Pattern*> patternsByContent;
+	std::vector<std::tuple<int, int, int>> barNotes;
+	int nUnmappedNotes = 0;
+	size_t nextNote = 0;
+
+	for ( const auto& bar : bars ) {
+		barNotes.clear();
+		while ( nextNote < m_notes.size() &&
+				m_notes[ nextNote ].nTick < bar.nStart + bar.nLength ) {
+			const auto& note = m_notes[ nextNote ];
+			const auto& pInstrument = instrumentsByKey[ note.nKey ];
+			if ( pInstrument == nullptr ) {
+				++nUnmappedNotes;
+			} else {
+				barNotes.push_back( std::make_tuple(
+					note.nTick - bar.nStart, pInstrument->get_id(),
+					note.nVelocity ) );
+			}
+			++nextNote;
+		}
+
+		// A pattern holds at most one note per instrument and position.
+		// The loudest one is kept.
+		std::sort( barNotes.begin(), barNotes.end(),
+				   []( const auto& a, const auto& b ) {
+					   if ( std::get<0>( a ) != std::get<0>( b ) ) {
+						   return std::get<0>( a ) < std::get<0>( b );
+					   }
+					   if ( std::get<1>( a ) != std::get<1>( b ) ) {
+						   return std::get<1>( a ) < std::get<1>( b );
+					   }
+					   return std::get<2>( a ) > std::get<2>( b );
+				   } );
+		barNotes.erase(
+			std::unique( barNotes.begin(), barNotes.end(),
+						 []( const auto& a, const auto& b ) {
+							 return std::get<0>( a ) == std::get<0>( b ) &&
+								 std::get<1>( a ) == std::get<1>( b );
+						 } ), barNotes.end() );
+
+		std::vector<int> content;
+		content.reserve( 2 + 3 * barNotes.size() );
+		content.push_back( bar.nLength );
+		content.push_back( bar.nDenominator );
+		for ( const auto& [ nPosition, nId, nVelocity ] : barNotes ) {
+			content.push_back( nPosition );
+			content.push_back( nId );
+			content.push_back( nVelocity );
+		}
+
+		Pattern* pPattern = nullptr;
+		const auto it = patternsByContent.find( content );
+		if ( it != patternsByContent.end() ) {
+			pPattern = it->second;
+		}
+		else {
+			pPattern = new Pattern(
+				QString( "Pattern %1" ).arg( pPatternList->size() + 1 ),
+				sInfo, "", bar.nLength, bar.nDenominator );
+			for ( const auto& [ nPosition, nId, nVelocity ] : barNotes ) {
+				pPattern->insert_note(
+					new Note( pInstrumentList->find( nId ), nPosition,
+							  static_cast<float>( nVelocity ) / 127.0f ) );
+			}
+			pPatternList->add( pPattern );
+			patternsByContent[ std::move( content ) ] = pPattern;
+		}
+
+		auto pColumn = new PatternList();
+		pColumn->add( pPattern );
+		pPatternGroupVector->push_back( pColumn );
+	}
+
+	if ( nUnmappedNotes > 0 ) {
+		WARNINGLOG( QString( "[%1] notes were dropped since no instrument is mapped to their MIDI note" )
+					.arg( nUnmappedNotes ) );
+	}
+
+	// Replace the old song structure. Patterns are owned by the pattern
+	// list while columns only reference them.
+	auto pOldPatternList = pSong->getPatternList();
+	auto pOldPatternGroupVector = pSong->getPatternGroupVector();
+	pSong->setPatternList( pPatternList );
+	pSong->setPatternGroupVector( pPatternGroupVector );
+	if ( pOldPatternGroupVector != nullptr ) {
+		for ( auto& ppColumn : *pOldPatternGroupVector ) {
+			ppColumn->clear();
+			delete ppColumn;
+		}
+		delete pOldPatternGroupVector;
+	}
+	delete pOldPatternList;
+
+	// Tempo
+	auto pTimeline = pSong->getTimeline();
+	std::vector<int> oldTempoMarkerColumns;
+	for ( const auto& ppTempoMarker : pTimeline->getAllTempoMarkers() ) {
+		oldTempoMarkerColumns.push_back( ppTempoMarker->nColumn );
+	}
+	for ( const int nColumn : oldTempoMarkerColumns ) {
+		pTimeline->deleteTempoMarker( nColumn );
+	}
+	float fBpm = 120;
+	bool bTempoMarkers = false;
+	for ( const auto& tempoChange : m_tempoChanges ) {
+		const int nColumn = std::max( columnAt( tempoChange.nTick ), 0 );
+		if ( nColumn == 0 ) {
+			fBpm = tempoChange.fBpm;
+		} else {
+			// A marker already present in the column gets replaced.
+			pTimeline->addTempoMarker( nColumn, tempoChange.fBpm );
+			bTempoMarkers = true;
+		}
+	}
+	pSong->setBpm( fBpm );
+	pTimeline->setDefaultBpm( pSong->getBpm() );
+	pSong->setIsTimelineActivated( bTempoMarkers );
+
+	pSong->setMode( Song::Mode::Song );
+	pSong->setIsModified( true );
+
+	return true;
+}
+
+};
@@ -0,0 +1,105 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef SMF_READER_H
+#define SMF_READER_H
+
+#include <core/Object.h>
+
+#include <memory>
+#include <vector>
+
+#include <QString>
+
+class QIODevice;
+
+namespace H2Core
+{
+
+class Song;
+
+/** Imports Standard MIDI Files (format 0 and 1) into a Song.
+ *
+ * The file is read chunk by chunk. Note-on events are mapped onto
+ * the instruments of the song's drumkit using their MIDI output note
+ * (see InstrumentList::findMidiNote()) and quantized to the tick
+ * resolution of Hydrogen (48 ticks per quarter note). Each bar of the
+ * file - with its length derived from the time signature meta events
+ * - becomes one column of the song. Bars sharing the very same
+ * content share a single pattern. Tempo meta events are converted
+ * into the song tempo and Timeline tempo markers.
+ *
+ * \ingroup docCore docMIDI */
+class SMFReader : public H2Core::Object<SMFReader>
+{
+	H2_OBJECT(SMFReader)
+public:
+	SMFReader();
+	~SMFReader();
+
+	/** Replaces the patterns, pattern group vector, and tempo markers
+	 * of @a pSong by the content of @a sFilename.
+	 *
+	 * Just like deleting a Song, this is not safe while @a pSong is
+	 * played back. The caller has to care for the audio engine lock.
+	 *
+	 * @return `false` in case the file could not be read or parsed. The
+	 *   song is left unaltered in that case. */
+	bool load( const QString& sFilename, std::shared_ptr<Song> pSong );
+
+private:
+	struct NoteOn {
+		int nTick;
+		int nKey;
+		int nVelocity;
+	};
+	struct TempoChange {
+		int nTick;
+		float fBpm;
+	};
+	struct TimeSignature {
+		int nTick;
+		int nNumerator;
+		int nDenominator;
+	};
+
+	bool readHeader( QIODevice* pDevice );
+	/** Parses a single MTrk chunk and appends its content to
+	 * #m_notes, #m_tempoChanges, and #m_timeSignatures. */
+	bool readTrack( const QByteArray& track );
+	bool buildSong( std::shared_ptr<Song> pSong, const QString& sFilename );
+
+	/** Converts a tick of the file into a tick of Hydrogen. */
+	int toTick( long long nFileTick ) const;
+
+	int m_nFormat;
+	int m_nTracks;
+	/** Ticks per quarter note of the file. */
+	int m_nDivision;
+
+	std::vector<NoteOn> m_notes;
+	std::vector<TempoChange> m_tempoChanges;
+	std::vector<TimeSignature> m_timeSignatures;
+};
+
+};
+
+#endif
@@ -29,6 +29,7 @@
 
 #include <core/Basics/Adsr.h>
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/Profiler.h>
 #include <core/AudioEngine/TransportPosition.h>
 #include <core/Globals.h>
 #include <core/Hydrogen.h>
@@ -44,7 +45,9 @@
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Mix.h>
 #include <core/EventQueue.h>
+#include <core/rt_clock.h>
 
 #include <core/FX/Effects.h>
 #include <core/Sampler/Sampler.h>
@@ -75,6 +78,7 @@ Sampler::Sampler()
 		, m_pMainOut_R( nullptr )
 		, m_pPreviewInstrument( nullptr )
 		, m_interpolateMode( Interpolation::InterpolateMode::Linear )
+		, m_pTrackOutputDriver( nullptr )
 {
 	
 	
@@ -83,6 +87,8 @@ Sampler::Sampler()
 
 	m_nMaxLayers = InstrumentComponent::getMaxLayers();
 
+	m_instrumentRenderTimes.reserve( MAX_INSTRUMENTS );
+
 	QString sEmptySampleFilename = Filesystem::empty_sample_path();
 
 	// instrument used in file preview
@@ -123,13 +129,20 @@ void Sampler::process( uint32_t nFrames )
 	memset( m_pMainOut_L, 0, nFrames * sizeof( float ) );
 	memset( m_pMainOut_R, 0, nFrames * sizeof( float ) );
 
+	m_pTrackOutputDriver = nullptr;
+#ifdef H2CORE_HAVE_JACK
+	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
+		m_pTrackOutputDriver = dynamic_cast<JackAudioDriver*>(
+			pHydrogen->getAudioOutput() );
+	}
+#endif
+
 	// Max notes limit
 	int nMaxNotes = Preferences::get_instance()->m_nMaxNotes;
 	while ( ( int )m_playingNotesQueue.size() > nMaxNotes ) {
 		Note * pOldNote = m_playingNotesQueue[ 0 ];
 		m_playingNotesQueue.erase( m_playingNotesQueue.begin() );
 		if ( pOldNote->get_instrument() != nullptr ) {
-			pOldNote->get_instrument()->dequeue( pOldNote );
 			WARNINGLOG( QString( "Number of playing notes [%1] exceeds maximum [%2]. Dropping note [%3]" )
 						.arg( m_playingNotesQueue.size() ).arg( nMaxNotes )
 						.arg( pOldNote->toQString() ) );
@@ -142,17 +155,59 @@ void Sampler::process( uint32_t nFrames )
 		}
 	}
 
+	// Resolve everything constant during this cycle once.
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+	const auto pPref = Preferences::get_instance();
+	m_cycle.pSong = pSong;
+	m_cycle.pAudioDriver = pHydrogen->getAudioOutput();
+	m_cycle.pMidiOutput = pHydrogen->getMidiOutput();
+	m_cycle.nSampleRate = m_cycle.pAudioDriver != nullptr ?
+		static_cast<int>(m_cycle.pAudioDriver->getSampleRate()) : 0;
+	if ( pAudioEngine->getState() == AudioEngine::State::Playing ||
+		 pAudioEngine->getState() == AudioEngine::State::Testing ) {
+		m_cycle.nFrame = pAudioEngine->getTransportPosition()->getFrame();
+	} else {
+		// use this to support realtime events when transport is not
+		// rolling.
+		m_cycle.nFrame = pAudioEngine->getRealtimeFrame();
+	}
+	m_cycle.bIsExportSessionActive = pHydrogen->getIsExportSessionActive();
+	m_cycle.bAnyInstrumentSoloed =
+		pSong->getDrumkit()->getInstruments()->isAnyInstrumentSoloed();
+	m_cycle.bHasJackAudioDriver = pHydrogen->hasJackAudioDriver();
+	m_cycle.bPreFader = pPref->m_JackTrackOutputMode ==
+		Preferences::JackTrackOutputMode::preFader;
+	m_cycle.bPostFader = pPref->m_JackTrackOutputMode ==
+		Preferences::JackTrackOutputMode::postFader;
+
+	auto pProfiler = pAudioEngine->getProfiler();
+	const bool bProfileVoices = pProfiler->getVoiceProfiling();
+	m_instrumentRenderTimes.clear();
+
 	// Render next `nFrames` audio frames of all playing notes.
 	unsigned i = 0;
 	Note* pNote;
 	while ( i < m_playingNotesQueue.size() ) {
 		pNote = m_playingNotesQueue[ i ];
-		if ( renderNote( pNote, nFrames ) ) {
+
+		uint64_t nVoiceStartNs = 0;
+		if ( bProfileVoices ) {
+			nVoiceStartNs = rtClockNs();
+		}
+		const bool bNoteEnded = renderNote( pNote, nFrames );
+		if ( bProfileVoices ) {
+			const uint64_t nVoiceNs = rtClockNs() - nVoiceStartNs;
+			pProfiler->record( Profiler::Stage::Voice, nVoiceNs );
+			if ( pNote->get_instrument() != nullptr ) {
+				addInstrumentRenderTime( pNote->get_instrument()->get_id(),
+										 nVoiceNs );
+			}
+		}
+
+		if ( bNoteEnded ) {
 			// End of note was reached during rendering.
 			m_playingNotesQueue.erase( m_playingNotesQueue.begin() + i );
-			if ( pNote->get_instrument() != nullptr ) {
-				pNote->get_instrument()->dequeue( pNote );
-			} else {
+			if ( pNote->get_instrument() == nullptr ) {
 				ERRORLOG( QString( "Playing note in sampler does not have instrument! [%1]" )
 						  .arg( pNote->prettyName() ) );
 			}
@@ -163,6 +218,10 @@ void Sampler::process( uint32_t nFrames )
 		}
 	}
 
+	for ( const auto& [ nInstrumentId, nRenderNs ] : m_instrumentRenderTimes ) {
+		pProfiler->recordInstrument( nInstrumentId, nRenderNs );
+	}
+
 	if ( m_queuedNoteOffs.size() > 0 ) {
 		MidiOutput* pMidiOut = pHydrogen->getMidiOutput();
 		if ( pMidiOut != nullptr ) {
@@ -196,6 +255,9 @@ void Sampler::process( uint32_t nFrames )
 	}
 
 	processPlaybackTrack(nFrames);
+
+	// Do not keep the song alive beyond this cycle.
+	m_cycle.pSong = nullptr;
 }
 
 bool Sampler::isRenderingNotes() const {
@@ -247,7 +309,6 @@ void Sampler::noteOn(Note *pNote )
 	}
 
 	if ( ! pNote->get_note_off() ){
-		pInstr->enqueue( pNote );
 		m_playingNotesQueue.push_back( pNote );
 	}
 }
@@ -412,7 +473,7 @@ float Sampler::ratioConstKNormPanLaw( float fPan, float k) {
 }
 
 // function to direct the computation to the selected pan law.
-inline float Sampler::panLaw( float fPan, std::shared_ptr<Song> pSong ) {
+inline float Sampler::panLaw( float fPan, const std::shared_ptr<Song>& pSong ) {
 	int nPanLawType = pSong->getPanLawType();
 	if ( nPanLawType == RATIO_STRAIGHT_POLYGONAL ) {
 		return ratioStraightPolygonalPanLaw( fPan );
@@ -549,10 +610,74 @@ void Sampler::handleSongSizeChange() {
 
 //------------------------------------------------------------------
 
+void Sampler::updateVoicePan( Note* pNote )
+{
+	auto& voicePan = pNote->getVoicePan();
+	const auto& pSong = m_cycle.pSong;
+	const float fInstrumentPan = pNote->get_instrument()->getPan();
+	const float fNotePan = pNote->getPan();
+	const int nPanLawType = pSong->getPanLawType();
+	const float fPanLawKNorm = pSong->getPanLawKNorm();
+	const bool bPreFader = m_cycle.bHasJackAudioDriver && m_cycle.bPreFader;
+
+	if ( voicePan.bValid &&
+		 voicePan.fInstrumentPan == fInstrumentPan &&
+		 voicePan.fNotePan == fNotePan &&
+		 voicePan.nPanLawType == nPanLawType &&
+		 voicePan.fPanLawKNorm == fPanLawKNorm &&
+		 voicePan.bPreFader == bPreFader ) {
+		return;
+	}
+
+	// new instrument and note pan interaction--------------------------
+	// notePan moves the RESULTANT pan in a smaller pan range centered at instrumentPan
+
+   /** Get the RESULTANT pan, following a "matryoshka" multi panning, like in this graphic:
+    *
+    *   L--------------instrPan---------C------------------------------>R			(instrumentPan = -0.4)
+    *                     |
+    *                     V
+    *   L-----------------C---notePan-------->R									    (notePan = +0.3)
+    *                            |
+    *                            V
+    *   L----------------------resPan---C------------------------------>R		    (resultantPan = -0.22)
+    *
+    * Explanation:
+	* notePan moves the RESULTANT pan in a smaller pan range centered at instrumentPan value,
+	* whose extension depends on instrPan value:
+	*	if instrPan is central, notePan moves the signal in the whole pan range (really from left to right);
+	*	if instrPan is sided, notePan moves the signal in a progressively smaller pan range centered at instrPan;
+	*	if instrPan is HARD-sided, notePan doesn't have any effect.
+	*/
+	float fPan = fInstrumentPan + fNotePan * ( 1 - fabs( fInstrumentPan ) );
+	
+	// Pass fPan to the Pan Law
+	voicePan.fPan_L = panLaw( fPan, pSong );
+	voicePan.fPan_R = panLaw( -fPan, pSong );
+
+	// In PreFader mode of the per track output of the JACK driver we
+	// disregard the instrument pan along with all other settings
+	// available in the Mixer. The Note pan, however, will be used.
+	voicePan.fNotePan_L = 0;
+	voicePan.fNotePan_R = 0;
+	if ( bPreFader ) {
+		voicePan.fNotePan_L = panLaw( fNotePan, pSong );
+		voicePan.fNotePan_R = panLaw( -1 * fNotePan, pSong );
+	}
+	//---------------------------------------------------------
+
+	// panLaw() might have corrected an invalid pan law type.
+	voicePan.nPanLawType = pSong->getPanLawType();
+	voicePan.fInstrumentPan = fInstrumentPan;
+	voicePan.fNotePan = fNotePan;
+	voicePan.fPanLawKNorm = fPanLawKNorm;
+	voicePan.bPreFader = bPreFader;
+	voicePan.bValid = true;
+}
+
 bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 {
-	auto pHydrogen = Hydrogen::get_instance();
-	auto pSong = pHydrogen->getSong();
+	const auto& pSong = m_cycle.pSong;
 	if ( pSong == nullptr ) {
 		ERRORLOG( "no song" );
 		return true;
@@ -564,22 +689,12 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 		return true;
 	}
 
-	long long nFrame;
-	auto pAudioDriver = pHydrogen->getAudioOutput();
-	if ( pAudioDriver == nullptr ) {
+	if ( m_cycle.pAudioDriver == nullptr ) {
 		ERRORLOG( "AudioDriver is not ready!" );
 		return true;
 	}
 
-	auto pAudioEngine = pHydrogen->getAudioEngine();
-	if ( pAudioEngine->getState() == AudioEngine::State::Playing ||
-		 pAudioEngine->getState() == AudioEngine::State::Testing ) {
-		nFrame = pAudioEngine->getTransportPosition()->getFrame();
-	} else {
-		// use this to support realtime events when transport is not
-		// rolling.
-		nFrame = pAudioEngine->getRealtimeFrame();
-	}
+	const long long nFrame = m_cycle.nFrame;
 
 	// Only if the Sampler has not started rendering the note yet we
 	// care about its starting position. Else we would encounter
@@ -613,58 +728,25 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 		}
 	}
 
-	// new instrument and note pan interaction--------------------------
-	// notePan moves the RESULTANT pan in a smaller pan range centered at instrumentPan
-
-   /** Get the RESULTANT pan, following a "matryoshka" multi panning, like in this graphic:
-    *
-    *   L--------------instrPan---------C------------------------------>R			(instrumentPan = -0.4)
-    *                     |
-    *                     V
-    *   L-----------------C---notePan-------->R									    (notePan = +0.3)
-    *                            |
-    *                            V
-    *   L----------------------resPan---C------------------------------>R		    (resultantPan = -0.22)
-    *
-    * Explanation:
-	* notePan moves the RESULTANT pan in a smaller pan range centered at instrumentPan value,
-	* whose extension depends on instrPan value:
-	*	if instrPan is central, notePan moves the signal in the whole pan range (really from left to right);
-	*	if instrPan is sided, notePan moves the signal in a progressively smaller pan range centered at instrPan;
-	*	if instrPan is HARD-sided, notePan doesn't have any effect.
-	*/
-	float fPan = pInstr->getPan() + pNote->getPan() * ( 1 - fabs( pInstr->getPan() ) );
-	
-	// Pass fPan to the Pan Law
-	float fPan_L = panLaw( fPan, pSong );
-	float fPan_R = panLaw( -fPan, pSong );
-
-	// In PreFader mode of the per track output of the JACK driver we
-	// disregard the instrument pan along with all other settings
-	// available in the Mixer. The Note pan, however, will be used.
-	float fNotePan_L = 0;
-	float fNotePan_R = 0;
-	if ( pHydrogen->hasJackAudioDriver() &&
-		 Preferences::get_instance()->m_JackTrackOutputMode ==
-		 Preferences::JackTrackOutputMode::preFader ) {
-		fNotePan_L = panLaw( pNote->getPan(), pSong );
-		fNotePan_R = panLaw( -1 * pNote->getPan(), pSong );
-	}
-	//---------------------------------------------------------
+	updateVoicePan( pNote );
+	const auto& voicePan = pNote->getVoicePan();
+	const float fPan_L = voicePan.fPan_L;
+	const float fPan_R = voicePan.fPan_R;
+	const float fNotePan_L = voicePan.fNotePan_L;
+	const float fNotePan_R = voicePan.fNotePan_R;
 
 	auto pComponents = pInstr->get_components();
-	auto returnValues = std::vector<bool>( pComponents->size() );
 
-	for ( int ii = 0; ii < pComponents->size(); ++ii ){
-		returnValues[ ii ] = false;
-	}
+	// The note is only considered ended if all of its components are.
+	bool bNoteEnded = true;
 
 	int nAlreadySelectedLayer = -1;
 
 	for ( int ii = 0; ii < pComponents->size(); ++ii ) {
-		auto pCompo = pComponents->at( ii );
+		const auto& pCompo = pComponents->at( ii );
 		if ( pCompo == nullptr ) {
 			ERRORLOG( QString( "Component [%1] is invalid" ).arg( ii ) );
+			bNoteEnded = false;
 			continue;
 		}
 
@@ -672,41 +754,47 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 		// back (layer preview and sample editor).
 		if ( pNote->getSpecificCompoIdx() != -1 &&
 			 pNote->getSpecificCompoIdx() != ii ) {
-			continue;
-		}
-
-		auto pSample = pNote->getSample( ii, nAlreadySelectedLayer );
-		if ( pSample == nullptr ) {
-			returnValues[ ii ] = true;
+			bNoteEnded = false;
 			continue;
 		}
 
 		auto pSelectedLayer = pNote->get_layer_selected( ii );
 		if ( pSelectedLayer == nullptr ) {
 			ERRORLOG( "Invalid selection layer." );
-			returnValues[ ii ] = true;
 			continue;
 		}
 
-		// For round robin and random selection we will use the same
-		// layer again for all other samples.
-		if ( nAlreadySelectedLayer != -1 &&
-			 pInstr->sample_selection_alg() != Instrument::VELOCITY ) {
-			nAlreadySelectedLayer = pSelectedLayer->nSelectedLayer;
-		}
+		// Layer and sample are only resolved once per voice.
+		if ( pSelectedLayer->pSample == nullptr ) {
+			auto pSample = pNote->getSample( ii, nAlreadySelectedLayer );
+			if ( pSample == nullptr ) {
+				continue;
+			}
 
-		if ( pSelectedLayer->nSelectedLayer == -1 ) {
-			ERRORLOG( "Sample selection did not work." );
-			returnValues[ ii ] = true;
-			continue;
-		}
-		auto pLayer = pCompo->getLayer( pSelectedLayer->nSelectedLayer );
-		if ( pLayer == nullptr ) {
-			ERRORLOG( QString( "Unable to retrieve layer [%1]" )
-					  .arg( pSelectedLayer->nSelectedLayer ) );
-			returnValues[ ii ] = true;
-			continue;
+			// For round robin and random selection we will use the same
+			// layer again for all other samples.
+			if ( nAlreadySelectedLayer != -1 &&
+				 pInstr->sample_selection_alg() != Instrument::VELOCITY ) {
+				nAlreadySelectedLayer = pSelectedLayer->nSelectedLayer;
+			}
+
+			if ( pSelectedLayer->nSelectedLayer == -1 ) {
+				ERRORLOG( "Sample selection did not work." );
+				continue;
+			}
+			auto pLayer = pCompo->getLayer( pSelectedLayer->nSelectedLayer );
+			if ( pLayer == nullptr ) {
+				ERRORLOG( QString( "Unable to retrieve layer [%1]" )
+						  .arg( pSelectedLayer->nSelectedLayer ) );
+				continue;
+			}
+
+			pSelectedLayer->pLayer = pLayer;
+			pSelectedLayer->pSample = pSample;
 		}
+		const auto& pSample = pSelectedLayer->pSample;
+		const auto& pLayer = pSelectedLayer->pLayer;
+
 		float fLayerGain = pLayer->get_gain();
 		float fLayerPitch = pLayer->get_pitch();
 
@@ -721,7 +809,6 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 							.arg( pSelectedLayer->fSamplePosition )
 							.arg( pSample->get_frames() ) );
 			}
-			returnValues[ ii ] = true;
 			continue;
 		}
 
@@ -740,11 +827,9 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 		 *   - if another instrument  or component/layer of the same
 		 *     instrument is soloed.
 		 */
-		bool bIsMutedForExport = ( pHydrogen->getIsExportSessionActive() &&
+		bool bIsMutedForExport = ( m_cycle.bIsExportSessionActive &&
 								 ! pInstr->is_currently_exported() );
-		bool bAnyInstrumentIsSoloed =
-			pSong->getDrumkit()->getInstruments()->isAnyInstrumentSoloed();
-		bool bIsMutedBecauseOfSolo = ( bAnyInstrumentIsSoloed &&
+		bool bIsMutedBecauseOfSolo = ( m_cycle.bAnyInstrumentSoloed &&
 									   ! pInstr->is_soloed() );
 
 		// check wether another component of this instrument is muted
@@ -773,8 +858,7 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 			 pCompo->getIsMuted() || pLayer->getIsMuted() || bIsMutedBecauseOfSolo ) {
 			fCost_L = 0.0;
 			fCost_R = 0.0;
-			if ( Preferences::get_instance()->m_JackTrackOutputMode ==
-				 Preferences::JackTrackOutputMode::postFader ) {
+			if ( m_cycle.bPostFader ) {
 				fCostTrack_L = 0.0;
 				fCostTrack_R = 0.0;
 			}
@@ -793,16 +877,14 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 
 			fCost_L = fMonoGain * fPan_L;			// pan
 			fCost_R = fMonoGain * fPan_R;			// pan
-			if ( Preferences::get_instance()->m_JackTrackOutputMode ==
-				 Preferences::JackTrackOutputMode::postFader ) {
+			if ( m_cycle.bPostFader ) {
 				fCostTrack_R = fCost_R * 2;
 				fCostTrack_L = fCost_L * 2;
 			}
 		}
 
 		// direct track outputs only use velocity
-		if ( Preferences::get_instance()->m_JackTrackOutputMode ==
-			 Preferences::JackTrackOutputMode::preFader ) {
+		if ( m_cycle.bPreFader ) {
 			if ( pInstr->get_apply_velocity() ) {
 				fCostTrack_L *= pNote->get_velocity();
 			}
@@ -825,24 +907,22 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 		// Once the Sampler does start rendering a note we also push
 		// it to all connected MIDI devices.
 		if ( (int) pSelectedLayer->fSamplePosition == 0  && ! pInstr->is_muted() ) {
-			if ( pHydrogen->getMidiOutput() != nullptr ){
-				pHydrogen->getMidiOutput()->handleQueueNote( pNote );
+			if ( m_cycle.pMidiOutput != nullptr ){
+				m_cycle.pMidiOutput->handleQueueNote(
+					pNote, static_cast<int>( nInitialBufferPos ) );
 			}
 		}
 
 		// Actual rendering.
-		returnValues[ ii ] = renderNoteResample(
-			pSample, pNote, pSelectedLayer, pCompo, ii, nBufferSize,
-			nInitialBufferPos, fCost_L, fCost_R, fCostTrack_L, fCostTrack_R,
-			fLayerPitch );
-	}
-
-	for ( const auto& bReturnValue : returnValues ) {
-		if ( ! bReturnValue ) {
-			return false;
+		if ( ! renderNoteResample(
+				 pSample, pNote, pSelectedLayer, pCompo, ii, nBufferSize,
+				 nInitialBufferPos, fCost_L, fCost_R, fCostTrack_L, fCostTrack_R,
+				 fLayerPitch ) ) {
+			bNoteEnded = false;
 		}
 	}
-	return true;
+
+	return bNoteEnded;
 }
 
 /// Copy sample data to buffer, filling buffer with trailing silence at end of
@@ -1116,9 +1196,8 @@ bool Sampler::renderNoteResample(
 	float fLayerPitch
 )
 {
-	auto pHydrogen = Hydrogen::get_instance();
-	auto pAudioDriver = pHydrogen->getAudioOutput();
-	auto pSong = pHydrogen->getSong();
+	const auto& pSong = m_cycle.pSong;
+	auto pAudioDriver = m_cycle.pAudioDriver;
 
 	if ( pSong == nullptr ) {
 		ERRORLOG( "Invalid song" );
@@ -1142,20 +1221,29 @@ bool Sampler::renderNoteResample(
 	}
 
 	const float fNotePitch = pNote->get_total_pitch() + fLayerPitch;
+	const int nSampleRate = m_cycle.nSampleRate;
 	const bool bResample = fNotePitch != 0 ||
-		pSample->get_sample_rate() != pAudioDriver->getSampleRate();
-
-	float fStep;
-	if ( bResample ){
-		fStep = Note::pitchToFrequency( fNotePitch );
-
-		// Adjust for audio driver sample rate
-		fStep *= static_cast<float>(pSample->get_sample_rate()) /
-			static_cast<float>(pAudioDriver->getSampleRate());
-	}
-	else {
-		fStep = 1;
+		pSample->get_sample_rate() != nSampleRate;
+
+	// The resampling step only changes along with the pitch of the note
+	// (e.g. via automation) or the sample rate of the driver.
+	if ( pSelectedLayerInfo->nStepSampleRate != nSampleRate ||
+		 pSelectedLayerInfo->fStepPitch != fNotePitch ) {
+		if ( bResample ){
+			pSelectedLayerInfo->fStep = Note::pitchToFrequency( fNotePitch );
+
+			// Adjust for audio driver sample rate
+			pSelectedLayerInfo->fStep *=
+				static_cast<float>(pSample->get_sample_rate()) /
+				static_cast<float>(nSampleRate);
+		}
+		else {
+			pSelectedLayerInfo->fStep = 1;
+		}
+		pSelectedLayerInfo->fStepPitch = fNotePitch;
+		pSelectedLayerInfo->nStepSampleRate = nSampleRate;
 	}
+	const float fStep = pSelectedLayerInfo->fStep;
 
 	auto pSample_data_L = pSample->get_data_l();
 	auto pSample_data_R = pSample->get_data_r();
@@ -1239,13 +1327,21 @@ bool Sampler::renderNoteResample(
 	float* pTrackOutL = nullptr;
 	float* pTrackOutR = nullptr;
 
-	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
-		auto pJackAudioDriver = dynamic_cast<JackAudioDriver*>( pAudioDriver );
-		if ( pJackAudioDriver != nullptr ) {
-			pTrackOutL = pJackAudioDriver->getTrackOut_L(
-				pInstrument, nComponentIdx );
-			pTrackOutR = pJackAudioDriver->getTrackOut_R(
-				pInstrument, nComponentIdx );
+	if ( m_pTrackOutputDriver != nullptr ) {
+		// The track number only changes when the driver recreates its
+		// ports. Resolve it once per routing instead of on every cycle.
+		const int nGeneration = m_pTrackOutputDriver->getTrackRoutingGeneration();
+		if ( pSelectedLayerInfo->nTrackRoutingGeneration != nGeneration ) {
+			pSelectedLayerInfo->nTrackOutput =
+				m_pTrackOutputDriver->getTrackNumber( pInstrument->get_id(),
+													  nComponentIdx );
+			pSelectedLayerInfo->nTrackRoutingGeneration = nGeneration;
+		}
+		if ( pSelectedLayerInfo->nTrackOutput >= 0 ) {
+			pTrackOutL = m_pTrackOutputDriver->getTrackOut_L(
+				pSelectedLayerInfo->nTrackOutput );
+			pTrackOutR = m_pTrackOutputDriver->getTrackOut_R(
+				pSelectedLayerInfo->nTrackOutput );
 		}
 	}
 #endif
@@ -1337,28 +1433,35 @@ bool Sampler::renderNoteResample(
 		if ( pFX != nullptr && fLevel != 0.0 ) {
 			fLevel = fLevel * pFX->getVolume();
 
-			float *pBuf_L = pFX->m_pBuffer_L;
-			float *pBuf_R = pFX->m_pBuffer_R;
-
-			float fFXCost_L = fLevel * masterVol;
-			float fFXCost_R = fLevel * masterVol;
+			const float fFXCost = fLevel * masterVol;
 
-			int nBufferPos = nInitialBufferPos;
-			for ( int i = 0; i < nAvail_bytes; ++i ) {
-
-				fVal_L = buffer_L[ nBufferPos ];
-				fVal_R = buffer_R[ nBufferPos ];
-
-				pBuf_L[ nBufferPos ] += fVal_L * fFXCost_L;
-				pBuf_R[ nBufferPos ] += fVal_R * fFXCost_R;
-				++nBufferPos;
-			}
+			Mix::addScaled( &pFX->m_pBuffer_L[ nInitialBufferPos ],
+							&buffer_L[ nInitialBufferPos ], fFXCost,
+							nAvail_bytes );
+			Mix::addScaled( &pFX->m_pBuffer_R[ nInitialBufferPos ],
+							&buffer_R[ nInitialBufferPos ], fFXCost,
+							nAvail_bytes );
 		}
 	}
 #endif
 	return bRetValue;
 }
 
+void Sampler::addInstrumentRenderTime( int nInstrumentId, uint64_t nNs )
+{
+	for ( auto& [ nId, nRenderNs ] : m_instrumentRenderTimes ) {
+		if ( nId == nInstrumentId ) {
+			nRenderNs += nNs;
+			return;
+		}
+	}
+
+	// Do not allocate memory within the audio thread.
+	if ( m_instrumentRenderTimes.size() < m_instrumentRenderTimes.capacity() ) {
+		m_instrumentRenderTimes.push_back( { nInstrumentId, nNs } );
+	}
+}
+
 void Sampler::stopPlayingNotes( std::shared_ptr<Instrument> pInstr )
 {
 	if ( pInstr != nullptr ) { // stop all notes using this instrument
@@ -1366,7 +1469,6 @@ void Sampler::stopPlayingNotes( std::shared_ptr<Instrument> pInstr )
 			Note *pNote = m_playingNotesQueue[ i ];
 			assert( pNote );
 			if ( pNote->get_instrument() == pInstr ) {
-				pInstr->dequeue( pNote );
 				delete pNote;
 				m_playingNotesQueue.erase( m_playingNotesQueue.begin() + i );
 			}
@@ -1377,9 +1479,6 @@ void Sampler::stopPlayingNotes( std::shared_ptr<Instrument> pInstr )
 		// delete all copied notes in the playing notes queue
 		for ( unsigned i = 0; i < m_playingNotesQueue.size(); ++i ) {
 			Note *pNote = m_playingNotesQueue[i];
-			if ( pNote->get_instrument() != nullptr ) {
-				pNote->get_instrument()->dequeue( pNote );
-			}
 			delete pNote;
 		}
 		m_playingNotesQueue.clear();
@@ -1418,6 +1517,8 @@ void Sampler::preview_sample(std::shared_ptr<Sample> pSample, int nLength )
 		}
 		auto pLayer = pComponent->getLayer( 0 );
 
+		// Former preview notes might still be rendering the old sample.
+		Hydrogen::get_instance()->addSampleToDeathRow( pLayer->get_sample() );
 		pLayer->set_sample( pSample );
 
 		Note *pPreviewNote = new Note( m_pPreviewInstrument, 0, 1.0, 0.f, nLength );
@@ -1489,6 +1590,10 @@ void Sampler::reinitializePlaybackTrack()
 	
 	auto  pPlaybackTrackLayer = std::make_shared<InstrumentLayer>( pSample );
 
+	auto pOldLayer = m_pPlaybackTrackInstrument->get_components()->front()->getLayer( 0 );
+	if ( pOldLayer != nullptr ) {
+		pHydrogen->addSampleToDeathRow( pOldLayer->get_sample() );
+	}
 	m_pPlaybackTrackInstrument->get_components()->front()->setLayer( pPlaybackTrackLayer, 0 );
 	m_nPlayBackSamplePosition = 0;
 }
@@ -35,12 +35,15 @@
 namespace H2Core
 {
 
+class AudioOutput;
+class MidiOutput;
 class Note;
 class Song;
 class Sample;
 class Instrument;
 struct SelectedLayerInfo;
 class InstrumentComponent;
+class JackAudioDriver;
 
 ///
 /// Waveform based sampler.
@@ -248,10 +251,17 @@ public:
 private:
 	/** function to direct the computation to the selected pan law function
 	 */
-	float panLaw( float fPan, std::shared_ptr<Song> pSong );
+	float panLaw( float fPan, const std::shared_ptr<Song>& pSong );
+	/** Updates the pan coefficients cached in @a pNote in case one
+	 * of their inputs changed.*/
+	void updateVoicePan( Note* pNote );
 
 	bool processPlaybackTrack(int nBufferSize);
 
+	/** Accumulates the time spent rendering voices of instrument
+	 * @a nInstrumentId during the current process() cycle.*/
+	void addInstrumentRenderTime( int nInstrumentId, uint64_t nNs );
+
     /** @return false - the note is not ended, true - the note is ended */
 	bool renderNote( Note* pNote, unsigned nBufferSize );
 
@@ -289,6 +299,35 @@ private:
 	int m_nPlayBackSamplePosition;
 
 	Interpolation::InterpolateMode m_interpolateMode;
+
+	/** JACK driver providing the per-track output ports. Resolved
+	 * once at the beginning of each process() cycle and nullptr in
+	 * case per-track outputs are not used.*/
+	JackAudioDriver* m_pTrackOutputDriver;
+
+	/** Pairs of instrument id and render time in nanoseconds for the
+	 * current process() cycle. Only used if voice profiling is
+	 * enabled in the #Profiler.*/
+	std::vector<std::pair<int, uint64_t>> m_instrumentRenderTimes;
+
+	/** State shared by all voices rendered within a single process()
+	 * cycle. It is resolved once at the beginning of the cycle instead
+	 * of once per voice.*/
+	struct CycleContext {
+		std::shared_ptr<Song> pSong;
+		AudioOutput* pAudioDriver = nullptr;
+		MidiOutput* pMidiOutput = nullptr;
+		int nSampleRate = 0;
+		/** Frame corresponding to the beginning of the buffer.*/
+		long long nFrame = 0;
+		bool bIsExportSessionActive = false;
+		bool bAnyInstrumentSoloed = false;
+		bool bHasJackAudioDriver = false;
+		/** JACK per-track output mode.*/
+		bool bPreFader = false;
+		bool bPostFader = false;
+	};
+	CycleContext m_cycle;
 };
 
 inline const std::vector<Note*>& Sampler::getPlayingNotesQueue() const {
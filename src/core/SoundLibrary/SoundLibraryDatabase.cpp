@@ -20,14 +20,24 @@
  *
  */
 
+#include <atomic>
 #include <map>
 #include <set>
+#include <thread>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
 
 #include <core/SoundLibrary/SoundLibraryDatabase.h>
 
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Song.h>
 #include <core/EventQueue.h>
+#include <core/Helpers/DrumkitSwitcher.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Helpers/Xml.h>
 #include <core/Hydrogen.h>
@@ -38,7 +48,19 @@ namespace H2Core
 QString SoundLibraryDatabase::m_sPatternBaseCategory = "not_categorized";
 
 SoundLibraryDatabase::SoundLibraryDatabase()
+	: m_pWatcher( std::make_unique<QFileSystemWatcher>() )
+	, m_pUpdateTimer( std::make_unique<QTimer>() )
+	, m_bDrumkitFoldersChanged( false )
+	, m_bPatternFoldersChanged( false )
 {
+	m_pUpdateTimer->setSingleShot( true );
+	m_pUpdateTimer->setInterval( 500 );
+	QObject::connect( m_pUpdateTimer.get(), &QTimer::timeout,
+					  m_pUpdateTimer.get(), [&]() { onUpdateTimeout(); } );
+	QObject::connect( m_pWatcher.get(), &QFileSystemWatcher::directoryChanged,
+					  m_pWatcher.get(), [&]( const QString& sPath ) {
+						  onDirectoryChanged( sPath ); } );
+
 	update();
 }
 
@@ -48,6 +70,7 @@ SoundLibraryDatabase::~SoundLibraryDatabase()
 
 void SoundLibraryDatabase::printPatterns() const
 {
+	std::lock_guard<std::mutex> lock( m_mutex );
 	for ( const auto& pPatternInfo : m_patternInfoVector ) {
 		INFOLOG( QString( "Name: [%1]" ).arg( pPatternInfo->getName() ) );
 	}
@@ -59,6 +82,7 @@ void SoundLibraryDatabase::printPatterns() const
 
 bool SoundLibraryDatabase::isPatternInstalled( const QString& sPatternName ) const
 {
+	std::lock_guard<std::mutex> lock( m_mutex );
 	for ( const auto& pPatternInfo : m_patternInfoVector ) {
 		if ( pPatternInfo->getName() == sPatternName ) {
 			return true;
@@ -78,7 +102,15 @@ void SoundLibraryDatabase::update()
 
 void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 
-	m_drumkitDatabase.clear();
+	scanDrumkits();
+	updateWatchedDirectories();
+
+	if ( bTriggerEvent ) {
+		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
+	}
+}
+
+bool SoundLibraryDatabase::scanDrumkits() {
 
 	QStringList drumkitPaths;
 	// system drumkits
@@ -91,8 +123,14 @@ void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 		drumkitPaths <<
 			Filesystem::absolute_path( Filesystem::usr_drumkits_dir() + sDrumkitName );
 	}
+	QStringList customDrumkitPaths, customDrumkitFolders;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		customDrumkitPaths = m_customDrumkitPaths;
+		customDrumkitFolders = m_customDrumkitFolders;
+	}
 	// custom drumkits added by the user
-	for ( const auto& sDrumkitPath : m_customDrumkitPaths ) {
+	for ( const auto& sDrumkitPath : customDrumkitPaths ) {
 		if ( ! drumkitPaths.contains( sDrumkitPath ) ) {
 			drumkitPaths << sDrumkitPath;
 		}
@@ -101,49 +139,150 @@ void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 	// search custom drumkit folders for valid kits. Be careful not to add
 	// directories, which do not correspond to drumkits. This would lead to a
 	// lot of false positive error messages.
-	for ( const auto& sDrumkitFolder : m_customDrumkitFolders ) {
+	for ( const auto& sDrumkitFolder : customDrumkitFolders ) {
 		for ( const auto& sDrumkitName : Filesystem::drumkit_list( sDrumkitFolder ) ) {
 			drumkitPaths << QDir( sDrumkitFolder ).absoluteFilePath( sDrumkitName );
 		}
 	}
+	drumkitPaths.removeDuplicates();
 
+	QSet<QString> drumkitPathSet;
+	std::vector<QDateTime> allTimestamps;
 	for ( const auto& sDrumkitPath : drumkitPaths ) {
-		auto pDrumkit = Drumkit::load( sDrumkitPath );
-		if ( pDrumkit != nullptr ) {
-			if ( m_drumkitDatabase.find( sDrumkitPath ) !=
-				 m_drumkitDatabase.end() ) {
-				ERRORLOG( QString( "A drumkit was already loaded from [%1]. Something went wrong." )
-						  .arg( sDrumkitPath ) );
+		drumkitPathSet.insert( sDrumkitPath );
+		allTimestamps.push_back(
+			lastModified( Filesystem::drumkit_file( sDrumkitPath ) ) );
+	}
+
+	bool bChanged = false;
+	QStringList drumkitsToLoad;
+	std::vector<QDateTime> timestamps;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+
+		// Remove kits which are not present anymore.
+		for ( auto it = m_drumkitDatabase.begin(); it != m_drumkitDatabase.end(); ) {
+			if ( ! drumkitPathSet.contains( it->first ) ) {
+				INFOLOG( QString( "Drumkit [%1] removed from [%2]" )
+						 .arg( it->second->getName() ).arg( it->first ) );
+				m_drumkitTimestamps.erase( it->first );
+				m_drumkitUniqueLabels.erase( it->first );
+				it = m_drumkitDatabase.erase( it );
+				bChanged = true;
+			}
+			else {
+				++it;
+			}
+		}
+
+		// Only kits which are new or were modified have to be loaded.
+		for ( int ii = 0; ii < drumkitPaths.size(); ++ii ) {
+			const auto& sDrumkitPath = drumkitPaths[ ii ];
+			const auto& timestamp = allTimestamps[ ii ];
+			const auto it = m_drumkitTimestamps.find( sDrumkitPath );
+			if ( timestamp.isValid() && it != m_drumkitTimestamps.end() &&
+				 it->second == timestamp ) {
 				continue;
 			}
+			drumkitsToLoad << sDrumkitPath;
+			timestamps.push_back( timestamp );
+		}
+	}
+
+	if ( drumkitsToLoad.isEmpty() ) {
+		return bChanged;
+	}
+
+	// Loading takes a while. The database stays accessible meanwhile.
+	const auto drumkits = loadDrumkits( drumkitsToLoad );
 
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	// Kits are registered in the order they were found in order to keep
+	// the unique labels stable.
+	for ( int ii = 0; ii < drumkitsToLoad.size(); ++ii ) {
+		const auto& sDrumkitPath = drumkitsToLoad[ ii ];
+		const auto& pDrumkit = drumkits[ ii ];
+		if ( pDrumkit != nullptr ) {
 			INFOLOG( QString( "Drumkit [%1] loaded from [%2]" )
 					 .arg( pDrumkit->getName() ).arg( sDrumkitPath ) );
 
 			m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+			m_drumkitTimestamps[ sDrumkitPath ] = timestamps[ ii ];
 			registerUniqueLabel( sDrumkitPath, pDrumkit );
+			bChanged = true;
 		}
 		else {
 			ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
+			if ( m_drumkitDatabase.erase( sDrumkitPath ) > 0 ) {
+				m_drumkitTimestamps.erase( sDrumkitPath );
+				m_drumkitUniqueLabels.erase( sDrumkitPath );
+				bChanged = true;
+			}
 		}
 	}
 
-	if ( bTriggerEvent ) {
-		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
+	INFOLOG( QString( "[%1] of [%2] drumkits (re)loaded" )
+			 .arg( drumkitsToLoad.size() ).arg( drumkitPaths.size() ) );
+
+	return bChanged;
+}
+
+std::vector<std::shared_ptr<Drumkit>> SoundLibraryDatabase::loadDrumkits(
+	const QStringList& drumkitPaths ) {
+
+	std::vector<std::shared_ptr<Drumkit>> drumkits( drumkitPaths.size(), nullptr );
+
+	// Kits are independent of each other. Each worker picks the next kit
+	// not claimed yet till all are done.
+	std::atomic<int> nNextKit( 0 );
+	auto loadKits = [&]() {
+		int nKit;
+		while ( ( nKit = nNextKit++ ) < drumkitPaths.size() ) {
+			drumkits[ nKit ] = Drumkit::load( drumkitPaths.at( nKit ) );
+		}
+	};
+
+	// The calling thread loads kits as well.
+	const int nCores = static_cast<int>(std::thread::hardware_concurrency());
+	const int nWorkers = std::min( nCores, drumkitPaths.size() ) - 1;
+	std::vector<std::thread> workers;
+	for ( int ii = 0; ii < nWorkers; ++ii ) {
+		workers.push_back( std::thread( loadKits ) );
+	}
+	loadKits();
+	for ( auto& worker : workers ) {
+		worker.join();
+	}
+
+	return drumkits;
+}
+
+QDateTime SoundLibraryDatabase::lastModified( const QString& sPath ) {
+	const QFileInfo info( sPath );
+	if ( ! info.exists() ) {
+		return QDateTime();
 	}
+	return info.lastModified();
 }
 
 void SoundLibraryDatabase::updateDrumkit( const QString& sDrumkitPath, bool bTriggerEvent ) {
 
+	const auto timestamp =
+		lastModified( Filesystem::drumkit_file( sDrumkitPath ) );
 	auto pDrumkit = Drumkit::load( sDrumkitPath );
 	if ( pDrumkit != nullptr ) {
+		std::lock_guard<std::mutex> lock( m_mutex );
 		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+		m_drumkitTimestamps[ sDrumkitPath ] = timestamp;
 		registerUniqueLabel( sDrumkitPath, pDrumkit );
 	}
 	else {
 		ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
 	}
 
+	updateWatchedDirectories();
+
 	if ( bTriggerEvent ) {
 		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
 	}
@@ -174,34 +313,49 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getDrumkit( const QString& sDrumk
 		return nullptr;
 	}
 
-	if ( m_drumkitDatabase.find( sDrumkitPath ) ==
-		 m_drumkitDatabase.end() ) {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		const auto it = m_drumkitDatabase.find( sDrumkitPath );
+		if ( it != m_drumkitDatabase.end() ) {
+			return it->second;
+		}
+	}
+
+	// Drumkit is not present in database yet. We attempt to load
+	// and add it. Loading is done without holding the lock.
+	const auto timestamp =
+		lastModified( Filesystem::drumkit_file( sDrumkitPath ) );
+	auto pDrumkit = Drumkit::load( sDrumkitPath,
+								   true, // upgrade
+								   false // bSilent
+								   );
+	if ( pDrumkit == nullptr ) {
+		return nullptr;
+	}
 
-		// Drumkit is not present in database yet. We attempt to load
-		// and add it.
-		auto pDrumkit = Drumkit::load( sDrumkitPath,
-									   true, // upgrade
-									   false // bSilent
-									   );
-		if ( pDrumkit == nullptr ) {
-			return nullptr;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		const auto it = m_drumkitDatabase.find( sDrumkitPath );
+		if ( it != m_drumkitDatabase.end() ) {
+			// Added by another thread in the meantime.
+			return it->second;
 		}
 
 		m_customDrumkitPaths << sDrumkitPath;
 
 		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+		m_drumkitTimestamps[ sDrumkitPath ] = timestamp;
 		registerUniqueLabel( sDrumkitPath, pDrumkit );
-		
-		INFOLOG( QString( "Session Drumkit [%1] loaded from [%2]" )
-				  .arg( pDrumkit->getName() )
-				  .arg( sDrumkitPath ) );
-
-		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
-		
-		return pDrumkit;
 	}
-	
-	return m_drumkitDatabase.at( sDrumkitPath );
+	updateWatchedDirectories();
+
+	INFOLOG( QString( "Session Drumkit [%1] loaded from [%2]" )
+			  .arg( pDrumkit->getName() )
+			  .arg( sDrumkitPath ) );
+
+	EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
+
+	return pDrumkit;
 }
 
 std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() const {
@@ -213,10 +367,11 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() const {
 		return nullptr;
 	}
 
-	const auto sLastLoadedDrumkitPath = pSong->getLastLoadedDrumkitPath();
-	const auto search = m_drumkitDatabase.find( sLastLoadedDrumkitPath );
+	const auto sCurrentDrumkitPath = getCurrentDrumkitPath();
+	std::lock_guard<std::mutex> lock( m_mutex );
+	const auto search = m_drumkitDatabase.find( sCurrentDrumkitPath );
 
-	if ( sLastLoadedDrumkitPath.isEmpty() || search == m_drumkitDatabase.end() ) {
+	if ( sCurrentDrumkitPath.isEmpty() || search == m_drumkitDatabase.end() ) {
 		// In case we do not find the last loaded kit, we start at the top.
 		return m_drumkitDatabase.begin()->second;
 	}
@@ -238,11 +393,12 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() const {
 		return nullptr;
 	}
 
-	const auto sLastLoadedDrumkitPath = pSong->getLastLoadedDrumkitPath();
-	const auto search = m_drumkitDatabase.find( sLastLoadedDrumkitPath );
+	const auto sCurrentDrumkitPath = getCurrentDrumkitPath();
+	std::lock_guard<std::mutex> lock( m_mutex );
+	const auto search = m_drumkitDatabase.find( sCurrentDrumkitPath );
 
-	if ( sLastLoadedDrumkitPath.isEmpty() || search == m_drumkitDatabase.end() ||
-		 std::next( m_drumkitDatabase.find( sLastLoadedDrumkitPath ), 1 ) ==
+	if ( sCurrentDrumkitPath.isEmpty() || search == m_drumkitDatabase.end() ||
+		 std::next( m_drumkitDatabase.find( sCurrentDrumkitPath ), 1 ) ==
 		 m_drumkitDatabase.end() ) {
 		// In case we do not find the last loaded kit or it is located at the
 		// very bottom, we start at the top.
@@ -252,6 +408,24 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() const {
 	return std::next( search, 1 )->second;
 }
 
+QString SoundLibraryDatabase::getCurrentDrumkitPath() {
+	auto pHydrogen = H2Core::Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr ) {
+		return "";
+	}
+
+	auto pDrumkitSwitcher = pHydrogen->getDrumkitSwitcher();
+	if ( pDrumkitSwitcher != nullptr ) {
+		const auto pPendingDrumkit = pDrumkitSwitcher->getPendingDrumkit();
+		if ( pPendingDrumkit != nullptr ) {
+			return pPendingDrumkit->getPath();
+		}
+	}
+
+	return pSong->getLastLoadedDrumkitPath();
+}
+
 void SoundLibraryDatabase::registerUniqueLabel( const QString& sDrumkitPath,
 												std::shared_ptr<Drumkit> pDrumkit ) {
 
@@ -301,16 +475,23 @@ void SoundLibraryDatabase::registerUniqueLabel( const QString& sDrumkitPath,
 }
 
 QString SoundLibraryDatabase::getUniqueLabel( const QString& sDrumkitPath ) const {
+	std::lock_guard<std::mutex> lock( m_mutex );
 	return m_drumkitUniqueLabels.at( sDrumkitPath );
 }
 
 void SoundLibraryDatabase::registerDrumkitFolder( const QString& sDrumkitFolder ) {
+	std::lock_guard<std::mutex> lock( m_mutex );
 	if ( ! m_customDrumkitFolders.contains( sDrumkitFolder ) ) {
 		m_customDrumkitFolders << sDrumkitFolder;
 	}
 }
 
 QStringList SoundLibraryDatabase::getDrumkitFolders() const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return getDrumkitFoldersUnlocked();
+}
+
+QStringList SoundLibraryDatabase::getDrumkitFoldersUnlocked() const {
 	QStringList drumkitFolders( m_customDrumkitFolders );
 
 	drumkitFolders << Filesystem::sys_drumkits_dir()
@@ -321,6 +502,7 @@ QStringList SoundLibraryDatabase::getDrumkitFolders() const {
 
 std::set<DrumkitMap::Type> SoundLibraryDatabase::getAllTypes() const {
 	std::set<DrumkitMap::Type> allTypes;
+	std::lock_guard<std::mutex> lock( m_mutex );
 	for ( const auto& [ _, ppDrumkit ] : m_drumkitDatabase ) {
 		if ( ppDrumkit != nullptr ) {
 			allTypes.merge( ppDrumkit->getAllTypes() );
@@ -332,6 +514,19 @@ std::set<DrumkitMap::Type> SoundLibraryDatabase::getAllTypes() const {
 
 void SoundLibraryDatabase::updatePatterns( bool bTriggerEvent )
 {
+	scanPatterns();
+	updateWatchedDirectories();
+
+	if ( bTriggerEvent ) {
+		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
+	}
+}
+
+bool SoundLibraryDatabase::scanPatterns()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	const auto previousPatternInfos = m_patternInfoVector;
+
 	m_patternInfoVector.clear();
 	m_patternCategories = QStringList();
 
@@ -342,34 +537,152 @@ void SoundLibraryDatabase::updatePatterns( bool bTriggerEvent )
 	// search patterns user directory
 	loadPatternFromDirectory( Filesystem::patterns_dir() );
 
-	if ( bTriggerEvent ) {
-		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
+	// Drop patterns which are not present anymore.
+	QSet<QString> patternPaths;
+	for ( const auto& ppInfo : m_patternInfoVector ) {
+		patternPaths.insert( ppInfo->getPath() );
+	}
+	for ( auto it = m_patternCache.begin(); it != m_patternCache.end(); ) {
+		if ( ! patternPaths.contains( it->first ) ) {
+			it = m_patternCache.erase( it );
+		}
+		else {
+			++it;
+		}
 	}
+
+	// Unchanged patterns are reused from the cache. Comparing the
+	// pointers is thus sufficient.
+	return previousPatternInfos != m_patternInfoVector;
 }
 
 void SoundLibraryDatabase::loadPatternFromDirectory( const QString& sPatternDir )
 {
 	foreach ( const QString& sName, Filesystem::pattern_list( sPatternDir ) ) {
 		QString sFile = sPatternDir + sName;
-		std::shared_ptr<SoundLibraryInfo> pInfo =
-			std::make_shared<SoundLibraryInfo>();
+		const auto timestamp = lastModified( sFile );
+
+		std::shared_ptr<SoundLibraryInfo> pInfo = nullptr;
+		const auto it = m_patternCache.find( sFile );
+		if ( it != m_patternCache.end() && it->second.first == timestamp ) {
+			pInfo = it->second.second;
+		}
+		else {
+			pInfo = std::make_shared<SoundLibraryInfo>();
+			if ( ! pInfo->load( sFile ) ) {
+				continue;
+			}
 
-		if ( pInfo->load( sFile ) ) {
 			INFOLOG( QString( "Pattern [%1] of category [%2] loaded from [%3]" )
 					 .arg( pInfo->getName() ).arg( pInfo->getCategory() )
 					 .arg( sFile ) );
-			
-			m_patternInfoVector.push_back( pInfo );
+			m_patternCache[ sFile ] = std::make_pair( timestamp, pInfo );
+		}
+
+		m_patternInfoVector.push_back( pInfo );
 		
-			if ( ! m_patternCategories.contains( pInfo->getCategory() ) ) {
-				m_patternCategories << pInfo->getCategory();
-			}
+		if ( ! m_patternCategories.contains( pInfo->getCategory() ) ) {
+			m_patternCategories << pInfo->getCategory();
+		}
+	}
+}
+
+void SoundLibraryDatabase::updateWatchedDirectories() {
+	if ( QThread::currentThread() != m_pWatcher->thread() ) {
+		// Updates triggered by e.g. OSC commands. The watcher itself
+		// will pick up the new directories during its next update.
+		return;
+	}
+
+	QSet<QString> directories;
+	auto addDirectory = [&]( const QString& sPath ) {
+		const QDir dir( sPath );
+		if ( dir.exists() ) {
+			directories.insert( dir.absolutePath() );
+		}
+	};
+
+	// Folders containing kits are watched for kits being added or
+	// removed and the kits themselves for changes of their definition.
+	QStringList drumkitDirectories;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		drumkitDirectories = getDrumkitFoldersUnlocked();
+		for ( const auto& [ ssPath, _ ] : m_drumkitDatabase ) {
+			drumkitDirectories << ssPath;
+		}
+	}
+	for ( const auto& sPath : drumkitDirectories ) {
+		addDirectory( sPath );
+	}
+
+	addDirectory( Filesystem::patterns_dir() );
+	for ( const auto& sDrumkit : Filesystem::pattern_drumkits() ) {
+		addDirectory( Filesystem::patterns_dir( sDrumkit ) );
+	}
+
+	QSet<QString> watched;
+	for ( const auto& sPath : m_pWatcher->directories() ) {
+		watched.insert( sPath );
+	}
+
+	QStringList obsolete;
+	for ( const auto& sPath : watched ) {
+		if ( ! directories.contains( sPath ) ) {
+			obsolete << sPath;
+		}
+	}
+	QStringList added;
+	for ( const auto& sPath : directories ) {
+		if ( ! watched.contains( sPath ) ) {
+			added << sPath;
+		}
+	}
+
+	if ( obsolete.size() > 0 ) {
+		m_pWatcher->removePaths( obsolete );
+	}
+	if ( added.size() > 0 ) {
+		const auto failed = m_pWatcher->addPaths( added );
+		if ( failed.size() > 0 ) {
+			WARNINGLOG( QString( "Unable to watch [%1]" ).arg( failed.join( ", " ) ) );
 		}
 	}
 }
 
+void SoundLibraryDatabase::onDirectoryChanged( const QString& sPath ) {
+	if ( sPath.startsWith( QDir( Filesystem::patterns_dir() ).absolutePath() ) ) {
+		m_bPatternFoldersChanged = true;
+	}
+	else {
+		m_bDrumkitFoldersChanged = true;
+	}
+
+	m_pUpdateTimer->start();
+}
+
+void SoundLibraryDatabase::onUpdateTimeout() {
+	bool bChanged = false;
+	if ( m_bPatternFoldersChanged ) {
+		m_bPatternFoldersChanged = false;
+		bChanged = scanPatterns() || bChanged;
+	}
+	if ( m_bDrumkitFoldersChanged ) {
+		m_bDrumkitFoldersChanged = false;
+		bChanged = scanDrumkits() || bChanged;
+	}
+
+	updateWatchedDirectories();
+
+	if ( bChanged ) {
+		INFOLOG( "Sound library changed on disk" );
+		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
+	}
+}
+
 QString SoundLibraryDatabase::toQString( const QString& sPrefix, bool bShort ) const {
 	QString s = Base::sPrintIndention;
+	std::lock_guard<std::mutex> lock( m_mutex );
 	QString sOutput;
 	if ( ! bShort ) {
 		sOutput = QString( "%1[SoundLibraryDatabase]\n" ).arg( sPrefix )
@@ -378,6 +691,11 @@ QString SoundLibraryDatabase::toQString( const QString& sPrefix, bool bShort ) c
 			sOutput.append( QString( "%1%2%2%3: %4\n" ).arg( sPrefix ).arg( s )
 							.arg( ssPath ).arg( ddrumkit->toQString( "", true ) ) );
 		}
+		sOutput.append( QString( "%1%2m_drumkitTimestamps:\n" ).arg( sPrefix ).arg( s ) );
+		for ( const auto& [ ssPath, ttimestamp ] : m_drumkitTimestamps ) {
+			sOutput.append( QString( "%1%2%2%3: %4\n" ).arg( sPrefix ).arg( s )
+							.arg( ssPath ).arg( ttimestamp.toString( Qt::ISODateWithMs ) ) );
+		}
 		sOutput.append( QString( "%1%2m_drumkitUniqueLabels:\n" ).arg( sPrefix ).arg( s ) );
 		for ( const auto& [ ssPath, ssLabel ] : m_drumkitUniqueLabels ) {
 			sOutput.append( QString( "%1%2%2%3: %4\n" ).arg( sPrefix ).arg( s )
@@ -27,11 +27,16 @@
 #include <core/Basics/DrumkitMap.h>
 #include <core/SoundLibrary/SoundLibraryInfo.h>
 #include <core/Object.h>
+#include <QDateTime>
 #include <QStringList>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+class QFileSystemWatcher;
+class QTimer;
+
 namespace H2Core
 {
 /**
@@ -41,6 +46,17 @@ namespace H2Core
 *
 * This class organizes the metadata of all locally installed soundlibrary items.
 *
+* Updates are incremental. Drumkits and patterns are only (re)loaded in
+* case their files were added or modified on disk since the last
+* update. Kits are loaded in parallel. In addition, all drumkit and
+* pattern folders are watched and the database updates itself whenever
+* their content changes (requires a running Qt event loop).
+*
+* The database is accessed from the GUI, the OSC server, and worker
+* threads loading songs (see #PlaylistPreloader). All members are
+* guarded by #m_mutex. Kits are loaded from disk without holding it and
+* the database itself is only handed out as a copy.
+*
 * @author Sebastian Moors
 *
 */
@@ -57,15 +73,21 @@ class SoundLibraryDatabase :    public H2Core::Object<SoundLibraryDatabase>
 		static QString m_sPatternBaseCategory;
 
 	std::vector<std::shared_ptr<SoundLibraryInfo>> getPatternInfoVector() const {
+		std::lock_guard<std::mutex> lock( m_mutex );
 		return m_patternInfoVector;
 	}
 	QStringList getPatternCategories() const {
+		std::lock_guard<std::mutex> lock( m_mutex );
 		return m_patternCategories;
 	}
 
 	void update();
 
+	/** Rescans all drumkit folders. Only kits which are new or whose
+	 * drumkit.xml file was modified since the last update will be
+	 * loaded from disk. Kits no longer present will be removed. */
 	void updateDrumkits( bool bTriggerEvent = true );
+	/** Reloads the kit located at @a sDrumkitPath unconditionally. */
 	void updateDrumkit( const QString& sDrumkitPath, bool bTriggerEvent = true );
 	/**
 	 * Retrieve a drumkit from the database.
@@ -79,14 +101,19 @@ class SoundLibraryDatabase :    public H2Core::Object<SoundLibraryDatabase>
 
 		/** Based on #Song::m_sLastLoadedDrumkitPath get the previous drumkit in
 		 * the data base (the one shown above the last loaded one in the Sound
-		 * Library widget) */
+		 * Library widget). In case a switch is pending in the
+		 * #DrumkitSwitcher, the requested kit is used instead. */
 		std::shared_ptr<Drumkit> getPreviousDrumkit() const;
 		/** Based on #Song::m_sLastLoadedDrumkitPath get the next drumkit in the
 		 * data base (the one shown below the last loaded one in the Sound
-		 * Library widget) */
+		 * Library widget). In case a switch is pending in the
+		 * #DrumkitSwitcher, the requested kit is used instead. */
 		std::shared_ptr<Drumkit> getNextDrumkit() const;
 
-	const std::map<QString, std::shared_ptr<Drumkit>>& getDrumkitDatabase() const {
+	/** \return A copy of the database as it might be altered by other
+	 * threads while being iterated. */
+	std::map<QString, std::shared_ptr<Drumkit>> getDrumkitDatabase() const {
+		std::lock_guard<std::mutex> lock( m_mutex );
 		return m_drumkitDatabase;
 	}
 		/** Retrieves an unique label for the kit associated with @a
@@ -108,9 +135,10 @@ class SoundLibraryDatabase :    public H2Core::Object<SoundLibraryDatabase>
 	 * @return The list of unique types sorted alphabetically.*/
 	 std::set<DrumkitMap::Type> getAllTypes() const;
 	
+	/** Rescans all pattern folders. Only patterns which are new or
+	 * were modified since the last update are parsed. */
 	void updatePatterns( bool bTriggerEvent = true );
 	void printPatterns() const;
-	void loadPatternFromDirectory( const QString& path );
 	bool isPatternInstalled( const QString& sPatternName ) const;
 
 	/** Formatted string version for debugging purposes.
@@ -124,9 +152,47 @@ class SoundLibraryDatabase :    public H2Core::Object<SoundLibraryDatabase>
 	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 
 private:
+		/** Requires #m_mutex to be locked. */
+		void loadPatternFromDirectory( const QString& path );
+		/** Requires #m_mutex to be locked. */
 		void registerUniqueLabel( const QString& sDrumkitPath,
 								  std::shared_ptr<Drumkit> pDrumkit );
 
+		/** \return true in case at least one kit was added, changed, or
+		 * removed. */
+		bool scanDrumkits();
+		/** \return true in case at least one pattern was added, changed,
+		 * or removed. */
+		bool scanPatterns();
+		/** Requires #m_mutex to be locked. */
+		QStringList getDrumkitFoldersUnlocked() const;
+		/** Path of the kit getPreviousDrumkit() and getNextDrumkit()
+		 * are relative to. This way several requests in a row step
+		 * through the kits even if they are not switched to yet.
+		 *
+		 * \return Empty string in case there is no song. */
+		static QString getCurrentDrumkitPath();
+		/** Loads all kits in @a drumkitPaths using a pool of worker
+		 * threads.
+		 *
+		 * \return Kits in the same order as @a drumkitPaths. An element
+		 * is nullptr in case the corresponding kit could not be
+		 * loaded. */
+		static std::vector<std::shared_ptr<Drumkit>> loadDrumkits(
+			const QStringList& drumkitPaths );
+		/** Modification time of the definition file of a kit or pattern.
+		 * Invalid in case it does not exist. */
+		static QDateTime lastModified( const QString& sPath );
+
+		/** Aligns the directories observed by #m_pWatcher with the
+		 * current content of the database. */
+		void updateWatchedDirectories();
+		/** Called by #m_pWatcher. The update itself is deferred by
+		 * #m_pUpdateTimer since a single install or removal of a kit
+		 * triggers a burst of notifications. */
+		void onDirectoryChanged( const QString& sPath );
+		void onUpdateTimeout();
+
 	std::map<QString, std::shared_ptr<Drumkit>> m_drumkitDatabase;
 		/** The absolute path to a drumkit folder is not the most accessible way
 		 * to refer to a kit in the GUI. Instead, each kit will also have an
@@ -139,6 +205,15 @@ private:
 		 * */
 		std::map<QString, QString> m_drumkitUniqueLabels;
 
+		/** Modification time of the drumkit.xml file of each kit in
+		 * #m_drumkitDatabase at the time it was loaded. */
+		std::map<QString, QDateTime> m_drumkitTimestamps;
+
+		/** All patterns parsed so far and the modification time of
+		 * their file at that time. Keyed by absolute file path. */
+		std::map<QString, std::pair<QDateTime,
+									std::shared_ptr<SoundLibraryInfo>>> m_patternCache;
+
 	std::vector<std::shared_ptr<SoundLibraryInfo>> m_patternInfoVector;
 	QStringList m_patternCategories;
 
@@ -154,6 +229,16 @@ private:
 		/** Whole folders that will be scanned for drumkits in addition to the
 		 * system and user drumkti folder. */
 		QStringList m_customDrumkitFolders;
+
+		/** Guards all members except of #m_pWatcher and
+		 * #m_pUpdateTimer, which are only used by the thread the
+		 * database was created in. */
+		mutable std::mutex m_mutex;
+
+		std::unique_ptr<QFileSystemWatcher> m_pWatcher;
+		std::unique_ptr<QTimer> m_pUpdateTimer;
+		bool m_bDrumkitFoldersChanged;
+		bool m_bPatternFoldersChanged;
 };
 }; // namespace H2Core
 
@@ -55,4 +55,30 @@
 	#define RTCLOCK_MS -1
 #endif
 
+#include <cstdint>
+#ifdef WIN32
+	#include <chrono>
+#else
+	#include <time.h>
+#endif
+
+/** \return Monotonic time stamp in nanoseconds.
+ *
+ * In contrast to the macros above it is available in all builds and
+ * cheap enough to be called within the audio thread (clock_gettime()
+ * is served by the vDSO on Linux).*/
+inline uint64_t rtClockNs()
+{
+#ifdef WIN32
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#else
+	struct timespec t;
+	clock_gettime( CLOCK_MONOTONIC, &t );
+	return static_cast<uint64_t>(t.tv_sec) * 1000000000ULL +
+		static_cast<uint64_t>(t.tv_nsec);
+#endif
+}
+
 #endif // H2_RTCLOCK_H
@@ -0,0 +1,78 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef DAMAGE_REGION_H
+#define DAMAGE_REGION_H
+
+#include <QRect>
+#include <QRegion>
+
+//! Parts of a cached pixmap which have to be repainted.
+//!
+//! Widgets with large cached pixmaps (e.g. the SongEditor or the
+//! DrumPatternEditor) do not redraw them entirely on every
+//! modification. Instead, the rectangles affected by a change are
+//! reported using invalidate(). These are snapped to a fixed grid of
+//! tiles, so the resulting region stays simple even after many small
+//! invalidations. During the next paint event the owner redraws the
+//! tiles in region() - with its painter clipped to them - and clear()s
+//! the damage.
+//!
+//! Invalidation of the whole pixmap is still handled by the owning
+//! widget itself (e.g. using its background invalid flag).
+/** \ingroup docGUI*/
+class DamageRegion {
+public:
+	//! Edge length of a single tile in device-independent pixels.
+	static constexpr int nTileSize = 128;
+
+	void invalidate( const QRect& rect ) {
+		if ( rect.isEmpty() ) {
+			return;
+		}
+		const int nLeft = floorToTile( rect.left() );
+		const int nTop = floorToTile( rect.top() );
+		const int nRight = floorToTile( rect.right() ) + nTileSize;
+		const int nBottom = floorToTile( rect.bottom() ) + nTileSize;
+		m_region += QRect( nLeft, nTop, nRight - nLeft, nBottom - nTop );
+	}
+	void clear() {
+		m_region = QRegion();
+	}
+	bool isEmpty() const {
+		return m_region.isEmpty();
+	}
+	//! Tile-aligned region which has to be repainted.
+	const QRegion& region() const {
+		return m_region;
+	}
+
+private:
+	static int floorToTile( int nValue ) {
+		const int nRemainder = nValue % nTileSize;
+		return nRemainder >= 0 ? nValue - nRemainder :
+			nValue - nRemainder - nTileSize;
+	}
+
+	QRegion m_region;
+};
+
+#endif // DAMAGE_REGION_H
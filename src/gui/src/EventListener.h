@@ -57,7 +57,7 @@ class EventListener
 		virtual void loopModeActivationEvent(){}
 		virtual void updatePreferencesEvent( int nValue ){ UNUSED( nValue ); }
 		virtual void actionModeChangeEvent( int nValue ){ UNUSED( nValue ); }
-    	virtual void gridCellToggledEvent(){}
+    	virtual void gridCellToggledEvent( int nColumn ){ UNUSED( nColumn ); }
 	virtual void drumkitLoadedEvent(){}
 	virtual void patternEditorLockedEvent(){}
 	virtual void relocationEvent(){}
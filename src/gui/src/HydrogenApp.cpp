@@ -983,7 +983,7 @@ void HydrogenApp::onEventQueueTimer()
 				break;
 
 			case EVENT_GRID_CELL_TOGGLED:
-				pListener->gridCellToggledEvent();
+				pListener->gridCellToggledEvent( event.value );
 				break;
 
 			case EVENT_DRUMKIT_LOADED:
@@ -1001,6 +1001,10 @@ void InstrumentEditor::removeLayerButtonClicked()
 
 	auto pCompo = m_pInstrument->get_component( m_nSelectedComponent );
 	if ( pCompo != nullptr ) {
+		auto pOldLayer = pCompo->getLayer( m_nSelectedLayer );
+		if ( pOldLayer != nullptr ) {
+			pHydrogen->addSampleToDeathRow( pOldLayer->get_sample() );
+		}
 		pCompo->setLayer( nullptr, m_nSelectedLayer );
 
 		pHydrogen->setIsModified( true );
@@ -1131,7 +1135,9 @@ void InstrumentEditor::loadLayerBtnClicked()
 			auto pLayer = pCompo->getLayer( selectedLayer );
 
 			if ( pLayer != nullptr ) {
-				// insert new sample from newInstrument, old sample gets deleted by set_sample
+				// insert new sample from newInstrument. The old one is
+				// released once no note is rendering it anymore.
+				pHydrogen->addSampleToDeathRow( pLayer->get_sample() );
 				pLayer->set_sample( pNewSample );
 			}
 			else {
@@ -1197,6 +1203,7 @@ void InstrumentEditor::setAutoVelocity()
 			++nLayer;
 		}
 	}
+	pCompo->updateLayerSelection();
 }
 
 void InstrumentEditor::renameComponentAction()
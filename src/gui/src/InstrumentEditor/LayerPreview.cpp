@@ -375,7 +375,8 @@ void LayerPreview::mouseMoveEvent( QMouseEvent *ev )
 		return;
 	}
 	if ( m_bMouseGrab ) {
-		auto pLayer = m_pInstrument->get_component( m_nSelectedComponent )->getLayer( m_nSelectedLayer );
+		auto pCompo = m_pInstrument->get_component( m_nSelectedComponent );
+		auto pLayer = pCompo->getLayer( m_nSelectedLayer );
 		if ( pLayer ) {
 			if ( m_bMouseGrab ) {
 				bool bChanged = false;
@@ -395,6 +396,7 @@ void LayerPreview::mouseMoveEvent( QMouseEvent *ev )
 				}
 
 				if ( bChanged ) {
+					pCompo->updateLayerSelection();
 					update();
 					Hydrogen::get_instance()->setIsModified( true );
 				}
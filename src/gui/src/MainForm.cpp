@@ -34,6 +34,7 @@
 #include <core/Basics/Playlist.h>
 #include <core/EventQueue.h>
 #include <core/H2Exception.h>
+#include <core/Helpers/AutoSaver.h>
 #include <core/Helpers/Files.h>
 #include <core/Hydrogen.h>
 #include <core/IO/MidiCommon.h>
@@ -97,6 +98,7 @@ MainForm::MainForm( QApplication * pQApplication, const QString& sSongFilename,
 					const QString& sPlaylistFilename )
 	: QMainWindow( nullptr )
 	, m_sPreviousAutoSaveSongFile( "" )
+	, m_pAutoSaver( std::make_unique<AutoSaver>() )
 {
 	const auto pPref = H2Core::Preferences::get_instance();
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
@@ -753,9 +755,7 @@ void MainForm::action_file_new()
 	QFileInfo autoSaveFile( QString( "%1/.%2.autosave%3" )
 							.arg( fileInfo.absoluteDir().absolutePath() )
 							.arg( sBaseName ).arg( Filesystem::songs_ext ) );
-	if ( autoSaveFile.exists() ) {
-		Filesystem::rm( autoSaveFile.absoluteFilePath() );
-	}
+	m_pAutoSaver->remove( autoSaveFile.absoluteFilePath() );
 	
 	HydrogenApp::openSong( pSong );
 
@@ -862,11 +862,8 @@ bool MainForm::action_file_save_as()
 			// autosave file corresponding to the empty one. Else, it might be
 			// loaded later when clicking "New Song" while not generating a new
 			// autosave file.
-			const QString sAutoSaveFile = Filesystem::getAutoSaveFilename(
-				Filesystem::Type::Song, sLastFilename );
-			if ( Filesystem::file_exists( sAutoSaveFile, true ) ) {
-				Filesystem::rm( sAutoSaveFile );
-			}
+			m_pAutoSaver->remove( Filesystem::getAutoSaveFilename(
+				Filesystem::Type::Song, sLastFilename ) );
 		}
 	}
 
@@ -928,6 +925,17 @@ bool MainForm::action_file_save( const QString& sNewFilename )
 		return false;
 	}
 
+	// An autosave job queued right before saving could still be written
+	// afterwards. The autosave file would then be newer than the song and
+	// we would offer to recover it on the next load.
+	m_pAutoSaver->remove( Filesystem::getAutoSaveFilename(
+		Filesystem::Type::Song,
+		sNewFilename.isEmpty() ? sFilename : sNewFilename ) );
+	if ( ! m_sPreviousAutoSaveSongFile.isEmpty() ) {
+		m_pAutoSaver->remove( m_sPreviousAutoSaveSongFile );
+		m_sPreviousAutoSaveSongFile = "";
+	}
+
 	h2app->showStatusBarMessage( tr("Song saved into") + QString(": ") +
 									 sFilename );
 	return true;
@@ -2142,43 +2150,34 @@ void MainForm::onAutoSaveTimer()
 	auto pSong = pHydrogen->getSong();
 	auto pPlaylist = pHydrogen->getPlaylist();
 
+	// Only the XML documents are assembled in here. Serializing and
+	// writing them is done by the AutoSaver in the background, which
+	// also skips files whose content did not change.
 	if ( pSong != nullptr && pSong->getIsModified() ) {
-		const QString sOldFilename = pSong->getFilename();
-
 		const QString sAutoSaveFilename = Filesystem::getAutoSaveFilename(
 			Filesystem::Type::Song, pSong->getFilename() );
 		if ( sAutoSaveFilename != m_sPreviousAutoSaveSongFile ) {
 			if ( ! m_sPreviousAutoSaveSongFile.isEmpty() ) {
-				QFile file( m_sPreviousAutoSaveSongFile );
-				file.remove();
+				m_pAutoSaver->remove( m_sPreviousAutoSaveSongFile );
 			}
 			m_sPreviousAutoSaveSongFile = sAutoSaveFilename;
 		}
-			
-		pSong->save( sAutoSaveFilename );
 
-		pSong->setFilename( sOldFilename );
-		pSong->setIsModified( true );
+		m_pAutoSaver->save( sAutoSaveFilename, pSong->toXMLDoc( true ) );
 	}
 
 	if ( pPlaylist != nullptr && pPlaylist->getIsModified() ) {
-		const QString sOldFilename = pPlaylist->getFilename();
-
 		const QString sAutoSaveFilename = Filesystem::getAutoSaveFilename(
 			Filesystem::Type::Playlist, pPlaylist->getFilename() );
 		if ( sAutoSaveFilename != m_sPreviousAutoSavePlaylistFile ) {
 			if ( ! m_sPreviousAutoSavePlaylistFile.isEmpty() ) {
-				QFile file( m_sPreviousAutoSavePlaylistFile );
-				file.remove();
+				m_pAutoSaver->remove( m_sPreviousAutoSavePlaylistFile );
 			}
 			m_sPreviousAutoSavePlaylistFile = sAutoSaveFilename;
 		}
 
-		pPlaylist->saveAs( sAutoSaveFilename );
-
-		pPlaylist->setFilename( sOldFilename );
-		pPlaylist->setIsModified( true );
-
+		m_pAutoSaver->save( sAutoSaveFilename,
+							pPlaylist->toXMLDoc( sAutoSaveFilename ) );
 	}
 }
 
@@ -42,6 +42,7 @@ class InfoBar;
 class QUndoView;///debug only
 
 namespace H2Core {
+	class AutoSaver;
 	class Drumkit;
 }
 
@@ -89,6 +90,7 @@ class MainForm :  public QMainWindow,
 											  const QString& sContext );
 
 		void setPreviousAutoSavePlaylistFile( const QString& sFile );
+		H2Core::AutoSaver* getAutoSaver() const;
 
 		static void exportDrumkit( std::shared_ptr<H2Core::Drumkit> pDrumkit );
 		static bool switchDrumkit( std::shared_ptr<H2Core::Drumkit> pTargetKit );
@@ -323,6 +325,8 @@ public slots:
 		written unless we take care of them.*/
 	QString m_sPreviousAutoSaveSongFile;
 	QString m_sPreviousAutoSavePlaylistFile;
+	/** Serializes and writes the autosave files in the background. */
+	std::unique_ptr<H2Core::AutoSaver> m_pAutoSaver;
 
 	/**
 	 * Maps an incoming @a pKeyEvent to actions via #Shortcuts
@@ -337,4 +341,7 @@ public slots:
 inline void MainForm::setPreviousAutoSavePlaylistFile( const QString& sFile ) {
 	m_sPreviousAutoSavePlaylistFile = sFile;
 }
+inline H2Core::AutoSaver* MainForm::getAutoSaver() const {
+	return m_pAutoSaver.get();
+}
 #endif
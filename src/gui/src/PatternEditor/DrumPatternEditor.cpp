@@ -56,6 +56,7 @@ using namespace H2Core;
 
 DrumPatternEditor::DrumPatternEditor(QWidget* parent, PatternEditorPanel *panel)
  : PatternEditor( parent, panel )
+ , m_bOnlyDamagedRows( false )
 {
 	m_editor = PatternEditor::Editor::DrumPattern;
 	const auto pPref = H2Core::Preferences::get_instance();
@@ -80,9 +81,18 @@ void DrumPatternEditor::updateEditor( bool bPatternOnly )
 	if ( pAudioEngine->getState() != H2Core::AudioEngine::State::Ready &&
 		 pAudioEngine->getState() != H2Core::AudioEngine::State::Playing ) {
 		ERRORLOG( "FIXME: skipping pattern editor update (state should be READY or PLAYING)" );
+		// Rows damaged in the meantime are not tracked reliably
+		// anymore. The next update has to redraw everything.
+		m_damage.clear();
+		m_bOnlyDamagedRows = false;
+		invalidateBackground();
 		return;
 	}
 
+	const uint nOldEditorWidth = m_nEditorWidth;
+	const int nOldActiveWidth = m_nActiveWidth;
+	const uint nOldEditorHeight = m_nEditorHeight;
+
 	updatePatternInfo();
 	updateWidth();
 
@@ -95,11 +105,30 @@ void DrumPatternEditor::updateEditor( bool bPatternOnly )
 	}
 	resize( m_nEditorWidth, m_nEditorHeight );
 
-	// redraw all
-	invalidateBackground();
+	if ( ! m_bOnlyDamagedRows ||
+		 nOldEditorWidth != m_nEditorWidth ||
+		 nOldActiveWidth != m_nActiveWidth ||
+		 nOldEditorHeight != m_nEditorHeight ) {
+		// redraw all
+		invalidateBackground();
+	}
+	m_bOnlyDamagedRows = false;
 	update();
 }
 
+void DrumPatternEditor::invalidateRow( int nRow ) {
+	if ( nRow < 0 ) {
+		return;
+	}
+
+	// Notes can affect the whole row, e.g. the tail of all preceding
+	// ones when adding a note-off or the "2x" marker left of
+	// superimposed ones.
+	m_damage.invalidate( QRect( 0, nRow * m_nGridHeight,
+								m_nEditorWidth + 1, m_nGridHeight + 1 ) );
+	m_bOnlyDamagedRows = true;
+}
+
 
 void DrumPatternEditor::addOrRemoveNote( int nColumn, int nRealColumn, int nRow,
 										 bool bDoAdd, bool bDoDelete,
@@ -462,6 +491,7 @@ void DrumPatternEditor::addOrDeleteNoteAction(	int nColumn,
 	pHydrogen->setIsModified( true );
 	m_pAudioEngine->unlock(); // unlock the audio engine
 
+	invalidateRow( nInstrumentRow );
 	m_pPatternEditorPanel->updateEditors();
 }
 
@@ -540,6 +570,8 @@ void DrumPatternEditor::moveNoteAction( int nColumn,
 	pHydrogen->setIsModified( true );
 	m_pAudioEngine->unlock();
 
+	invalidateRow( nRow );
+	invalidateRow( nNewRow );
 	m_pPatternEditorPanel->updateEditors();
 }
 
@@ -1066,7 +1098,7 @@ void DrumPatternEditor::paste()
 ///
 /// Draws a pattern
 ///
-void DrumPatternEditor::drawPattern(QPainter& painter)
+void DrumPatternEditor::drawPattern( QPainter& painter, const QRect& clipRect )
 {
 	if ( m_pPattern == nullptr ) {
 		return;
@@ -1133,6 +1165,16 @@ void DrumPatternEditor::drawPattern(QPainter& painter)
 				}
 
 				int nInstrumentID = pNote->get_instrument_id();
+				if ( clipRect.isValid() ) {
+					const int nY = pInstrList->index( pNote->get_instrument() ) *
+						m_nGridHeight;
+					if ( nY + static_cast<int>(m_nGridHeight) < clipRect.top() ||
+						 nY > clipRect.bottom() ) {
+						++noteIt;
+						continue;
+					}
+				}
+
 				// An ID of -1 corresponds to an empty instrument.
 				if ( nInstrumentID >= 0 ) {
 					if ( nInstrumentID >= noteCount.size() ) {
@@ -1291,6 +1333,7 @@ void DrumPatternEditor::drawBackground( QPainter& p)
 
 void DrumPatternEditor::createBackground() {
 	m_bBackgroundInvalid = false;
+	m_damage.clear();
 
 	// Resize pixmap if pixel ratio has changed
 	qreal pixelRatio = devicePixelRatio();
@@ -1321,6 +1364,14 @@ void DrumPatternEditor::paintEvent( QPaintEvent* ev )
 	if ( pixelRatio != m_pBackgroundPixmap->devicePixelRatio() || m_bBackgroundInvalid ) {
 		createBackground();
 	}
+	else if ( ! m_damage.isEmpty() ) {
+		// Only redraw the tiles affected by the latest changes.
+		QPainter painter( m_pBackgroundPixmap );
+		painter.setClipRegion( m_damage.region() );
+		drawBackground( painter );
+		drawPattern( painter, m_damage.region().boundingRect() );
+		m_damage.clear();
+	}
 	
 	QPainter painter( this );
 	painter.drawPixmap( ev->rect(), *m_pBackgroundPixmap, QRectF( pixelRatio * ev->rect().x(),
@@ -24,6 +24,7 @@
 #ifndef DRUM_PATTERN_EDITOR_H
 #define DRUM_PATTERN_EDITOR_H
 
+#include "../DamageRegion.h"
 #include "../EventListener.h"
 #include "../Selection.h"
 #include "PatternEditor.h"
@@ -134,6 +135,17 @@ class DrumPatternEditor : public PatternEditor, protected WidgetWithScalableFont
 
 	private:
 	void createBackground() override;
+	/** Only the tiles covering row @a nRow will be redrawn during the
+	 * next call to updateEditor() (unless the size of the editor
+	 * changes as well).*/
+	void invalidateRow( int nRow );
+	/** Parts of #m_pBackgroundPixmap to be redrawn in case
+	 * #m_bBackgroundInvalid is not set.*/
+	DamageRegion m_damage;
+	/** Set by invalidateRow() and consumed by the next
+	 * updateEditor(). In case it is not set, updateEditor() can not
+	 * know what changed and redraws the whole pixmap.*/
+	bool m_bOnlyDamagedRows;
 	/**
 	 * Draw a note
 	 *
@@ -144,7 +156,9 @@ class DrumPatternEditor : public PatternEditor, protected WidgetWithScalableFont
 	 *   selected in the song editor)
 	 */
 	void drawNote( H2Core::Note* pNote, QPainter& painter, bool bIsForeground = true );
-		void drawPattern( QPainter& painter );
+		/** @param clipRect In case it is valid, notes of instruments
+		 * whose row does not intersect it are skipped.*/
+		void drawPattern( QPainter& painter, const QRect& clipRect = QRect() );
 		void drawBackground( QPainter& pointer );
 		void drawFocus( QPainter& painter );
 
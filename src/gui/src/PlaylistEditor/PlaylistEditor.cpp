@@ -32,6 +32,7 @@
 #include "Widgets/PixmapWidget.h"
 
 #include <core/CoreActionController.h>
+#include <core/Helpers/AutoSaver.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Preferences/Preferences.h>
 #include <core/Preferences/Shortcuts.h>
@@ -418,9 +419,8 @@ void PlaylistEditor::newPlaylist()
 							.arg( fileInfo.absoluteDir().absolutePath() )
 							.arg( sBaseName )
 							.arg( Filesystem::playlist_ext ) );
-	if ( autoSaveFile.exists() ) {
-		Filesystem::rm( autoSaveFile.absoluteFilePath() );
-	}
+	HydrogenApp::get_instance()->getMainForm()->getAutoSaver()
+		->remove( autoSaveFile.absoluteFilePath() );
 
 	return;
 }
@@ -612,16 +612,20 @@ bool PlaylistEditor::savePlaylistAs() {
 
 	pPref->setLastPlaylistDirectory( fd.directory().absolutePath() );
 
+	// Pending autosave jobs must not be written after the playlist.
+	// Else, we would offer to recover them on the next load.
+	HydrogenApp::get_instance()->getMainForm()->getAutoSaver()->remove(
+		Filesystem::getAutoSaveFilename( Filesystem::Type::Playlist,
+										 pPlaylist->getFilename() ) );
+
 	if ( sLastFilename == Filesystem::empty_path( Filesystem::Type::Playlist ) ) {
 		// In case we stored the playlist for the first time, we remove the
 		// autosave file corresponding to the empty one. Else, it might be
 		// loaded later when clicking "New Playlist" while not generating a new
 		// autosave file.
-		const QString sAutoSaveFile = Filesystem::getAutoSaveFilename(
-			Filesystem::Type::Playlist, sLastFilename );
-		if ( Filesystem::file_exists( sAutoSaveFile, true ) ) {
-			Filesystem::rm( sAutoSaveFile );
-		}
+		HydrogenApp::get_instance()->getMainForm()->getAutoSaver()->remove(
+			Filesystem::getAutoSaveFilename( Filesystem::Type::Playlist,
+											 sLastFilename ) );
 	}
 
 	return true;
@@ -646,6 +650,11 @@ bool PlaylistEditor::savePlaylist()
 		return false;
 	}
 
+	// Pending autosave jobs must not be written after the playlist.
+	HydrogenApp::get_instance()->getMainForm()->getAutoSaver()->remove(
+		Filesystem::getAutoSaveFilename( Filesystem::Type::Playlist,
+										 pPlaylist->getFilename() ) );
+
 	return true;
 }
 
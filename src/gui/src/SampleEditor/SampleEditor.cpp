@@ -463,6 +463,7 @@ void SampleEditor::createNewLayer()
 			pLayer = pInstrument->get_component( m_nSelectedComponent )->getLayer( m_nSelectedLayer );
 
 			// insert new sample from newInstrument
+			pHydrogen->addSampleToDeathRow( pLayer->get_sample() );
 			pLayer->set_sample( pEditSample );
 		}
 
@@ -85,6 +85,11 @@ SongEditor::SongEditor( QWidget *parent, QScrollArea *pScrollView, SongEditorPan
  , m_bEntered( false )
  , m_pBackgroundPixmap( nullptr )
  , m_pSequencePixmap( nullptr )
+ , m_nBackgroundPatterns( -1 )
+ , m_nBackgroundSelectedPattern( -1 )
+ , m_nBackgroundMaxBars( -1 )
+ , m_nBackgroundGridWidth( 0 )
+ , m_nBackgroundGridHeight( 0 )
 {
 	m_pHydrogen = Hydrogen::get_instance();
 	m_pAudioEngine = m_pHydrogen->getAudioEngine();
@@ -690,7 +695,7 @@ void SongEditor::focusInEvent( QFocusEvent *ev )
 
 	// If there are some patterns selected, we have to switch their
 	// border color inactive <-> active.
-	invalidateBackground();
+	invalidateSelectedCells();
 	update();
 	
 	if ( ! HydrogenApp::get_instance()->hideKeyboardCursor() ) {
@@ -706,7 +711,7 @@ void SongEditor::focusOutEvent( QFocusEvent *ev )
 
 	// If there are some patterns selected, we have to switch their
 	// border color inactive <-> active.
-	invalidateBackground();
+	invalidateSelectedCells();
 	update();
 	
 	if ( ! HydrogenApp::get_instance()->hideKeyboardCursor() ) {
@@ -732,7 +737,6 @@ void SongEditor::mousePressEvent( QMouseEvent *ev )
 	auto pHydrogenApp = HydrogenApp::get_instance();
 	updateModifiers( ev );
 	m_currentMousePosition = ev->pos();
-	m_bSequenceChanged = true;
 
 	// Update keyboard cursor position
 	QPoint p = xyToColumnRow( ev->pos() );
@@ -744,6 +748,9 @@ void SongEditor::mousePressEvent( QMouseEvent *ev )
 	pHydrogenApp->setHideKeyboardCursor( true );
 
 	if ( Hydrogen::get_instance()->getActionMode() == H2Core::Song::ActionMode::selectMode ) {
+		// The selection might change. In draw mode toggled cells are
+		// redrawn via invalidateColumn() instead.
+		m_bSequenceChanged = true;
 		m_selection.mousePressEvent( ev );
 		if ( ! pHydrogenApp->hideKeyboardCursor() ) {
 			pHydrogenApp->getSongEditorPanel()->getSongEditorPatternList()->update();
@@ -993,25 +1000,34 @@ void SongEditor::updatePosition( float fTick ) {
 
 void SongEditor::patternModifiedEvent() {
 	// This can change the length of one pattern in a column
-	// containing multiple ones.
-	invalidateBackground();
+	// containing multiple ones. The background itself only has to be
+	// redrawn in case the number of patterns changed.
+	m_bBackgroundInvalid = true;
+	m_bSequenceChanged = true;
 	update();
 }
 
 void SongEditor::relocationEvent() {
 	if ( Hydrogen::get_instance()->isPatternEditorLocked() ) {
-		invalidateBackground();
+		// The selected pattern might have changed. createBackground()
+		// does only redraw the affected rows.
+		m_bBackgroundInvalid = true;
 		update();
 	}
 }
 
 void SongEditor::patternEditorLockedEvent() {
 	if ( Hydrogen::get_instance()->isPatternEditorLocked() ) {
-		invalidateBackground();
+		m_bBackgroundInvalid = true;
 		update();
 	}
 }
 
+void SongEditor::selectedPatternChangedEvent() {
+	m_bBackgroundInvalid = true;
+	update();
+}
+
 void SongEditor::paintEvent( QPaintEvent *ev )
 {
 	if ( m_bBackgroundInvalid ) {
@@ -1021,8 +1037,13 @@ void SongEditor::paintEvent( QPaintEvent *ev )
 	// ridisegno tutto solo se sono cambiate le note
 	if (m_bSequenceChanged) {
 		m_bSequenceChanged = false;
+		m_sequenceDamage.clear();
 		drawSequence();
 	}
+	else if ( ! m_sequenceDamage.isEmpty() ) {
+		drawSequence( m_sequenceDamage.region() );
+		m_sequenceDamage.clear();
+	}
 	
 	const auto pPref = Preferences::get_instance();
 
@@ -1121,20 +1142,21 @@ void SongEditor::createBackground()
 	const auto pPref = H2Core::Preferences::get_instance();
 	std::shared_ptr<Song> pSong = m_pHydrogen->getSong();
 
-	uint nPatterns = pSong->getPatternList()->size();
+	int nPatterns = pSong->getPatternList()->size();
 	int nSelectedPatternNumber = m_pHydrogen->getSelectedPatternNumber();
 	int nMaxPatternSequence = pPref->getMaxBars();
 
-	static int nOldHeight = -1;
 	int nNewHeight = m_nGridHeight * nPatterns;
+	if ( nNewHeight < m_nMinimumHeight ) {
+		WARNINGLOG( QString( "nNewHeight [%1] below minimum one [%2]" )
+					.arg( nNewHeight ).arg( m_nMinimumHeight ) );
+		nNewHeight = m_nMinimumHeight;	// the pixmap should not be empty
+	}
 
-	if (nOldHeight != nNewHeight) {
+	if ( m_pBackgroundPixmap == nullptr ||
+		 m_pBackgroundPixmap->height() != nNewHeight ||
+		 m_pBackgroundPixmap->width() != width() ) {
 		// cambiamento di dimensioni...
-		if ( nNewHeight < m_nMinimumHeight ) {
-			WARNINGLOG( QString( "nNewHeight [%1] below minimum one [%2]" )
-						.arg( nNewHeight ).arg( m_nMinimumHeight ) );
-			nNewHeight = m_nMinimumHeight;	// the pixmap should not be empty
-		}
 		if ( m_pBackgroundPixmap ) {
 			delete m_pBackgroundPixmap;
 		}
@@ -1144,13 +1166,56 @@ void SongEditor::createBackground()
 		m_pBackgroundPixmap = new QPixmap( width(), nNewHeight );	// initialize the pixmap
 		m_pSequencePixmap = new QPixmap( width(), nNewHeight );	// initialize the pixmap
 		this->resize( QSize( width(), nNewHeight ) );
+
+		// Enforce a full redraw.
+		m_nBackgroundPatterns = -1;
+	}
+	else if ( nPatterns == m_nBackgroundPatterns &&
+			  nMaxPatternSequence == m_nBackgroundMaxBars &&
+			  m_nGridWidth == m_nBackgroundGridWidth &&
+			  m_nGridHeight == m_nBackgroundGridHeight ) {
+		// Layout of the grid is still the same. At most the
+		// highlighting of the selected row changed.
+		if ( nSelectedPatternNumber != m_nBackgroundSelectedPattern ) {
+			QPainter p( m_pBackgroundPixmap );
+			for ( const int nRow : { m_nBackgroundSelectedPattern,
+									 nSelectedPatternNumber } ) {
+				if ( nRow < 0 || nRow >= nPatterns ) {
+					continue;
+				}
+				const QRect rect = rowRect( nRow );
+				p.setClipRect( rect );
+				p.fillRect( rect, pPref->getTheme().m_color.m_songEditor_backgroundColor );
+				drawBackground( p, nPatterns, nSelectedPatternNumber,
+								nMaxPatternSequence );
+				m_sequenceDamage.invalidate( rect );
+			}
+			m_nBackgroundSelectedPattern = nSelectedPatternNumber;
+		}
+		return;
 	}
 
-	
+	m_nBackgroundPatterns = nPatterns;
+	m_nBackgroundSelectedPattern = nSelectedPatternNumber;
+	m_nBackgroundMaxBars = nMaxPatternSequence;
+	m_nBackgroundGridWidth = m_nGridWidth;
+	m_nBackgroundGridHeight = m_nGridHeight;
+
 	m_pBackgroundPixmap->fill( pPref->getTheme().m_color.m_songEditor_backgroundColor );
 
 	QPainter p( m_pBackgroundPixmap );
-	
+	drawBackground( p, nPatterns, nSelectedPatternNumber, nMaxPatternSequence );
+
+	// ~ celle
+	m_bSequenceChanged = true;
+
+}
+
+void SongEditor::drawBackground( QPainter& p, int nPatterns,
+								 int nSelectedPatternNumber, int nMaxPatternSequence )
+{
+	const auto pPref = H2Core::Preferences::get_instance();
+
 	for ( int ii = 0; ii < nPatterns + 1; ii++) {
 		if ( ( ii % 2 ) == 0 &&
 			 ii != nSelectedPatternNumber ) {
@@ -1183,14 +1248,38 @@ void SongEditor::createBackground()
 
 		p.drawLine( 0, y, (nMaxPatternSequence * m_nGridWidth), y );
 	}
-
-	// ~ celle
-	m_bSequenceChanged = true;
-
 }
 
 void SongEditor::invalidateBackground() {
 	m_bBackgroundInvalid = true;
+	m_nBackgroundPatterns = -1;
+}
+
+void SongEditor::invalidateColumn( int nColumn ) {
+	if ( nColumn < 0 ) {
+		return;
+	}
+
+	// Toggling a cell can change the width of all other cells in the
+	// same column since it is defined relative to the longest pattern.
+	m_sequenceDamage.invalidate( QRect( SongEditor::nMargin + nColumn * m_nGridWidth, 0,
+										m_nGridWidth + 1, height() ) );
+}
+
+QRect SongEditor::rowRect( int nRow ) const {
+	return QRect( 0, m_nGridHeight * nRow, width(), m_nGridHeight + 1 );
+}
+
+QRect SongEditor::cellRect( const QPoint& cell ) const {
+	return QRect( SongEditor::nMargin + cell.x() * m_nGridWidth,
+				  cell.y() * m_nGridHeight,
+				  m_nGridWidth + 1, m_nGridHeight + 1 );
+}
+
+void SongEditor::invalidateSelectedCells() {
+	for ( const QPoint& cell : m_selection ) {
+		m_sequenceDamage.invalidate( cellRect( cell ) );
+	}
 }
 
 // Update the GridCell representation.
@@ -1245,14 +1334,13 @@ void SongEditor::drawSequence()
 
 	p.begin( m_pSequencePixmap );
 	p.drawPixmap( rect(), *m_pBackgroundPixmap, rect() );
-	p.end();
 
 	updateGridCells();
 
 	// Draw using GridCells representation
 	for ( const auto& it : m_gridCells ) {
 		if ( ! m_selection.isSelected( QPoint( it.first.x(), it.first.y() ) ) ) {
-			drawPattern( it.first.x(), it.first.y(),
+			drawPattern( p, it.first.x(), it.first.y(),
 						 it.second.m_bDrawnVirtual, it.second.m_fWidth );
 		}
 	}
@@ -1261,17 +1349,51 @@ void SongEditor::drawSequence()
 	// could be overwritten by an adjecent, unselected pattern).
 	for ( const auto& it : m_gridCells ) {
 		if ( m_selection.isSelected( QPoint( it.first.x(), it.first.y() ) ) ) {
-			drawPattern( it.first.x(), it.first.y(),
+			drawPattern( p, it.first.x(), it.first.y(),
 						 it.second.m_bDrawnVirtual, it.second.m_fWidth );
 		}
 	}
 }
 
+void SongEditor::drawSequence( const QRegion& region )
+{
+	QPainter p( m_pSequencePixmap );
+	p.setClipRegion( region );
+	for ( const QRect& rect : region ) {
+		p.drawPixmap( rect, *m_pBackgroundPixmap, rect );
+	}
 
+	updateGridCells();
 
-void SongEditor::drawPattern( int nPos, int nNumber, bool bInvertColour, double fWidth )
+	// Cells are ordered by column first. Only those located within
+	// the damaged columns have to be considered.
+	const QRect boundingRect = region.boundingRect();
+	const int nFirstColumn = std::max(
+		0, xyToColumnRow( boundingRect.topLeft() ).x() - 1 );
+	const int nLastColumn = xyToColumnRow( boundingRect.bottomRight() ).x();
+
+	std::vector<std::pair<QPoint, GridCell>> selectedCells;
+	for ( auto it = m_gridCells.lower_bound( QPoint( nFirstColumn, 0 ) );
+		  it != m_gridCells.end() && it->first.x() <= nLastColumn; ++it ) {
+		if ( ! region.intersects( cellRect( it->first ) ) ) {
+			continue;
+		}
+		if ( m_selection.isSelected( it->first ) ) {
+			selectedCells.push_back( *it );
+		} else {
+			drawPattern( p, it->first.x(), it->first.y(),
+						 it->second.m_bDrawnVirtual, it->second.m_fWidth );
+		}
+	}
+	// Selected ones last, see drawSequence().
+	for ( const auto& [ cell, gridCell ] : selectedCells ) {
+		drawPattern( p, cell.x(), cell.y(),
+					 gridCell.m_bDrawnVirtual, gridCell.m_fWidth );
+	}
+}
+
+void SongEditor::drawPattern( QPainter& p, int nPos, int nNumber, bool bInvertColour, double fWidth )
 {
-	QPainter p( m_pSequencePixmap );
 	/*
 	 * The default color of the cubes in rgb is 97,167,251.
 	 */
@@ -1359,7 +1481,7 @@ QRect SongEditor::getKeyboardCursorRect() {
 				  QSize( m_nGridWidth, m_nGridHeight -1 ) );
 }
 
-void SongEditor::clearThePatternSequenceVector( const QString& filename )
+void SongEditor::clearThePatternSequenceVector()
 {
 	Hydrogen *pHydrogen = Hydrogen::get_instance();
 
@@ -1367,9 +1489,6 @@ void SongEditor::clearThePatternSequenceVector( const QString& filename )
 
 	std::shared_ptr<Song> pSong = pHydrogen->getSong();
 
-	//before deleting the sequence, write a temp sequence file to disk
-	pSong->saveTempPatternList( filename );
-
 	std::vector<PatternList*> *pPatternGroupsVect = pSong->getPatternGroupVector();
 	for (uint i = 0; i < pPatternGroupsVect->size(); i++) {
 		PatternList *pPatternList = (*pPatternGroupsVect)[i];
@@ -1947,23 +2066,11 @@ void SongEditorPatternList::patternPopup_load()
 	}
 	QString patternPath = fd.selectedFiles().first();
 
-	QString prevPatternPath =
-		Files::savePatternTmp( pPattern->get_name(), pPattern, pSong,
-							   pDrumkit->getName() );
-
-	if ( prevPatternPath.isEmpty() ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-		return;
-	}
-	QString sequencePath = Filesystem::tmp_file_path( "SEQ.xml" );
-	if ( !pSong->saveTempPatternList( sequencePath ) ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not export sequence.") );
-		return;
-	}
 	pPref->setLastOpenPatternDirectory( fd.directory().absolutePath() );
 
 	SE_loadPatternAction *action =
-		new SE_loadPatternAction( patternPath, prevPatternPath, sequencePath,
+		new SE_loadPatternAction( patternPath, new Pattern( pPattern ),
+								  pSong->getSequenceSnapshot(),
 								  m_nRowClicked, false );
 	HydrogenApp *hydrogenApp = HydrogenApp::get_instance();
 	hydrogenApp->m_pUndoStack->push( action );
@@ -2102,21 +2209,9 @@ void SongEditorPatternList::patternPopup_delete()
 
 	auto pPattern = pSong->getPatternList()->get( m_nRowClicked );
 
-	QString patternPath =
-		Files::savePatternTmp( pPattern->get_name(), pPattern, pSong,
-							   pDrumkit->getName() );
-	if ( patternPath.isEmpty() ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-		return;
-	}
-	QString sequencePath = Filesystem::tmp_file_path( "SEQ.xml" );
-	if ( !pSong->saveTempPatternList( sequencePath ) ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not export sequence.") );
-		return;
-	}
-
 	SE_deletePatternFromListAction *action =
-		new SE_deletePatternFromListAction( patternPath, sequencePath,
+		new SE_deletePatternFromListAction( new Pattern( pPattern ),
+											pSong->getSequenceSnapshot(),
 											m_nRowClicked );
 	HydrogenApp *hydrogenApp = HydrogenApp::get_instance();
 	hydrogenApp->m_pUndoStack->push( action );
@@ -2155,20 +2250,15 @@ void SongEditorPatternList::patternPopup_duplicate()
 	PatternPropertiesDialog *dialog = new PatternPropertiesDialog( this, pNewPattern, m_nRowClicked, true );
 
 	if ( dialog->exec() == QDialog::Accepted ) {
-		QString filePath = Files::savePatternTmp( pNewPattern->get_name(),
-												  pNewPattern, pSong,
-												  pDrumkit->getName() );
-		if ( filePath.isEmpty() ) {
-			QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-			return;
-		}
+		// Ownership is passed to the undo action.
 		SE_duplicatePatternAction *action =
-			new SE_duplicatePatternAction( filePath, m_nRowClicked + 1 );
+			new SE_duplicatePatternAction( pNewPattern, m_nRowClicked + 1 );
 		HydrogenApp::get_instance()->m_pUndoStack->push( action );
+	} else {
+		delete pNewPattern;
 	}
 
 	delete dialog;
-	delete pNewPattern;
 }
 
 void SongEditorPatternList::patternPopup_fill()
@@ -2344,16 +2434,16 @@ void SongEditorPatternList::dropEvent(QDropEvent *event)
 		QStringList tokens = sText.split( "::" );
 		QString sPatternName = tokens.at( 1 );
 
-		//create a unique sequencefilename
 		Pattern *pPattern = pSong->getPatternList()->get( nTargetPattern );
 		HydrogenApp *pHydrogenApp = HydrogenApp::get_instance();
 
-		QString oldPatternName = pPattern->get_name();
-
-		QString sequenceFilename = Filesystem::tmp_file_path( "SEQ.xml" );
 		bool drag = false;
 		if( QString( tokens.at(0) ).contains( "drag pattern" )) drag = true;
-		SE_loadPatternAction *pAction = new SE_loadPatternAction( sPatternName, oldPatternName, sequenceFilename, nTargetPattern, drag );
+		SE_loadPatternAction *pAction =
+			new SE_loadPatternAction( sPatternName,
+									  drag ? nullptr : new Pattern( pPattern ),
+									  pSong->getSequenceSnapshot(),
+									  nTargetPattern, drag );
 
 		pHydrogenApp->m_pUndoStack->push( pAction );
 	}
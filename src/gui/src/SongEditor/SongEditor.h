@@ -37,6 +37,7 @@
 #include <core/Timeline.h>
 #include "../EventListener.h"
 #include "PatternFillDialog.h"
+#include "../DamageRegion.h"
 #include "../Selection.h"
 #include "../Widgets/WidgetWithScalableFont.h"
 
@@ -85,6 +86,9 @@ class SongEditor : public QWidget
 
 		void createBackground();
 		void invalidateBackground();
+		/** Only redraw the cells of column @a nColumn the next time
+		 * the widget is painted.*/
+		void invalidateColumn( int nColumn );
 		void updatePosition( float fTick );
 
 		int getGridWidth ();
@@ -99,7 +103,7 @@ class SongEditor : public QWidget
 									   const std::vector<QPoint>& deleteCells,
 									   const std::vector<QPoint>& selectCells );
 
-		void clearThePatternSequenceVector( const QString& filename );
+		void clearThePatternSequenceVector();
 		void updateEditorandSetTrue();
 
 		int yScrollTarget( QScrollArea *pScrollArea, int *pnPatternInView );
@@ -141,6 +145,9 @@ class SongEditor : public QWidget
 
 		//! Pattern sequence or selection has changed, so must be redrawn.
 		bool 					m_bSequenceChanged;
+		//! Parts of #m_pSequencePixmap which have to be redrawn
+		//! while the remainder of the sequence is still valid.
+		DamageRegion			m_sequenceDamage;
 
 		QMenu *					m_pPopupMenu;
 
@@ -154,11 +161,26 @@ class SongEditor : public QWidget
 		//!   * The sequence pixmap are only updated when cells are added/removed or selections change
 		//!       * the cached grid background pixmap is used when repainting the pattern
 		//!   * selections and moving cells are painted on top of the cached sequence pixmap
+		//!   * changes affecting only a couple of cells (toggling a cell, changing the selected pattern, focus
+		//!       changes) are recorded in #m_sequenceDamage and just the tiles containing them are repainted.
 		//! @{
 		QPixmap *				m_pBackgroundPixmap;
 		QPixmap *				m_pSequencePixmap;
 		//! @}
 
+		//! @name State the background pixmap was created for
+		//!
+		//! Used by createBackground() to decide whether the pixmap
+		//! has to be redrawn entirely, only some of its rows have to
+		//! be updated, or it is still valid.
+		//! @{
+		int m_nBackgroundPatterns;
+		int m_nBackgroundSelectedPattern;
+		int m_nBackgroundMaxBars;
+		unsigned m_nBackgroundGridWidth;
+		unsigned m_nBackgroundGridHeight;
+		//! @}
+
 		//! @name Position of the keyboard input cursor
 		//! @{
 		int m_nCursorRow;
@@ -207,9 +229,22 @@ class SongEditor : public QWidget
 		void setPatternActive( int nColumn, int nRow, bool bActivate );
 
 		void drawSequence();
+		/** Redraw only the parts of the sequence pixmap covered by
+		 * @a region.*/
+		void drawSequence( const QRegion& region );
+		void drawBackground( QPainter& p, int nPatterns,
+							 int nSelectedPatternNumber, int nMaxPatternSequence );
+		/** Rectangle covered by row @a nRow across all columns.*/
+		QRect rowRect( int nRow ) const;
+		/** Rectangle covered by a single cell in both the background
+		 * and sequence pixmap.*/
+		QRect cellRect( const QPoint& cell ) const;
   
-		void drawPattern( int pos, int number, bool invertColour, double width );
+		void drawPattern( QPainter& p, int pos, int number, bool invertColour, double width );
 		void drawFocus( QPainter& painter );
+		/** Mark all selected cells for redrawing, e.g. since the
+		 * color of their border changes on focus in/out.*/
+		void invalidateSelectedCells();
 
 		std::map< QPoint, GridCell > m_gridCells;
 		void updateGridCells();
@@ -218,6 +253,7 @@ class SongEditor : public QWidget
 	virtual void patternModifiedEvent() override;
 	virtual void relocationEvent() override;
 	virtual void patternEditorLockedEvent() override;
+	virtual void selectedPatternChangedEvent() override;
 	
 	/** Cached position of the playhead.*/
 	float m_fTick;
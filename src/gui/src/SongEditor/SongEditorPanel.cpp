@@ -560,6 +560,16 @@ void SongEditorPanel::updateAll()
 	patternModifiedEvent();
 }
 
+void SongEditorPanel::updateAllButSongEditor()
+{
+	m_pPatternList->invalidateBackground();
+	m_pPatternList->update();
+
+	updatePositionRuler();
+
+	patternModifiedEvent();
+}
+
 void SongEditorPanel::patternModifiedEvent() {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
@@ -698,29 +708,21 @@ void SongEditorPanel::clearSequence()
 		return;
 	}
 	
-	QString filename = Filesystem::tmp_file_path( "SEQ.xml" );
-	SE_deletePatternSequenceAction *pAction = new SE_deletePatternSequenceAction( filename );
+	SE_deletePatternSequenceAction *pAction = new SE_deletePatternSequenceAction(
+		Hydrogen::get_instance()->getSong()->getSequenceSnapshot() );
 	HydrogenApp *pH2App = HydrogenApp::get_instance();
 
 	pH2App->m_pUndoStack->push( pAction );
 }
 
 
-void SongEditorPanel::restoreGroupVector( const QString& filename )
+void SongEditorPanel::restoreGroupVector( std::shared_ptr<const Song::SequenceSnapshot> pSnapshot )
 {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pAudioEngine = pHydrogen->getAudioEngine();
-	//clear the old sequese
-	std::vector<PatternList*> *pPatternGroupsVect = pHydrogen->getSong()->getPatternGroupVector();
-	for (uint i = 0; i < pPatternGroupsVect->size(); i++) {
-		PatternList *pPatternList = (*pPatternGroupsVect)[i];
-		pPatternList->clear();
-		delete pPatternList;
-	}
-	pPatternGroupsVect->clear();
 
 	pAudioEngine->lock( RIGHT_HERE );
-	pHydrogen->getSong()->loadTempPatternList( filename );
+	pHydrogen->getSong()->setSequenceSnapshot( pSnapshot );
 	pHydrogen->updateSongSize();
 	pHydrogen->updateSelectedPattern( false );
 	pAudioEngine->unlock();
@@ -1010,7 +1012,9 @@ void SongEditorPanel::faderChanged( WidgetWithInput *pRef )
 
 void SongEditorPanel::selectedPatternChangedEvent()
 {
-	updateAll();
+	// The SongEditor handles this event itself and redraws just the
+	// rows of the previously and newly selected pattern.
+	updateAllButSongEditor();
 
 	auto pHydrogen = Hydrogen::get_instance();
 	if ( pHydrogen->getSelectedPatternNumber() == -1 ) {
@@ -1156,8 +1160,13 @@ void SongEditorPanel::setTimelineEnabled( bool bEnabled ) {
 	HydrogenApp::get_instance()->showStatusBarMessage( sMessage );
 }
 
-void SongEditorPanel::gridCellToggledEvent() {
-	updateAll();
+void SongEditorPanel::gridCellToggledEvent( int nColumn ) {
+	// Only the tiles of the affected column of the SongEditor are
+	// redrawn.
+	m_pSongEditor->invalidateColumn( nColumn );
+	m_pSongEditor->update();
+
+	updateAllButSongEditor();
 }
 
 void SongEditorPanel::playingPatternsChangedEvent() {
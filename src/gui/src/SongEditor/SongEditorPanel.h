@@ -27,6 +27,7 @@
 #include "../EventListener.h"
 #include <core/Object.h>
 #include <core/Basics/Pattern.h>
+#include <core/Basics/Song.h>
 
 #include <QtGui>
 #include <QtWidgets>
@@ -76,7 +77,7 @@ class SongEditorPanel :  public QWidget, public EventListener,  public H2Core::O
 		 * signal the user her last action was not permitted.
 		 */
 		void highlightPatternEditorLocked( bool bUseRedBackground );	
-		void restoreGroupVector( const QString& filename );
+		void restoreGroupVector( std::shared_ptr<const H2Core::Song::SequenceSnapshot> pSnapshot );
 		// ~ Implements EventListener interface
 		/** Disables and deactivates the Timeline when an external
 		 * JACK Timebase controller is detected and enables it when it's
@@ -95,7 +96,7 @@ class SongEditorPanel :  public QWidget, public EventListener,  public H2Core::O
 		 * \param nValue 0 - select mode and 1 - draw mode.
 		 */
 		virtual void actionModeChangeEvent( int nValue ) override;
-		virtual void gridCellToggledEvent() override;
+		virtual void gridCellToggledEvent( int nColumn ) override;
 	virtual void patternModifiedEvent() override;
 
 		virtual void playingPatternsChangedEvent() override;
@@ -148,6 +149,10 @@ class SongEditorPanel :  public QWidget, public EventListener,  public H2Core::O
 		void automationPathPointMoved(float ox, float oy, float tx, float ty);
 
 	private:
+		/** Like updateAll() but leaves the (expensive) full redraw of
+		 * the SongEditor out.*/
+		void updateAllButSongEditor();
+
 		static const int			m_nPatternListWidth = 200;
 									
 		QScrollArea*				m_pEditorScrollView;
@@ -37,6 +37,7 @@
 #include <core/Basics/Note.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
 #include <core/CoreActionController.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/License.h>
@@ -109,52 +110,56 @@ private:
 class SE_deletePatternSequenceAction : public QUndoCommand
 {
 public:
-	explicit SE_deletePatternSequenceAction( const QString& pFilename ){
+	explicit SE_deletePatternSequenceAction( std::shared_ptr<const H2Core::Song::SequenceSnapshot> pSequence ){
 		setText( QObject::tr( "Delete complete pattern-sequence" ) );
-		__pFilename = pFilename ;
+		m_pSequence = pSequence;
 	}
 	virtual void undo()
 	{
 		//qDebug() << "Delete complete pattern-sequence  undo";
 		HydrogenApp* h2app = HydrogenApp::get_instance();
-		h2app->getSongEditorPanel()->restoreGroupVector( __pFilename );
+		h2app->getSongEditorPanel()->restoreGroupVector( m_pSequence );
 	}
 
 	virtual void redo()
 	{
 		//qDebug() << "Delete complete pattern-sequence redo " ;
 		HydrogenApp* h2app = HydrogenApp::get_instance();
-		h2app->getSongEditorPanel()->getSongEditor()->clearThePatternSequenceVector( __pFilename );
+		h2app->getSongEditorPanel()->getSongEditor()->clearThePatternSequenceVector();
 	}
 private:
-	QString __pFilename;
+	std::shared_ptr<const H2Core::Song::SequenceSnapshot> m_pSequence;
 };
 
 /** \ingroup docGUI*/
 class SE_deletePatternFromListAction : public QUndoCommand
 {
 public:
-	SE_deletePatternFromListAction( const QString& sPatternFilename,
-									const QString& sSequenceFilename,
+	SE_deletePatternFromListAction( H2Core::Pattern* pPattern,
+									std::shared_ptr<const H2Core::Song::SequenceSnapshot> pSequence,
 									int nPatternPosition ){
 		setText( QObject::tr( "Delete pattern from list" ) );
-		m_sPatternFilename =  sPatternFilename;
-		m_sSequenceFilename = sSequenceFilename;
+		m_pPattern = pPattern;
+		m_pSequence = pSequence;
 		m_nPatternPosition = nPatternPosition;
 	}
+	~SE_deletePatternFromListAction()
+	{
+		delete m_pPattern;
+	}
 	virtual void undo() {
 		HydrogenApp* h2app = HydrogenApp::get_instance();
-		H2Core::CoreActionController::openPattern( m_sPatternFilename,
-																		  m_nPatternPosition );
-		h2app->getSongEditorPanel()->restoreGroupVector( m_sSequenceFilename );
+		H2Core::CoreActionController::setPattern( new H2Core::Pattern( m_pPattern ),
+												  m_nPatternPosition );
+		h2app->getSongEditorPanel()->restoreGroupVector( m_pSequence );
 	}
 
 	virtual void redo() {
 		H2Core::CoreActionController::removePattern( m_nPatternPosition );
 	}
 private:
-	QString m_sPatternFilename;
-	QString m_sSequenceFilename;
+	H2Core::Pattern* m_pPattern;
+	std::shared_ptr<const H2Core::Song::SequenceSnapshot> m_pSequence;
 	int m_nPatternPosition;
 };
 
@@ -231,20 +236,25 @@ private:
 class SE_duplicatePatternAction : public QUndoCommand
 {
 public:
-	SE_duplicatePatternAction( const QString& patternFilename, int patternPosition ){
+	SE_duplicatePatternAction( H2Core::Pattern* pPattern, int patternPosition ){
 		setText( QObject::tr( "Duplicate pattern" ) );
-		m_sPatternFilename = patternFilename;
+		m_pPattern = pPattern;
 		m_nPatternPosition = patternPosition;
 	}
+	~SE_duplicatePatternAction()
+	{
+		delete m_pPattern;
+	}
 	virtual void undo() {
 		H2Core::CoreActionController::removePattern( m_nPatternPosition );
 	}
 
 	virtual void redo() {
-		H2Core::CoreActionController::openPattern( m_sPatternFilename, m_nPatternPosition );
+		H2Core::CoreActionController::setPattern( new H2Core::Pattern( m_pPattern ),
+												  m_nPatternPosition );
 	}
 private:
-	QString m_sPatternFilename;
+	H2Core::Pattern* m_pPattern;
 	int m_nPatternPosition;
 };
 
@@ -279,26 +289,33 @@ private:
 class SE_loadPatternAction : public QUndoCommand
 {
 public:
+	/** @param pOldPattern Copy of the pattern replaced by the loaded
+	 *   one. Ownership is passed to the action. `nullptr` in case of
+	 *   @a bDragFromList. */
 	SE_loadPatternAction( const QString& sPatternName,
-						  const QString& sOldPatternName,
-						  const QString& sSequenceFilename, int nPatternPosition,
+						  H2Core::Pattern* pOldPattern,
+						  std::shared_ptr<const H2Core::Song::SequenceSnapshot> pSequence,
+						  int nPatternPosition,
 						  bool bDragFromList){
 		setText( QObject::tr( "Load/drag pattern" ) );
 		m_sPatternName =  sPatternName;
-		m_sOldPatternName = sOldPatternName;
-		m_sSequenceFilename = sSequenceFilename;
+		m_pOldPattern = pOldPattern;
+		m_pSequence = pSequence;
 		m_nPatternPosition = nPatternPosition;
 		m_bDragFromList = bDragFromList;
 	}
+	~SE_loadPatternAction()
+	{
+		delete m_pOldPattern;
+	}
 	virtual void undo() {
-		if( m_bDragFromList ){
-			H2Core::CoreActionController::removePattern( m_nPatternPosition );
-		} else {
-			H2Core::CoreActionController::removePattern( m_nPatternPosition );
-			H2Core::CoreActionController::openPattern( m_sOldPatternName, m_nPatternPosition );
+		H2Core::CoreActionController::removePattern( m_nPatternPosition );
+		if( ! m_bDragFromList && m_pOldPattern != nullptr ){
+			H2Core::CoreActionController::setPattern(
+				new H2Core::Pattern( m_pOldPattern ), m_nPatternPosition );
 		}
 		HydrogenApp::get_instance()->getSongEditorPanel()
-			->restoreGroupVector( m_sSequenceFilename );
+			->restoreGroupVector( m_pSequence );
 	}
 
 	virtual void redo() {
@@ -309,8 +326,8 @@ public:
 	}
 private:
 	QString m_sPatternName;
-	QString m_sOldPatternName;
-	QString m_sSequenceFilename;
+	H2Core::Pattern* m_pOldPattern;
+	std::shared_ptr<const H2Core::Song::SequenceSnapshot> m_pSequence;
 	int m_nPatternPosition;
 	bool m_bDragFromList;
 };
@@ -286,7 +286,7 @@ void MidiTable::setupMidiTable()
 		}
 	}
 
-	for ( const auto& ppAction : pMidiMap->getPCActions() ) {
+	for ( const auto& ppAction : pMidiMap->getPCActionVector() ) {
 		if ( ppAction != nullptr && ! ppAction->isNull() ) {
 			insertNewRow( ppAction,
 						  H2Core::MidiMessage::EventToQString(
@@ -302,7 +302,7 @@ void MidiTable::setupMidiTable()
 void MidiTable::saveMidiTable()
 {
 	auto pMidiMap = H2Core::Preferences::get_instance()->getMidiMap();
-	pMidiMap.reset();
+	pMidiMap->reset();
 	
 	for ( int row = 0; row < m_nRowCount; row++ ) {
 
@@ -333,15 +333,15 @@ void MidiTable::saveMidiTable()
 
 			switch ( event ) {
 			case H2Core::MidiMessage::Event::CC:
-				pMidiMap->registerCCEvent( eventSpinner->cleanText().toInt() , pAction );
+				pMidiMap->registerCCEvent( eventSpinner->cleanText().toInt() , pAction, false );
 				break;
 				
 			case H2Core::MidiMessage::Event::Note:
-				pMidiMap->registerNoteEvent( eventSpinner->cleanText().toInt() , pAction );
+				pMidiMap->registerNoteEvent( eventSpinner->cleanText().toInt() , pAction, false );
 				break;
 				
 			case H2Core::MidiMessage::Event::PC:
-				pMidiMap->registerPCEvent( pAction );
+				pMidiMap->registerPCEvent( pAction, false );
 				break;
 				
 			case H2Core::MidiMessage::Event::Null:
@@ -355,6 +355,8 @@ void MidiTable::saveMidiTable()
 			}
 		}
 	}
+
+	pMidiMap->updateLookupTable();
 }
 
 void MidiTable::updateRow( int nRow ) {
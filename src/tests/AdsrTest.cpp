@@ -23,6 +23,7 @@
 #include "AdsrTest.h"
 
 #include <core/Basics/Adsr.h>
+#include <cmath>
 #include <stdio.h>
 #include <memory>
 
@@ -270,3 +271,60 @@ void ADSRTest::testRelease()
 	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, getValue( 2.0 ), delta );
 	___INFOLOG( "passed" );
 }
+
+/* Compare an envelope rendered with a non-integer step size against the closed form of its
+   exponentials. */
+void ADSRTest::testReferenceCurve()
+{
+	___INFOLOG( "" );
+	// Parameters of the exponentials as defined in Adsr.cpp.
+	const double fAttackExponent = 0.038515241777294117,
+		fAttackInit = 1.039835771720117430;
+	const double fDecayExponent = 0.044796211247505179,
+		fDecayInit = 1.046934808452493870,
+		fDecayYOffset = -0.046934663351557632;
+
+	const int N = 1000;
+	const float fStep = 1.3;
+	const float fSustain = 0.6;
+	const int nFrames = 6 * N;
+	const int nReleaseStart = 3 * N;
+	const int nPhaseFrames = ceil( N / fStep );
+
+	float a[ nFrames ], b[ nFrames ];
+	for ( int n = 0; n < nFrames; n++) {
+		a[n] = b[n] = 1.0;
+	}
+
+	ADSR Adsr( N, N, fSustain, N );
+	Adsr.applyADSR( a, b, nFrames, nReleaseStart, fStep );
+	checkEqual( a, b, nFrames );
+
+	for ( int n = 0; n < nFrames; n++ ) {
+		double fExpected;
+		if ( n < nPhaseFrames ) {
+			fExpected = fAttackInit -
+				fAttackInit * pow( fAttackExponent, n * fStep / N );
+		}
+		else if ( n < 2 * nPhaseFrames ) {
+			const int nn = n - nPhaseFrames;
+			fExpected = ( fDecayInit * pow( fDecayExponent, nn * fStep / N ) +
+						  fDecayYOffset ) * ( 1.0 - fSustain ) + fSustain;
+		}
+		else if ( n < nReleaseStart ) {
+			fExpected = fSustain;
+		}
+		else if ( n < nReleaseStart + nPhaseFrames ) {
+			const int nn = n - nReleaseStart;
+			fExpected = ( fDecayInit * pow( fDecayExponent, nn * fStep / N ) +
+						  fDecayYOffset ) * fSustain;
+		}
+		else {
+			fExpected = 0.0;
+		}
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(
+			QString( "values at index %1" ).arg( n ).toStdString(),
+			fExpected, a[n], 0.0001 );
+	}
+	___INFOLOG( "passed" );
+}
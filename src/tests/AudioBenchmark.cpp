@@ -32,6 +32,7 @@
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/InstrumentComponent.h>
 #include <core/Basics/PatternList.h>
+#include <core/SMF/SMF.h>
 #include "TestHelper.h"
 #include "AudioBenchmark.h"
 
@@ -144,6 +145,68 @@ void AudioBenchmark::timeADSR() {
 	}
 
 	out << "ADSR time: " << showTimes( times, nFrames ) << Qt::endl;
+
+	// Same envelope rendered in process cycles of a resampled note.
+	const int nCycleFrames = 256;
+	const float fStep = 1.0594631;
+	times.clear();
+	for ( int i = 0; i < 100; i++ ) {
+		for (int i = 0; i < nFrames; i++) {
+			data_L[i] = data_R[i] = 1.0;
+		}
+
+		ADSR adsr( nFrames / 4, nFrames / 4, 0.5, nFrames / 4 );
+
+		std::clock_t start = std::clock();
+		for ( int nPos = 0; nPos < nFrames; nPos += nCycleFrames ) {
+			adsr.applyADSR( &data_L[ nPos ], &data_R[ nPos ], nCycleFrames,
+							3 * nFrames / 4 - nPos, fStep );
+		}
+		std::clock_t end = std::clock();
+
+		times.push_back( end - start );
+	}
+
+	out << "ADSR time (resampled, " << nCycleFrames << " frame cycles): "
+		<< showTimes( times, nFrames ) << Qt::endl;
+}
+
+void AudioBenchmark::timeMidiExport( const QString& sSongFile ) {
+	const int nBars = 10000;
+	const int nIterations = 10;
+	auto outFile = Filesystem::tmp_file_path("test.mid");
+
+	// Inflate the song by repeating all its patterns for each bar.
+	auto pSong = Song::load( sSongFile );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	auto pPatternGroups = pSong->getPatternGroupVector();
+	for ( auto& ppPatternList : *pPatternGroups ) {
+		ppPatternList->clear();
+		delete ppPatternList;
+	}
+	pPatternGroups->clear();
+	for ( int nBar = 0; nBar < nBars; ++nBar ) {
+		auto pPatternList = new PatternList();
+		for ( const auto& ppPattern : *pSong->getPatternList() ) {
+			pPatternList->add( ppPattern );
+		}
+		pPatternGroups->push_back( pPatternList );
+	}
+
+	std::vector< clock_t > times;
+	for ( int i = 0; i < nIterations; i++ ) {
+		SMF1WriterMulti writer;
+		std::clock_t start = std::clock();
+		writer.save( outFile, pSong );
+		std::clock_t end = std::clock();
+
+		times.push_back( end - start );
+	}
+
+	out << "MIDI export of " << nBars << " bars: "
+		<< showTimes( times, nBars ) << Qt::endl;
+
+	Filesystem::rm( outFile );
 }
 
 double AudioBenchmark::timeExport( int nSampleRate,
@@ -217,6 +280,9 @@ void AudioBenchmark::audioBenchmark(void)
 	auto songFile = H2TEST_FILE("functional/test.h2song");
 	auto songADSRFile = H2TEST_FILE("functional/test_adsr.h2song");
 
+	out << "Benchmark MIDI export:" << Qt::endl;
+	timeMidiExport( songFile );
+
 	/* Load song and prepare */
 	std::shared_ptr<Song> pSong = Song::load( songFile );
 	CPPUNIT_ASSERT( pSong != nullptr );
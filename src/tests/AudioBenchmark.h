@@ -37,6 +37,7 @@ class AudioBenchmark : public CppUnit::TestCase {
 	QTextStream out;
 
 	void timeADSR();
+	void timeMidiExport( const QString& sSongFile );
 	double timeExport( int nSampleRate,
 					   H2Core::Interpolation::InterpolateMode interpolateMode,
 					   double fReference = 0.0,
@@ -21,10 +21,36 @@
  */
 
 #include "CoreActionControllerTest.h"
+#include "TestHelper.h"
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/InstrumentReclaimer.h>
+#include <core/AudioEngine/TransportPosition.h>
+#include <core/Basics/Adsr.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Sample.h>
+#include <core/Basics/Playlist.h>
 #include <core/CoreActionController.h>
+#include <core/FX/Effects.h>
+#include <core/Helpers/DrumkitSwitcher.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/PlaylistPreloader.h>
+#include <core/IO/AudioOutput.h>
+#include <core/MidiAction.h>
+#include <core/Preferences/Preferences.h>
+#include <core/Sampler/Sampler.h>
+#include <core/SoundLibrary/SoundLibraryDatabase.h>
 
+#include <QDir>
+
+#include <chrono>
+#include <cmath>
 #include <stdio.h>
+#include <thread>
 
 using namespace H2Core;
 
@@ -160,3 +186,412 @@ void CoreActionControllerTest::testIsPathValid() {
 	
 	___INFOLOG( "passed" );
 }
+
+void CoreActionControllerTest::testPlaylistPreloading() {
+	___INFOLOG( "" );
+
+	auto pPref = Preferences::get_instance();
+	const int nPreloadSongs = pPref->getPlaylistPreloadSongs();
+	const int nPreloadMemory = pPref->getPlaylistPreloadMemory();
+	pPref->setPlaylistPreloadSongs( 1 );
+
+	const QString sSong0 = H2TEST_FILE( "song/AE_loopMode.h2song" );
+	const QString sSong1 = H2TEST_FILE( "functional/test.h2song" );
+
+	auto pPlaylist = std::make_shared<Playlist>();
+	CPPUNIT_ASSERT( pPlaylist->add( std::make_shared<PlaylistEntry>( sSong0 ) ) );
+	CPPUNIT_ASSERT( pPlaylist->add( std::make_shared<PlaylistEntry>( sSong1 ) ) );
+	CPPUNIT_ASSERT( CoreActionController::setPlaylist( pPlaylist ) );
+
+	// No song is active yet. The first one should be preloaded.
+	auto pPreloader = m_pHydrogen->getPlaylistPreloader();
+	pPreloader->waitForPendingJobs();
+	CPPUNIT_ASSERT( pPreloader->isReady( sSong0 ) );
+	CPPUNIT_ASSERT( ! pPreloader->isReady( sSong1 ) );
+	CPPUNIT_ASSERT( pPreloader->getMemoryUsage() > 0 );
+
+	auto pSong = CoreActionController::loadSong( sSong0 );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	CPPUNIT_ASSERT( pSong->getDrumkit()->areSamplesLoaded() );
+	CPPUNIT_ASSERT( ! pPreloader->isReady( sSong0 ) );
+	CPPUNIT_ASSERT( CoreActionController::setSong( pSong ) );
+	pSong->setIsModified( false );
+#ifdef H2CORE_HAVE_LADSPA
+	std::vector<LadspaFX*> effects;
+	for ( int nFX = 0; nFX < MAX_FX; ++nFX ) {
+		effects.push_back( Effects::get_instance()->getLadspaFX( nFX ) );
+	}
+#endif
+	CPPUNIT_ASSERT( CoreActionController::activatePlaylistSong( 0 ) );
+
+	pPreloader->waitForPendingJobs();
+	CPPUNIT_ASSERT( pPreloader->isReady( sSong1 ) );
+
+	// Preloading must neither touch the effects of the current song
+	// nor mark it modified.
+	CPPUNIT_ASSERT( ! pSong->getIsModified() );
+#ifdef H2CORE_HAVE_LADSPA
+	for ( int nFX = 0; nFX < MAX_FX; ++nFX ) {
+		CPPUNIT_ASSERT( Effects::get_instance()->getLadspaFX( nFX ) ==
+						effects[ nFX ] );
+	}
+#endif
+
+	// Songs exceeding the memory budget must not be kept.
+	pPref->setPlaylistPreloadMemory( 0 );
+	pPreloader->clear();
+	CPPUNIT_ASSERT( pPreloader->getMemoryUsage() == 0 );
+	CPPUNIT_ASSERT( CoreActionController::activatePlaylistSong( 0 ) );
+	pPreloader->waitForPendingJobs();
+	CPPUNIT_ASSERT( ! pPreloader->isReady( sSong1 ) );
+	CPPUNIT_ASSERT( pPreloader->getMemoryUsage() == 0 );
+
+	// Songs not preloaded are loaded from disk as usual.
+	pSong = CoreActionController::loadSong( sSong1 );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	CPPUNIT_ASSERT( ! pSong->getDrumkit()->areSamplesLoaded() );
+
+	pPref->setPlaylistPreloadSongs( nPreloadSongs );
+	pPref->setPlaylistPreloadMemory( nPreloadMemory );
+	CPPUNIT_ASSERT( CoreActionController::setPlaylist(
+						std::make_shared<Playlist>() ) );
+	pPreloader->waitForPendingJobs();
+
+	___INFOLOG( "passed" );
+}
+
+void CoreActionControllerTest::testPlaylistPreloadingDuringRescan() {
+	___INFOLOG( "" );
+
+	auto pPref = Preferences::get_instance();
+	const int nPreloadSongs = pPref->getPlaylistPreloadSongs();
+	pPref->setPlaylistPreloadSongs( 1 );
+
+	// Kits are renamed back and forth in a custom folder. This way each
+	// rescan removes one kit from the database and adds another.
+	auto pDB = m_pHydrogen->getSoundLibraryDatabase();
+	const QString sFolder = Filesystem::tmp_dir() + "preloadRescanTest";
+	if ( QDir( sFolder ).exists() ) {
+		CPPUNIT_ASSERT( Filesystem::rm( sFolder, true ) );
+	}
+	const QString sKitPath = sFolder + "/baseKit";
+	const QString sRenamedKitPath = sFolder + "/baseKitRenamed";
+	CPPUNIT_ASSERT( Filesystem::mkdir( sKitPath ) );
+	const QString sSourceKit = H2TEST_FILE( "drumkits/baseKit" );
+	for ( const auto& sFile : QDir( sSourceKit ).entryList( QDir::Files ) ) {
+		CPPUNIT_ASSERT( Filesystem::file_copy(
+							sSourceKit + "/" + sFile, sKitPath + "/" + sFile,
+							false, true ) );
+	}
+	pDB->registerDrumkitFolder( sFolder );
+	pDB->updateDrumkits( false );
+
+	const QString sSong = H2TEST_FILE( "song/legacy/test_song_1.2.2.h2song" );
+	auto pPlaylist = std::make_shared<Playlist>();
+	CPPUNIT_ASSERT( pPlaylist->add( std::make_shared<PlaylistEntry>( sSong ) ) );
+	CPPUNIT_ASSERT( CoreActionController::setPlaylist( pPlaylist ) );
+
+	auto pPreloader = m_pHydrogen->getPlaylistPreloader();
+	for ( int ii = 0; ii < 100 &&
+			  ( ii < 4 || ! pPreloader->isReady( sSong ) ); ++ii ) {
+		if ( ii % 2 == 0 ) {
+			CPPUNIT_ASSERT( QDir().rename( sKitPath, sRenamedKitPath ) );
+		} else {
+			CPPUNIT_ASSERT( QDir().rename( sRenamedKitPath, sKitPath ) );
+		}
+		pDB->updateDrumkits( false );
+	}
+	pPreloader->waitForPendingJobs();
+	CPPUNIT_ASSERT( pPreloader->isReady( sSong ) );
+
+	auto pSong = CoreActionController::loadSong( sSong );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	CPPUNIT_ASSERT( pSong->getDrumkit()->areSamplesLoaded() );
+
+	pPref->setPlaylistPreloadSongs( nPreloadSongs );
+	CPPUNIT_ASSERT( CoreActionController::setPlaylist(
+						std::make_shared<Playlist>() ) );
+	pPreloader->waitForPendingJobs();
+	CPPUNIT_ASSERT( Filesystem::rm( sFolder, true ) );
+	pDB->updateDrumkits( false );
+
+	___INFOLOG( "passed" );
+}
+
+void CoreActionControllerTest::testDrumkitSwitching() {
+	___INFOLOG( "" );
+
+	auto pSwitcher = m_pHydrogen->getDrumkitSwitcher();
+	auto pPreviousDrumkit = m_pHydrogen->getSong()->getDrumkit();
+
+	const auto pDrumkit = Drumkit::load( H2TEST_FILE( "drumkits/baseKit" ) );
+	CPPUNIT_ASSERT( pDrumkit != nullptr );
+	CPPUNIT_ASSERT( ! pDrumkit->areSamplesLoaded() );
+
+	// Transport is not rolling. The kit is switched as soon as its
+	// samples are loaded.
+	CPPUNIT_ASSERT( CoreActionController::switchDrumkit( pDrumkit ) );
+	pSwitcher->waitForPendingJobs();
+	CPPUNIT_ASSERT( ! pSwitcher->isPending() );
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pDrumkit );
+	CPPUNIT_ASSERT( pDrumkit->areSamplesLoaded() );
+
+	auto pAudioEngine = m_pHydrogen->getAudioEngine();
+	auto pPos = pAudioEngine->getTransportPosition();
+	CPPUNIT_ASSERT( pAudioEngine->getAudioDriver() != nullptr );
+	const auto nBufferSize = pAudioEngine->getAudioDriver()->getBufferSize();
+
+	// The fake driver does not process any audio on its own. Transport
+	// only moves when we run a cycle and gives the switcher some time to
+	// check the new position afterwards.
+	auto processCycle = [&]() {
+		AudioEngine::audioEngine_process( nBufferSize, nullptr );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+	};
+	auto areAllSamplesLoaded = []( std::shared_ptr<Drumkit> pKit ) {
+		for ( const auto& ppInstrument : *pKit->getInstruments() ) {
+			for ( const auto& ppComponent : *ppInstrument->get_components() ) {
+				for ( const auto& ppLayer : ppComponent->getLayers() ) {
+					if ( ppLayer != nullptr && ( ppLayer->get_sample() == nullptr ||
+						 ! ppLayer->get_sample()->isLoaded() ) ) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	};
+	auto waitForSamples = [&]( std::shared_ptr<Drumkit> pKit ) {
+		for ( int ii = 0; ii < 100 && ! areAllSamplesLoaded( pKit ); ++ii ) {
+			std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		}
+		return areAllSamplesLoaded( pKit );
+	};
+
+	CoreActionController::activateSongMode( false );
+	pAudioEngine->lock( RIGHT_HERE );
+	pAudioEngine->play();
+	pAudioEngine->unlock();
+	processCycle();
+	CPPUNIT_ASSERT( pAudioEngine->getState() == AudioEngine::State::Playing );
+
+	// Only the latest request is honored. As long as no cycle is
+	// processed, the bar boundary is never reached and the first
+	// request is kept waiting.
+	const auto pDrumkit2 = Drumkit::load( H2TEST_FILE( "drumkits/baseKit" ) );
+	CPPUNIT_ASSERT( pDrumkit2 != nullptr );
+	CPPUNIT_ASSERT( CoreActionController::switchDrumkit(
+						pDrumkit2, DrumkitSwitcher::Quantization::Bar ) );
+	CPPUNIT_ASSERT( waitForSamples( pDrumkit2 ) );
+	CPPUNIT_ASSERT( pSwitcher->isPending() );
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pDrumkit );
+
+	CPPUNIT_ASSERT( CoreActionController::switchDrumkit(
+						pPreviousDrumkit, DrumkitSwitcher::Quantization::None ) );
+	pSwitcher->waitForPendingJobs();
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pPreviousDrumkit );
+	CPPUNIT_ASSERT( ! pDrumkit2->areSamplesLoaded() );
+
+	// Quantized switch with transport rolling.
+	CPPUNIT_ASSERT( CoreActionController::switchDrumkit( pDrumkit ) );
+	pSwitcher->waitForPendingJobs();
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pDrumkit );
+
+	const double fBarSize = static_cast<double>( pPos->getPatternSize() );
+	const double fRequestTick = pPos->getDoubleTick();
+	// Same margin as used by the switcher.
+	const double fMargin = AudioEngine::getLeadLagInTicks() +
+		( AudioEngine::nMaxTimeHumanize + 2 * static_cast<double>( nBufferSize ) ) /
+		static_cast<double>( pPos->getTickSize() );
+	double fBoundary = pPos->getPatternStartTick() + fBarSize *
+		( std::floor( ( fRequestTick - pPos->getPatternStartTick() ) /
+					  fBarSize ) + 1 );
+	if ( fBoundary - fRequestTick < fMargin ) {
+		fBoundary += fBarSize;
+	}
+
+	CPPUNIT_ASSERT( CoreActionController::switchDrumkit(
+						pDrumkit2, DrumkitSwitcher::Quantization::Bar ) );
+	CPPUNIT_ASSERT( waitForSamples( pDrumkit2 ) );
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pDrumkit );
+
+	// The crash sample is longer than a bar and still rings when the
+	// switch happens.
+	auto pCrash = pDrumkit->getInstruments()->find( "Crash" );
+	CPPUNIT_ASSERT( pCrash != nullptr );
+	pAudioEngine->lock( RIGHT_HERE );
+	pAudioEngine->getSampler()->noteOn( new Note( pCrash ) );
+	pAudioEngine->unlock();
+
+	double fSwitchTick = -1;
+	for ( int ii = 0; ii < 1000 &&
+			  pPos->getDoubleTick() < fBoundary + fBarSize; ++ii ) {
+		if ( m_pHydrogen->getSong()->getDrumkit() == pDrumkit2 ) {
+			fSwitchTick = pPos->getDoubleTick();
+			break;
+		}
+		processCycle();
+	}
+	pSwitcher->waitForPendingJobs();
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pDrumkit2 );
+
+	// The switch has to happen right before the first notes of the
+	// next bar are queued.
+	CPPUNIT_ASSERT( fSwitchTick >= 0 );
+	CPPUNIT_ASSERT( fSwitchTick < fBoundary );
+	CPPUNIT_ASSERT( fBoundary - fSwitchTick <= fMargin +
+					nBufferSize / static_cast<double>( pPos->getTickSize() ) );
+
+	// Voices of the previous kit ring out instead of being released.
+	pAudioEngine->lock( RIGHT_HERE );
+	bool bCrashRinging = false;
+	for ( const auto& ppNote : pAudioEngine->getSampler()->getPlayingNotesQueue() ) {
+		if ( ppNote->get_instrument() == pCrash ) {
+			const auto state = ppNote->get_adsr()->getState();
+			bCrashRinging = state != ADSR::State::Release &&
+				state != ADSR::State::Idle;
+		}
+	}
+	pAudioEngine->getSampler()->stopPlayingNotes();
+	pAudioEngine->unlock();
+	CPPUNIT_ASSERT( bCrashRinging );
+
+	// Consecutive LOAD_NEXT_DRUMKIT actions step through the sound
+	// library even before the boundary is reached. Each one is relative
+	// to the kit requested last.
+	const auto database =
+		m_pHydrogen->getSoundLibraryDatabase()->getDrumkitDatabase();
+	CPPUNIT_ASSERT( database.size() > 2 );
+	auto pLoadNextAction = std::make_shared<Action>( "LOAD_NEXT_DRUMKIT" );
+	CPPUNIT_ASSERT( MidiActionManager::get_instance()->handleAction(
+						pLoadNextAction ) );
+	const auto pFirstNextDrumkit = pSwitcher->getPendingDrumkit();
+	CPPUNIT_ASSERT( pFirstNextDrumkit != nullptr );
+	CPPUNIT_ASSERT( MidiActionManager::get_instance()->handleAction(
+						pLoadNextAction ) );
+	const auto pSecondNextDrumkit = pSwitcher->getPendingDrumkit();
+	CPPUNIT_ASSERT( pSecondNextDrumkit != nullptr );
+	CPPUNIT_ASSERT( pSecondNextDrumkit != pFirstNextDrumkit );
+	auto it = database.find( pFirstNextDrumkit->getPath() );
+	CPPUNIT_ASSERT( it != database.end() );
+	++it;
+	if ( it == database.end() ) {
+		it = database.begin();
+	}
+	CPPUNIT_ASSERT( it->second == pSecondNextDrumkit );
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pDrumkit2 );
+
+	// Drop the pending request.
+	CPPUNIT_ASSERT( CoreActionController::switchDrumkit(
+						pDrumkit2, DrumkitSwitcher::Quantization::None ) );
+	pSwitcher->waitForPendingJobs();
+	CPPUNIT_ASSERT( pSwitcher->getPendingDrumkit() == nullptr );
+	CPPUNIT_ASSERT( m_pHydrogen->getSong()->getDrumkit() == pDrumkit2 );
+
+	pAudioEngine->lock( RIGHT_HERE );
+	pAudioEngine->stop();
+	pAudioEngine->unlock();
+	processCycle();
+	CPPUNIT_ASSERT( pAudioEngine->getState() == AudioEngine::State::Ready );
+	CPPUNIT_ASSERT( CoreActionController::locateToTick( 0 ) );
+	CPPUNIT_ASSERT( CoreActionController::setDrumkit( pPreviousDrumkit ) );
+
+	___INFOLOG( "passed" );
+}
+
+void CoreActionControllerTest::testInstrumentReclamation() {
+	___INFOLOG( "" );
+
+	auto pAudioEngine = m_pHydrogen->getAudioEngine();
+	auto pReclaimer = pAudioEngine->getInstrumentReclaimer();
+	auto pPreviousDrumkit = m_pHydrogen->getSong()->getDrumkit();
+
+	auto isLoaded = []( std::shared_ptr<Instrument> pInstrument ) {
+		for ( const auto& ppComponent : *pInstrument->get_components() ) {
+			for ( const auto& ppLayer : ppComponent->getLayers() ) {
+				if ( ppLayer != nullptr && ppLayer->get_sample() != nullptr &&
+					 ppLayer->get_sample()->isLoaded() ) {
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+	auto waitForRetired = [&]( int nRetired ) {
+		for ( int ii = 0; ii < 100 &&
+				  pReclaimer->getRetiredCount() != nRetired; ++ii ) {
+			std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		}
+		return pReclaimer->getRetiredCount() == nRetired;
+	};
+
+	const auto pDrumkit = Drumkit::load( H2TEST_FILE( "drumkits/baseKit" ) );
+	CPPUNIT_ASSERT( pDrumkit != nullptr );
+	CPPUNIT_ASSERT( pDrumkit->getInstruments()->size() > 1 );
+	CPPUNIT_ASSERT( CoreActionController::setDrumkit( pDrumkit ) );
+	CPPUNIT_ASSERT( waitForRetired( 0 ) );
+
+	auto pPlaying = pDrumkit->getInstruments()->get( 0 );
+	auto pSilent = pDrumkit->getInstruments()->get( 1 );
+	CPPUNIT_ASSERT( isLoaded( pPlaying ) );
+	CPPUNIT_ASSERT( isLoaded( pSilent ) );
+
+	// Let one instrument ring in the sampler. Since the fake driver does
+	// not process any audio, its note stays there.
+	pAudioEngine->lock( RIGHT_HERE );
+	pAudioEngine->getSampler()->noteOn( new Note( pPlaying ) );
+	pAudioEngine->unlock();
+
+	CPPUNIT_ASSERT( CoreActionController::setDrumkit( pPreviousDrumkit ) );
+	CPPUNIT_ASSERT( pPlaying->is_retired() );
+	CPPUNIT_ASSERT( waitForRetired( 1 ) );
+	CPPUNIT_ASSERT( isLoaded( pPlaying ) );
+	CPPUNIT_ASSERT( ! isLoaded( pSilent ) );
+
+	// Once the note is gone, its instrument is reclaimed too.
+	pAudioEngine->lock( RIGHT_HERE );
+	pAudioEngine->getSampler()->stopPlayingNotes();
+	pAudioEngine->unlock();
+	CPPUNIT_ASSERT( waitForRetired( 0 ) );
+	CPPUNIT_ASSERT( ! pPlaying->is_retired() );
+	CPPUNIT_ASSERT( ! isLoaded( pPlaying ) );
+
+	// Switching back revives the instruments.
+	CPPUNIT_ASSERT( CoreActionController::setDrumkit( pDrumkit ) );
+	CPPUNIT_ASSERT( isLoaded( pPlaying ) );
+
+	// A sample replaced in a layer stays alive till the note rendering
+	// it is done and is released by the reclaimer afterwards.
+	auto pLayer = pPlaying->get_component( 0 )->getLayer( 0 );
+	CPPUNIT_ASSERT( pLayer != nullptr && pLayer->get_sample() != nullptr );
+	std::weak_ptr<Sample> pOldSample = pLayer->get_sample();
+	auto pNote = new Note( pPlaying );
+	CPPUNIT_ASSERT( pNote->get_layer_selected( 0 ) != nullptr );
+	pNote->get_layer_selected( 0 )->nSelectedLayer = 0;
+	pNote->get_layer_selected( 0 )->pLayer = pLayer;
+	pNote->get_layer_selected( 0 )->pSample = pLayer->get_sample();
+	pAudioEngine->lock( RIGHT_HERE );
+	pAudioEngine->getSampler()->noteOn( pNote );
+	m_pHydrogen->addSampleToDeathRow( pLayer->get_sample() );
+	pLayer->set_sample( std::make_shared<Sample>( pLayer->get_sample() ) );
+	pAudioEngine->unlock();
+
+	std::this_thread::sleep_for( std::chrono::milliseconds(
+		2 * InstrumentReclaimer::nRetryInterval ) );
+	CPPUNIT_ASSERT( pReclaimer->getRetiredSampleCount() == 1 );
+	CPPUNIT_ASSERT( ! pOldSample.expired() );
+
+	pAudioEngine->lock( RIGHT_HERE );
+	pAudioEngine->getSampler()->stopPlayingNotes();
+	pAudioEngine->unlock();
+	for ( int ii = 0; ii < 100 &&
+			  pReclaimer->getRetiredSampleCount() != 0; ++ii ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+	}
+	CPPUNIT_ASSERT( pReclaimer->getRetiredSampleCount() == 0 );
+	CPPUNIT_ASSERT( pOldSample.expired() );
+
+	CPPUNIT_ASSERT( CoreActionController::setDrumkit( pPreviousDrumkit ) );
+
+	___INFOLOG( "passed" );
+}
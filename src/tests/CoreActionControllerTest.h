@@ -29,6 +29,10 @@ class CoreActionControllerTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( CoreActionControllerTest );
 	CPPUNIT_TEST( testSessionManagement );
 	CPPUNIT_TEST( testIsPathValid );
+	CPPUNIT_TEST( testPlaylistPreloading );
+	CPPUNIT_TEST( testPlaylistPreloadingDuringRescan );
+	CPPUNIT_TEST( testDrumkitSwitching );
+	CPPUNIT_TEST( testInstrumentReclamation );
 	CPPUNIT_TEST_SUITE_END();
 	
 private:
@@ -54,4 +58,24 @@ public:
 	
 	// Tests Filesystem::isPathValid()
 	void testIsPathValid();
+
+	// Tests whether upcoming playlist songs are preloaded by the
+	// PlaylistPreloader and handed over by
+	// CoreActionController::loadSong().
+	void testPlaylistPreloading();
+
+	// Tests whether a legacy song, which queries the
+	// SoundLibraryDatabase for the license of its kit, can be preloaded
+	// while the database is rescanned.
+	void testPlaylistPreloadingDuringRescan();
+
+	// Tests whether CoreActionController::switchDrumkit() switches
+	// kits in the background and whether LOAD_NEXT_DRUMKIT steps
+	// relative to a pending switch.
+	void testDrumkitSwitching();
+
+	// Tests whether the InstrumentReclaimer unloads the samples of
+	// instruments removed from the kit and releases samples replaced
+	// in a layer only after their last note.
+	void testInstrumentReclamation();
 };
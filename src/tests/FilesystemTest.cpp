@@ -24,6 +24,9 @@
 
 #include <QTest>
 
+#include <core/Helpers/AutoSaver.h>
+#include <core/Helpers/Xml.h>
+
 using namespace H2Core;
 
 void FilesystemTest::setUp() {
@@ -107,3 +110,45 @@ void FilesystemTest::testFilePathValidation() {
 		CPPUNIT_ASSERT( ssValidatedTwice == ssValidated );
 	}
 }
+
+void FilesystemTest::testAutoSaver() {
+	___INFOLOG( "" );
+	const QString sPath = Filesystem::tmp_file_path( "autosave.h2song" );
+
+	auto createDoc = []( const QString& sValue ) {
+		auto pDoc = std::make_unique<XMLDoc>();
+		XMLNode root = pDoc->set_root( "song" );
+		root.write_string( "name", sValue );
+		return pDoc;
+	};
+
+	{
+		AutoSaver autoSaver;
+		autoSaver.save( sPath, createDoc( "first" ) );
+		autoSaver.waitForPendingJobs();
+		CPPUNIT_ASSERT( Filesystem::file_exists( sPath, true ) );
+		CPPUNIT_ASSERT( autoSaver.getWriteCount() == 1 );
+
+		// Unchanged content must not be written again.
+		autoSaver.save( sPath, createDoc( "first" ) );
+		autoSaver.waitForPendingJobs();
+		CPPUNIT_ASSERT( autoSaver.getWriteCount() == 1 );
+		CPPUNIT_ASSERT( autoSaver.getSkipCount() == 1 );
+
+		autoSaver.save( sPath, createDoc( "second" ) );
+		autoSaver.waitForPendingJobs();
+		CPPUNIT_ASSERT( autoSaver.getWriteCount() == 2 );
+
+		XMLDoc doc;
+		CPPUNIT_ASSERT( doc.read( sPath, nullptr, true ) );
+		CPPUNIT_ASSERT( doc.firstChildElement( "song" )
+						.firstChildElement( "name" ).text() == "second" );
+
+		autoSaver.save( sPath, createDoc( "third" ) );
+		autoSaver.remove( sPath );
+		CPPUNIT_ASSERT( ! Filesystem::file_exists( sPath, true ) );
+	}
+	CPPUNIT_ASSERT( ! Filesystem::file_exists( sPath, true ) );
+
+	___INFOLOG( "passed" );
+}
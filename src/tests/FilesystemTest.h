@@ -29,6 +29,7 @@ class FilesystemTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST( testPermissions );
 	CPPUNIT_TEST( testUniquePrefix );
 	CPPUNIT_TEST( testFilePathValidation );
+	CPPUNIT_TEST( testAutoSaver );
 	CPPUNIT_TEST_SUITE_END();
 	
 	
@@ -39,6 +40,7 @@ public:
 	void testPermissions();
 		void testUniquePrefix();
 	void testFilePathValidation();
+	void testAutoSaver();
 
 private:
 	QString m_sNotExistingPath;
@@ -40,12 +40,15 @@
 #include <core/Basics/Song.h>
 #include <core/Basics/Playlist.h>
 #include <core/SMF/SMF.h>
+#include <core/SMF/SMFReader.h>
 #include "TestHelper.h"
 #include "assertions/File.h"
 #include "assertions/AudioFile.h"
 
 #include <chrono>
 #include <memory>
+#include <set>
+#include <utility>
 
 using namespace H2Core;
 
@@ -55,6 +58,7 @@ class FunctionalTest : public CppUnit::TestCase {
 	CPPUNIT_TEST( testExportMIDISMF0 );
 	CPPUNIT_TEST( testExportMIDISMF1Single );
 	CPPUNIT_TEST( testExportMIDISMF1Multi );
+	CPPUNIT_TEST( testImportMIDI );
 //	CPPUNIT_TEST( testExportMuteGroupsAudio ); // SKIP
 	CPPUNIT_TEST( testExportVelocityAutomationAudio );
 	CPPUNIT_TEST( testExportVelocityAutomationMIDISMF0 );
@@ -142,6 +146,44 @@ public:
 	___INFOLOG( "passed" );
 	}
 	
+	void testImportMIDI()
+	{
+	___INFOLOG( "" );
+		auto songFile = H2TEST_FILE("functional/test.h2song");
+
+		// Position and instrument of all notes in a pattern.
+		auto noteSet = []( const Pattern* pPattern ) {
+			std::set<std::pair<int, int>> notes;
+			FOREACH_NOTE_CST_IT_BEGIN_END( pPattern->get_notes(), it ) {
+				notes.insert( std::make_pair(
+								  it->second->get_position(),
+								  it->second->get_instrument()->get_id() ) );
+			}
+			return notes;
+		};
+
+		for ( const auto& sMidiFile : { "functional/smf0.test.ref.mid",
+										 "functional/smf1multi.test.ref.mid" } ) {
+			auto pSong = Song::load( songFile );
+			CPPUNIT_ASSERT( pSong != nullptr );
+			const auto originalNotes =
+				noteSet( pSong->getPatternList()->get( 0 ) );
+
+			SMFReader reader;
+			CPPUNIT_ASSERT( reader.load( H2TEST_FILE( sMidiFile ), pSong ) );
+
+			CPPUNIT_ASSERT_EQUAL( 1, pSong->getPatternList()->size() );
+			CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(1),
+								  pSong->getPatternGroupVector()->size() );
+			CPPUNIT_ASSERT_EQUAL( 120.0f, pSong->getBpm() );
+
+			auto pPattern = pSong->getPatternList()->get( 0 );
+			CPPUNIT_ASSERT_EQUAL( 192, pPattern->get_length() );
+			CPPUNIT_ASSERT( originalNotes == noteSet( pPattern ) );
+		}
+	___INFOLOG( "passed" );
+	}
+
 /* SKIP
 	void testExportMuteGroupsAudio()
 	{
@@ -35,6 +35,7 @@ class InstrumentListTest : public CppUnit::TestCase {
 	CPPUNIT_TEST( test2 );
 	CPPUNIT_TEST( test3 );
 	CPPUNIT_TEST( test4 );
+	CPPUNIT_TEST( testFindMidiNote );
 	CPPUNIT_TEST_SUITE_END();
 	
 	public:
@@ -131,5 +132,44 @@ class InstrumentListTest : public CppUnit::TestCase {
 		CPPUNIT_ASSERT( !list.is_valid_index(-42) );
 	___INFOLOG( "passed" );
 	}
+
+	void testFindMidiNote()
+	{
+	___INFOLOG( "" );
+		InstrumentList list;
+
+		auto pKick = std::make_shared<Instrument>( EMPTY_INSTR_ID, "Kick" );
+		pKick->set_midi_out_note(36);
+		list.add(pKick);
+
+		auto pSnare = std::make_shared<Instrument>( EMPTY_INSTR_ID, "Snare" );
+		pSnare->set_midi_out_note(38);
+		list.add(pSnare);
+
+		auto pDummy = std::make_shared<Instrument>( EMPTY_INSTR_ID, "Dummy" );
+		pDummy->set_midi_out_note(36); // duplicate
+		list.add(pDummy);
+
+		CPPUNIT_ASSERT( list.findMidiNote( 36 ) == pKick );
+		CPPUNIT_ASSERT( list.findMidiNote( 38 ) == pSnare );
+		CPPUNIT_ASSERT( list.findMidiNote( 40 ) == nullptr );
+		CPPUNIT_ASSERT( list.findMidiNote( -1 ) == nullptr );
+		CPPUNIT_ASSERT( list.findMidiNote( 128 ) == nullptr );
+
+		// Lookup table has to follow changes of the instruments...
+		pSnare->set_midi_out_note(40);
+		CPPUNIT_ASSERT( list.findMidiNote( 38 ) == nullptr );
+		CPPUNIT_ASSERT( list.findMidiNote( 40 ) == pSnare );
+
+		// ... as well as of the list itself.
+		list.move( 2, 0 );
+		CPPUNIT_ASSERT( list.findMidiNote( 36 ) == pDummy );
+		list.del( pDummy );
+		CPPUNIT_ASSERT( list.findMidiNote( 36 ) == pKick );
+		list.del( pKick );
+		CPPUNIT_ASSERT( list.findMidiNote( 36 ) == nullptr );
+		CPPUNIT_ASSERT( list.findMidiNote( 40 ) == pSnare );
+	___INFOLOG( "passed" );
+	}
 };
 
@@ -23,6 +23,8 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/Note.h>
 #include <core/IO/MidiCommon.h>
@@ -38,6 +40,7 @@ class NoteTest : public CppUnit::TestCase {
 	CPPUNIT_TEST( testVirtualKeyboard );
 	CPPUNIT_TEST( testProbability );
 	CPPUNIT_TEST( testSerializeProbability );
+	CPPUNIT_TEST( testLayerSelection );
 	CPPUNIT_TEST_SUITE_END();
 
 	void testMidiDefaultOffset() {
@@ -100,5 +103,51 @@ class NoteTest : public CppUnit::TestCase {
 		delete pOut;
 	___INFOLOG( "passed" );
 	}
+
+	void testLayerSelection()
+	{
+	___INFOLOG( "" );
+		auto pCompo = std::make_shared<InstrumentComponent>();
+		CPPUNIT_ASSERT_EQUAL( -1, pCompo->selectLayer( 0.5, Instrument::VELOCITY ) );
+
+		// Two velocity layers with a hole in between and two round
+		// robin layers on top.
+		auto addLayer = [&]( int nIdx, float fStart, float fEnd ) {
+			auto pLayer = std::make_shared<InstrumentLayer>( nullptr );
+			pLayer->set_start_velocity( fStart );
+			pLayer->set_end_velocity( fEnd );
+			pCompo->setLayer( pLayer, nIdx );
+		};
+		addLayer( 0, 0.0, 0.3 );
+		addLayer( 1, 0.4, 0.6 );
+		addLayer( 2, 0.6, 1.0 );
+		addLayer( 3, 0.6, 1.0 );
+
+		CPPUNIT_ASSERT_EQUAL( 0, pCompo->selectLayer( 0.0, Instrument::VELOCITY ) );
+		CPPUNIT_ASSERT_EQUAL( 0, pCompo->selectLayer( 0.3, Instrument::VELOCITY ) );
+		CPPUNIT_ASSERT_EQUAL( 1, pCompo->selectLayer( 0.6, Instrument::VELOCITY ) );
+		CPPUNIT_ASSERT_EQUAL( 2, pCompo->selectLayer( 0.61, Instrument::VELOCITY ) );
+		CPPUNIT_ASSERT_EQUAL( 2, pCompo->selectLayer( 1.0, Instrument::VELOCITY ) );
+
+		// Hole. The layer with the nearest start velocity is used.
+		CPPUNIT_ASSERT_EQUAL( 1, pCompo->selectLayer( 0.35, Instrument::VELOCITY ) );
+
+		// Round robin cycles through all layers covering the velocity.
+		CPPUNIT_ASSERT_EQUAL( 3, pCompo->selectLayer( 0.8, Instrument::ROUND_ROBIN ) );
+		CPPUNIT_ASSERT_EQUAL( 2, pCompo->selectLayer( 0.8, Instrument::ROUND_ROBIN ) );
+		CPPUNIT_ASSERT_EQUAL( 3, pCompo->selectLayer( 0.8, Instrument::ROUND_ROBIN ) );
+		CPPUNIT_ASSERT_EQUAL( 0, pCompo->selectLayer( 0.1, Instrument::ROUND_ROBIN ) );
+
+		for ( int ii = 0; ii < 10; ++ii ) {
+			const int nLayer = pCompo->selectLayer( 0.7, Instrument::RANDOM );
+			CPPUNIT_ASSERT( nLayer == 2 || nLayer == 3 );
+		}
+
+		// Changes of the velocity range have to be picked up.
+		pCompo->getLayer( 0 )->set_end_velocity( 0.4 );
+		pCompo->updateLayerSelection();
+		CPPUNIT_ASSERT_EQUAL( 0, pCompo->selectLayer( 0.35, Instrument::VELOCITY ) );
+	___INFOLOG( "passed" );
+	}
 };
 
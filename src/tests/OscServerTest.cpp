@@ -28,8 +28,14 @@
 #include <core/MidiAction.h>
 #include <core/OscServer.h>
 
+#include <QElapsedTimer>
 #include <QTest>
 
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Song.h>
+
 using namespace H2Core;
 
 
@@ -119,4 +125,47 @@ void OscServerTest::testSessionManagement(){
 	___INFOLOG( "passed" );
 }
 
+void OscServerTest::testStripRoutes(){
+	___INFOLOG( "" );
+
+	auto pSong = m_pHydrogen->getSong();
+	CPPUNIT_ASSERT( pSong != nullptr );
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( 0 );
+	CPPUNIT_ASSERT( pInstrument != nullptr );
+
+	lo_arg arg;
+	lo_arg* argv[] = { &arg };
+
+	arg.f = 0.5;
+	OscServer::generic_handler( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1", "f",
+								argv, 1, nullptr, nullptr );
+	CPPUNIT_ASSERT( pInstrument->get_volume() == 0.5 );
+
+	arg.f = 0.7;
+	for ( const auto& sPath : { "/Hydrogen/STRIP_VOLUME_ABSOLUTE",
+								"/Hydrogen/STRIP_VOLUME_ABSOLUTE/",
+								"/Hydrogen/STRIP_VOLUME_ABSOLUTE/0",
+								"/Hydrogen/STRIP_VOLUME_ABSOLUTE/1a",
+								"/Hydrogen/STRIP_VOLUME_ABSOLUTE/1/2",
+								"/Hydrogen/STRIP_VOLUME_ABSOLUTE_X/1",
+								"/Hydro/STRIP_VOLUME_ABSOLUTE/1" } ) {
+		OscServer::generic_handler( sPath, "f", argv, 1, nullptr, nullptr );
+		CPPUNIT_ASSERT( pInstrument->get_volume() == 0.5 );
+	}
+
+	const int nMessages = 10000;
+	QElapsedTimer timer;
+	timer.start();
+	for ( int ii = 0; ii < nMessages; ++ii ) {
+		arg.f = static_cast<float>( ii % 100 ) / 100;
+		OscServer::generic_handler( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1", "f",
+									argv, 1, nullptr, nullptr );
+	}
+	const qint64 nElapsed = std::max( timer.nsecsElapsed(), qint64( 1 ) );
+	___INFOLOG( QString( "[%1] strip messages per second" )
+				.arg( static_cast<double>( nMessages ) * 1e9 / nElapsed ) );
+
+	___INFOLOG( "passed" );
+}
+
 #endif
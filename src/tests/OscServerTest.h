@@ -33,6 +33,7 @@
 class OscServerTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( OscServerTest );
 	CPPUNIT_TEST( testSessionManagement );
+	CPPUNIT_TEST( testStripRoutes );
 	CPPUNIT_TEST_SUITE_END();
 	
 private:
@@ -73,6 +74,13 @@ public:
 	 * current song does match the expected result.
 	 */
 	void testSessionManagement();
+
+	/**
+	 * Invokes OscServer::generic_handler() directly with valid and
+	 * malformed strip paths and measures how many strip messages per
+	 * second can be dispatched.
+	 */
+	void testStripRoutes();
 };
 
 #endif
@@ -24,6 +24,12 @@
 
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
+
+#include "TestHelper.h"
+
+#include <vector>
 
 using namespace H2Core;
 
@@ -43,3 +49,67 @@ void PatternTest::testPurgeInstrument()
 	delete pPattern;
 	___INFOLOG( "passed" );
 }
+
+void PatternTest::testSequenceSnapshot()
+{
+	___INFOLOG( "" );
+	auto pSong = Song::load(
+		H2TEST_FILE( "song/AE_transportProcessingTimeline.h2song" ) );
+	CPPUNIT_ASSERT( pSong != nullptr );
+
+	auto pPatternList = pSong->getPatternList();
+	auto pColumns = pSong->getPatternGroupVector();
+	CPPUNIT_ASSERT( pPatternList->size() > 1 );
+	CPPUNIT_ASSERT( pColumns->size() > 1 );
+
+	pPatternList->get( 0 )->virtual_patterns_add( pPatternList->get( 1 ) );
+	pPatternList->flattened_virtual_patterns_compute();
+
+	std::vector<std::vector<Pattern*>> columns;
+	for ( const auto& ppColumn : *pColumns ) {
+		std::vector<Pattern*> column;
+		for ( const auto& ppPattern : *ppColumn ) {
+			column.push_back( ppPattern );
+		}
+		columns.push_back( column );
+	}
+
+	auto pSnapshot = pSong->getSequenceSnapshot();
+	CPPUNIT_ASSERT_EQUAL( columns.size(), pSnapshot->columns.size() );
+
+	// Unaltered columns are shared between consecutive snapshots.
+	auto pColumn = ( *pColumns )[ 0 ];
+	pColumn->add( pPatternList->get( pPatternList->size() - 1 ) );
+	auto pOtherSnapshot = pSong->getSequenceSnapshot();
+	CPPUNIT_ASSERT( pSnapshot->columns[ 0 ] != pOtherSnapshot->columns[ 0 ] );
+	for ( int ii = 1; ii < pSnapshot->columns.size(); ++ii ) {
+		CPPUNIT_ASSERT( pSnapshot->columns[ ii ] == pOtherSnapshot->columns[ ii ] );
+	}
+
+	// Restore the original state after clearing the sequence.
+	for ( auto& ppColumn : *pColumns ) {
+		ppColumn->clear();
+		delete ppColumn;
+	}
+	pColumns->clear();
+	pPatternList->get( 0 )->virtual_patterns_clear();
+
+	pSong->setSequenceSnapshot( pSnapshot );
+
+	CPPUNIT_ASSERT_EQUAL( columns.size(), pColumns->size() );
+	for ( int ii = 0; ii < columns.size(); ++ii ) {
+		auto pRestoredColumn = ( *pColumns )[ ii ];
+		CPPUNIT_ASSERT_EQUAL( static_cast<int>(columns[ ii ].size()),
+							  pRestoredColumn->size() );
+		for ( int jj = 0; jj < columns[ ii ].size(); ++jj ) {
+			CPPUNIT_ASSERT( columns[ ii ][ jj ] == pRestoredColumn->get( jj ) );
+		}
+	}
+
+	auto pVirtualPatterns = pPatternList->get( 0 )->get_virtual_patterns();
+	CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(1), pVirtualPatterns->size() );
+	CPPUNIT_ASSERT( *pVirtualPatterns->begin() == pPatternList->get( 1 ) );
+	CPPUNIT_ASSERT( pPatternList->get( 0 )->get_flattened_virtual_patterns()
+					->count( pPatternList->get( 1 ) ) == 1 );
+	___INFOLOG( "passed" );
+}
@@ -0,0 +1,110 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <core/Helpers/Random.h>
+
+#include <thread>
+#include <vector>
+
+using namespace H2Core;
+
+class RandomTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE( RandomTest );
+	CPPUNIT_TEST( testSameSeed );
+	CPPUNIT_TEST( testDifferentSeed );
+	CPPUNIT_TEST( testThreadIndependence );
+	CPPUNIT_TEST_SUITE_END();
+
+	private:
+		uint64_t m_nOldSeed;
+
+		/** Mixes all kinds of numbers as drawn e.g. during
+		 * humanization. */
+		static std::vector<float> draw( int nCount ) {
+			std::vector<float> values;
+			for ( int ii = 0; ii < nCount; ++ii ) {
+				values.push_back( Random::getUniform() );
+				values.push_back( static_cast<float>( Random::getInt( 1000 ) ) );
+				values.push_back( Random::getGaussian( 1.0 ) );
+			}
+			return values;
+		}
+
+	public:
+	void setUp() override {
+		m_nOldSeed = Random::getSeed();
+	}
+
+	void tearDown() override {
+		Random::setSeed( m_nOldSeed );
+	}
+
+	void testSameSeed() {
+	___INFOLOG( "" );
+		Random::setSeed( 42 );
+		const auto first = draw( 100 );
+		Random::setSeed( 42 );
+		const auto second = draw( 100 );
+
+		CPPUNIT_ASSERT( first == second );
+		CPPUNIT_ASSERT_EQUAL( static_cast<uint64_t>( 42 ), Random::getSeed() );
+	___INFOLOG( "passed" );
+	}
+
+	void testDifferentSeed() {
+	___INFOLOG( "" );
+		Random::setSeed( 42 );
+		const auto first = draw( 100 );
+		Random::setSeed( 43 );
+		const auto second = draw( 100 );
+
+		CPPUNIT_ASSERT( first != second );
+	___INFOLOG( "passed" );
+	}
+
+	void testThreadIndependence() {
+	___INFOLOG( "" );
+		Random::setSeed( 1234 );
+		const auto reference = draw( 100 );
+
+		// Numbers drawn by one thread must neither advance nor be
+		// affected by the generator of another one. Each of them
+		// starts from the common seed.
+		Random::setSeed( 1234 );
+		const auto head = draw( 50 );
+
+		std::vector<float> other;
+		std::thread thread( [&]() { other = draw( 100 ); } );
+		thread.join();
+
+		const auto tail = draw( 50 );
+
+		CPPUNIT_ASSERT( other == reference );
+
+		auto combined = head;
+		combined.insert( combined.end(), tail.begin(), tail.end() );
+		CPPUNIT_ASSERT( combined == reference );
+	___INFOLOG( "passed" );
+	}
+};
@@ -24,10 +24,13 @@
 #include "TestHelper.h"
 
 #include <core/Basics/Sample.h>
+#include <core/Helpers/SampleMemory.h>
+#include <core/Preferences/Preferences.h>
 
 class SampleTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE( SampleTest );
 	CPPUNIT_TEST( testLoadInvalidSample );
+	CPPUNIT_TEST( testSampleMemory );
 
 	CPPUNIT_TEST_SUITE_END();
 
@@ -47,4 +50,53 @@ class SampleTest : public CppUnit::TestCase {
 		CPPUNIT_ASSERT(pSample == nullptr);
 	___INFOLOG( "passed" );
 	}
+
+	void testSampleMemory()
+	{
+	___INFOLOG( "" );
+#ifdef WIN32
+		// Sample data is always allocated using new[] on Windows.
+		return;
+#endif
+		auto pPref = H2Core::Preferences::get_instance();
+		const bool bOldLockSampleMemory = pPref->m_bLockSampleMemory;
+		pPref->m_bLockSampleMemory = true;
+
+		const size_t nBaseline = H2Core::SampleMemory::getLockedBytes() +
+			H2Core::SampleMemory::getUnlockedBytes();
+
+		auto pSample = H2Core::Sample::load(
+			H2TEST_FILE( "drumkits/baseKit/crash.wav" ) );
+		CPPUNIT_ASSERT( pSample != nullptr );
+		CPPUNIT_ASSERT( pSample->get_frames() > 0 );
+
+		// Sample data is placed in the arenas, aligned, and accounted
+		// for either as locked or unlocked memory (depending on
+		// RLIMIT_MEMLOCK of the test environment).
+		CPPUNIT_ASSERT( reinterpret_cast<uintptr_t>( pSample->get_data_l() ) %
+						H2Core::SampleMemory::nAlignment == 0 );
+		CPPUNIT_ASSERT( reinterpret_cast<uintptr_t>( pSample->get_data_r() ) %
+						H2Core::SampleMemory::nAlignment == 0 );
+		CPPUNIT_ASSERT( H2Core::SampleMemory::getLockedBytes() +
+						H2Core::SampleMemory::getUnlockedBytes() >=
+						nBaseline + 2 * pSample->get_frames() * sizeof( float ) );
+
+		// Copies use the arenas as well.
+		auto pCopy = std::make_shared<H2Core::Sample>( pSample );
+		CPPUNIT_ASSERT( pCopy->get_data_l() != pSample->get_data_l() );
+		CPPUNIT_ASSERT( std::equal( pSample->get_data_l(),
+									pSample->get_data_l() + pSample->get_frames(),
+									pCopy->get_data_l() ) );
+
+		pSample = nullptr;
+		pCopy = nullptr;
+		CPPUNIT_ASSERT( H2Core::SampleMemory::getLockedBytes() +
+						H2Core::SampleMemory::getUnlockedBytes() == nBaseline );
+
+		// Arrays not allocated by the arenas are released as well.
+		H2Core::SampleMemory::release( new float[ 16 ] );
+
+		pPref->m_bLockSampleMemory = bOldLockSampleMemory;
+	___INFOLOG( "passed" );
+	}
 };
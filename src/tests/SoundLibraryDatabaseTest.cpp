@@ -0,0 +1,89 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "SoundLibraryDatabaseTest.h"
+#include "TestHelper.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include <core/Basics/Drumkit.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/SoundLibrary/SoundLibraryDatabase.h>
+
+using namespace H2Core;
+
+void SoundLibraryDatabaseTest::testIncrementalUpdate() {
+	___INFOLOG( "" );
+
+	const QString sFolder = Filesystem::tmp_dir() + "soundLibraryDatabaseTest";
+	const QString sKitPath = sFolder + "/baseKit";
+	if ( QDir( sFolder ).exists() ) {
+		CPPUNIT_ASSERT( Filesystem::rm( sFolder, true ) );
+	}
+	CPPUNIT_ASSERT( Filesystem::mkdir( sKitPath ) );
+
+	const QString sSourceKit = H2TEST_FILE( "drumkits/baseKit" );
+	for ( const auto& sFile : QDir( sSourceKit ).entryList( QDir::Files ) ) {
+		CPPUNIT_ASSERT( Filesystem::file_copy(
+							sSourceKit + "/" + sFile, sKitPath + "/" + sFile,
+							false, true ) );
+	}
+
+	auto pDB = std::make_shared<SoundLibraryDatabase>();
+	pDB->registerDrumkitFolder( sFolder );
+	pDB->updateDrumkits( false );
+
+	const QString sAbsoluteKitPath = QDir( sKitPath ).absolutePath();
+	auto database = pDB->getDrumkitDatabase();
+	CPPUNIT_ASSERT( database.find( sAbsoluteKitPath ) != database.end() );
+	const auto pDrumkit = database.at( sAbsoluteKitPath );
+	CPPUNIT_ASSERT( pDrumkit != nullptr );
+
+	// Unchanged kits are not loaded again.
+	pDB->updateDrumkits( false );
+	database = pDB->getDrumkitDatabase();
+	CPPUNIT_ASSERT( database.at( sAbsoluteKitPath ) == pDrumkit );
+
+	// Modified ones are.
+	QFile drumkitFile( Filesystem::drumkit_file( sKitPath ) );
+	CPPUNIT_ASSERT( drumkitFile.open( QIODevice::ReadWrite ) );
+	CPPUNIT_ASSERT( drumkitFile.setFileTime(
+						QDateTime::currentDateTime().addSecs( 10 ),
+						QFileDevice::FileModificationTime ) );
+	drumkitFile.close();
+	pDB->updateDrumkits( false );
+	database = pDB->getDrumkitDatabase();
+	CPPUNIT_ASSERT( database.find( sAbsoluteKitPath ) != database.end() );
+	CPPUNIT_ASSERT( database.at( sAbsoluteKitPath ) != pDrumkit );
+	CPPUNIT_ASSERT( database.at( sAbsoluteKitPath )->getName() ==
+					pDrumkit->getName() );
+
+	// Removed ones are dropped.
+	CPPUNIT_ASSERT( Filesystem::rm( sFolder, true ) );
+	pDB->updateDrumkits( false );
+	database = pDB->getDrumkitDatabase();
+	CPPUNIT_ASSERT( database.find( sAbsoluteKitPath ) == database.end() );
+
+	___INFOLOG( "passed" );
+}
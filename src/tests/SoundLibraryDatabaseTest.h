@@ -0,0 +1,37 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef SOUND_LIBRARY_DATABASE_TEST_H
+#define SOUND_LIBRARY_DATABASE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SoundLibraryDatabaseTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( SoundLibraryDatabaseTest );
+	CPPUNIT_TEST( testIncrementalUpdate );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	/** Only kits added or modified on disk must be reloaded. */
+	void testIncrementalUpdate();
+};
+#endif
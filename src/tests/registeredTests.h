@@ -43,8 +43,10 @@
 #include "NoteTest.cpp"
 #include "OscServerTest.h"
 #include "PatternTest.h"
+#include "RandomTest.cpp"
 #include "SampleTest.cpp"
 #include "SongExportTest.h"
+#include "SoundLibraryDatabaseTest.h"
 #include "TimeTest.h"
 #include "Translations.cpp"
 #include "TransportTest.h"
@@ -76,8 +78,10 @@ CPPUNIT_TEST_SUITE_REGISTRATION( NoteTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( OscServerTest );
 #endif
 CPPUNIT_TEST_SUITE_REGISTRATION( PatternTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( RandomTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( SampleTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( SongExportTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SoundLibraryDatabaseTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TimeTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TransportTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( UITranslationTest );